@@ -0,0 +1,212 @@
+#include <engine/engine.h>
+#include <engine/utils/timer.h>
+
+#include <stb_image.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <cctype>
+#include <cstdlib>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+using namespace eng;
+
+//Asset cooker - bakes the startup resources (res/json & res/textures) into a single pack, that the game memory maps at startup.
+//Game uses the pack automatically when it exists (res/assets.pak), delete it to go back to the loose files. Usage:
+//    strategy2d_cook [output] [--raw]     (--raw = no compression, pixels are uploaded straight from the mapped file)
+//    strategy2d_cook [output] --atlas [max_side]   (also bakes the merged spritesheet atlas, default max_side = 8192; must not exceed the GPU's max texture size)
+//    strategy2d_cook --verify [output]    (compares the pack contents with the loose files & measures the load times of both)
+
+static const std::vector<std::string> cooked_directories = { "res/json", "res/textures" };
+
+//Packs the spritesheet textures (same order as Resources::MergeSpritesheets) & composes the atlas image on the CPU.
+static bool BakeAtlas(int max_side, std::vector<AssetPack::GeneratedAsset>& out_assets) {
+    std::vector<std::pair<std::string, std::string>> entries = Resources::AtlasSpritesheets();
+
+    struct SourceImage {
+        int width = 0, height = 0, channels = 0;
+        uint8_t* pixels = nullptr;
+    };
+    std::vector<SourceImage> images;
+    std::vector<std::string> names;
+    std::vector<glm::ivec2> sizes;
+    auto release = [&images]() {
+        for(SourceImage& img : images)
+            stbi_image_free(img.pixels);
+    };
+
+    for(auto& [name, texture_filepath] : entries) {
+        SourceImage img = {};
+        stbi_set_flip_vertically_on_load_thread(false);
+        img.pixels = stbi_load(texture_filepath.c_str(), &img.width, &img.height, &img.channels, 0);
+        if(img.pixels == nullptr) {
+            LOG_ERROR("Failed to decode spritesheet texture '{}'.", texture_filepath);
+            release();
+            return false;
+        }
+        images.push_back(img);
+        names.push_back(GetFilename(texture_filepath));
+        sizes.push_back(glm::ivec2(img.width, img.height));
+    }
+
+    AtlasLayout layout = {};
+    if(!AtlasLayout::Compute(sizes, max_side, layout)) {
+        release();
+        return false;
+    }
+    layout.inputs_hash = AtlasLayout::InputsHash(names, sizes);
+
+    //RGBA, rows in the same order as the individual textures are uploaded in
+    AssetPack::GeneratedAsset atlas = {};
+    atlas.name = Resources::BAKED_ATLAS_IMAGE;
+    atlas.type = AssetPack::EntryType::IMAGE;
+    atlas.image.width = layout.size.x;
+    atlas.image.height = layout.size.y;
+    atlas.image.channels = 4;
+    atlas.image.buffer.resize(size_t(layout.size.x) * layout.size.y * 4, 0);
+    for(size_t i = 0; i < images.size(); i++) {
+        const SourceImage& img = images[i];
+        for(int y = 0; y < img.height; y++) {
+            for(int x = 0; x < img.width; x++) {
+                const uint8_t* src = img.pixels + (size_t(y) * img.width + x) * img.channels;
+                uint8_t* dst = atlas.image.buffer.data() + ((size_t(layout.offsets[i].y) + y) * layout.size.x + layout.offsets[i].x + x) * 4;
+                for(int c = 0; c < std::min(img.channels, 4); c++)
+                    dst[c] = src[c];
+                if(img.channels < 4)
+                    dst[3] = 255;
+            }
+        }
+    }
+    release();
+
+    AssetPack::GeneratedAsset layout_asset = {};
+    layout_asset.name = Resources::BAKED_ATLAS_LAYOUT;
+    layout_asset.type = AssetPack::EntryType::JSON;
+    layout_asset.json = nlohmann::json::parse(layout.Serialize());
+
+    LOG_INFO("Baked spritesheet atlas - {} textures, {}x{}.", entries.size(), layout.size.x, layout.size.y);
+    out_assets.push_back(std::move(layout_asset));
+    out_assets.push_back(std::move(atlas));
+    return true;
+}
+
+//Loads every cooked asset both from the pack & from the loose file, checks that they match.
+static int Verify(const std::string& filepath) {
+    if(!AssetPack::Mount(filepath)) {
+        LOG_ERROR("Failed to mount the asset pack '{}'.", filepath);
+        return 1;
+    }
+
+    std::vector<std::string> jsons, images;
+    for(const std::string& dir : cooked_directories) {
+        for(const auto& item : std::filesystem::recursive_directory_iterator(dir)) {
+            std::string path = item.path().generic_string();
+            std::string ext = GetExtension(path);
+            if(ext == "json")
+                jsons.push_back(path);
+            else if(ext == "png")
+                images.push_back(path);
+        }
+    }
+
+    int mismatches = 0;
+    long long time_loose = 0, time_pack = 0;
+    Timer t = {};
+
+    for(const std::string& path : jsons) {
+        if(!AssetPack::Contains(path)) {
+            printf("    missing:  %s\n", path.c_str());
+            mismatches++;
+            continue;
+        }
+        t.Reset();
+        nlohmann::json a = nlohmann::json::parse(ReadFile(path.c_str()));
+        time_loose += t.TimeElapsed();
+        t.Reset();
+        nlohmann::json b = AssetPack::LoadJSON(path);
+        time_pack += t.TimeElapsed();
+
+        if(a != b) {
+            printf("    mismatch: %s\n", path.c_str());
+            mismatches++;
+        }
+    }
+
+    for(const std::string& path : images) {
+        t.Reset();
+        int w, h, c;
+        stbi_set_flip_vertically_on_load_thread(false);
+        uint8_t* pixels = stbi_load(path.c_str(), &w, &h, &c, 0);
+        time_loose += t.TimeElapsed();
+
+        t.Reset();
+        AssetPack::ImageData img = {};
+        bool found = AssetPack::ReadImage(path, img);
+        time_pack += t.TimeElapsed();
+
+        bool match = found && pixels != nullptr && img.width == w && img.height == h && img.channels == c && memcmp(img.pixels, pixels, size_t(w) * h * c) == 0;
+        if(!match) {
+            printf("    %s %s\n", found ? "mismatch:" : "missing: ", path.c_str());
+            mismatches++;
+        }
+        stbi_image_free(pixels);
+    }
+
+    printf("strategy2d_cook - '%s'\n", filepath.c_str());
+    printf("    assets:      %zu JSON files, %zu images (%d mismatches)\n", jsons.size(), images.size(), mismatches);
+    printf("    loose files: %8.2fms (JSON text parsing, PNG decoding)\n", time_loose * 1e-3);
+    printf("    asset pack:  %8.2fms (%.1fx faster)\n", time_pack * 1e-3, double(time_loose) / std::max(time_pack, 1LL));
+
+    AssetPack::Unmount();
+    return (mismatches == 0) ? 0 : 2;
+}
+
+int main(int argc, char** argv) {
+    std::string filepath = AssetPack::DefaultPath();
+    bool compress = true;
+    bool verify = false;
+    int atlas_max_side = 0;
+
+    for(int i = 1; i < argc; i++) {
+        if(strncmp(argv[i], "--raw", 5) == 0) {
+            compress = false;
+        }
+        else if(strncmp(argv[i], "--atlas", 7) == 0) {
+            atlas_max_side = 8192;
+            if(i+1 < argc && isdigit((unsigned char)argv[i+1][0]))
+                atlas_max_side = atoi(argv[++i]);
+        }
+        else if(strncmp(argv[i], "--verify", 8) == 0) {
+            verify = true;
+        }
+        else {
+            filepath = argv[i];
+        }
+    }
+
+    Log::Initialize();
+
+    if(verify)
+        return Verify(filepath);
+
+    std::vector<AssetPack::GeneratedAsset> generated;
+    if(atlas_max_side > 0 && !BakeAtlas(atlas_max_side, generated)) {
+        LOG_ERROR("Failed to bake the spritesheet atlas.");
+        return 1;
+    }
+
+    AssetPack::CookStats stats = {};
+    if(!AssetPack::Cook(cooked_directories, filepath, compress, &stats, generated)) {
+        LOG_ERROR("Failed to cook the assets into '{}'.", filepath);
+        return 1;
+    }
+
+    printf("strategy2d_cook - '%s'\n", filepath.c_str());
+    printf("    assets:      %d JSON files, %d images\n", stats.json_count, stats.image_count);
+    printf("    size:        %.1fMB cooked, %.1fMB stored (%s)\n", stats.raw_bytes / (1024.0 * 1024.0), stats.bytes / (1024.0 * 1024.0), compress ? "compressed" : "raw");
+    printf("    elapsed:     %.0fms\n", stats.time_ms);
+    return 0;
+}
@@ -69,7 +69,7 @@ int EditorContext::Terrain_Save(const std::string& filepath) {
 
 void EditorContext::Render() {
     level.map.Render();
-    level.objects.Render();
+    level.objects.Render(level.map);
     tools.Render();
     for(EditorComponentRef& comp : components) {
         comp->Render();
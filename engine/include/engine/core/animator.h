@@ -14,6 +14,7 @@ namespace eng {
 
     //===== AnimatorData =====
 
+    //Animations are stored in a dense array indexed by the action ID (action IDs are small & mostly contiguous).
     class AnimatorData {
     public:
         AnimatorData() = default;
@@ -22,12 +23,18 @@ namespace eng {
         std::string Name() const { return name; }
 
         SpriteGroup& GetGraphics(int action);
-        bool HasGraphics(int action) const { return anims.count(action); }
+        bool HasGraphics(int action) const { return (unsigned int)action < (unsigned int)defined.size() && defined[action]; }
+
+        //Doesn't overwrite already existing action.
         void AddAction(int actionIdx, const SpriteGroup& graphics);
 
-        int ActionCount() const { return anims.size(); }
+        //Number of defined actions.
+        int ActionCount() const { return count; }
     private:
-        std::map<int, SpriteGroup> anims;
+        std::vector<SpriteGroup> anims;
+        std::vector<uint8_t> defined;
+        int count = 0;
+        int fallback = -1;      //lowest defined action, used for invalid action IDs
         std::string name;
     };
     using AnimatorDataRef = std::shared_ptr<AnimatorData>;
@@ -43,7 +50,7 @@ namespace eng {
         void SwitchAction(int action, bool forceReset = false);
         int GetLastActionIdx() const { return lastAction; }
 
-        //Updates animation switching logic
+        //Updates animation switching logic, advances the animation by a single simulation tick.
         bool Update(int action);
 
         void Render(const glm::vec3& screen_pos, const glm::vec2& screen_size, int action, int orientation, const glm::uvec4& info = glm::uvec4(QuadType::Animator,0,0,0));
@@ -193,6 +193,7 @@ namespace eng::GUI {
         std::string text;
         bool centered;
         int highlightIdx = -1;
+        TextLayout layout;
     };
 
     //===== TextInput =====
@@ -529,6 +530,7 @@ namespace eng::GUI {
         glm::vec4 filler_clr;
         StyleRef text_style;
         glm::vec2 borders_size;
+        TextLayout layout;
     };
 
     //===== KeyValue =====
@@ -550,6 +552,7 @@ namespace eng::GUI {
         std::string text;
         glm::ivec2 highlight_idx;
         size_t sep_pos;
+        TextLayout layout;
     };
 
 
@@ -571,6 +574,7 @@ namespace eng::GUI {
         std::string text;
         glm::ivec2 highlight_range;
         Sprite sprite;
+        TextLayout layout;
     };
 
     //===== ImageButtonGrid =====
@@ -67,12 +67,9 @@ namespace eng {
         //Use keycode=-1 for any key.
         void AddKeyCallback(int keycode, KeyPressCallbackFn callback, bool replace = false, void* userData = nullptr);
 
+        //Real time (not affected by game speed), use SimClock for gameplay timing.
         static double CurrentTime();
 
-        //For delay tracking with game speed modifications applied.
-        //Returns current time + provided delay in game time.
-        static float GameTimeDelay(float delay_s);
-
         void ClampCursorPos(const glm::vec2& min, const glm::vec2& max);
 
         float CustomAnimationFrame(int seed);
@@ -14,7 +14,7 @@ namespace eng {
         glm::vec2 texCoords;
 
         uint32_t textureID = 0;
-        float alphaFromTexture = 0.f;
+        float alphaFromTexture = 0.f;       //0 = regular texture, 1 = alpha from the red channel, 2 = red channel is a signed distance field
         float paletteIdx = -1.f;
 
         glm::uvec4 info;
@@ -30,6 +30,9 @@ namespace eng {
     struct QuadVertices {
         Vertex vertices[4];
     public:
+        //Axis aligned quad (same layout as Quad::FromCorner).
+        static QuadVertices FromCorner(const glm::uvec4& info, const glm::vec3& botLeft, const glm::vec2& size, const glm::vec4& color, const TexCoords& tc);
+
         Vertex& operator[](int i);
         const Vertex& operator[](int i) const;
 
@@ -41,6 +44,9 @@ namespace eng {
 
         void SetAlphaFromTexture(bool enabled);
         void SetPaletteIdx(float idx);
+
+        //Texture's red channel is a signed distance field (font atlases), alpha is derived from it.
+        void SetDistanceField(bool enabled);
     };
 
     //======= QuadIndices =======
@@ -54,6 +60,32 @@ namespace eng {
         QuadIndices(int idx);
     };
 
+    //======= SpriteInstance =======
+
+    //Compact record of an axis aligned quad for the instanced rendering path (32B vs. 4 vertices + 5 indices).
+    //Corners & texture coords are expanded in the vertex shader. There's no room for object info (it's always 0).
+    struct SpriteInstance {
+        glm::vec3 position;             //bottom left corner
+        glm::u16vec2 size;              //half floats
+        glm::u16vec4 texRect;           //unorm16 coords of the bottom left (xy) & top right (zw) corner
+        glm::u8vec4 color;
+        uint16_t paletteIdx;            //half float, negative = no color cycling
+        uint8_t textureID = 0;
+        uint8_t flags = 0;              //bit 0 = alphaFromTexture
+    public:
+        //Same layout as QuadVertices::FromCorner (texture coords are expected to be axis aligned).
+        static SpriteInstance FromCorner(const glm::vec3& botLeft, const glm::vec2& size, const glm::vec4& color, const TexCoords& tc);
+
+        //Expands the instance into regular quad vertices (when the instanced path isn't available).
+        QuadVertices Vertices() const;
+
+        void UpdateTextureIdx(uint32_t texIdx);
+
+        void SetAlphaFromTexture(bool enabled);
+        void SetPaletteIdx(float idx);
+    };
+    static_assert(sizeof(SpriteInstance) == 32, "SpriteInstance doesn't match the instance attributes layout.");
+
     //======= QuadType =======
 
     //Classifies a broader group of quad's purpose (describes what it's function on the screen is).
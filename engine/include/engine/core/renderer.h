@@ -6,16 +6,81 @@
 
 namespace eng {
 
+    //===== QuadMesh =====
+
+    //Static quads with their own GPU buffers (e.g. terrain chunk) - uploaded once & redrawn without going through the batch.
+    //Positions are transformed by the shader's transform uniform. Quads have to reference their texture through slot 1 (see Renderer::RenderMesh).
+    class QuadMesh {
+    public:
+        static constexpr int TEXTURE_SLOT = 1;
+    public:
+        QuadMesh() = default;
+        ~QuadMesh();
+
+        //copy disabled
+        QuadMesh(const QuadMesh&) = delete;
+        QuadMesh& operator=(const QuadMesh&) = delete;
+
+        //move enabled
+        QuadMesh(QuadMesh&&) noexcept;
+        QuadMesh& operator=(QuadMesh&&) noexcept;
+
+        //Replaces the mesh contents (reallocates the buffers only when they grow).
+        //With the null & recording backends, contents are only kept on the CPU (no GL calls).
+        void Upload(const std::vector<QuadVertices>& quads);
+
+        //Issues the draw call, expects the shader & textures to be already bound.
+        void Draw() const;
+
+        int QuadCount() const { return count; }
+
+        //Mesh contents, as uploaded with a non-GL backend active (empty otherwise).
+        const std::vector<QuadVertices>& CPUQuads() const { return cpu_quads; }
+    private:
+        void Release() noexcept;
+        void Move(QuadMesh&&) noexcept;
+    private:
+        GLuint vao = 0;
+        GLuint vbo = 0;
+        GLuint ebo = 0;
+        int count = 0;
+        int capacity = 0;
+        std::vector<QuadVertices> cpu_quads;
+    };
+
     //Manages quad batch rendering to the screen.
     namespace Renderer {
 
-        //Stats for the ongoing (or last) rendering session. Resets with Begin() calls.
+        //Stats for the ongoing (or last) rendering session. Resets with StatsReset() calls (game resets them every frame).
         struct RenderStats {
             int drawCalls = 0;
             int totalQuads = 0;
             
             int wastedQuads = 0;        //unused capacity of the internal quad buffer (ignoring the last call; high number = too many textures)
             int numTextures = 0;
+            int bytesUploaded = 0;      //vertex & instance data written into the streaming buffers (indices are static)
+            int textureFlushes = 0;     //draw calls triggered by running out of texture slots
+            int deferredQuads = 0;      //quads & sprites that went through the deferred mode sorting
+            int ringStalls = 0;         //flushes, that had to wait for the GPU to finish reading the next streaming buffer region
+        };
+
+        //Where the submitted quads end up. Null & Recording backends don't make any GL calls (no context needed), headless build always uses one of them.
+        namespace Backend {
+            enum { GL = 0, Null, Recording };
+        }//namespace Backend
+
+        //===== Recording =====
+
+        //Output of the recording backend - batches as they'd be drawn (sprites are expanded into quads). Cleared with every Begin() call.
+        struct Recording {
+            std::vector<QuadVertices> quads;    //vertex texture IDs are the slots within the batch
+            std::vector<GLuint> textures;       //texture handle for each quad (always 0 in headless build, textures have no GPU storage there)
+            std::vector<int> batches;           //quad count of each draw call (meshes included, with the transform applied)
+        public:
+            void Clear();
+
+            //FNV-1a over the recorded data, for regression checks of the render output (compares exact float values - same build & platform only).
+            uint64_t Hash() const;
         };
 
         //Fetches renderer stats structure of ongoing/last rendering session.
@@ -23,13 +88,20 @@ namespace eng {
 
         void StatsReset();
 
+        //Texture slots used by the batch - driver's limit, capped by the shaders' MAX_TEXTURES.
         int TextureSlotsCount();
         int MaxTextureSize();
 
+        int ActiveBackend();
+
+        //Quads captured by the recording backend in the ongoing/last session.
+        const Recording& Recorded();
+
         //======================
 
-        //Initialization call. Can be omitted, since initialization is checked at each session start.
-        void Initialize();
+        //Initialization call. Can be omitted, since initialization is checked at each session start (GL backend is used then).
+        //Backend can only be changed by calling Release() first. Headless build replaces GL with the null backend.
+        void Initialize(int backend = Backend::GL);
 
         //Cleanup call, to release all the internally allocated resources.
         void Release();
@@ -43,6 +115,17 @@ namespace eng {
         void Begin(const ShaderRef& shader, const FramebufferRef& fbo = nullptr, bool clearFBO = true);
         void Begin(const ShaderRef& shader, bool clearFBO, const FramebufferRef& fbo = nullptr);
 
+        //Enables the instanced sprite path for the ongoing session (until End()). Shader has to expand SpriteInstance attributes
+        //and share the fragment stage with the session's shader. Without it, sprites are submitted as regular quads.
+        //Headless build doesn't require a shader (submission only).
+        void UseSpriteShader(const ShaderRef& shader);
+
+        //Enables deferred submission for the ongoing session (until End()). Quads & sprites are collected until the next Flush(),
+        //then sorted back to front by depth & grouped by texture within the same depth (fewer flushes due to texture slots).
+        //Depth testing keeps the result the same, except for overlapping quads of different textures at exactly the same depth.
+        //Meshes aren't deferred (RenderMesh() submits everything collected before it).
+        void DeferredMode(bool enabled);
+
         //Ends the rendering session, triggers flush.
         void End();
 
@@ -54,6 +137,18 @@ namespace eng {
         //Queue a quad for rendering within active rendering session.
         void RenderQuad(const Quad& quad);
 
+        //Queue a quad, that references its texture only by the GL handle (texture's own or the atlas', if it's merged; 0 = no texture).
+        //Vertices have to contain the final texture coordinates. Cheaper than going through Quad (no TextureRef copies).
+        void RenderQuad(const QuadVertices& vertices, GLuint texture);
+
+        //Queue an axis aligned sprite (single instance record instead of a quad, if the session uses the instanced path).
+        //Switching between sprites & quads triggers a flush, in order to keep the submission order.
+        void RenderSprite(const SpriteInstance& sprite, GLuint texture);
+
+        //Draws a static mesh (in its own draw call). Vertex positions are transformed as (pos.xy * transform.xy + transform.zw).
+        //Queued quads are flushed first, texture is bound to QuadMesh::TEXTURE_SLOT.
+        void RenderMesh(const QuadMesh& mesh, GLuint texture, const glm::vec4& transform);
+
         //Enables or disables wireframe rendering mode.
         void WireframeMode(bool enabled);
 
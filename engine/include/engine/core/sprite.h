@@ -52,6 +52,9 @@ namespace eng {
         //Alternate render call with additional options (modify color/use texture as alpha).
         void RenderAlt(const glm::uvec4& info, const glm::vec4& color, bool noTexture, const glm::vec3& screen_pos, const glm::vec2& screen_size, int idxY = 0, int idxX = 0) const;
 
+        //Texture coordinates of given frame, the same ones that Render() uses (for building static meshes).
+        TexCoords FrameTexCoords(int idxY, int idxX) const;
+
         //Update texture coordinates. Call when spritesheet or sprite's offset/size changes.
         void RecomputeTexCoords();
 
@@ -71,6 +74,22 @@ namespace eng {
         void DBG_GUI();
         TextureRef GetTexture() const { return texture; }
     private:
+        //Texture coordinates of all the frames, baked in advance (shared between copies of the sprite).
+        struct FrameTable {
+            int revision = -1;              //texture revision the table was baked for
+            std::vector<TexCoords> grid;    //[idxY * line_length + idxX]
+            std::vector<TexCoords> anim;    //[frameIdx * ANIM_ORIENTATIONS + spriteIdx], flip already applied
+        };
+        static constexpr int ANIM_ORIENTATIONS = 9;
+
+        //Returns the frame table, rebakes it if the texture got relocated (merging) since the last bake.
+        const FrameTable& Frames() const;
+        void BakeFrames(FrameTable& table) const;
+
+        //Computes texture coordinates of given frame (slow path, used for baking).
+        TexCoords ComputeFrameTexCoords(int idxY, int idxX) const;
+        TexCoords ComputeAnimTexCoords(int frameIdx, int spriteIdx) const;
+
         //To compute texture coordinates of selected frame of the sprite.
         TexCoords TexOffset(const glm::ivec2& offset) const;
         TexCoords TexOffset(const glm::ivec2& offset, bool flip) const;
@@ -78,6 +97,7 @@ namespace eng {
         SpriteData data;
         TextureRef texture = nullptr;
         TexCoords texCoords;
+        std::shared_ptr<FrameTable> frames = nullptr;
     };
     using SpriteRef = std::shared_ptr<Sprite>;
 
@@ -4,21 +4,30 @@
 #include "engine/utils/mathdefs.h"
 
 #include <memory>
+#include <string>
+#include <vector>
 
 namespace eng {
 
+    //Glyph metrics at the font's current height (in pixels). Size & bearing include the distance field's padding.
     struct CharInfo {
-        glm::ivec2 size;
-        glm::ivec2 bearing;		//aka. offsets
+        glm::vec2 size;
+        glm::vec2 bearing;		//aka. offsets
         glm::ivec2 advance;
 
-        //character's x-offset within the atlas texture
+        //character's x-offset within the atlas texture & size of its rectangle (in atlas pixels)
         float textureOffset;
+        glm::vec2 textureSize;
     };
 
     class Font;
     using FontRef = std::shared_ptr<Font>;
 
+    struct FontAtlas;
+    using FontAtlasRef = std::shared_ptr<FontAtlas>;
+
+    //Font, that's rasterized once into a signed distance field atlas (at a fixed base height) & scaled in the shader.
+    //Atlas is cached on disk and shared between all the fonts created from the same file - resizing only rescales the glyph metrics.
     class Font {
     public:
         Font(const std::string& filepath, int fontHeight = 48);
@@ -68,11 +77,16 @@ namespace eng {
         void RenderTextCentered(const char* text, const glm::vec2 center, float scale, const glm::vec4& color1, const glm::vec4& color2, int letterIdx, const glm::ivec2& pxOffset, float zIndex = -0.9f, const glm::uvec4& info = glm::uvec4(0));
         void RenderTextCentered(const char* text, const glm::vec2 center, float scale, const glm::vec4& color1, const glm::vec4& color2, const glm::ivec2& highlightRange, const glm::ivec2& pxOffset, float zIndex = -0.9f, const glm::uvec4& info = glm::uvec4(0));
 
+        //Only rescales the glyph metrics, atlas stays the same.
         void Resize(int newHeight);
 
+        //Changes whenever the glyph metrics change (resize) - for cached text layouts.
+        int Revision() const { return revision; }
+
         TextureRef GetTexture() { return texture; }
     private:
         void Load(const std::string& filepath);
+        void Rescale();
         
         void Release() noexcept;
         void Move(Font&&) noexcept;
@@ -81,12 +95,69 @@ namespace eng {
         std::string filepath;
 
         int fontHeight;
-        CharInfo chars[128];
+        CharInfo chars[128] = {};
+        FontAtlasRef atlas = nullptr;
         TextureRef texture = nullptr;
 
         int rowHeight;
+        int revision = 0;
 
         glm::vec2 atlasSize_inv;
     };
 
+    //===== TextLayout =====
+
+    //Alignment modes, matching the Font::RenderText* variants.
+    namespace TextAlign {
+        enum {
+            TopLeft = 0,    //RenderText
+            Centered,       //RenderTextCentered
+            Left,           //RenderTextAlignLeft (still centered vertically)
+            KeyValue,       //RenderTextKeyValue (anchor at the separator)
+        };
+    }//namespace TextAlign
+
+    //Cached glyph quads of a single string (positions relative to the anchor point).
+    //Layout is only recomputed when the text, font, scale or window size changes. Rendering then only offsets the quads & assigns colors.
+    class TextLayout {
+    public:
+        TextLayout() = default;
+
+        //Recomputes the layout if any of the parameters changed. sep_pos = key length in KeyValue mode.
+        void Update(const FontRef& font, const std::string& text, float scale, int align, size_t sep_pos = 0);
+
+        void Render(const glm::vec2& anchor, const glm::vec4& color, float zIndex = -0.9f, const glm::uvec4& info = glm::uvec4(0)) const;
+
+        //Glyphs in the highlight range use color2. In KeyValue mode, the range indexes into the value part.
+        void Render(const glm::vec2& anchor, const glm::vec4& color1, const glm::vec4& color2, const glm::ivec2& highlightRange, float zIndex = -0.9f, const glm::uvec4& info = glm::uvec4(0)) const;
+
+        //Number of layout recomputations (across all the layouts).
+        static int RebuildCount();
+
+        //Debug toggle - when disabled, layouts are recomputed on every Update() (for measurements).
+        static void SetCaching(bool enabled);
+        static bool Caching();
+    private:
+        void Rebuild();
+    private:
+        struct Glyph {
+            glm::vec2 botLeft;
+            glm::vec2 size;
+            TexCoords tc;
+            int idx;        //index used for highlighting (-1 = never highlighted)
+        };
+
+        FontRef font = nullptr;
+        std::string text;
+        float scale = 0.f;
+        int align = TextAlign::TopLeft;
+        size_t sep_pos = 0;
+
+        glm::ivec2 windowSize = glm::ivec2(0);
+        int fontRevision = -1;
+        bool valid = false;
+
+        std::vector<Glyph> glyphs;
+    };
+
 }//namespace eng
@@ -2,6 +2,8 @@
 
 #include <memory>
 #include <string>
+#include <vector>
+#include <cstdint>
 
 #include "engine/utils/mathdefs.h"
 #include "engine/utils/setup.h"
@@ -13,6 +15,8 @@ namespace eng {
     class Texture;
     using TextureRef = std::shared_ptr<Texture>;
 
+    class Image;
+
     //Texture construction options.
     namespace TextureFlags {
         enum {
@@ -69,6 +73,32 @@ namespace eng {
         TexCoords& operator +=(const glm::vec2& offset);
     };
 
+    //======= AtlasLayout =======
+
+    //Placement of the merged textures within an atlas (result of the rectangle packing, offsets are in the merge order).
+    //Packing is deterministic for given inputs, so the layouts are cached on disk & reused on the next launch.
+    struct AtlasLayout {
+        uint64_t inputs_hash = 0;       //merged textures' names & sizes (see InputsHash)
+        int max_side = 0;               //max texture size, that the layout was computed for
+        glm::ivec2 size = glm::ivec2(0);
+        std::vector<glm::ivec2> offsets;
+    public:
+        static uint64_t InputsHash(const std::vector<std::string>& names, const std::vector<glm::ivec2>& sizes);
+
+        //Runs the rectangle packing. Returns false when the textures don't fit into a single atlas.
+        static bool Compute(const std::vector<glm::ivec2>& sizes, int max_side, AtlasLayout& out_layout);
+
+        //Layout cache lookup (by inputs hash & max texture size) & update.
+        static bool LoadCached(uint64_t inputs_hash, int max_side, AtlasLayout& out_layout);
+        bool StoreCached() const;
+
+        static std::string CachePath();
+
+        //JSON text form (same as the cache entries) - used for the layouts baked into the asset pack.
+        std::string Serialize() const;
+        static bool Deserialize(const std::string& text, AtlasLayout& out_layout);
+    };
+
     //======== Texture ========
 
     //Wrapper for the underlaying texture resource on the GPU.
@@ -93,12 +123,19 @@ namespace eng {
         Texture(const std::string& filepath, int flags = 0, const TextureParams& params = {});
         Texture(const std::string& filepath, const TextureParams& params, int flags = 0);
 
+        //Constructor for textures from already decoded image (decoding can run on a worker thread, only the upload has to be on the main thread).
+        //Filepath only serves as a name, from the flags only LOAD_SRGB matters (image is uploaded as is).
+        Texture(const std::string& filepath, const Image& image, int flags = 0, const TextureParams& params = {});
+
         //Constructor for empty textures (8-bit color channels). TextureParams fields 'dtype' & 'format' are ignored.
         Texture(const TextureParams& params, const std::string& name = "custom");
 
         //Constructor for textures with custom data type and specific data (data can be nullptr). All TextureParams fields matter.
     	Texture(const TextureParams& params, void* data, const std::string& name = "custom");
 
+        //Constructor for textures without any GPU storage of their own - only usable once merged into a pre-baked atlas (see MergeTextures).
+        Texture(const std::string& filepath, const glm::ivec2& size);
+
         Texture() = default;
         ~Texture();
 
@@ -128,12 +165,18 @@ namespace eng {
 
         GLuint Handle() const { return handle; }
 
+        //Changes whenever the texture's location changes (merging, moves) - for cached texture coordinates.
+        int Revision() const { return revision; }
+
         //Returns TexCoords for given rectangle in the texture. Takes into account texture merging.
         TexCoords GetTexCoords() const;
         TexCoords GetTexCoords(const glm::ivec2& offset, const glm::ivec2& size) const;
         TexCoords GetTexCoords(const glm::ivec2& offset, const glm::ivec2& size, bool flip) const;
 
         static void MergeTextures(std::vector<TextureRef>& texturesToMerge, GLenum filteringMode, bool rgba = true);
+
+        //Merge with a pre-baked atlas - uploads the atlas (RGBA pixels) & points the textures to their location in it (no copies).
+        static void MergeTextures(std::vector<TextureRef>& texturesToMerge, const AtlasLayout& layout, const uint8_t* pixels, GLenum filteringMode);
         static int HandleCount() { return TextureHandle::counter; }
 
         void DBG_GUI() const;
@@ -144,6 +187,9 @@ namespace eng {
         //Loads texture from provided file.
         bool LoadFromFile(const std::string& filepath, int flags);
 
+        //Creates the GPU texture from 8-bit pixel data & resolves the format fields in params (width & height have to be set).
+        void Upload(const uint8_t* pixels, int channels, bool srgb);
+
         //To update handle and offset into the texture after texture merging.
         void Merge_UpdateData(TextureHandleRef handle, const glm::ivec2& offset, const glm::vec2& size);
 
@@ -157,6 +203,7 @@ namespace eng {
         GLuint handle = 0;     //keeping a copy, to avoid the pointer dereference
         glm::ivec2 merge_offset;
         glm::vec2 merge_size;
+        int revision = 0;
     };
 
     //===== Image =====
@@ -181,6 +228,12 @@ namespace eng {
         Image operator()(int y, int x, int h, int w);
 
         uint8_t* ptr() { return data; }
+        const uint8_t* ptr() const { return data; }
+
+        int Width() const { return width; }
+        int Height() const { return height; }
+        int Channels() const { return channels; }
+        bool Empty() const { return data == nullptr; }
 
         bool Write(const std::string& filepath);
     private:
@@ -192,10 +245,10 @@ namespace eng {
         bool LoadFromFile(const std::string& filepath, int flags);
         bool WriteToFile(const std::string& filepath);
     private:
-        uint8_t* data;
-        int channels;
-        int height;
-        int width;
+        uint8_t* data = nullptr;
+        int channels = 0;
+        int height = 0;
+        int width = 0;
 
         std::string name;
     };
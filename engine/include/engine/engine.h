@@ -33,8 +33,12 @@
 #include "game/object_data.h"
 #include "game/command.h"
 #include "game/config.h"
+#include "game/sim_clock.h"
+#include "game/autosave.h"
 
 #include "utils/generator.h"
 #include "utils/ring_buffer.hpp"
 #include "utils/pool.hpp"
 #include "utils/randomness.h"
+#include "utils/jobs.h"
+#include "utils/asset_pack.h"
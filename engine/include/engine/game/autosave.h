@@ -0,0 +1,81 @@
+#pragma once
+
+#include <string>
+#include <thread>
+#include <mutex>
+#include <atomic>
+
+#include "engine/game/sim_clock.h"
+
+namespace eng {
+
+    class Level;
+    struct LevelSnapshot;
+
+    //===== AutosaveStats =====
+
+    struct AutosaveStats {
+        float snapshot_ms = 0.f;            //main thread stall (level snapshot) during the last autosave
+        float snapshot_ms_max = 0.f;
+        float save_ms = 0.f;                //background serialization, compression & write of the last autosave
+        long long bytes = 0;
+        int count = 0;
+        int failed = 0;
+    };
+
+    //===== Autosave =====
+
+    //Periodically stores the level state without stalling the game. Main thread only takes a snapshot of the level (between ticks),
+    //serialization, compression & file write run on a dedicated background thread. File is written into a temporary file first
+    //& then renamed, so that a crash mid-write never leaves a corrupted autosave behind.
+    //Dedicated thread is used instead of the job system - job system threads participate in the simulation update & a long running
+    //save job would stall whoever picks it up.
+    class Autosave {
+    public:
+        Autosave() = default;
+        ~Autosave();
+
+        //copy disabled
+        Autosave(const Autosave&) = delete;
+        Autosave& operator=(const Autosave&) = delete;
+
+        //move disabled (background thread references the object)
+        Autosave(Autosave&&) noexcept = delete;
+        Autosave& operator=(Autosave&&) noexcept = delete;
+
+        //Triggers an autosave once the interval elapses. Call after Level::Update() (at the tick boundary).
+        void Update(Level& level, const std::string& filepath = "");
+
+        //Snapshots the level & starts the background save. Returns false if the previous save is still running.
+        bool Trigger(Level& level, const std::string& filepath = "");
+
+        bool InProgress() const { return running; }
+
+        //Blocks until the background save finishes.
+        void Wait();
+
+        //Waits for the running save & restarts the interval (use when a level is loaded).
+        void Reset();
+
+        //Interval in seconds of game time. Negative value = use the value from the config (Config::AutosaveInterval()).
+        void SetInterval(float seconds) { interval = seconds; }
+
+        AutosaveStats Stats();
+
+        static std::string DefaultPath();
+
+        void DBG_GUI();
+    private:
+        void BackgroundSave(LevelSnapshot&& snapshot, const std::string& filepath);
+    private:
+        std::thread worker;
+        std::atomic<bool> running = false;
+
+        std::mutex stats_mutex;
+        AutosaveStats stats = {};
+
+        float interval = -1.f;
+        tick_t last_tick = 0;
+    };
+
+}//namespace eng
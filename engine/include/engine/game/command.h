@@ -2,6 +2,7 @@
 
 #include "engine/utils/mathdefs.h"
 #include "engine/game/object_data.h"
+#include "engine/game/sim_clock.h"
 
 #include <string>
 
@@ -56,6 +57,7 @@ namespace eng {
             bool c = false;
             float t = 0.f;
             int count = 0;
+            tick_t tick = 0;        //action cooldown (simulation tick, when it runs out)
         public:
             void Reset();
             void DBG_Print();
@@ -87,6 +89,32 @@ namespace eng {
         Action::Entry Export() const;
     };
 
+    //===== NavQuery =====
+
+    namespace NavQueryType { enum { NONE = 0, TARGET_SEARCH, NEXT_POSITION, NEXT_POSITION_RANGE }; }
+
+    //Map query (target search or pathfinding), precomputed during the parallel phase of the object update.
+    //Command handlers use the result only if it was computed during the same tick & with matching parameters, otherwise they query the map directly.
+    struct NavQuery {
+        int type = NavQueryType::NONE;
+        tick_t tick = -1;
+        glm::ivec2 unit_pos = glm::ivec2(-1);   //unit's position at the time of the query
+        glm::ivec2 m = glm::ivec2(-1);          //target position (or min corner of the target block)
+        glm::ivec2 M = glm::ivec2(-1);          //max corner of the target block
+        int distance = 0;                       //search range (or range to get within)
+
+        bool found = false;
+        ObjectID target_id = ObjectID();
+        glm::ivec2 result = glm::ivec2(-1);     //next position or target position
+    public:
+        //Query runs are read-only (map isn't modified) & can run in parallel for different units.
+        static NavQuery SearchForTarget(const Unit& src, Level& level, int range);
+        static NavQuery NextPosition(const Unit& src, Level& level, const glm::ivec2& target_pos);
+        static NavQuery NextPosition_Range(const Unit& src, Level& level, const glm::ivec2& m, const glm::ivec2& M, int distance);
+
+        bool Matches(int type, const glm::ivec2& unit_pos, const glm::ivec2& m, const glm::ivec2& M, int distance) const;
+    };
+
     //===== Command =====
 
     typedef void(*CommandHandler)(Unit& source, Level& level, Command& cmd, Action& action);
@@ -147,6 +175,10 @@ namespace eng {
 
         void Update(Unit& src, Level& level);
 
+        //Precomputes the map query, that the command is going to make during this tick's update (if it can be predicted).
+        //Doesn't modify the map or other objects, so it can run in parallel for different units.
+        void Plan(const Unit& src, Level& level);
+
         Command::Entry Export() const;
 
         int Type() const { return type; }
@@ -169,7 +201,9 @@ namespace eng {
         int flag;
 
         glm::ivec2 v2;
-        float t;
+        tick_t t = 0;
+
+        NavQuery query;
     };
 
     //===== BuildingAction =====
@@ -199,6 +233,7 @@ namespace eng {
             int i = 0;
             bool flag = false;
             ObjectID target_id = ObjectID();
+            tick_t tick = 0;        //attack timer (simulation tick of the last attack)
         };
         struct Entry {
             int type;
@@ -37,10 +37,14 @@ namespace eng::Config {
     float Map_KeySpeed();
     bool FogOfWar();
 
+    //Interval between autosaves in seconds of game time (0 = autosave disabled).
+    float AutosaveInterval();
+
     bool CameraPanning();
 
     void UpdateSpeeds(float game, float mouse, float keys, bool save_changes = true);
     void UpdatePreferences(bool fog, bool save_changes = true);
+    void UpdateAutosaveInterval(float seconds, bool save_changes = true);
 
     void UpdateCameraPanning(bool enabled);
     void ToggleCameraPanning();
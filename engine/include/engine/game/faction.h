@@ -155,8 +155,12 @@ namespace eng {
         void UpdateKillCounts(const glm::ivec2& killCounts);
         EndgameFactionData GetEndgameStats() const;
 
+        //Simulation update, invoked once per simulation tick.
         virtual void Update(Level& level) {}
 
+        //Invoked once per rendered frame (outside of simulation ticks), meant for input processing & GUI.
+        virtual void FrameUpdate(Level& level) {}
+
         //Only for player controller, signals that GUI panel needs to be updated.
         virtual void SignalGUIUpdate() {}
         virtual void SignalGUIUpdate(const FactionObject& obj) {}
@@ -288,6 +292,7 @@ namespace eng {
         size_t size() const { return factions.size(); }
 
         void Update(Level& level);
+        void FrameUpdate(Level& level);
 
         bool IsInitialized() const { return initialized; }
 
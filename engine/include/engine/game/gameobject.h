@@ -24,6 +24,7 @@ namespace eng {
     
     class GameObject {
         friend class ObjectPool;
+        friend class Replay;
     public:
         struct Entry;
     public:
@@ -327,6 +328,9 @@ namespace eng {
         virtual void Render() override;
         virtual bool Update() override;
 
+        //Precomputes map queries for this tick's update (read-only, can run in parallel for different units).
+        void PlanUpdate();
+
         Unit::Entry Export() const;
         void RepairIDs(const idMappingType& ids);
 
@@ -427,6 +431,7 @@ namespace eng {
         Action action = Action();
 
         glm::vec2 move_offset = glm::vec2(0.f);
+        glm::vec2 prev_position = glm::vec2(-1e3f);       //position (incl. move_offset) from the previous tick, for rendering interpolation
         bool animation_ended = false;
 
         int carry_state = WorkerCarryState::NONE;        //worker load indicator
@@ -635,6 +640,7 @@ namespace eng {
         LiveData live_data;
         glm::vec2 real_position;
         glm::vec2 real_size;
+        glm::ivec3 anim_owner = glm::ivec3(-1);     //corpses - unit, whose death animation is playing (its index in the corpse animator isn't stored, it depends on the parsed prefabs)
     };
 
     //=============================================
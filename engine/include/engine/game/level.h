@@ -1,8 +1,12 @@
 #pragma once
 
 #include <vector>
+#include <memory>
+#include <atomic>
 
 #include "engine/utils/mathdefs.h"
+#include "engine/utils/randomness.h"
+#include "engine/utils/jobs.h"
 
 #include "engine/game/gameobject.h"
 #include "engine/game/faction.h"
@@ -10,6 +14,8 @@
 #include "engine/game/object_pool.h"
 #include "engine/game/player_controller.h"
 #include "engine/game/scenario.h"
+#include "engine/game/sim_clock.h"
+#include "engine/game/replay.h"
 
 namespace eng {
 
@@ -57,12 +63,15 @@ namespace eng {
         int preferred_opponents = 1;
         std::vector<glm::ivec2> startingLocations;
         EndConditions end_conditions;
+        tick_t tick = 0;
+        Random::Generator rng;      //simulation random stream state
     public:
         void DBG_GUI();
     };
 
     //===== Savefile =====
 
+    //Level state in its serializable form. Stored either as a binary snapshot (fast, used for in-game saves) or as JSON (human-readable, used for maps & import/export).
     struct Savefile {
         Mapfile map;
         LevelInfo info;
@@ -71,24 +80,82 @@ namespace eng {
         std::vector<int> scenario;
     public:
         Savefile() = default;
+        //Loads the savefile, format is detected from the file header.
         Savefile(const std::string& filepath);
 
+        //Picks the format based on the file extension (.json = JSON, anything else = binary snapshot).
         void Save(const std::string& filepath);
+
+        void SaveJSON(const std::string& filepath);
+        void SaveBinary(const std::string& filepath, bool compress = true) const;
+
+        static bool IsBinary(const uint8_t* data, size_t size);
+
+        //Toggles the streaming (SAX) JSON parser - map tiles & object entries are filled in as the tokens arrive, without building the whole document.
+        //When disabled, the file is parsed into a DOM first (slower, roughly 3x the peak memory).
+        static bool StreamingParserEnabled();
+        static void EnableStreamingParser(bool enabled);
+    private:
+        void LoadJSON(const std::string& text);
+        void LoadJSON_Streaming(const std::string& text);
+        void LoadBinary(const uint8_t* data, size_t size);
+
+        //Files from before the simulation clock (no tick in the level info) store timers in seconds of the application clock.
+        void ConvertLegacyTimers();
+    };
+
+    //===== LevelSnapshot =====
+
+    //Level state captured at a tick boundary, for saving on a background thread. Map tiles are shared copy-on-write chunks,
+    //objects are stored as their POD entries. Snapshot doesn't reference the level, so it can be serialized while the game runs.
+    struct LevelSnapshot {
+        MapSnapshot map;
+        LevelInfo info;
+        FactionsFile factions;
+        ObjectsFile objects;
+        std::vector<int> scenario;
+        float camera_zoom = 1.f;
+        glm::vec2 camera_position = glm::vec2(0.f);
+    public:
+        //Stores the snapshot in the binary savefile format (same output as Savefile::SaveBinary()).
+        void SaveBinary(const std::string& filepath, bool compress = true) const;
+    };
+
+    //===== TickStats =====
+
+    //Time spent in individual simulation subsystems, accumulated over multiple ticks (in microseconds).
+    struct TickStats {
+        int ticks = 0;
+        long long scenario = 0;
+        long long map = 0;          //untouchability & runes
+        long long factions = 0;
+        long long objects = 0;
+        long long conditions = 0;
+    public:
+        long long Total() const { return scenario + map + factions + objects + conditions; }
     };
 
     //===== Level =====
 
     class Level {
+        friend class LevelLoader;
     public:
         Level();
         Level(const glm::vec2& mapSize, const TilesetRef& tileset);
         Level(Savefile& savefile);
 
+        //Runs simulation ticks (based on the elapsed frame time) & per-frame faction updates (input handling, GUI).
         void Update();
         void Render();
 
+        //Advances the simulation by a single fixed-length tick.
+        void Tick();
+
         bool Save(const std::string& filepath);
         static int Load(const std::string& filepath, Level& out_level);
+
+        //Cheap copy of the level state (for background saving). Has to be called between ticks.
+        LevelSnapshot Snapshot();
         void Release();
 
         glm::ivec2 MapSize() const { return map.Size(); }
@@ -97,10 +164,15 @@ namespace eng {
         void CustomGame_InitEndConditions();
 
         void EndConditionsEnabled(bool enabled);
+
+        //Main thread part of the initialization for levels constructed on a loading thread (see LevelLoader).
+        //Creates the GL resources (occlusion sprite, player's GUI) & restores the global state (simulation clock, random stream).
+        void Finalize();
     private:
         Savefile Export();
         void LevelPtrUpdate();
         void ConditionsUpdate();
+        void RestoreGlobalState();
     public:
         //dont change the order !!!
         Map map;
@@ -110,7 +182,63 @@ namespace eng {
         ScenarioControllerRef scenario = nullptr;
 
         bool initialized = false;
-        float lastConditionsUpdate = 0.f;
+        tick_t lastConditionsUpdate = 0;
+
+        TickStats tickStats = {};
+        Replay replay;
+    };
+
+    //===== LevelLoader =====
+
+    namespace LevelLoadStage { enum { IDLE, PARSING, RESOURCES, CONSTRUCTING, DONE, FAILED }; }
+
+    //Loads a level without blocking the main thread. Savefile parsing & level construction run as jobs on the worker threads,
+    //tileset (texture upload) is loaded by a main thread job in between. The level is constructed without any GL resources,
+    //these are created in Finalize(), when the loaded level is swapped in (on the main thread).
+    class LevelLoader {
+    public:
+        LevelLoader() = default;
+        ~LevelLoader();
+
+        //copy/move disabled (jobs reference the object)
+        LevelLoader(const LevelLoader&) = delete;
+        LevelLoader& operator=(const LevelLoader&) = delete;
+
+        LevelLoader(LevelLoader&&) noexcept = delete;
+        LevelLoader& operator=(LevelLoader&&) noexcept = delete;
+
+        //Starts loading the level from given file. Returns false if the previous load is still in progress.
+        bool Start(const std::string& filepath);
+
+        //True once the background part is finished (successfully or not).
+        bool Done() const { return counter.Done(); }
+        bool InProgress() const { return stage != LevelLoadStage::IDLE; }
+
+        int Stage() const { return stage; }
+        //Loading progress estimate in range [0,1] (based on the current stage).
+        float Progress() const;
+
+        //Moves the loaded level into out_level & runs its main thread initialization. Call once Done() returns true.
+        //Returns the same codes as Level::Load() (0 = success).
+        int Finalize(Level& out_level);
+
+        //Blocks until the background part finishes.
+        void Wait();
+    private:
+        void Parse();
+        void LoadResources();
+        void Construct();
+    private:
+        Jobs::Counter counter;
+        std::atomic<int> stage = LevelLoadStage::IDLE;
+        int result = 0;
+
+        std::string filepath;
+        Savefile savefile;
+        std::unique_ptr<Level> level = nullptr;
+
+        long long parse_us = 0;
+        long long construct_us = 0;
     };
 
 }//namespace eng
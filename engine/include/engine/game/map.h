@@ -7,6 +7,7 @@
 
 #include "engine/utils/mathdefs.h"
 #include "engine/core/sprite.h"
+#include "engine/core/renderer.h"
 
 #include "engine/game/object_data.h"
 
@@ -70,7 +71,13 @@ namespace eng {
         int taken = 0;                  //tracks if the tile is taken (bitmap - NavigationBit)
         int permanent = 0;              //defines if the object occupying it intends to stay (bitmap, false -> just moving through)
         bool building = false;          //additional check, to ensure that units can't pass trough buildings
+    public:
+        void Claim(int navType, bool permanently, bool is_building);
+        void Unclaim(int navType, bool is_building);
+    };
 
+    //Temporary per-tile variables, used during the pathfinding computations.
+    struct NavScratch {
         bool pathtile = false;      //purely for debugging
         float d = HUGE_VALF;
         bool visited = false;
@@ -78,9 +85,6 @@ namespace eng {
     public:
         //Clears the temporary variables for next pathfinding.
         void Cleanup();
-
-        void Claim(int navType, bool permanently, bool is_building);
-        void Unclaim(int navType, bool is_building);
     };
 
     //Used to store intermediate info during the pathfinding computations.
@@ -98,6 +102,27 @@ namespace eng {
 
     using pathfindingContainer = std::priority_queue<NavEntry, std::vector<NavEntry>, std::greater<NavEntry>>;
 
+    //===== NavGrid =====
+
+    //Pathfinding workspace - temporary per-tile variables & the open set.
+    //Each thread has its own workspace, which allows pathfinding queries to run in parallel (as long as the map isn't being modified).
+    class NavGrid {
+    public:
+        //Returns the calling thread's workspace, resized to match given map size.
+        static NavGrid& Get(const glm::ivec2& size);
+
+        //Clears the temporary variables for next pathfinding.
+        void Cleanup();
+
+        NavScratch& operator()(int y, int x) { return data[y*(size.x+1)+x]; }
+        NavScratch& operator()(const glm::ivec2& idx) { return operator()(idx.y, idx.x); }
+    public:
+        pathfindingContainer open;
+    private:
+        glm::ivec2 size = glm::ivec2(0);
+        std::vector<NavScratch> data;
+    };
+
     struct ObjectInfo {
         ObjectID id = {};                   //id of an object located on this tile (invalid means empty)
         int factionId = -1;
@@ -141,7 +166,7 @@ namespace eng {
 
         //Returns true if a unit with given navigation type can traverse this tile (& the tile isn't taken).
         bool Traversable(int unitNavType) const;
-        bool TraversableOrForrest(int unitNavType) const;
+        bool TraversableOrForrest(int unitNavType, const NavScratch& nav) const;
 
         //Same as Traversable(), but doesn't consider if the tile is taken or not.
         bool Traversable_Terrain(int unitNavType) const;
@@ -162,6 +187,7 @@ namespace eng {
         bool IsTreeTile() const { return tileType == TileType::TREES; }
 
         bool IsVisible(bool occlusion_enabled = true) const;
+        bool IsExplored(bool occlusion_enabled = true) const;
 
         bool IsCoastTile() const;
 
@@ -267,8 +293,7 @@ namespace eng {
         void RoundCorners_Increment(const glm::ivec2& m, const glm::ivec2& M, int range);
         void RoundCorners_Decrement(const glm::ivec2& m, const glm::ivec2& M, int range);
 
-        void NavDataCleanup();
-        int NavData_Forrest_FloodFill(const glm::ivec2& pos);
+        int NavData_Forrest_FloodFill(NavGrid& nav, const glm::ivec2& pos);
     private:
         void Move(MapTiles&& m) noexcept;
         void Release() noexcept;
@@ -359,6 +384,28 @@ namespace eng {
         MapTiles tiles;
     };
 
+    //===== MapSnapshot =====
+
+    //Persistent part of the tile state (the fields stored in savefiles).
+    struct TileState {
+        int32_t tileType;
+        int32_t variation;
+        int32_t cornerType;
+        int32_t health;
+    };
+
+    //Copy-on-write snapshot of the persistent tile state. Tiles (in MapTiles' linear order) are split into fixed-size chunks,
+    //chunks that weren't modified since the previous snapshot are shared with it. Chunks are immutable, snapshot can be read from any thread.
+    struct MapSnapshot {
+        static constexpr int CHUNK_SIZE = 1024;
+        using Chunk = std::vector<TileState>;
+    public:
+        std::string tileset;
+        glm::ivec2 size = glm::ivec2(0);
+        int count = 0;
+        std::vector<std::shared_ptr<const Chunk>> chunks;
+    };
+
     //===== Map =====
 
     class Map {
@@ -374,6 +421,9 @@ namespace eng {
 
         Mapfile Export();
 
+        //Captures the persistent tile state. Only chunks modified since the previous snapshot are copied.
+        MapSnapshot Snapshot();
+
         glm::ivec2 Size() const { return tiles.Size(); }
         int Width() const { return tiles.Size().x; }
         int Height() const { return tiles.Size().y; }
@@ -387,13 +437,21 @@ namespace eng {
         //Harvest tick on given tile. Should only be used on wood tiles. Returns true when the health hits zero.
         bool HarvestTile(const glm::ivec2& idx);
 
+        //Draws the visible terrain chunks (static meshes) & the occlusion/fog quads of the tiles in view.
         void Render();
         void RenderRange(int x, int y, int w, int h);
 
         bool IsWithinBounds(const glm::ivec2& pos) const;
 
+        //Range of tiles currently in the camera view (min inclusive, max exclusive), extended by given margin & clamped to the map.
+        std::pair<glm::ivec2, glm::ivec2> VisibleRange(int margin = 0) const;
+
         void ChangeTileset(const TilesetRef& tilesetNew);
 
+        //Creates the GL resources (occlusion sprite) & updates camera bounds. Done by the constructor when running on the main thread,
+        //maps constructed on a loading thread have to call it once they're handed over to the main thread.
+        void InitializeGraphics();
+
         TilesetRef GetTileset() const { return tileset; }
 
         //Updates untouchability flags on all tiles.
@@ -491,6 +549,9 @@ namespace eng {
         bool IsTileVisible(const glm::ivec2& position) const;
         bool IsTileVisible(const glm::ivec2& position, const glm::ivec2& size) const;
 
+        //Explored = not covered by the occlusion, regardless of the fog of war (objects there are rendered from memory).
+        bool IsTileExplored(const glm::ivec2& position, const glm::ivec2& size) const;
+
         //Returns true if any of the tiles in 2x2 area is a coast tile
         bool IsDockingLocation(const glm::ivec2& bot_left) const;
 
@@ -517,30 +578,40 @@ namespace eng {
         //Defines what corner type to write when painting given tileType.
         int ResolveCornerType(int paintedTileType) const;
 
-        glm::ivec2 MinDistanceNeighbor(const glm::ivec2& center, int step = 1);
-        glm::ivec2 MinDistanceNeighbor(const glm::ivec2& center, int nav_type, int step);
+        glm::ivec2 MinDistanceNeighbor(NavGrid& nav, const glm::ivec2& center, int step = 1);
+        glm::ivec2 MinDistanceNeighbor(NavGrid& nav, const glm::ivec2& center, int nav_type, int step);
 
-        //Retrieves next position for movement. Call after pathfinding is done (uses filled out distance values in the map data).
-        glm::ivec2 Pathfinding_RetrieveNextPos(const glm::ivec2& pos_src, const glm::ivec2& pos_dst, int navType);
+        //Retrieves next position for movement. Call after pathfinding is done (uses filled out distance values in the workspace).
+        glm::ivec2 Pathfinding_RetrieveNextPos(NavGrid& nav, const glm::ivec2& pos_src, const glm::ivec2& pos_dst, int navType);
         //Retrieves the final position for movement - where does the path end if true destination is inaccessible.
-        glm::ivec2 Pathfinding_RetrieveFinalPos(const glm::ivec2& pos_src, const glm::ivec2& pos_dst, int navType);
+        glm::ivec2 Pathfinding_RetrieveFinalPos(NavGrid& nav, const glm::ivec2& pos_src, const glm::ivec2& pos_dst, int navType);
 
         TileData& at(int y, int x);
         const TileData& at(int y, int x) const;
 
         int c2i(int y, int x) const { return y * (tiles.Size().x+1) + x; }
 
+        //Marks snapshot chunk containing given tile as modified (no position = invalidates all the chunks).
+        void SnapshotInvalidate(const glm::ivec2& idx);
+        void SnapshotInvalidate();
+
+        //Marks terrain mesh chunk containing given tile for rebuild (no position = rebuilds all the chunks).
+        void TerrainInvalidate(const glm::ivec2& idx);
+        void TerrainInvalidate();
+
         void DBG_PrintTiles() const;
         void DBG_PrintDistances() const;
 
         Sprite GenOcclusionSprite();
 
         void Move(Map&&) noexcept;
+    private:
+        //Regenerates the terrain mesh of given chunk from the current tile indices.
+        void RebuildTerrainChunk(const glm::ivec2& chunk, QuadMesh& mesh);
     private:
         TilesetRef tileset;
         MapTiles tiles;
 
-        pathfindingContainer nav_list;
         std::vector<TraversableObjectEntry> traversableObjects;
         int playerFactionId = -1;
 
@@ -548,6 +619,13 @@ namespace eng {
         Sprite occlusion;
 
         std::vector<std::pair<glm::ivec2, ObjectID>> rune_dispatch;
+
+        std::vector<std::shared_ptr<const MapSnapshot::Chunk>> snapshot_chunks;     //chunks of the last snapshot
+        std::vector<uint8_t> snapshot_dirty;                                        //chunk modified since the last snapshot
+
+        std::vector<QuadMesh> terrain_chunks;                                       //static terrain geometry (TERRAIN_CHUNK_SIZE^2 tiles each), in map coords
+        std::vector<uint8_t> terrain_dirty;                                         //chunk tile indices changed since the last mesh upload
+        glm::ivec2 terrain_stats = glm::ivec2(0);                                   //last frame - drawn chunks, submitted quads (terrain & occlusion)
     };
 
 }//namespace eng
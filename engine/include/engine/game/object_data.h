@@ -113,7 +113,8 @@ namespace eng {
         std::string str_id;         //string identifier  ... format usually smth like "human/town_hall"
         glm::ivec3  num_id;         //numeric identifier ... format {UNIT|BUILDING|UTILITY, type, race}
         int objectType;
-        bool initialized = false;
+        bool initialized = false;   //full definition parsed (happens on the first use, see Resources::LoadObject)
+        bool indexed = false;       //definition was found during preload - header fields (name, cost, icon, size, ...) are valid
 
         std::string name;
         glm::ivec4 cost;
@@ -10,6 +10,10 @@ namespace eng {
 
     void GameObjectData_ParseExisting(const nlohmann::json& config, GameObjectDataRef data);
 
+    //Only parses the fields shared by all the prefabs (name, cost, icon, ...), rest of the definition is parsed on the first use.
+    GameObjectDataRef GameObjectData_ParseHeaderNew(const nlohmann::json& config);
+    void GameObjectData_ParseHeader(const nlohmann::json& config, GameObjectDataRef data);
+
     void GameObjectData_FinalizeButtonDescriptions(GameObjectDataRef& data);
 
     ResearchVisuals ResearchInfo_Parse(const nlohmann::json& entry, int type, std::vector<ResearchData>& level_entries);
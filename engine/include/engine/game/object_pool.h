@@ -10,6 +10,7 @@
 namespace eng {
 
     class ObjectPool;
+    class Map;
 
     //===== EntranceController =====
 
@@ -26,7 +27,7 @@ namespace eng {
             ObjectID enteree;
             glm::ivec2 cmd_target;
             int cmd_type;
-            float start_time;
+            tick_t start_tick;
         };
         struct ExportData {
             std::vector<Entry> entries;
@@ -93,8 +94,13 @@ namespace eng {
         ObjectPool(Level& level, ObjectsFile&& file);
         void Release();
 
+        //Two-phase update - units first precompute their map queries (in parallel, against unmodified map), then all objects update in pool order.
+        //Results only depend on the pool order, never on the number of threads used (planning runs inline, when there are no workers).
         void Update();
-        void Render();
+
+        //Renders units & buildings registered on the map tiles in the camera view (plus a margin), skipping the ones hidden by occlusion/fog.
+        //Utility objects aren't on the map grid (& their render handlers place them freely), so they're all rendered.
+        void Render(const Map& map);
 
         ObjectsFile Export() const;
 
@@ -138,6 +144,9 @@ namespace eng {
 
         ObjectID GetObjectAt(const glm::ivec2& map_coords);
 
+        //Looks up the current identifier of an object, based on its unique ID (pool slot indices don't persist through save/load). Iterates the entire pool - O(n).
+        ObjectID FindObject(ObjectID::dtype type, ObjectID::dtype id);
+
         Unit& GetUnit(const ObjectID& id);
         Building& GetBuilding(const ObjectID& id);
         FactionObject& GetObject(const ObjectID& id);
@@ -193,6 +202,10 @@ namespace eng {
     private:
         idMappingType PopulatePools(Level& level, const ObjectsFile& file);
         void UpdateLinkage(Level& level, const idMappingType& id_mapping);
+
+        //Planning phase of the update - read-only, runs on the Jobs worker threads (inline when there are none).
+        //Always runs, so that the results don't depend on the worker count (queries are against the map at the start of the tick).
+        void PlanUpdates();
     private:
         UnitsPool units;
         BuildingsPool buildings;
@@ -202,6 +215,12 @@ namespace eng {
         std::vector<UtilityObject> to_spawn;                //objects added from other objects Update() method
         std::vector<int> factionObjectCount;
         std::vector<glm::ivec2> factionKillCount;
+        std::vector<Unit*> planned;                         //units processed during the planning phase
+
+        uint32_t render_frame = 0;
+        std::vector<uint32_t> rendered_units;               //frame, in which the unit (pool slot) was last visited by Render (dedup across its tiles)
+        std::vector<uint32_t> rendered_buildings;
+        glm::ivec3 render_stats = glm::ivec3(0);            //last Render() - drawn, culled by the view, hidden by occlusion/fog
 
         EntranceController entranceController;
     };
@@ -340,12 +340,15 @@ namespace eng {
     public:
         PlayerFactionController(FactionsFile::FactionEntry&& entry, const glm::ivec2& mapSize);
 
+        //Creates the GUI & map view texture. Done by the constructor on the main thread, controllers created on a loading thread call it during level finalization.
+        void InitializeGraphics(const glm::ivec2& mapSize);
+
         const OcclusionMask& Occlusion() const { return occlusion; }
 
         //Render player's GUI.
         void Render();
 
-        virtual void Update(Level& level) override;
+        virtual void FrameUpdate(Level& level) override;
 
         virtual void SignalGUIUpdate() override;
         virtual void SignalGUIUpdate(const FactionObject& obj) override;
@@ -418,6 +421,8 @@ namespace eng {
         int buildingViz_id = -1;
         std::vector<bool> buildingViz_check;
         glm::ivec2 buildingViz_workerPos = glm::ivec2(0);
+
+        float dbg_guiTime = 0.f;       //smoothed CPU time of the GUI elements rendering (us)
     };
 
 }//namespace eng
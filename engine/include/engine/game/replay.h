@@ -0,0 +1,86 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstdint>
+
+#include "engine/utils/mathdefs.h"
+#include "engine/game/command.h"
+#include "engine/game/sim_clock.h"
+
+namespace eng {
+
+    class Level;
+
+    //===== ReplayEntry =====
+
+    namespace ReplayEntryType { enum { UNIT_COMMAND = 0, BUILDING_ACTION, BUILDING_CANCEL, COUNT }; }
+
+    //Single player-issued order, stamped with the simulation tick, during which it was issued.
+    struct ReplayEntry {
+        tick_t tick;
+        int type;
+        ObjectID object;                    //unit or building, that received the order
+        Command::Entry command;             //UNIT_COMMAND only
+        BuildingAction::Entry action;       //BUILDING_ACTION only
+        glm::ivec3 price = glm::ivec3(0);   //BUILDING_ACTION only - resources paid by the player
+    };
+
+    //===== Replay =====
+
+    //Records player orders during a game session & re-executes them on top of the initial savefile.
+    //Initial state is stored as a regular savefile (next to the log, as '<filepath>.json'), the log itself is a compact binary file.
+    //Reproducibility relies on fixed simulation ticks & on the random generator being reseeded with the seed stored in the log.
+    //Recording should start right after the level is loaded (state, that isn't part of the savefile, has to be in its default values).
+    class Replay {
+    public:
+        Replay() = default;
+
+        //Exports the level as the initial savefile, reseeds the random generator & starts recording the player orders.
+        bool StartRecording(Level& level, const std::string& filepath);
+
+        //Stops the recording & writes the log file (along with the end tick & state hash).
+        bool StopRecording(Level& level);
+
+        //Reads replay log from given file. Level has to be loaded from SavefilePath() & then passed into StartPlayback().
+        bool Load(const std::string& filepath);
+
+        //Restores the recorded simulation setup (random seed, object ID counter) & starts the playback.
+        void StartPlayback(Level& level);
+
+        //Re-executes all the orders recorded for the current tick. Invoked at the start of each simulation tick.
+        void Apply(Level& level);
+
+        void RecordCommand(const ObjectID& unitID, const Command& command);
+        void RecordAction(const ObjectID& buildingID, const BuildingAction& action, const glm::ivec3& price);
+        void RecordCancel(const ObjectID& buildingID);
+
+        bool IsRecording() const { return recording; }
+        bool IsPlaying() const { return playing; }
+        bool Finished() const { return SimClock::Now() >= end_tick; }
+
+        std::string SavefilePath() const { return filepath + ".json"; }
+        tick_t EndTick() const { return end_tick; }
+        uint64_t EndHash() const { return end_hash; }
+        size_t EntryCount() const { return entries.size(); }
+
+        //Hash of the simulation-relevant level state (objects, factions & map tiles). Independent on object pool layout.
+        static uint64_t StateHash(Level& level);
+    private:
+        void Record(ReplayEntry&& entry);
+    private:
+        std::string filepath;
+        std::vector<ReplayEntry> entries;
+        size_t next_entry = 0;
+
+        uint32_t seed = 0;
+        int next_object_id = 0;
+        tick_t start_tick = 0;
+        tick_t end_tick = 0;
+        uint64_t end_hash = 0;
+
+        bool recording = false;
+        bool playing = false;
+    };
+
+}//namespace eng
@@ -2,6 +2,8 @@
 
 #include <string>
 #include <memory>
+#include <vector>
+#include <utility>
 
 #include "engine/core/texture.h"
 #include "engine/core/text.h"
@@ -52,6 +54,13 @@ namespace eng::Resources {
     Sprite LoadSprite(const std::string& full_name);
     SpritesheetRef LoadSpritesheet(const std::string& name);
 
+    //Spritesheet textures, that are merged into a single atlas during preload - (name, texture filepath) pairs in the merge order.
+    //The atlas can also be baked into the asset pack (strategy2d_cook --atlas), the packing & GPU copies are skipped then.
+    std::vector<std::pair<std::string, std::string>> AtlasSpritesheets();
+
+    constexpr const char* BAKED_ATLAS_LAYOUT = "res/atlas/spritesheets.json";
+    constexpr const char* BAKED_ATLAS_IMAGE = "res/atlas/spritesheets.png";
+
     //===== Object Prefabs =====
 
     //lookup in the map
@@ -67,6 +76,13 @@ namespace eng::Resources {
     BuildingDataRef LoadBuilding(int num_id, bool isOrc);
     UnitDataRef LoadUnit(int num_id, bool isOrc);
 
+    //Prefabs are only indexed during preload & fully parsed on their first use (any of the Load calls above).
+    //Warmup parses given prefabs ahead of time (during level loading), to avoid the parsing hitches mid-game.
+    void WarmupObjects(const std::vector<glm::ivec3>& num_ids);
+
+    //Resolves the unit prefab, whose death animation has given index in the corpse animator. Returns false for the corpse's own animations.
+    bool DeathAnimationOwner(int anim_idx, glm::ivec3& out_num_id);
+
     bool LoadResearchInfo(int type, int level, ResearchInfo& out_info);
     int LoadResearchBonus(int type, int level);
     int LoadResearchLevels(int type);
@@ -0,0 +1,71 @@
+#pragma once
+
+namespace eng {
+
+    //Simulation tick index.
+    using tick_t = int;
+
+    //====== SimClock ======
+
+    //Fixed-timestep clock, that drives the game simulation. Singleton pattern.
+    //Simulation advances in discrete ticks of constant length (in game time), independently of the rendering framerate.
+    //Frame time (already scaled by the game speed) is accumulated and converted into the number of ticks to simulate during given frame.
+    //Gameplay timers should be expressed in ticks (or advanced by the fixed DeltaTime()), never in real time.
+    class SimClock {
+    public:
+        static constexpr int TICK_RATE = 30;
+        static constexpr float TICK_LENGTH = 1.f / TICK_RATE;
+
+        //Upper limit on ticks per frame - on slow frames, the simulation slows down instead of spiraling.
+        static constexpr int MAX_TICKS_PER_FRAME = 8;
+    public:
+        static SimClock& Get();
+    public:
+        //copy disabled
+        SimClock(const SimClock&) = delete;
+        SimClock& operator=(const SimClock&) const = delete;
+
+        //move disabled
+        SimClock(SimClock&&) noexcept = delete;
+        SimClock& operator=(SimClock&&) noexcept = delete;
+
+        //Accumulates frame time (in game seconds) & returns the number of ticks to simulate during this frame.
+        int Advance(float frameTime);
+
+        //Marks the end of a simulation tick.
+        void Step() { tick++; }
+
+        //Resets the tick counter & drops any accumulated time (use when loading a level).
+        void Reset(tick_t tick = 0);
+
+        //Interpolation factor between the last two simulated ticks (for rendering), in range <0,1).
+        float Alpha() const { return acc * TICK_RATE; }
+
+        //Number of ticks simulated during the last frame.
+        int FrameTicks() const { return frameTicks; }
+
+        //Index of the current simulation tick.
+        static tick_t Now();
+
+        //Simulation time in game seconds.
+        static float Time() { return Now() * TICK_LENGTH; }
+
+        //Fixed length of a single tick (in game seconds).
+        static constexpr float DeltaTime() { return TICK_LENGTH; }
+
+        //Converts duration (in game seconds) into number of ticks (rounded up).
+        static tick_t Ticks(float seconds);
+
+        //Returns the tick, at which delay of given duration (in game seconds) expires.
+        static tick_t Delay(float seconds) { return Now() + Ticks(seconds); }
+
+        void DBG_GUI();
+    private:
+        SimClock() = default;
+    private:
+        tick_t tick = 0;
+        float acc = 0.f;
+        int frameTicks = 0;
+    };
+
+}//namespace eng
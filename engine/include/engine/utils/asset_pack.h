@@ -0,0 +1,73 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstdint>
+
+#include <nlohmann/json.hpp>
+
+namespace eng::AssetPack {
+
+    //Cooked assets - single file with the startup resources in their preprocessed form (JSON files as MessagePack, images as decoded pixels),
+    //memory mapped at startup & resolved by offset. Assets are looked up by their original filepath; anything, that's missing
+    //in the pack (or when there's no pack at all), is loaded from the loose files.
+
+    namespace EntryType { enum { JSON = 1, IMAGE }; }
+    namespace EntryFlags { enum { COMPRESSED = 1 }; }
+
+    //===== ImageData =====
+
+    //Decoded image from the pack. Pixels point directly into the mapped file, unless the image had to be decompressed or flipped (then it's the buffer).
+    struct ImageData {
+        int width = 0;
+        int height = 0;
+        int channels = 0;
+        const uint8_t* pixels = nullptr;
+        std::vector<uint8_t> buffer;
+    };
+
+    //===== GeneratedAsset =====
+
+    //Asset without a loose file, that's cooked into the pack as well (e.g. the baked texture atlas).
+    struct GeneratedAsset {
+        std::string name;
+        int type = EntryType::JSON;
+        nlohmann::json json;        //JSON entries
+        ImageData image;            //IMAGE entries (pixels or buffer)
+    };
+
+    //===== CookStats =====
+
+    struct CookStats {
+        int json_count = 0;
+        int image_count = 0;
+        size_t raw_bytes = 0;       //size of the cooked data before compression
+        size_t bytes = 0;           //pack file size
+        float time_ms = 0.f;
+    };
+
+    //===== AssetPack =====
+
+    //Maps the pack into memory. Returns false if the file doesn't exist or isn't a valid pack (loose files are used then).
+    bool Mount(const std::string& filepath);
+    void Unmount();
+    bool IsMounted();
+
+    std::string DefaultPath();
+
+    bool Contains(const std::string& filepath);
+
+    //Returns parsed JSON file - from the pack if it's there, from the loose file otherwise (throws on failure).
+    nlohmann::json LoadJSON(const std::string& filepath);
+
+    //Retrieves pre-decoded image. Returns false when the image isn't in the pack.
+    bool ReadImage(const std::string& filepath, ImageData& out, bool flip = false);
+
+    //Image dimensions without touching the pixel data. Returns false when the image isn't in the pack.
+    bool ImageInfo(const std::string& filepath, int& width, int& height, int& channels);
+
+    //Bakes all the JSON & PNG files from given directories (recursively) into a pack. Asset names are the filepaths, as they're referenced at runtime.
+    //Generated assets are appended after the files.
+    bool Cook(const std::vector<std::string>& directories, const std::string& output_filepath, bool compress = true, CookStats* stats = nullptr, const std::vector<GeneratedAsset>& generated = {});
+
+}//namespace eng::AssetPack
@@ -0,0 +1,18 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+namespace eng::LZ {
+
+    //Fast LZ77-style block compression (LZ4-like sequence encoding, 64kB window). Favors decompression speed over compression ratio.
+    //Compressed block doesn't store the original size, it has to be stored alongside.
+
+    //Compresses given data block. Output is never larger than (size + size/255 + 16) bytes.
+    std::vector<uint8_t> Compress(const uint8_t* data, size_t size);
+
+    //Decompresses given block into preallocated buffer of exactly the original size. Returns false on malformed input.
+    bool Decompress(const uint8_t* data, size_t size, uint8_t* out, size_t out_size);
+
+}//namespace eng::LZ
@@ -65,8 +65,18 @@ namespace eng {
         int InvokationCount();
         void Clear();
 
+        //Generated textures are also cached on disk (keyed by Params::Hash), so they're only synthesized once.
         TextureRef GetTexture(const Params& params);
 
+        //Loads (or generates) the textures used during the last session on the worker threads & uploads them. Call during the loading stage.
+        void Pregenerate();
+
+        //Window size dependent textures (buttons) are regenerated in the background, the old texture is used until the new one's ready.
+        void OnResize(int width, int height);
+
+        //Per-frame update (regeneration after a resize & texture merging).
+        void Update();
+
         void TextureMergingUpdate();
         void Merge();
 
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <atomic>
+#include <functional>
+#include <mutex>
+#include <vector>
+
+namespace eng::Jobs {
+
+    using JobFn = std::function<void()>;
+    using RangeFn = std::function<void(size_t begin, size_t end)>;
+
+    //MAIN_THREAD jobs are only executed from the main thread (GL calls, window & audio API) - in ProcessMainThreadJobs() or while the main thread waits.
+    namespace Affinity { enum { ANY = 0, MAIN_THREAD }; }
+
+    //===== Counter =====
+
+    //Tracks the number of unfinished jobs. Used to wait for a group of jobs or to start jobs after a group finishes (dependencies).
+    //Counter has to outlive all the jobs, that reference it.
+    class Counter {
+        friend struct JobsData;
+    public:
+        Counter() = default;
+
+        //copy/move disabled (jobs hold a pointer to it)
+        Counter(const Counter&) = delete;
+        Counter& operator=(const Counter&) = delete;
+
+        bool Done() const { return value.load(std::memory_order_acquire) == 0; }
+        int Pending() const { return value.load(std::memory_order_acquire); }
+    private:
+        void Increment() { value.fetch_add(1, std::memory_order_relaxed); }
+        void Decrement();
+    private:
+        struct Continuation {
+            JobFn fn;
+            Counter* counter;
+            int affinity;
+        };
+
+        std::atomic<int> value = 0;
+        std::mutex mutex;
+        std::vector<Continuation> continuations;
+    };
+
+    //===== Jobs =====
+
+    //Spawns the worker threads (negative count = number of hardware threads - 1; zero means jobs run on the calling thread).
+    void Initialize(int worker_count = -1);
+
+    //Finishes all the scheduled jobs & joins the worker threads.
+    void Release();
+
+    bool IsInitialized();
+    int WorkerCount();
+    bool IsMainThread();
+
+    //Schedules a job. Counter (if provided) is incremented immediately & decremented once the job finishes.
+    //When the system isn't initialized, the job runs immediately on the calling thread (MAIN_THREAD jobs are still deferred, unless already on the main thread).
+    void Run(JobFn&& fn, Counter* counter = nullptr, int affinity = Affinity::ANY);
+
+    //Schedules a job, that starts once the dependency counter reaches zero.
+    void RunAfter(Counter& dependency, JobFn&& fn, Counter* counter = nullptr, int affinity = Affinity::ANY);
+
+    //Blocks until the counter reaches zero. Calling thread executes scheduled jobs in the meantime (main thread includes MAIN_THREAD jobs).
+    void Wait(Counter& counter);
+
+    //Splits index range [0, count) into batches, runs them in parallel & waits for completion. Calling thread participates.
+    //Batch size of zero picks one based on the number of workers.
+    void ParallelFor(size_t count, const RangeFn& body, size_t batch_size = 0);
+
+    //Executes the queued MAIN_THREAD jobs. Call once per frame from the main loop.
+    void ProcessMainThreadJobs();
+
+    void DBG_GUI();
+
+}//namespace eng::Jobs
@@ -1,11 +1,73 @@
 #pragma once
 
+#include <cstdint>
+
 namespace eng::Random {
 
-    //Random uniform float in range <0,1>.
+    //Independent random number streams. Only the simulation stream affects the game state (it's reproducible from a seed & its state is stored in savefiles).
+    //Cosmetic & audio streams can be drawn from anywhere (rendering, input handling) without disturbing the simulation's sequence.
+    namespace Stream { enum { SIMULATION = 0, COSMETIC, AUDIO, COUNT }; }
+
+    //===== Generator =====
+
+    //Small & fast pseudo-random generator (xoshiro128**). Trivially copyable, copy of the generator is its full state.
+    struct Generator {
+        uint32_t s[4] = {};
+    public:
+        Generator() = default;
+        Generator(uint64_t seed) { Seed(seed); }
+
+        //Initializes the state from a 64bit seed (expanded with splitmix64).
+        void Seed(uint64_t seed);
+
+        uint32_t Next() {
+            uint32_t result = Rotl(s[1] * 5, 7) * 9;
+            uint32_t t = s[1] << 9;
+            s[2] ^= s[0];
+            s[3] ^= s[1];
+            s[1] ^= s[2];
+            s[0] ^= s[3];
+            s[2] ^= t;
+            s[3] = Rotl(s[3], 11);
+            return result;
+        }
+
+        //Random uniform float in range <0,1).
+        float Uniform() { return (Next() >> 8) * (1.f / 16777216.f); }
+
+        //Random int in range <0,max>.
+        int UniformInt(int max) { return UniformInt(0, max); }
+
+        //Random int in range <min,max>.
+        int UniformInt(int min, int max) { return min + int((uint64_t(Next()) * uint64_t(uint32_t(max - min) + 1)) >> 32); }
+
+        //All-zero state is invalid for xoshiro (used to mark state, that wasn't initialized/loaded).
+        bool Valid() const { return (s[0] | s[1] | s[2] | s[3]) != 0; }
+    private:
+        static uint32_t Rotl(uint32_t x, int k) { return (x << k) | (x >> (32 - k)); }
+    };
+
+    //===== streams =====
+
+    //Returns given stream of the calling thread. Each thread has its own set of streams (seeded randomly on first use),
+    //so that parallel work can draw random numbers without locking. To keep parallel work deterministic, reseed the
+    //thread's simulation stream with a key derived from the work item (e.g. tick & object ID) before using it.
+    Generator& Get(int stream);
+
+    //Reseeds the simulation stream of the calling thread (to make the simulation reproducible).
+    void Seed(uint64_t seed);
+
+    //Simulation stream state of the calling thread (for savefiles).
+    Generator State();
+    void Restore(const Generator& state);
+
+    //Random uniform float in range <0,1) (simulation stream).
     float Uniform();
 
+    //Random int in range <0,max> (simulation stream).
     int UniformInt(int max);
+
+    //Random int in range <min,max> (simulation stream).
     int UniformInt(int min, int max);
 
 }//namespace eng::Random
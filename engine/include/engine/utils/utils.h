@@ -3,6 +3,8 @@
 //==== Utility functions ====
 
 #include <string>
+#include <vector>
+#include <cstdint>
 
 namespace eng {
 
@@ -12,6 +14,9 @@ namespace eng {
     //Same as ReadFile, but returns true/false as a status, file contents are returned through the out_text arugment.
     bool TryReadFile(const char* filepath, std::string& out_text);
 
+    //Reads the whole file in binary mode (single read call). Returns false on failure.
+    bool TryReadBinaryFile(const char* filepath, std::vector<uint8_t>& out_data);
+
     //Writes provided text into a textfile (throws exception on failure). Always overrides the entire file.
     void WriteFile(const char* filepath, const std::string& text);
 
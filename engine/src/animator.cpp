@@ -1,7 +1,8 @@
 #include "engine/core/animator.h"
 
-#include "engine/core/input.h"
+#include "engine/game/sim_clock.h"
 #include "engine/utils/randomness.h"
+#include "engine/utils/log.h"
 
 #define WOBBLING_OFFSET 5e-3f
 
@@ -11,28 +12,47 @@ namespace eng {
 
     static SpriteGroup no_anim = SpriteGroup::CreateDefault();
 
-    AnimatorData::AnimatorData(const std::string& name_, const std::map<int, SpriteGroup>& anims_) : name(name_), anims(anims_) {}
+    AnimatorData::AnimatorData(const std::string& name_, const std::map<int, SpriteGroup>& anims_) : name(name_) {
+        for(auto& [actionIdx, graphics] : anims_)
+            AddAction(actionIdx, graphics);
+    }
 
     SpriteGroup& AnimatorData::GetGraphics(int action) {
-        if(anims.count(action)) {
-            return anims.at(action);
+        if(HasGraphics(action)) {
+            return anims[action];
         }
         else {
             //TODO: AnimatorData - invalid actionID - add some defaulting mechanism
-            if(anims.size() != 0)
-                return anims.begin()->second;
+            if(fallback >= 0)
+                return anims[fallback];
             else
                 return no_anim;
         }
     }
 
     void AnimatorData::AddAction(int actionIdx, const SpriteGroup& graphics) {
-        anims.insert({ actionIdx, graphics });
+        if(actionIdx < 0) {
+            ENG_LOG_WARN("AnimatorData::AddAction - negative action index ({}) in '{}'.", actionIdx, name);
+            return;
+        }
+        if(HasGraphics(actionIdx))
+            return;
+
+        if(actionIdx >= (int)anims.size()) {
+            anims.resize(actionIdx+1);
+            defined.resize(actionIdx+1, 0);
+        }
+        anims[actionIdx] = graphics;
+        defined[actionIdx] = 1;
+        count++;
+
+        if(fallback < 0 || actionIdx < fallback)
+            fallback = actionIdx;
     }
 
     //===== Animator =====
 
-    Animator::Animator(const AnimatorDataRef& data_, float anim_speed_) : data(data_), anim_speed(anim_speed_), frame(Random::Uniform()) {}
+    Animator::Animator(const AnimatorDataRef& data_, float anim_speed_) : data(data_), anim_speed(anim_speed_), frame(Random::Get(Random::Stream::COSMETIC).Uniform()) {}
 
     void Animator::SwitchAction(int action, bool forceReset) {
         if(lastAction != action || forceReset) {
@@ -46,7 +66,7 @@ namespace eng {
 
         SwitchAction(action);
 
-        frame += Input::Get().deltaTime * anim_speed;
+        frame += SimClock::DeltaTime() * anim_speed;
         bool res = false;
         while(frame >= graphics.Duration() && graphics.Repeat()) {
             frame -= graphics.Duration();
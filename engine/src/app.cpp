@@ -2,6 +2,7 @@
 
 #include "engine/utils/log.h"
 #include "engine/utils/dbg_gui.h"
+#include "engine/utils/jobs.h"
 #include "engine/core/renderer.h"
 #include "engine/core/audio.h"
 
@@ -12,6 +13,7 @@ namespace eng {
 
     App::App(int windowWidth, int windowHeight, const char* windowName) {
         Log::Initialize();
+        Jobs::Initialize();
 
         Window::Get().Initialize(windowWidth, windowHeight, windowName, float(windowWidth) / windowHeight);
         Window::Get().SetResizeCallbackHandler(this);
@@ -24,6 +26,7 @@ namespace eng {
     }
 
     App::~App() {
+        Jobs::Release();
         Resources::Release();
         Renderer::Release();
         Audio::Release();
@@ -43,9 +46,10 @@ namespace eng {
         while(!window.ShouldClose()) {
             DBG_GUI::Begin();
 
+            Jobs::ProcessMainThreadJobs();
             OnUpdate();
             Resources::CursorIcons::Update();
-            TextureGenerator::TextureMergingUpdate();
+            TextureGenerator::Update();
 
 #ifdef ENGINE_ENABLE_GUI
             OnGUI();
@@ -62,6 +66,7 @@ namespace eng {
 
     void App::OnResize(int width, int height) {
         Resources::OnResize(width, height);
+        TextureGenerator::OnResize(width, height);
     }
 
 }//namespace eng
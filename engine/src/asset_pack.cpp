@@ -0,0 +1,526 @@
+#include "engine/utils/asset_pack.h"
+
+#include "engine/utils/compression.h"
+#include "engine/utils/utils.h"
+#include "engine/utils/setup.h"
+#include "engine/utils/timer.h"
+
+#include <stb_image.h>
+
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <unordered_map>
+
+#ifdef _WIN32
+    #define WIN32_LEAN_AND_MEAN
+    #define NOMINMAX
+    #include <windows.h>
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+#define ASSET_PACK_MAGIC "S2PK"
+#define ASSET_PACK_VERSION 1
+#define ASSET_PACK_ALIGNMENT 16
+
+//Asset pack layout (little-endian):
+//  header:       char[4] magic, u32 version, u32 entry_count, u32 string_table_size
+//  entry table:  entry_count x PackEntry
+//  string table: entry names (referenced by offset & length, not null-terminated)
+//  data:         16B aligned entry blobs, offsets are relative to the file start; LZ compressed when the flag COMPRESSED is set
+//                  JSON:  MessagePack encoding of the document
+//                  IMAGE: decoded pixels (width x height x channels, 8bit channels, first row = top of the image)
+
+namespace eng::AssetPack {
+
+    struct PackHeader {
+        char magic[4];
+        uint32_t version;
+        uint32_t entry_count;
+        uint32_t string_table_size;
+    };
+    static_assert(sizeof(PackHeader) == 16);
+
+    struct PackEntry {
+        uint32_t type;
+        uint32_t flags;
+        uint32_t name_offset;
+        uint32_t name_length;
+        uint64_t offset;
+        uint64_t stored_size;
+        uint64_t raw_size;
+        int32_t width;
+        int32_t height;
+        int32_t channels;
+        uint32_t reserved;
+    };
+    static_assert(sizeof(PackEntry) == 56);
+
+    //===== MappedFile =====
+
+    //Read-only memory mapping of the whole file.
+    struct MappedFile {
+        const uint8_t* data = nullptr;
+        size_t size = 0;
+#ifdef _WIN32
+        HANDLE file = INVALID_HANDLE_VALUE;
+        HANDLE mapping = NULL;
+#endif
+    public:
+        bool Open(const std::string& filepath);
+        void Close();
+    };
+
+    struct PackData {
+        MappedFile file;
+        std::string filepath;
+        const PackEntry* entries = nullptr;
+        std::unordered_map<std::string, const PackEntry*> lookup;
+    };
+    static PackData pack = {};
+
+    //============
+
+    std::string NormalizePath(const std::string& filepath);
+    const PackEntry* FindEntry(const std::string& filepath, int type);
+    bool ReadEntry(const PackEntry& entry, std::vector<uint8_t>& out);
+    bool IsLittleEndian();
+
+    //============
+
+    bool Mount(const std::string& filepath) {
+        Unmount();
+
+        if(!std::filesystem::exists(filepath))
+            return false;
+
+        if(!IsLittleEndian()) {
+            ENG_LOG_WARN("AssetPack - big-endian platforms aren't supported, using loose files.");
+            return false;
+        }
+
+        if(!pack.file.Open(filepath)) {
+            ENG_LOG_WARN("AssetPack - failed to map '{}', using loose files.", filepath);
+            return false;
+        }
+
+        //validate the header & tables before resolving anything
+        const uint8_t* data = pack.file.data;
+        size_t size = pack.file.size;
+        PackHeader header = {};
+        if(size >= sizeof(PackHeader))
+            memcpy(&header, data, sizeof(PackHeader));
+        if(memcmp(header.magic, ASSET_PACK_MAGIC, 4) != 0) {
+            ENG_LOG_WARN("AssetPack - '{}' isn't an asset pack, using loose files.", filepath);
+            Unmount();
+            return false;
+        }
+        if(header.version != ASSET_PACK_VERSION) {
+            ENG_LOG_WARN("AssetPack - '{}' has unsupported version ({}, expected {}), using loose files.", filepath, header.version, ASSET_PACK_VERSION);
+            Unmount();
+            return false;
+        }
+
+        size_t strings_start = sizeof(PackHeader) + size_t(header.entry_count) * sizeof(PackEntry);
+        if(strings_start + header.string_table_size > size) {
+            ENG_LOG_WARN("AssetPack - '{}' is truncated, using loose files.", filepath);
+            Unmount();
+            return false;
+        }
+
+        pack.entries = (const PackEntry*)(data + sizeof(PackHeader));
+        const char* strings = (const char*)(data + strings_start);
+        for(uint32_t i = 0; i < header.entry_count; i++) {
+            const PackEntry& e = pack.entries[i];
+            bool valid_image = (e.type != EntryType::IMAGE) || (e.width > 0 && e.height > 0 && e.channels > 0 && e.raw_size == uint64_t(e.width) * e.height * e.channels);
+            if(uint64_t(e.name_offset) + e.name_length > header.string_table_size || e.offset > size || e.stored_size > size - e.offset || !valid_image) {
+                ENG_LOG_WARN("AssetPack - '{}' contains invalid entry ({}), using loose files.", filepath, i);
+                Unmount();
+                return false;
+            }
+            pack.lookup.insert({ std::string(strings + e.name_offset, e.name_length), &e });
+        }
+
+        pack.filepath = filepath;
+        ENG_LOG_INFO("[R] AssetPack - mounted '{}' ({} entries, {:.1f}MB).", filepath, header.entry_count, size / (1024.f * 1024.f));
+        return true;
+    }
+
+    void Unmount() {
+        pack.file.Close();
+        pack.entries = nullptr;
+        pack.lookup.clear();
+        pack.filepath.clear();
+    }
+
+    bool IsMounted() {
+        return pack.file.data != nullptr;
+    }
+
+    std::string DefaultPath() {
+        return "res/assets.pak";
+    }
+
+    bool Contains(const std::string& filepath) {
+        return IsMounted() && pack.lookup.count(NormalizePath(filepath));
+    }
+
+    nlohmann::json LoadJSON(const std::string& filepath) {
+        const PackEntry* entry = FindEntry(filepath, EntryType::JSON);
+        if(entry != nullptr) {
+            const uint8_t* data = pack.file.data + entry->offset;
+            if(!HAS_FLAG(entry->flags, EntryFlags::COMPRESSED))
+                return nlohmann::json::from_msgpack(data, data + entry->stored_size);
+
+            std::vector<uint8_t> buffer;
+            if(ReadEntry(*entry, buffer))
+                return nlohmann::json::from_msgpack(buffer.begin(), buffer.end());
+            ENG_LOG_WARN("AssetPack - corrupted entry '{}', loading the loose file instead.", filepath);
+        }
+
+        return nlohmann::json::parse(ReadFile(filepath.c_str()));
+    }
+
+    bool ReadImage(const std::string& filepath, ImageData& out, bool flip) {
+        const PackEntry* entry = FindEntry(filepath, EntryType::IMAGE);
+        if(entry == nullptr)
+            return false;
+
+        out.width = entry->width;
+        out.height = entry->height;
+        out.channels = entry->channels;
+
+        //uncompressed & not flipped - pixels can be used straight from the mapped file
+        if(!HAS_FLAG(entry->flags, EntryFlags::COMPRESSED) && !flip) {
+            out.pixels = pack.file.data + entry->offset;
+            return true;
+        }
+
+        if(!ReadEntry(*entry, out.buffer)) {
+            ENG_LOG_WARN("AssetPack - corrupted entry '{}', loading the loose file instead.", filepath);
+            return false;
+        }
+
+        if(flip) {
+            size_t row = size_t(out.width) * out.channels;
+            std::vector<uint8_t> tmp(row);
+            for(int y = 0; y < out.height / 2; y++) {
+                uint8_t* a = out.buffer.data() + y * row;
+                uint8_t* b = out.buffer.data() + (out.height - 1 - y) * row;
+                memcpy(tmp.data(), a, row);
+                memcpy(a, b, row);
+                memcpy(b, tmp.data(), row);
+            }
+        }
+
+        out.pixels = out.buffer.data();
+        return true;
+    }
+
+    bool ImageInfo(const std::string& filepath, int& width, int& height, int& channels) {
+        const PackEntry* entry = FindEntry(filepath, EntryType::IMAGE);
+        if(entry == nullptr)
+            return false;
+
+        width = entry->width;
+        height = entry->height;
+        channels = entry->channels;
+        return true;
+    }
+
+    bool Cook(const std::vector<std::string>& directories, const std::string& output_filepath, bool compress, CookStats* stats, const std::vector<GeneratedAsset>& generated) {
+        struct CookedEntry {
+            std::string name;
+            PackEntry entry;
+            std::vector<uint8_t> data;
+        };
+
+        if(!IsLittleEndian()) {
+            ENG_LOG_ERROR("AssetPack::Cook - big-endian platforms aren't supported.");
+            return false;
+        }
+
+        Timer t = {};
+        CookStats s = {};
+
+        //collect the files (sorted, so that the output doesn't depend on the directory iteration order)
+        std::vector<std::string> filepaths;
+        for(const std::string& dir : directories) {
+            if(!std::filesystem::is_directory(dir)) {
+                ENG_LOG_ERROR("AssetPack::Cook - '{}' is not a directory.", dir);
+                return false;
+            }
+            for(const auto& item : std::filesystem::recursive_directory_iterator(dir)) {
+                std::string ext = GetExtension(item.path().string());
+                if(item.is_regular_file() && (ext == "json" || ext == "png"))
+                    filepaths.push_back(NormalizePath(item.path().generic_string()));
+            }
+        }
+        std::sort(filepaths.begin(), filepaths.end());
+
+        auto store = [compress, &s](CookedEntry& ce) {
+            ce.entry.raw_size = ce.data.size();
+            s.raw_bytes += ce.data.size();
+            if(compress) {
+                std::vector<uint8_t> compressed = LZ::Compress(ce.data.data(), ce.data.size());
+                if(compressed.size() < ce.data.size()) {
+                    ce.data = std::move(compressed);
+                    ce.entry.flags |= EntryFlags::COMPRESSED;
+                }
+            }
+            ce.entry.stored_size = ce.data.size();
+        };
+
+        std::vector<CookedEntry> entries;
+        for(const std::string& filepath : filepaths) {
+            CookedEntry ce = {};
+            ce.name = filepath;
+            ce.entry = {};
+
+            if(GetExtension(filepath) == "json") {
+                try {
+                    ce.data = nlohmann::json::to_msgpack(nlohmann::json::parse(ReadFile(filepath.c_str())));
+                } catch(std::exception& e) {
+                    //not cooked - runtime falls back to the loose file (and reports the error, if the file is ever used)
+                    ENG_LOG_WARN("AssetPack::Cook - skipping '{}', failed to parse ({}).", filepath, e.what());
+                    continue;
+                }
+                ce.entry.type = EntryType::JSON;
+                s.json_count++;
+            }
+            else {
+                int width, height, channels;
+                stbi_set_flip_vertically_on_load_thread(false);
+                uint8_t* pixels = stbi_load(filepath.c_str(), &width, &height, &channels, 0);
+                if(pixels == nullptr) {
+                    ENG_LOG_WARN("AssetPack::Cook - skipping '{}', failed to decode.", filepath);
+                    continue;
+                }
+                ce.data.assign(pixels, pixels + size_t(width) * height * channels);
+                stbi_image_free(pixels);
+
+                ce.entry.type = EntryType::IMAGE;
+                ce.entry.width = width;
+                ce.entry.height = height;
+                ce.entry.channels = channels;
+                s.image_count++;
+            }
+
+            store(ce);
+            entries.push_back(std::move(ce));
+        }
+
+        //assets that don't exist as loose files (produced by the cooking tool itself)
+        for(const GeneratedAsset& asset : generated) {
+            CookedEntry ce = {};
+            ce.name = NormalizePath(asset.name);
+            ce.entry = {};
+            ce.entry.type = asset.type;
+
+            if(asset.type == EntryType::JSON) {
+                ce.data = nlohmann::json::to_msgpack(asset.json);
+                s.json_count++;
+            }
+            else {
+                size_t size = size_t(asset.image.width) * asset.image.height * asset.image.channels;
+                const uint8_t* pixels = (asset.image.pixels != nullptr) ? asset.image.pixels : asset.image.buffer.data();
+                if(size == 0 || (asset.image.pixels == nullptr && asset.image.buffer.size() < size)) {
+                    ENG_LOG_WARN("AssetPack::Cook - skipping generated asset '{}', no image data.", asset.name);
+                    continue;
+                }
+                ce.data.assign(pixels, pixels + size);
+                ce.entry.width = asset.image.width;
+                ce.entry.height = asset.image.height;
+                ce.entry.channels = asset.image.channels;
+                s.image_count++;
+            }
+
+            store(ce);
+            entries.push_back(std::move(ce));
+        }
+
+        //string table
+        std::string strings;
+        for(CookedEntry& ce : entries) {
+            ce.entry.name_offset = uint32_t(strings.size());
+            ce.entry.name_length = uint32_t(ce.name.size());
+            strings += ce.name;
+        }
+
+        //data offsets (aligned)
+        auto align = [](uint64_t v) { return (v + ASSET_PACK_ALIGNMENT - 1) & ~uint64_t(ASSET_PACK_ALIGNMENT - 1); };
+        uint64_t offset = align(sizeof(PackHeader) + entries.size() * sizeof(PackEntry) + strings.size());
+        for(CookedEntry& ce : entries) {
+            ce.entry.offset = offset;
+            offset = align(offset + ce.entry.stored_size);
+        }
+
+        PackHeader header = {};
+        memcpy(header.magic, ASSET_PACK_MAGIC, 4);
+        header.version = ASSET_PACK_VERSION;
+        header.entry_count = uint32_t(entries.size());
+        header.string_table_size = uint32_t(strings.size());
+
+        //write into a temporary file first - pack that's currently in use is only replaced once the new one is complete
+        std::string tmp_filepath = output_filepath + ".tmp";
+        {
+            std::ofstream file = std::ofstream(tmp_filepath, std::ios::binary);
+            if(!file.is_open()) {
+                ENG_LOG_ERROR("AssetPack::Cook - failed to open '{}' for writing.", tmp_filepath);
+                return false;
+            }
+
+            static const char padding[ASSET_PACK_ALIGNMENT] = {};
+            file.write((const char*)&header, sizeof(header));
+            for(const CookedEntry& ce : entries)
+                file.write((const char*)&ce.entry, sizeof(PackEntry));
+            file.write(strings.data(), strings.size());
+            for(const CookedEntry& ce : entries) {
+                file.write(padding, std::streamsize(ce.entry.offset - uint64_t(file.tellp())));
+                file.write((const char*)ce.data.data(), ce.data.size());
+            }
+
+            if(!file) {
+                ENG_LOG_ERROR("AssetPack::Cook - failed to write '{}'.", tmp_filepath);
+                return false;
+            }
+        }
+
+        //pack can't be replaced while it's mapped (on some platforms)
+        bool remount = IsMounted() && NormalizePath(pack.filepath) == NormalizePath(output_filepath);
+        if(remount)
+            Unmount();
+
+        std::error_code ec;
+        std::filesystem::rename(tmp_filepath, output_filepath, ec);
+        if(ec) {
+            ENG_LOG_ERROR("AssetPack::Cook - failed to store the pack as '{}' ({}).", output_filepath, ec.message());
+            std::filesystem::remove(tmp_filepath, ec);
+            return false;
+        }
+        if(remount)
+            Mount(output_filepath);
+
+        s.bytes = size_t(std::filesystem::file_size(output_filepath, ec));
+        s.time_ms = t.TimeElapsed<Timer::us>() * 1e-3f;
+        ENG_LOG_INFO("AssetPack::Cook - '{}' cooked ({} JSON files, {} images, {:.1f}MB -> {:.1f}MB, {:.0f}ms).", output_filepath, s.json_count, s.image_count,
+            s.raw_bytes / (1024.f * 1024.f), s.bytes / (1024.f * 1024.f), s.time_ms);
+
+        if(stats != nullptr)
+            *stats = s;
+        return true;
+    }
+
+    //============
+
+    std::string NormalizePath(const std::string& filepath) {
+        return std::filesystem::path(filepath).lexically_normal().generic_string();
+    }
+
+    const PackEntry* FindEntry(const std::string& filepath, int type) {
+        if(!IsMounted())
+            return nullptr;
+
+        auto it = pack.lookup.find(NormalizePath(filepath));
+        if(it == pack.lookup.end() || it->second->type != uint32_t(type))
+            return nullptr;
+        return it->second;
+    }
+
+    bool ReadEntry(const PackEntry& entry, std::vector<uint8_t>& out) {
+        const uint8_t* data = pack.file.data + entry.offset;
+        out.resize(size_t(entry.raw_size));
+
+        if(!HAS_FLAG(entry.flags, EntryFlags::COMPRESSED)) {
+            if(entry.stored_size != entry.raw_size)
+                return false;
+            memcpy(out.data(), data, out.size());
+            return true;
+        }
+
+        return LZ::Decompress(data, size_t(entry.stored_size), out.data(), out.size());
+    }
+
+    bool IsLittleEndian() {
+        uint32_t v = 1;
+        return *(const uint8_t*)&v == 1;
+    }
+
+    //===== MappedFile =====
+
+#ifdef _WIN32
+    bool MappedFile::Open(const std::string& filepath) {
+        file = CreateFileA(filepath.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+        if(file == INVALID_HANDLE_VALUE)
+            return false;
+
+        LARGE_INTEGER file_size;
+        if(!GetFileSizeEx(file, &file_size) || file_size.QuadPart == 0) {
+            Close();
+            return false;
+        }
+
+        mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+        if(mapping == NULL) {
+            Close();
+            return false;
+        }
+
+        data = (const uint8_t*)MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+        if(data == nullptr) {
+            Close();
+            return false;
+        }
+        size = size_t(file_size.QuadPart);
+        return true;
+    }
+
+    void MappedFile::Close() {
+        if(data != nullptr)
+            UnmapViewOfFile(data);
+        if(mapping != NULL)
+            CloseHandle(mapping);
+        if(file != INVALID_HANDLE_VALUE)
+            CloseHandle(file);
+        data = nullptr;
+        size = 0;
+        mapping = NULL;
+        file = INVALID_HANDLE_VALUE;
+    }
+#else
+    bool MappedFile::Open(const std::string& filepath) {
+        int fd = open(filepath.c_str(), O_RDONLY);
+        if(fd < 0)
+            return false;
+
+        struct stat st;
+        if(fstat(fd, &st) != 0 || st.st_size == 0) {
+            close(fd);
+            return false;
+        }
+
+        //mapping stays valid after the descriptor is closed
+        void* ptr = mmap(nullptr, size_t(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+        close(fd);
+        if(ptr == MAP_FAILED)
+            return false;
+
+        data = (const uint8_t*)ptr;
+        size = size_t(st.st_size);
+        return true;
+    }
+
+    void MappedFile::Close() {
+        if(data != nullptr)
+            munmap((void*)data, size);
+        data = nullptr;
+        size = 0;
+    }
+#endif
+
+}//namespace eng::AssetPack
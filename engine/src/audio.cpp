@@ -19,6 +19,29 @@ namespace eng {
 
     namespace Audio {
 
+#ifdef ENGINE_HEADLESS
+        //headless build - audio is compiled out, all the calls are no-ops
+
+        void Initialize() {}
+        void Release() {}
+
+        bool Play(const std::string& path) { return true; }
+        bool Play(const std::string& path, const glm::vec2& position) { return true; }
+        bool PlayMusic(const std::string& path) { return true; }
+
+        void UpdateListenerPosition(const glm::vec2& position) {}
+
+        void Enabled(bool enabled) {
+            Config::Audio().enabled = enabled;
+        }
+
+        void SetVolume_Master(float volume) {}
+        void SetVolume_Music(float volume) {}
+        void SetVolume_Digital(float volume) {}
+
+        void DBG_GUI() {}
+
+#else
         ma_sound* FetchFreeSoundObject();
 
         struct InternalAudioData {
@@ -209,6 +232,7 @@ namespace eng {
             ENG_LOG_FINEST("SoundPool - inserting new sound ({})", data.soundPool.size());
             return &data.soundPool.back();
         }
+#endif
 
     }//namespace Audio
 
@@ -0,0 +1,142 @@
+#include "engine/game/autosave.h"
+
+#include "engine/game/level.h"
+#include "engine/game/config.h"
+
+#include "engine/utils/setup.h"
+#include "engine/utils/dbg_gui.h"
+#include "engine/utils/timer.h"
+
+#include <algorithm>
+#include <filesystem>
+
+#define AUTOSAVE_NAME "autosave.sav"
+
+namespace eng {
+
+    Autosave::~Autosave() {
+        Wait();
+    }
+
+    void Autosave::Update(Level& level, const std::string& filepath) {
+        float seconds = (interval >= 0.f) ? interval : Config::AutosaveInterval();
+        if(seconds <= 0.f || !level.initialized)
+            return;
+
+        //measured in ticks - game time, doesn't advance while paused
+        tick_t now = SimClock::Now();
+        if(now < last_tick)
+            last_tick = now;
+        if(float(now - last_tick) * SimClock::DeltaTime() < seconds || running)
+            return;
+
+        Trigger(level, filepath);
+    }
+
+    bool Autosave::Trigger(Level& level, const std::string& filepath_) {
+        if(running) {
+            ENG_LOG_TRACE("Autosave - previous save still in progress, skipping.");
+            return false;
+        }
+        if(worker.joinable())
+            worker.join();
+
+        std::string filepath = filepath_.empty() ? DefaultPath() : filepath_;
+        last_tick = SimClock::Now();
+
+        //the only part, that runs on the main thread
+        Timer t = {};
+        LevelSnapshot snapshot = level.Snapshot();
+        float snapshot_ms = t.TimeElapsed<Timer::us>() * 1e-3f;
+        {
+            std::lock_guard<std::mutex> lock(stats_mutex);
+            stats.snapshot_ms = snapshot_ms;
+            stats.snapshot_ms_max = std::max(stats.snapshot_ms_max, snapshot_ms);
+        }
+
+        running = true;
+        worker = std::thread([this, snapshot = std::move(snapshot), filepath]() mutable {
+            BackgroundSave(std::move(snapshot), filepath);
+        });
+        return true;
+    }
+
+    void Autosave::Wait() {
+        if(worker.joinable())
+            worker.join();
+    }
+
+    void Autosave::Reset() {
+        Wait();
+        last_tick = SimClock::Now();
+    }
+
+    AutosaveStats Autosave::Stats() {
+        std::lock_guard<std::mutex> lock(stats_mutex);
+        return stats;
+    }
+
+    std::string Autosave::DefaultPath() {
+        return Config::Saves::FullPath(AUTOSAVE_NAME);
+    }
+
+    void Autosave::DBG_GUI() {
+#ifdef ENGINE_ENABLE_GUI
+        ImGui::Begin("Autosave");
+
+        AutosaveStats s = Stats();
+        float seconds = (interval >= 0.f) ? interval : Config::AutosaveInterval();
+        float elapsed = float(SimClock::Now() - last_tick) * SimClock::DeltaTime();
+
+        if(seconds > 0.f)
+            ImGui::Text("Interval: %.0fs (next in %.0fs)", seconds, std::max(seconds - elapsed, 0.f));
+        else
+            ImGui::Text("Interval: disabled");
+        ImGui::Text("State: %s", running ? "saving" : "idle");
+        ImGui::Separator();
+        ImGui::Text("Saves: %d (%d failed)", s.count, s.failed);
+        ImGui::Text("Snapshot (main thread): %.2fms (max %.2fms)", s.snapshot_ms, s.snapshot_ms_max);
+        ImGui::Text("Save (background): %.2fms", s.save_ms);
+        ImGui::Text("Size: %.1fkB", s.bytes / 1024.f);
+
+        ImGui::End();
+#endif
+    }
+
+    void Autosave::BackgroundSave(LevelSnapshot&& snapshot, const std::string& filepath) {
+        //write into a temporary file first - autosave is only replaced once the new one is complete
+        std::string tmp_filepath = filepath + ".tmp";
+
+        Timer t = {};
+        bool success = true;
+        long long bytes = 0;
+        try {
+            snapshot.SaveBinary(tmp_filepath);
+            bytes = (long long)std::filesystem::file_size(tmp_filepath);
+            std::filesystem::rename(tmp_filepath, filepath);
+        }
+        catch(std::exception& e) {
+            ENG_LOG_WARN("Autosave - failed to store the level as '{}' ({}).", filepath, e.what());
+            std::error_code ec;
+            std::filesystem::remove(tmp_filepath, ec);
+            success = false;
+        }
+        float save_ms = t.TimeElapsed<Timer::us>() * 1e-3f;
+
+        {
+            std::lock_guard<std::mutex> lock(stats_mutex);
+            if(success) {
+                stats.save_ms = save_ms;
+                stats.bytes = bytes;
+                stats.count++;
+            }
+            else {
+                stats.failed++;
+            }
+        }
+        if(success)
+            ENG_LOG_TRACE("Autosave - stored as '{}' ({:.2f}ms, {} bytes).", filepath, save_ms, bytes);
+        running = false;
+    }
+
+}//namespace eng
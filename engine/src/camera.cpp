@@ -100,7 +100,7 @@ namespace eng {
     }
 
     void Camera::UpdateMultiplier(const glm::vec2& aspect) {
-        mult = Window::Get().Aspect() * zoom;
+        mult = aspect * zoom;
     }
 
     std::pair<glm::ivec2, glm::ivec2> Camera::RectangleCoords() const {
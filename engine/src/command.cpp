@@ -1,6 +1,5 @@
 #include "engine/game/command.h"
 
-#include "engine/core/input.h"
 #include "engine/game/level.h"
 #include "engine/core/audio.h"
 #include "engine/game/config.h"
@@ -159,6 +158,21 @@ static bool cmd_switching = true;
     void BuildingAction_TrainOrResearch(Building& src, Level& level, BuildingAction& action);
     void BuildingAction_ConstructOrUpgrade(Building& src, Level& level, BuildingAction& action);
 
+    //=============================
+
+    /* PLANNED QUERIES:
+        - with parallel object update, units first precompute their map queries (target search, pathfinding) against the map state from the start of the tick
+        - command handlers go through these wrappers - precomputed result is used if it matches the query, otherwise the map is queried directly
+        - stale results are fine - move actions validate each tile before claiming it (unit waits or repaths when the tile got taken in the meantime)
+    */
+
+    bool Query_SearchForTarget(const Unit& src, Level& level, NavQuery& query, int range, ObjectID& out_targetID, glm::ivec2& out_targetPos);
+    glm::ivec2 Query_NextPosition(const Unit& src, Level& level, NavQuery& query, const glm::ivec2& target_pos);
+    glm::ivec2 Query_NextPosition_Range(const Unit& src, Level& level, NavQuery& query, const glm::ivec2& m, const glm::ivec2& M, int distance = -1);
+
+    //Predicts whether unit's current action finishes during this tick's update (only idle & move actions are predicted).
+    bool Action_Finishing(const Unit& src, const Action& action);
+
 
     //===== Action =====
 
@@ -168,10 +182,11 @@ static bool cmd_switching = true;
         count = i = j = k = 0;
         b = c = false;
         t = 0.f;
+        tick = 0;
     }
 
     void Action::Data::DBG_Print() {
-        ENG_LOG_TRACE("i={}, j={}, k={}, b={}, c={}, t={}", i, j, k, b, c, t);
+        ENG_LOG_TRACE("i={}, j={}, k={}, b={}, c={}, t={}, tick={}", i, j, k, b, c, t, tick);
     }
 
     Action::Action() : logic(Action::Logic(ActionType::IDLE, IdleAction_Update, IdleAction_Signal)), data(Action::Data{}) {}
@@ -190,7 +205,6 @@ static bool cmd_switching = true;
         case ActionType::ACTION:
             logic.update = ActionAction_Update;
             logic.signal = ActionAction_Signal;
-            data.t = 0.f;       //contains time, could halt the action
             break;
         }
     }
@@ -298,8 +312,6 @@ static bool cmd_switching = true;
     void IdleAction_Signal(Unit& src, Action& action, int signal, int cmdType, int cmdType_prev) {}
 
     int MoveAction_Update(Unit& src, Level& level, Action& action) {
-        Input& input = Input::Get();
-
         //interpolation limits, based on whether the movement goes along the diagonal or not
         constexpr static float lim[2] = { 1.f, 1.41421f };
 
@@ -360,7 +372,7 @@ static bool cmd_switching = true;
         }
 
         //motion update tick
-        t += input.deltaTime * src.MoveSpeed_Real();
+        t += SimClock::DeltaTime() * src.MoveSpeed_Real();
         move_offset = (t/l) * glm::vec2(action.data.move_dir);
 
         return ACTION_INPROGRESS;
@@ -371,12 +383,11 @@ static bool cmd_switching = true;
     }
 
     int ActionAction_Update(Unit& src, Level& level, Action& action) {
-        Input& input = Input::Get();
         int& orientation = action.data.i;
         int payload_id = action.data.j;
         bool& delivered = action.data.b;
         bool& anim_ended = action.data.c;
-        float& action_stop_time = action.data.t;
+        tick_t& action_stop_tick = action.data.tick;
         //===========
 
         int action_result = ACTION_FINISHED_SUCCESS;
@@ -474,7 +485,7 @@ static bool cmd_switching = true;
         if(!anim_ended && src.AnimationFinished()) {
             anim_ended = true;
             //cooldown influenced by haste/slow buff
-            action_stop_time = input.GameTimeDelay((2.f - src.SpeedBuffValue()) * src.Cooldown());
+            action_stop_tick = SimClock::Delay((2.f - src.SpeedBuffValue()) * src.Cooldown());
         }
 
         if(orientation < 0)
@@ -485,7 +496,7 @@ static bool cmd_switching = true;
         src.ori() = orientation;
 
         //terminate action only once the cooldown is over
-        return (anim_ended && action_stop_time < (float)input.CurrentTime()) ? action_result : ACTION_INPROGRESS;
+        return (anim_ended && action_stop_tick < SimClock::Now()) ? action_result : ACTION_INPROGRESS;
     }
 
     void ActionAction_Signal(Unit& src, Action& action, int signal, int cmdType, int cmdType_prev) {
@@ -496,9 +507,47 @@ static bool cmd_switching = true;
 
     //=======================================
 
+    //===== NavQuery =====
+
+    NavQuery NavQuery::SearchForTarget(const Unit& src, Level& level, int range) {
+        NavQuery q = {};
+        q.type = NavQueryType::TARGET_SEARCH;
+        q.tick = SimClock::Now();
+        q.unit_pos = src.Position();
+        q.distance = range;
+        q.found = level.map.SearchForTarget(src, level.factions.Diplomacy(), range, q.target_id, &q.result);
+        return q;
+    }
+
+    NavQuery NavQuery::NextPosition(const Unit& src, Level& level, const glm::ivec2& target_pos) {
+        NavQuery q = {};
+        q.type = NavQueryType::NEXT_POSITION;
+        q.tick = SimClock::Now();
+        q.unit_pos = src.Position();
+        q.m = q.M = target_pos;
+        q.result = level.map.Pathfinding_NextPosition(src, target_pos);
+        return q;
+    }
+
+    NavQuery NavQuery::NextPosition_Range(const Unit& src, Level& level, const glm::ivec2& m, const glm::ivec2& M, int distance) {
+        NavQuery q = {};
+        q.type = NavQueryType::NEXT_POSITION_RANGE;
+        q.tick = SimClock::Now();
+        q.unit_pos = src.Position();
+        q.m = m;
+        q.M = M;
+        q.distance = distance;
+        q.result = level.map.Pathfinding_NextPosition_Range(src, m, M, distance);
+        return q;
+    }
+
+    bool NavQuery::Matches(int type_, const glm::ivec2& unit_pos_, const glm::ivec2& m_, const glm::ivec2& M_, int distance_) const {
+        return type == type_ && tick == SimClock::Now() && unit_pos == unit_pos_ && m == m_ && M == M_ && distance == distance_;
+    }
+
     //===== Command =====
 
-    Command::Command() : type(CommandType::IDLE), handler(CommandHandler_Idle), flag(0), t(0.f) {}
+    Command::Command() : type(CommandType::IDLE), handler(CommandHandler_Idle), flag(0), t(0) {}
 
     Command::Command(const Command::Entry& entry) {
         type = entry.type;
@@ -723,6 +772,38 @@ static bool cmd_switching = true;
         handler(src, level, *this, src.action);
     }
 
+    void Command::Plan(const Unit& src, Level& level) {
+        query = {};
+
+        switch(type) {
+            case CommandType::IDLE:
+                //periodical enemy scan
+                if(Command::SwitchingEnabled() && !src.PassiveMindset() && ((t + SimClock::Ticks(IDLE_COMMAND_TICK_PERIOD)) < SimClock::Now()))
+                    query = NavQuery::SearchForTarget(src, level, src.VisionRange());
+                break;
+            case CommandType::PATROL:
+                //enemy scan at every waypoint
+                if(Action_Finishing(src, src.action))
+                    query = NavQuery::SearchForTarget(src, level, src.VisionRange());
+                break;
+            case CommandType::MOVE:
+                if(Action_Finishing(src, src.action) && target_pos != src.Position())
+                    query = NavQuery::NextPosition(src, level, target_pos);
+                break;
+            case CommandType::ATTACK:
+            {
+                FactionObject* target = nullptr;
+                if(Action_Finishing(src, src.action) && target_id.type != ObjectType::MAP_OBJECT && target_id != src.OID() && level.objects.GetObject(target_id, target)) {
+                    glm::ivec2 m = glm::ivec2(target->MinPos());
+                    glm::ivec2 M = glm::ivec2(target->MaxPos());
+                    if(src.AttackRange() < get_range(src.Position(), m, M))
+                        query = NavQuery::NextPosition_Range(src, level, m, M, src.AttackRange());
+                }
+                break;
+            }
+        }
+    }
+
     Command::Entry Command::Export() const {
         Command::Entry entry = {};
         entry.type = type;
@@ -734,7 +815,7 @@ static bool cmd_switching = true;
     }
 
     void Command::RandomizeIdleRotation() {
-        t = Random::Uniform() * IDLE_COMMAND_TICK_PERIOD;
+        t = tick_t(Random::Uniform() * SimClock::Ticks(IDLE_COMMAND_TICK_PERIOD));
     }
 
     std::string Command::to_string() const {
@@ -791,17 +872,17 @@ static bool cmd_switching = true;
         }
 
         //periodically idle update
-        if(((cmd.t + IDLE_COMMAND_TICK_PERIOD) < Input::CurrentTime())) {
-            cmd.t = Input::CurrentTime();
+        if(((cmd.t + SimClock::Ticks(IDLE_COMMAND_TICK_PERIOD)) < SimClock::Now())) {
+            cmd.t = SimClock::Now();
 
             //scan for enemy units & attack (unless the unit has passive mindset)
             ObjectID targetID = ObjectID();
             glm::ivec2 targetPos = glm::ivec2(-1);
-            if(Command::SwitchingEnabled() && !src.PassiveMindset() && level.map.SearchForTarget(src, level.factions.Diplomacy(), src.VisionRange(), targetID, &targetPos)) {
+            if(Command::SwitchingEnabled() && !src.PassiveMindset() && Query_SearchForTarget(src, level, cmd.query, src.VisionRange(), targetID, targetPos)) {
                 //switch to attack command if enemy detected
                 ENG_LOG_TRACE("Idle Command - Enemy detected ({}), switching to attack.", targetID.to_string());
                 cmd = Command::Attack(targetID, targetPos);
-                cmd.t = Input::CurrentTime();
+                cmd.t = SimClock::Now();
                 return;
             }
             else if(src.NavigationType() == NavigationBit::GROUND && !src.IsSiege() && Random::Uniform() < 0.2f) {
@@ -838,8 +919,8 @@ static bool cmd_switching = true;
         }
 
         //no target or unreachable -> scan for new targets (in periodical ticks, not every frame)
-        if(no_target && (cmd.t + IDLE_COMMAND_TICK_PERIOD < Input::CurrentTime())) {
-            cmd.t = Input::CurrentTime();
+        if(no_target && (cmd.t + SimClock::Ticks(IDLE_COMMAND_TICK_PERIOD) < SimClock::Now())) {
+            cmd.t = SimClock::Now();
 
             ObjectID targetID = ObjectID();
             glm::ivec2 targetPos = glm::ivec2(-1);
@@ -880,7 +961,7 @@ static bool cmd_switching = true;
             }
             else {
                 //consult navmesh - fetch next target position
-                glm::ivec2 target_pos = level.map.Pathfinding_NextPosition(src, cmd.target_pos);
+                glm::ivec2 target_pos = Query_NextPosition(src, level, cmd.query, cmd.target_pos);
                 if(target_pos == src.Position()) {
                     //target destination unreachable
                     cmd = Command::Idle();
@@ -942,7 +1023,7 @@ static bool cmd_switching = true;
             //range check & action issuing
             if(src.AttackRange() < get_range(src.Position(), pos_min, pos_max)) {
                 //range check failed -> lookup new possible location to attack from & start moving there
-                glm::ivec2 move_pos = level.map.Pathfinding_NextPosition_Range(src, pos_min, pos_max);
+                glm::ivec2 move_pos = Query_NextPosition_Range(src, level, cmd.query, pos_min, pos_max);
                 if(move_pos == src.Position()) {
                     //no reachable destination found
                     cmd = Command::Idle();
@@ -1061,7 +1142,7 @@ static bool cmd_switching = true;
         //scan the unit's vision range for enemy units
         ObjectID targetID = ObjectID();
         glm::ivec2 targetPos = glm::ivec2(-1);
-        if(level.map.SearchForTarget(src, level.factions.Diplomacy(), src.VisionRange(), targetID, &targetPos)) {
+        if(Query_SearchForTarget(src, level, cmd.query, src.VisionRange(), targetID, targetPos)) {
             //switch to attack command if enemy detected
             ENG_LOG_TRACE("Patrol Command - Enemy detected ({}), switching to attack.", targetID.to_string());
             cmd = Command::Attack(targetID, targetPos);
@@ -1077,7 +1158,7 @@ static bool cmd_switching = true;
         }
         
         //consult navmesh - fetch next target position
-        glm::ivec2 target_pos = level.map.Pathfinding_NextPosition(src, cmd.target_pos);
+        glm::ivec2 target_pos = Query_NextPosition(src, level, cmd.query, cmd.target_pos);
         if(target_pos == src.Position()) {
             //target destination unreachable
             cmd = Command::Idle();
@@ -1501,6 +1582,48 @@ static bool cmd_switching = true;
 
     //=======================================
 
+    bool Query_SearchForTarget(const Unit& src, Level& level, NavQuery& query, int range, ObjectID& out_targetID, glm::ivec2& out_targetPos) {
+        if(query.Matches(NavQueryType::TARGET_SEARCH, src.Position(), glm::ivec2(-1), glm::ivec2(-1), range)) {
+            query.type = NavQueryType::NONE;
+            if(query.found) {
+                out_targetID = query.target_id;
+                out_targetPos = query.result;
+            }
+            return query.found;
+        }
+        return level.map.SearchForTarget(src, level.factions.Diplomacy(), range, out_targetID, &out_targetPos);
+    }
+
+    glm::ivec2 Query_NextPosition(const Unit& src, Level& level, NavQuery& query, const glm::ivec2& target_pos) {
+        if(query.Matches(NavQueryType::NEXT_POSITION, src.Position(), target_pos, target_pos, 0)) {
+            query.type = NavQueryType::NONE;
+            return query.result;
+        }
+        return level.map.Pathfinding_NextPosition(src, target_pos);
+    }
+
+    glm::ivec2 Query_NextPosition_Range(const Unit& src, Level& level, NavQuery& query, const glm::ivec2& m, const glm::ivec2& M, int distance) {
+        if(distance < 0) distance = src.AttackRange();
+        if(query.Matches(NavQueryType::NEXT_POSITION_RANGE, src.Position(), m, M, distance)) {
+            query.type = NavQueryType::NONE;
+            return query.result;
+        }
+        return level.map.Pathfinding_NextPosition_Range(src, m, M, distance);
+    }
+
+    bool Action_Finishing(const Unit& src, const Action& action) {
+        switch(action.logic.type) {
+            case ActionType::IDLE:
+                return true;
+            case ActionType::MOVE:
+                return action.data.t >= 0.f && src.Position() == action.data.target_pos;
+            default:
+                return false;
+        }
+    }
+
+    //=======================================
+
     //===== BuildingAction =====
 
     BuildingAction::Logic::Logic(int type_, BuildingActionUpdateHandler handler_) : type(type_), update(handler_) {}
@@ -1636,8 +1759,7 @@ static bool cmd_switching = true;
         src.real_act() = BuildingAnimationType::IDLE;
         
         //=====
-        Input& input = Input::Get();
-        float& attack_tick = action.data.t1;
+        tick_t& attack_tick = action.data.tick;
         bool& engaged = action.data.flag;
         int& scan_counter = action.data.i;
         ObjectID& targetID = action.data.target_id;
@@ -1650,7 +1772,7 @@ static bool cmd_switching = true;
                 scan_counter = 0;
                 if(level.map.SearchForTarget(src, level.factions.Diplomacy(), src.AttackRange(), targetID)) {
                     engaged = true;
-                    attack_tick = (float)input.CurrentTime();
+                    attack_tick = SimClock::Now();
                     ENG_LOG_TRACE("BuildingAttack - Found target to attack.");
                 }
             }
@@ -1658,8 +1780,8 @@ static bool cmd_switching = true;
         }
         
         //attack timer tick
-        float attack_gap = src.AttackSpeed() / Config::GameSpeed();
-        if(attack_tick + attack_gap <= (float)Input::CurrentTime()) {
+        tick_t attack_gap = SimClock::Ticks(src.AttackSpeed());
+        if(attack_tick + attack_gap <= SimClock::Now()) {
             //validate the target or search for new one within range
             FactionObject* target;
             if(!level.objects.GetObject(targetID, target) || !src.RangeCheck(*target)) {
@@ -1688,13 +1810,12 @@ static bool cmd_switching = true;
                 }
 
                 //reset the attack timer
-                attack_tick = (float)input.CurrentTime();
+                attack_tick = SimClock::Now();
             }
         }
     }
 
     void BuildingAction_TrainOrResearch(Building& src, Level& level, BuildingAction& action) {
-        Input& input = Input::Get();
         float& progress = action.data.t1;
         float& prev_health = action.data.t2;
         bool is_training = action.data.flag;
@@ -1702,8 +1823,8 @@ static bool cmd_switching = true;
         float target = action.data.t3;
         //=====
 
-        //compute the uptick for this frame
-        float uptick = input.deltaTime * CONSTRUCTION_SPEED;
+        //compute the uptick for this tick
+        float uptick = SimClock::DeltaTime() * CONSTRUCTION_SPEED;
 
         //increment construction tracking as well as building health
         progress += uptick;
@@ -1717,7 +1838,6 @@ static bool cmd_switching = true;
     }
 
     void BuildingAction_ConstructOrUpgrade(Building& src, Level& level, BuildingAction& action) {
-        Input& input = Input::Get();
         float& progress = action.data.t1;
         float& prev_health = action.data.t2;
         int& next_tick = action.data.i;         //only for construction, for upgrade, it carries payloadID
@@ -1726,8 +1846,8 @@ static bool cmd_switching = true;
         action.data.t3 = target;        //displayed in debug messages
         //=====
 
-        //compute the uptick for this frame
-        float uptick = input.deltaTime * CONSTRUCTION_SPEED;
+        //compute the uptick for this tick
+        float uptick = SimClock::DeltaTime() * CONSTRUCTION_SPEED;
 
         //increment construction tracking as well as building health
         progress += uptick;
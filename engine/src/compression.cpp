@@ -0,0 +1,153 @@
+#include "engine/utils/compression.h"
+
+#include <algorithm>
+#include <cstring>
+
+#define LZ_HASH_BITS 14
+#define LZ_MIN_MATCH 4
+#define LZ_MAX_OFFSET 65535
+
+//Block layout - sequence of (token, literals, offset, match length extension):
+//  token:   u8 - upper 4 bits = literal count, lower 4 bits = match length - 4 (value 15 means the length continues in extra bytes)
+//  lengths: extra bytes are added to the 15 until a byte smaller than 255 is encountered
+//  offset:  u16 (little-endian) - distance to the match start (backwards from the current position)
+//Last sequence only contains literals (block ends after them).
+
+namespace eng::LZ {
+
+    void WriteLength(std::vector<uint8_t>& out, size_t length);
+    bool ReadLength(const uint8_t*& ip, const uint8_t* end, size_t& length);
+    void EmitSequence(std::vector<uint8_t>& out, const uint8_t* literals, size_t literal_count, size_t offset, size_t match_length);
+
+    uint32_t Read32(const uint8_t* p) {
+        uint32_t v;
+        memcpy(&v, p, sizeof(v));
+        return v;
+    }
+
+    uint32_t Hash(uint32_t v) {
+        return (v * 2654435761u) >> (32 - LZ_HASH_BITS);
+    }
+
+    //==================
+
+    std::vector<uint8_t> Compress(const uint8_t* data, size_t size) {
+        std::vector<uint8_t> out;
+        out.reserve(size / 2 + 16);
+
+        std::vector<int64_t> table(size_t(1) << LZ_HASH_BITS, -1);
+
+        size_t anchor = 0;
+        size_t i = 0;
+        while(i + LZ_MIN_MATCH <= size) {
+            uint32_t seq = Read32(data + i);
+            uint32_t h = Hash(seq);
+            int64_t candidate = table[h];
+            table[h] = int64_t(i);
+
+            if(candidate < 0 || i - size_t(candidate) > LZ_MAX_OFFSET || Read32(data + candidate) != seq) {
+                i++;
+                continue;
+            }
+
+            size_t length = LZ_MIN_MATCH;
+            while(i + length < size && data[candidate + length] == data[i + length])
+                length++;
+
+            EmitSequence(out, data + anchor, i - anchor, i - size_t(candidate), length);
+            i += length;
+            anchor = i;
+        }
+
+        //trailing literals
+        EmitSequence(out, data + anchor, size - anchor, 0, 0);
+        return out;
+    }
+
+    bool Decompress(const uint8_t* data, size_t size, uint8_t* out, size_t out_size) {
+        const uint8_t* ip = data;
+        const uint8_t* ip_end = data + size;
+        uint8_t* op = out;
+        uint8_t* op_end = out + out_size;
+
+        while(ip < ip_end) {
+            uint8_t token = *ip++;
+
+            //literals
+            size_t literal_count = token >> 4;
+            if(literal_count == 15 && !ReadLength(ip, ip_end, literal_count))
+                return false;
+            if(literal_count > size_t(ip_end - ip) || literal_count > size_t(op_end - op))
+                return false;
+            if(literal_count > 0)
+                memcpy(op, ip, literal_count);
+            ip += literal_count;
+            op += literal_count;
+
+            //last sequence has no match
+            if(ip == ip_end)
+                break;
+
+            //match
+            if(ip_end - ip < 2)
+                return false;
+            size_t offset = size_t(ip[0]) | (size_t(ip[1]) << 8);
+            ip += 2;
+
+            size_t match_length = token & 15;
+            if(match_length == 15 && !ReadLength(ip, ip_end, match_length))
+                return false;
+            match_length += LZ_MIN_MATCH;
+
+            if(offset == 0 || offset > size_t(op - out) || match_length > size_t(op_end - op))
+                return false;
+
+            //byte by byte - match can overlap with the output it's copying
+            const uint8_t* match = op - offset;
+            for(size_t k = 0; k < match_length; k++)
+                op[k] = match[k];
+            op += match_length;
+        }
+
+        return op == op_end;
+    }
+
+    //==================
+
+    void WriteLength(std::vector<uint8_t>& out, size_t length) {
+        while(length >= 255) {
+            out.push_back(255);
+            length -= 255;
+        }
+        out.push_back(uint8_t(length));
+    }
+
+    bool ReadLength(const uint8_t*& ip, const uint8_t* end, size_t& length) {
+        uint8_t b;
+        do {
+            if(ip >= end)
+                return false;
+            b = *ip++;
+            length += b;
+        } while(b == 255);
+        return true;
+    }
+
+    void EmitSequence(std::vector<uint8_t>& out, const uint8_t* literals, size_t literal_count, size_t offset, size_t match_length) {
+        size_t ml = (match_length >= LZ_MIN_MATCH) ? (match_length - LZ_MIN_MATCH) : 0;
+        uint8_t token = uint8_t((std::min(literal_count, size_t(15)) << 4) | std::min(ml, size_t(15)));
+        out.push_back(token);
+
+        if(literal_count >= 15)
+            WriteLength(out, literal_count - 15);
+        out.insert(out.end(), literals, literals + literal_count);
+
+        if(match_length >= LZ_MIN_MATCH) {
+            out.push_back(uint8_t(offset & 0xFF));
+            out.push_back(uint8_t(offset >> 8));
+            if(ml >= 15)
+                WriteLength(out, ml - 15);
+        }
+    }
+
+}//namespace eng::LZ
@@ -6,7 +6,10 @@
 #include "engine/utils/json.h"
 #include "engine/utils/utils.h"
 
+#include <algorithm>
+
 #define CONFIG_FILEPATH "res/game.config"
+#define SAVEFILE_EXTENSION ".sav"
 
 namespace eng::Config {
 
@@ -19,6 +22,7 @@ namespace eng::Config {
 
         bool fog_of_war = true;
         bool camera_panning = true;
+        float autosave_interval = 300.f;
         bool hack_map_reveal = false;
         bool hack_map_reveal_flag = false;
         bool hack_no_prices = false;
@@ -102,6 +106,7 @@ namespace eng::Config {
         ImGui::Text("Preferences");
 
         ImGui::Checkbox("Fog of War", &data.fog_of_war);
+        ImGui::SliderFloat("Autosave interval", &data.autosave_interval, 0.f, 1800.f, "%.0f s");
 
         ImGui::Separator();
         ImGui::Text("Hacks");
@@ -155,6 +160,10 @@ namespace eng::Config {
         return data.fog_of_war;
     }
 
+    float AutosaveInterval() {
+        return data.autosave_interval;
+    }
+
     bool CameraPanning() {
         return data.camera_panning;
     }
@@ -173,6 +182,12 @@ namespace eng::Config {
             SaveChanges();
     }
 
+    void UpdateAutosaveInterval(float seconds, bool save_changes) {
+        data.autosave_interval = std::max(seconds, 0.f);
+        if(save_changes)
+            SaveChanges();
+    }
+
     void UpdateCameraPanning(bool enabled) {
         data.camera_panning = enabled;
     }
@@ -209,10 +224,16 @@ namespace eng::Config {
             return false;
         }
 
+        bool is_savefile(const std::string& name) {
+            return string_ends_with(name, ".json") || string_ends_with(name, SAVEFILE_EXTENSION);
+        }
+
         std::string FullPath(const std::string& name, bool append_extension) {
             std::string res = DirPath() + name;
-            if(append_extension && !string_ends_with(name, ".json")) {
-                res += ".json";
+            if(append_extension && !is_savefile(name)) {
+                //older JSON saves keep their extension, new saves are stored as binary snapshots
+                bool json_exists = std::filesystem::exists(res + ".json") && !std::filesystem::exists(res + SAVEFILE_EXTENSION);
+                res += json_exists ? ".json" : SAVEFILE_EXTENSION;
             }
             return res;
         }
@@ -237,7 +258,7 @@ namespace eng::Config {
             std::vector<std::string> files;
             try {
                 for (const auto& entry : std::filesystem::directory_iterator(dir)) {
-                    if (entry.is_regular_file() && entry.path().extension() == ".json") {
+                    if (entry.is_regular_file() && is_savefile(entry.path().filename().string())) {
                         if(extract_names)
                             files.push_back(entry.path().stem().string());
                         else
@@ -248,6 +269,10 @@ namespace eng::Config {
                     ENG_LOG_ERROR("Failed to scan directory '{}' for files.", dir);
                     return {};
                 }
+
+            //same save can exist in both formats
+            std::sort(files.begin(), files.end());
+            files.erase(std::unique(files.begin(), files.end()), files.end());
                 
             return files;
         }
@@ -306,6 +331,7 @@ namespace eng::Config {
 
         if(config.count("fog_of_war"))      data.fog_of_war = config.at("fog_of_war");
         if(config.count("camera_panning"))  data.camera_panning = config.at("camera_panning");
+        if(config.count("autosave_interval"))   data.autosave_interval = config.at("autosave_interval");
 
         return data;
     }
@@ -329,6 +355,7 @@ namespace eng::Config {
         out["audio_rolloff"] = data.audio.outOfScreenRolloff;
 
         out["fog_of_war"] = data.fog_of_war;
+        out["autosave_interval"] = data.autosave_interval;
 
         return TryWriteFile(filepath, out.dump());
     }
@@ -3,6 +3,7 @@
 #include "engine/core/window.h"
 #include "engine/core/texture.h"
 #include "engine/utils/json.h"
+#include "engine/utils/asset_pack.h"
 #include "engine/utils/log.h"
 #include "engine/utils/utils.h"
 #include "engine/utils/mathdefs.h"
@@ -70,9 +71,10 @@ namespace eng {
     }
 
     void CursorIconManager::LoadFromConfig(const std::string& config_filepath) {
-        using json = nlohmann::json;
-
-        auto config = json::parse(ReadFile(config_filepath.c_str()));
+#ifdef ENGINE_HEADLESS
+        //no window to attach the cursors to
+#else
+        auto config = AssetPack::LoadJSON(config_filepath);
         for(auto& entry : config) {
             std::string filepath            = entry.at("filepath");
             glm::ivec2 icon_size_global     = eng::json::parse_ivec2(entry.at("icon_size"));
@@ -104,6 +106,7 @@ namespace eng {
                 icons.push_back(cursor);
             }
         }
+#endif
     }
 
 }//namespace eng
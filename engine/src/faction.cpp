@@ -795,6 +795,14 @@ namespace eng {
         }
     }
 
+    void Factions::FrameUpdate(Level& level) {
+        ASSERT_MSG(initialized, "Factions are not initialized properly!");
+
+        for(FactionControllerRef& faction : factions) {
+            faction->FrameUpdate(level);
+        }
+    }
+
     bool Factions::IsValidFaction(const FactionControllerRef& faction) const {
         const auto& pos = std::find(factions.begin(), factions.end(), faction);
         return (pos != factions.end());
@@ -10,6 +10,7 @@
 #include "engine/utils/randomness.h"
 #include "engine/core/audio.h"
 #include "engine/core/input.h"
+#include "engine/game/sim_clock.h"
 
 #include "engine/game/player_controller.h"
 
@@ -510,13 +511,20 @@ namespace eng {
             return;
         bool render_centered = (NavigationType() == NavigationBit::GROUND);
         float zOffset        = (NavigationType() == NavigationBit::AIR) ? (-1e-3f) : 0.f;
-        RenderAt(glm::vec2(Position()) + move_offset, data->size, data->scale, render_centered, zOffset);
+
+        //interpolate between the last two simulation ticks (skipped on discontinuous moves, such as spawning or unloading)
+        glm::vec2 pos = glm::vec2(Position()) + move_offset;
+        if(glm::length(pos - prev_position) < 2.f)
+            pos = glm::mix(prev_position, pos, SimClock::Get().Alpha());
+
+        RenderAt(pos, data->size, data->scale, render_centered, zOffset);
     }
 
     bool Unit::Update() {
         ASSERT_MSG(data != nullptr, "Unit isn't properly initialized!");
         if(!IsActive())
             return (Health() <= 0) || IsKilled();
+        prev_position = glm::vec2(Position()) + move_offset;
         command.Update(*this, *lvl());
         UpdateVariationIdx();
         ManaIncrement();
@@ -525,6 +533,11 @@ namespace eng {
         return (Health() <= 0) || IsKilled();
     }
 
+    void Unit::PlanUpdate() {
+        if(IsActive())
+            command.Plan(*this, *lvl());
+    }
+
     Unit::Entry Unit::Export() const {
         Unit::Entry entry = {};
 
@@ -810,7 +823,7 @@ namespace eng {
 
     void Unit::ManaIncrement() {
         if(IsCaster() || NumID()[1] == UnitType::KNIGHT) {
-            mana += Input::Get().deltaTime * UNIT_MANA_REGEN_SPEED;
+            mana += SimClock::DeltaTime() * UNIT_MANA_REGEN_SPEED;
             if(mana > 255.f)
                 mana = 255.f;
         }
@@ -818,7 +831,7 @@ namespace eng {
 
     void Unit::TrollRegeneration() {
         if(IsOrc() && NumID()[1] == UnitType::RANGER && Tech().GetResearch(ResearchType::LM_UNIQUE, true)) {
-            AddHealth(Input::Get().deltaTime * TROLL_REGENERATION_SPEED);
+            AddHealth(SimClock::DeltaTime() * TROLL_REGENERATION_SPEED);
         }
     }
 
@@ -1290,6 +1303,21 @@ namespace eng {
         live_data = entry.live_data;
         real_position = entry.real_position;
         m_real_size = entry.real_size;
+
+        //corpses - death animation index is resolved from the unit prefab
+        glm::ivec3 owner_id;
+        if(data->utility_id == UtilityObjectType::CORPSE && Resources::DeathAnimationOwner(live_data.i1, owner_id)) {
+            UnitDataRef owner = (entry.anim_owner.x >= 0) ? std::dynamic_pointer_cast<UnitData>(Resources::LoadObject(entry.anim_owner)) : nullptr;
+            if(owner != nullptr && owner->deathAnimIdx >= 0) {
+                live_data.i1 = owner->deathAnimIdx;
+                act() = live_data.i1;
+            }
+            else {
+                //savefile without the owner (animation index from the parsing order) -> skip to the next corpse animation
+                ENG_LOG_WARN("UtilityObject - corpse without a valid death animation owner ({}), skipping the death animation.", entry.anim_owner);
+                live_data.f1 = 0.f;
+            }
+        }
     }
 
     UtilityObject::~UtilityObject() {}
@@ -1318,6 +1346,10 @@ namespace eng {
         entry.real_position = real_position;
         entry.real_size = m_real_size;
 
+        glm::ivec3 owner_id;
+        if(data->utility_id == UtilityObjectType::CORPSE && Resources::DeathAnimationOwner(live_data.i1, owner_id))
+            entry.anim_owner = owner_id;
+
         return entry;
     }
 
@@ -2,62 +2,148 @@
 
 #include "engine/core/window.h"
 #include "engine/utils/dbg_gui.h"
+#include "engine/utils/compression.h"
+#include "engine/utils/jobs.h"
+#include "engine/utils/timer.h"
 
 #include <utility>
 #include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <thread>
 
 #define TEXTURE_MERGE_FREQUENCY 60
+#define RESIZE_REGENERATION_DELAY 10        //in frames - resize events come in bursts while the window's being dragged
+
+#define GENERATED_CACHE_DIR "res/generated"
+#define GENERATED_CACHE_MAGIC "TGEN"
+#define GENERATED_CACHE_VERSION 1           //bump whenever the generating code changes (invalidates the textures cached on disk)
 
 namespace eng {
 
     namespace TextureGenerator {
 
+        using SerializedParams = std::array<int32_t, 18>;
+
+        //CPU side of a generated texture - can be produced on any thread & stored on disk, GPU upload happens on the main thread.
+        struct GeneratedImage {
+            int width = 0;
+            int height = 0;
+            int channels = 0;       //3 or 4
+            std::string name;
+            std::vector<uint8_t> pixels;
+        public:
+            GeneratedImage() = default;
+            GeneratedImage(int width, int height, int channels, const void* data, const std::string& name);
+
+            bool Empty() const { return pixels.empty(); }
+            TextureRef Upload() const;
+        };
+
+        struct CacheEntry {
+            TextureRef texture = nullptr;
+            Params params;                              //params of the current texture contents (differ from the requested ones after a resize)
+            Params base_params;                         //params, as they were requested
+            glm::ivec2 base_window = glm::ivec2(0);     //window size at the time of the request
+            bool requested = false;                     //false for pre-generated textures, that weren't asked for yet
+            int revision = 0;                           //incremented on each regeneration, outdated background results are dropped
+        };
+
         struct TextureCache {
-            std::unordered_map<int, TextureRef> cache;
+            std::unordered_map<int, CacheEntry> cache;
             int invokation_count = 0;
             bool updated = true;
+
+            glm::ivec2 window_size = glm::ivec2(0);
+            int resize_frames = -1;                     //frames since the last resize event (-1 = nothing to regenerate)
+
+            std::atomic<int> generated_count = 0;
+            std::atomic<int> disk_count = 0;
+            int pregenerated_count = 0;
+            int regenerated_count = 0;
         public:
             bool Contains(int hash);
             TextureRef GetTexture(int hash);
-            TextureRef Add(int hash, const TextureRef& texture);
+            TextureRef Add(int hash, const Params& params, const TextureRef& texture, bool requested);
         };
 
         static TextureCache cache = {};
 
+        //Writes generated textures into the disk cache on a dedicated thread (started on demand, exits once the queue is empty).
+        //Job system isn't used - its threads participate in the simulation update & a blocking file write would stall whoever picks it up (same as Autosave).
+        struct DiskCacheWriter {
+            std::thread thread;
+            std::mutex mutex;
+            std::condition_variable done;
+            std::deque<std::pair<Params, GeneratedImage>> queue;
+            bool running = false;
+        public:
+            ~DiskCacheWriter() { Wait(); }
+
+            void Push(const Params& params, const GeneratedImage& image);
+
+            //Blocks until all the queued textures are written.
+            void Wait();
+        private:
+            void Loop();
+        };
+
+        static DiskCacheWriter writer = {};
+
+        GeneratedImage Generate(const Params& params);
+        GeneratedImage LoadOrGenerate(const Params& params);
+        void RegenerateForWindow(const glm::ivec2& window_size);
+        Params RescaleForWindow(const Params& base, const glm::ivec2& base_window, const glm::ivec2& window_size);
+        bool IsWindowDependent(int type);
+        glm::ivec2 CurrentWindowSize();
+
+        SerializedParams SerializeParams(const Params& params);
+        Params DeserializeParams(const SerializedParams& data);
+        std::string DiskCache_Path(int hash);
+        bool DiskCache_Load(const Params& params, GeneratedImage& out_image);
+        bool DiskCache_Store(const Params& params, const GeneratedImage& image);
+        std::vector<Params> DiskCache_LoadManifest();
+        void DiskCache_StoreManifest();
+
         //========== old API ==========
         
-        TextureRef ButtonTexture_Clear1(const Params& params);
-        TextureRef ButtonTexture_Clear2(const Params& params);
-        TextureRef ButtonTexture_Clear3(const Params& params);
-        TextureRef ButtonTexture_Clear_2borders(const Params& params);
-        TextureRef ButtonTexture_Clear_3borders(const Params& params);
-        TextureRef ButtonTexture_Triangle(const Params& params);
-        TextureRef ButtonTexture_Gem(const Params& params);
-        TextureRef ButtonTexture_Gem2(const Params& params);
-        TextureRef ButtonHighlightTexture(const Params& params);
-        TextureRef ShadowsTexture(const Params& params);
-        TextureRef OcclusionTileset(const Params& params);
+        GeneratedImage ButtonTexture_Clear1(const Params& params);
+        GeneratedImage ButtonTexture_Clear2(const Params& params);
+        GeneratedImage ButtonTexture_Clear3(const Params& params);
+        GeneratedImage ButtonTexture_Clear_2borders(const Params& params);
+        GeneratedImage ButtonTexture_Clear_3borders(const Params& params);
+        GeneratedImage ButtonTexture_Triangle(const Params& params);
+        GeneratedImage ButtonTexture_Gem(const Params& params);
+        GeneratedImage ButtonTexture_Gem2(const Params& params);
+        GeneratedImage ButtonHighlightTexture(const Params& params);
+        GeneratedImage ShadowsTexture(const Params& params);
+        GeneratedImage OcclusionTileset(const Params& params);
 
         //==============================
 
         //Creates a very basic button texture (plain color, borders & simple shading).
-        TextureRef ButtonTexture_Clear(int width, int height, int borderWidth, int shadingWidth, int channel, bool flipShading);
-        TextureRef ButtonTexture_Clear(int width, int height, int bw, int sw, const rgb& fill, const rgb& border, const rgb& light, const rgb& shadow);
-        TextureRef ButtonTexture_Clear(int width, int height, int bw, int sw, const rgba& fill, const rgba& border, const rgba& light, const rgba& shadow);
-        TextureRef ButtonTexture_Clear_2borders(int width, int height, int bw, int sw, const rgb& fill, const rgb& border, const rgb& light, const rgb& shadow, const rgb& b2, int b2w);
-        TextureRef ButtonTexture_Clear_3borders(int width, int height, int bw, int sw, const rgb& fill, const rgb& border, const rgb& light, const rgb& shadow, const rgb& b2, int b2w, const rgb& b3, int b3w);
-        TextureRef ButtonTexture_Triangle(int width, int height, int borderWidth, bool flipShading, bool up);
+        GeneratedImage ButtonTexture_Clear(int width, int height, int borderWidth, int shadingWidth, int channel, bool flipShading);
+        GeneratedImage ButtonTexture_Clear(int width, int height, int bw, int sw, const rgb& fill, const rgb& border, const rgb& light, const rgb& shadow);
+        GeneratedImage ButtonTexture_Clear(int width, int height, int bw, int sw, const rgba& fill, const rgba& border, const rgba& light, const rgba& shadow);
+        GeneratedImage ButtonTexture_Clear_2borders(int width, int height, int bw, int sw, const rgb& fill, const rgb& border, const rgb& light, const rgb& shadow, const rgb& b2, int b2w);
+        GeneratedImage ButtonTexture_Clear_3borders(int width, int height, int bw, int sw, const rgb& fill, const rgb& border, const rgb& light, const rgb& shadow, const rgb& b2, int b2w, const rgb& b3, int b3w);
+        GeneratedImage ButtonTexture_Triangle(int width, int height, int borderWidth, bool flipShading, bool up);
 
         //ratio is screen width/height - to make it a circle rather than ellipsoid
-        TextureRef ButtonTexture_Gem(int width, int height, int borderWidth, float ratio, const rgba& fillColor = rgba(71,0,0,255));
-        TextureRef ButtonTexture_Gem2(int width, int height, int borderWidth, float ratio, const rgba& clr1 = rgba(71,0,0,255), const rgba& clr2 = rgba(222,0,0,255));
+        GeneratedImage ButtonTexture_Gem(int width, int height, int borderWidth, float ratio, const rgba& fillColor = rgba(71,0,0,255));
+        GeneratedImage ButtonTexture_Gem2(int width, int height, int borderWidth, float ratio, const rgba& clr1 = rgba(71,0,0,255), const rgba& clr2 = rgba(222,0,0,255));
 
         //Yellow outline that marks selected button.
-        TextureRef ButtonHighlightTexture(int width, int height, int borderWidth);
-        TextureRef ButtonHighlightTexture(int width, int height, int borderWidth, const rgba& clr);
+        GeneratedImage ButtonHighlightTexture(int width, int height, int borderWidth);
+        GeneratedImage ButtonHighlightTexture(int width, int height, int borderWidth, const rgba& clr);
 
-        TextureRef ShadowsTexture(int width, int height, int size);
-        TextureRef OcclusionTileset(int tile_size, int block_size);
+        GeneratedImage ShadowsTexture(int width, int height, int size);
+        GeneratedImage OcclusionTileset(int tile_size, int block_size);
 
         //============ Params ==================
 
@@ -186,6 +272,12 @@ namespace eng {
         }
 
         void Clear() {
+            writer.Wait();
+#ifndef ENGINE_HEADLESS
+            //textures used during this session are pre-generated on the next launch
+            //(not in headless runs - benchmarks would overwrite the game's list with whatever they happened to touch)
+            DiskCache_StoreManifest();
+#endif
             cache.cache.clear();
         }
 
@@ -193,36 +285,79 @@ namespace eng {
             cache.invokation_count++;
 
             int hash = params.Hash();
-            if(cache.Contains(hash))
-                return cache.GetTexture(hash);
+            if(cache.Contains(hash)) {
+                CacheEntry& entry = cache.cache.at(hash);
+                if(!entry.requested) {
+                    entry.requested = true;
+                    entry.base_params = params;
+                    entry.base_window = CurrentWindowSize();
+                }
+                return entry.texture;
+            }
 
-            switch(params.type) {
-                case GeneratedTextureType::BUTTON1:
-                    return cache.Add(hash, ButtonTexture_Clear1(params));
-                case GeneratedTextureType::BUTTON2:
-                    return cache.Add(hash, ButtonTexture_Clear2(params));
-                case GeneratedTextureType::BUTTON3:
-                    return cache.Add(hash, ButtonTexture_Clear3(params));
-                case GeneratedTextureType::BUTTON_2BORDERS:
-                    return cache.Add(hash, ButtonTexture_Clear_2borders(params));
-                case GeneratedTextureType::BUTTON_3BORDERS:
-                    return cache.Add(hash, ButtonTexture_Clear_3borders(params));
-                case GeneratedTextureType::BUTTON_TRIANGLE:
-                    return cache.Add(hash, ButtonTexture_Triangle(params));
-                case GeneratedTextureType::BUTTON_GEM1:
-                    return cache.Add(hash, ButtonTexture_Gem(params));
-                case GeneratedTextureType::BUTTON_GEM2:
-                    return cache.Add(hash, ButtonTexture_Gem2(params));
-                case GeneratedTextureType::BUTTON_HIGHLIGHT:
-                    return cache.Add(hash, ButtonHighlightTexture(params)); 
-                case GeneratedTextureType::SHADOWS:
-                    return cache.Add(hash, ShadowsTexture(params));
-                case GeneratedTextureType::OCCLUSION:
-                    return cache.Add(hash, OcclusionTileset(params)); 
-                default:
-                    ENG_LOG_ERROR("TextureGenerator::GetTexture - invalid texture type ({})", params.type);
-                    throw std::runtime_error("");
+            GeneratedImage image = {};
+            if(DiskCache_Load(params, image)) {
+                cache.disk_count++;
             }
+            else {
+                image = Generate(params);
+                if(!image.Empty()) {
+                    //disk write doesn't need to hold up the caller
+                    writer.Push(params, image);
+                }
+            }
+
+            if(image.Empty())
+                return nullptr;
+            return cache.Add(hash, params, image.Upload(), true);
+        }
+
+        void Pregenerate() {
+            std::vector<Params> manifest = DiskCache_LoadManifest();
+            if(manifest.empty())
+                return;
+            Timer t = {};
+
+            //disk reads (or the generation itself, when the cached file is missing) run on the workers, GPU upload afterwards in one go
+            std::vector<GeneratedImage> images(manifest.size());
+            Jobs::Counter counter = {};
+            for(size_t i = 0; i < manifest.size(); i++) {
+                if(cache.Contains(manifest[i].Hash()))
+                    continue;
+                Jobs::Run([i, &manifest, &images]() {
+                    try {
+                        images[i] = LoadOrGenerate(manifest[i]);
+                    }
+                    catch(std::exception&) {
+                        //invalid manifest entry, skipped
+                    }
+                }, &counter);
+            }
+            Jobs::Wait(counter);
+
+            int count = 0;
+            for(size_t i = 0; i < manifest.size(); i++) {
+                if(!images[i].Empty() && !cache.Contains(manifest[i].Hash())) {
+                    cache.Add(manifest[i].Hash(), manifest[i], images[i].Upload(), false);
+                    count++;
+                }
+            }
+            cache.pregenerated_count += count;
+
+            ENG_LOG_TRACE("TextureGenerator::Pregenerate - {} textures ({} from disk, {} generated, {:.2f}ms)", count, cache.disk_count.load(), cache.generated_count.load(), t.TimeElapsed<Timer::us>() * 1e-3f);
+        }
+
+        void OnResize(int width, int height) {
+            cache.window_size = glm::ivec2(width, height);
+            cache.resize_frames = 0;
+        }
+
+        void Update() {
+            if(cache.resize_frames >= 0 && ++cache.resize_frames >= RESIZE_REGENERATION_DELAY) {
+                cache.resize_frames = -1;
+                RegenerateForWindow(cache.window_size);
+            }
+            TextureMergingUpdate();
         }
 
         void TextureMergingUpdate() {
@@ -241,8 +376,8 @@ namespace eng {
             ENG_LOG_INFO("TextureGenerator::Merge - new textures detected, merging.");
 
             std::vector<TextureRef> textures = {};
-            for(auto& [hash, tex] : cache.cache) {
-                textures.push_back(tex);
+            for(auto& [hash, entry] : cache.cache) {
+                textures.push_back(entry.texture);
             }
             Texture::MergeTextures(textures, GL_LINEAR);
             
@@ -254,71 +389,394 @@ namespace eng {
             ImGui::Begin("TextureGen");
             ImGui::Text("TextureGenerator count: %d", (int)TextureGenerator::Count());
             ImGui::Text("TextureGenerator invokations: %d", TextureGenerator::InvokationCount());
+            ImGui::Text("Generated: %d, from disk: %d, pre-generated: %d", cache.generated_count.load(), cache.disk_count.load(), cache.pregenerated_count);
+            ImGui::Text("Regenerated after resize: %d", cache.regenerated_count);
 
             if(cache.cache.size() > 0) {
-                cache.cache.begin()->second->DBG_GUI();
+                cache.cache.begin()->second.texture->DBG_GUI();
             }
             ImGui::End();
 #endif
         }
 
+        void DiskCacheWriter::Push(const Params& params, const GeneratedImage& image) {
+            std::lock_guard<std::mutex> lock(mutex);
+            queue.push_back({ params, image });
+            if(!running) {
+                //previous thread has already finished (it clears the flag right before exiting)
+                if(thread.joinable())
+                    thread.join();
+                running = true;
+                thread = std::thread([this]() { Loop(); });
+            }
+        }
+
+        void DiskCacheWriter::Wait() {
+            std::unique_lock<std::mutex> lock(mutex);
+            done.wait(lock, [this]() { return !running; });
+            if(thread.joinable())
+                thread.join();
+        }
+
+        void DiskCacheWriter::Loop() {
+            while(true) {
+                std::pair<Params, GeneratedImage> item;
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    if(queue.empty()) {
+                        running = false;
+                        done.notify_all();
+                        return;
+                    }
+                    item = std::move(queue.front());
+                    queue.pop_front();
+                }
+                DiskCache_Store(item.first, item.second);
+            }
+        }
+
         bool TextureCache::Contains(int hash) {
             return cache.count(hash);
         }
 
         TextureRef TextureCache::GetTexture(int hash) {
-            return cache.at(hash);
+            return cache.at(hash).texture;
         }
 
-        TextureRef TextureCache::Add(int hash, const TextureRef& texture) {
+        TextureRef TextureCache::Add(int hash, const Params& params, const TextureRef& texture, bool requested) {
             if(cache.count(hash))
                 ENG_LOG_WARN("TextureGenerator::Add - overriding an existing texture reference.");
-            cache.insert({ hash, texture });
+
+            CacheEntry entry = {};
+            entry.texture = texture;
+            entry.params = entry.base_params = params;
+            entry.base_window = CurrentWindowSize();
+            entry.requested = requested;
+            cache[hash] = entry;
+
             updated = false;
             return texture;
         }
 
-        TextureRef ButtonTexture_Clear1(const Params& params) {
+        //==============================
+
+        GeneratedImage::GeneratedImage(int width_, int height_, int channels_, const void* data, const std::string& name_)
+            : width(width_), height(height_), channels(channels_), name(name_) {
+            const uint8_t* bytes = (const uint8_t*)data;
+            pixels.assign(bytes, bytes + size_t(width) * height * channels);
+        }
+
+        TextureRef GeneratedImage::Upload() const {
+            return std::make_shared<Texture>(
+                TextureParams::CustomData(width, height, GL_RGBA, (channels == 4) ? GL_RGBA : GL_RGB, GL_UNSIGNED_BYTE),
+                (void*)pixels.data(),
+                name
+            );
+        }
+
+        GeneratedImage Generate(const Params& params) {
+            cache.generated_count++;
+            switch(params.type) {
+                case GeneratedTextureType::BUTTON1:
+                    return ButtonTexture_Clear1(params);
+                case GeneratedTextureType::BUTTON2:
+                    return ButtonTexture_Clear2(params);
+                case GeneratedTextureType::BUTTON3:
+                    return ButtonTexture_Clear3(params);
+                case GeneratedTextureType::BUTTON_2BORDERS:
+                    return ButtonTexture_Clear_2borders(params);
+                case GeneratedTextureType::BUTTON_3BORDERS:
+                    return ButtonTexture_Clear_3borders(params);
+                case GeneratedTextureType::BUTTON_TRIANGLE:
+                    return ButtonTexture_Triangle(params);
+                case GeneratedTextureType::BUTTON_GEM1:
+                    return ButtonTexture_Gem(params);
+                case GeneratedTextureType::BUTTON_GEM2:
+                    return ButtonTexture_Gem2(params);
+                case GeneratedTextureType::BUTTON_HIGHLIGHT:
+                    return ButtonHighlightTexture(params); 
+                case GeneratedTextureType::SHADOWS:
+                    return ShadowsTexture(params);
+                case GeneratedTextureType::OCCLUSION:
+                    return OcclusionTileset(params); 
+                default:
+                    ENG_LOG_ERROR("TextureGenerator::GetTexture - invalid texture type ({})", params.type);
+                    throw std::runtime_error("");
+            }
+        }
+
+        GeneratedImage LoadOrGenerate(const Params& params) {
+            GeneratedImage image = {};
+            if(DiskCache_Load(params, image)) {
+                cache.disk_count++;
+                return image;
+            }
+
+            image = Generate(params);
+            if(!image.Empty())
+                writer.Push(params, image);
+            return image;
+        }
+
+        void RegenerateForWindow(const glm::ivec2& window_size) {
+            if(window_size.x <= 0 || window_size.y <= 0)
+                return;
+
+            for(auto& [hash_, entry] : cache.cache) {
+                if(!entry.requested || !IsWindowDependent(entry.base_params.type) || entry.base_window.x <= 0 || entry.base_window.y <= 0)
+                    continue;
+
+                Params params = RescaleForWindow(entry.base_params, entry.base_window, window_size);
+                if(SerializeParams(params) == SerializeParams(entry.params))
+                    continue;
+                entry.params = params;
+                int revision = ++entry.revision;
+                int hash = hash_;
+
+                //old texture stays in use until the new one's uploaded (texture object is updated in place, so all the references see the change)
+                Jobs::Run([hash, params, revision]() {
+                    GeneratedImage image = {};
+                    try {
+                        image = LoadOrGenerate(params);
+                    }
+                    catch(std::exception&) {}
+
+                    Jobs::Run([hash, revision, image]() {
+                        auto it = cache.cache.find(hash);
+                        if(it == cache.cache.end() || it->second.revision != revision || image.Empty())
+                            return;
+                        *it->second.texture = std::move(*image.Upload());
+                        cache.regenerated_count++;
+                        cache.updated = false;
+                    }, nullptr, Jobs::Affinity::MAIN_THREAD);
+                });
+            }
+        }
+
+        Params RescaleForWindow(const Params& base, const glm::ivec2& base_window, const glm::ivec2& window_size) {
+            //GUI textures are sized relative to the window - follow the window's aspect ratio, while keeping the smaller side's resolution
+            //(borders are rescaled accordingly, so that they keep their on-screen thickness)
+            Params params = base;
+            glm::vec2 target = glm::vec2(base.size) * (glm::vec2(window_size) / glm::vec2(base_window));
+            float k = float(std::min(base.size.x, base.size.y)) / std::max(std::min(target.x, target.y), 1.f);
+            auto scale = [k](const glm::ivec2& v) { return glm::ivec2(glm::round(glm::vec2(v) * k)); };
+
+            params.size = glm::max(glm::ivec2(glm::round(target * k)), glm::ivec2(1));
+            params.borderSize = scale(base.borderSize);
+            params.shadingSize = scale(base.shadingSize);
+            params.w = scale(base.w);
+            if(base.type == GeneratedTextureType::BUTTON_GEM1 || base.type == GeneratedTextureType::BUTTON_GEM2)
+                params.ratio = float(window_size.x) / window_size.y;
+            return params;
+        }
+
+        bool IsWindowDependent(int type) {
+            return type != GeneratedTextureType::SHADOWS && type != GeneratedTextureType::OCCLUSION;
+        }
+
+        glm::ivec2 CurrentWindowSize() {
+            return (cache.window_size.x > 0) ? cache.window_size : Window::Get().Size();
+        }
+
+        //==============================
+
+        //Header of the cached texture file (followed by the name & LZ compressed pixels).
+        struct DiskCacheHeader {
+            char magic[4];
+            uint32_t version;
+            SerializedParams params;
+            int32_t width;
+            int32_t height;
+            int32_t channels;
+            uint32_t name_length;
+            uint32_t stored_size;
+        };
+
+        SerializedParams SerializeParams(const Params& p) {
+            int32_t ratio_bits;
+            memcpy(&ratio_bits, &p.ratio, sizeof(ratio_bits));
+
+            SerializedParams data = { p.type, p.size.x, p.size.y, p.borderSize.x, p.borderSize.y, p.shadingSize.x, p.shadingSize.y, p.channel, p.w.x, p.w.y, ratio_bits, p.flags };
+            for(size_t i = 0; i < p.colors.size(); i++) {
+                const glm::u8vec4& c = p.colors[i];
+                data[12 + i] = int32_t(uint32_t(c.r) | (uint32_t(c.g) << 8) | (uint32_t(c.b) << 16) | (uint32_t(c.a) << 24));
+            }
+            return data;
+        }
+
+        Params DeserializeParams(const SerializedParams& data) {
+            float ratio;
+            memcpy(&ratio, &data[10], sizeof(ratio));
+
+            Params::colorArray colors = {};
+            for(size_t i = 0; i < colors.size(); i++) {
+                uint32_t c = uint32_t(data[12 + i]);
+                colors[i] = glm::u8vec4(c & 0xFF, (c >> 8) & 0xFF, (c >> 16) & 0xFF, (c >> 24) & 0xFF);
+            }
+            return Params(data[0], glm::ivec2(data[1], data[2]), glm::ivec2(data[3], data[4]), glm::ivec2(data[5], data[6]), data[7], glm::ivec2(data[8], data[9]), ratio, data[11], colors);
+        }
+
+        std::string DiskCache_Path(int hash) {
+            char buf[64];
+            snprintf(buf, sizeof(buf), GENERATED_CACHE_DIR "/%08x.tex", uint32_t(hash));
+            return std::string(buf);
+        }
+
+        bool DiskCache_Load(const Params& params, GeneratedImage& out_image) {
+            std::ifstream file = std::ifstream(DiskCache_Path(params.Hash()), std::ios::binary);
+            if(!file.is_open())
+                return false;
+
+            //params are compared in full (hash collisions, stale files from older versions)
+            DiskCacheHeader header = {};
+            if(!file.read((char*)&header, sizeof(header)) || memcmp(header.magic, GENERATED_CACHE_MAGIC, 4) != 0 || header.version != GENERATED_CACHE_VERSION || header.params != SerializeParams(params))
+                return false;
+            if(header.width <= 0 || header.height <= 0 || (header.channels != 3 && header.channels != 4) || header.name_length > 256)
+                return false;
+
+            std::string name(header.name_length, '\0');
+            std::vector<uint8_t> stored(header.stored_size);
+            if(!file.read(name.data(), header.name_length) || !file.read((char*)stored.data(), stored.size()))
+                return false;
+
+            out_image.width = header.width;
+            out_image.height = header.height;
+            out_image.channels = header.channels;
+            out_image.name = name;
+            out_image.pixels.resize(size_t(header.width) * header.height * header.channels);
+            if(!LZ::Decompress(stored.data(), stored.size(), out_image.pixels.data(), out_image.pixels.size())) {
+                ENG_LOG_DEBUG("TextureGenerator - corrupted cache file '{}'.", DiskCache_Path(params.Hash()));
+                out_image = GeneratedImage();
+                return false;
+            }
+            return true;
+        }
+
+        bool DiskCache_Store(const Params& params, const GeneratedImage& image) {
+            std::error_code ec;
+            std::filesystem::create_directories(GENERATED_CACHE_DIR, ec);
+
+            std::vector<uint8_t> stored = LZ::Compress(image.pixels.data(), image.pixels.size());
+
+            DiskCacheHeader header = {};
+            memcpy(header.magic, GENERATED_CACHE_MAGIC, 4);
+            header.version = GENERATED_CACHE_VERSION;
+            header.params = SerializeParams(params);
+            header.width = image.width;
+            header.height = image.height;
+            header.channels = image.channels;
+            header.name_length = uint32_t(image.name.size());
+            header.stored_size = uint32_t(stored.size());
+
+            //written under a unique name first - the same texture can be requested from multiple places at once
+            std::string filepath = DiskCache_Path(params.Hash());
+            std::string tmp_filepath = filepath + "." + std::to_string(std::hash<std::thread::id>{}(std::this_thread::get_id())) + ".tmp";
+            {
+                std::ofstream file = std::ofstream(tmp_filepath, std::ios::binary);
+                file.write((const char*)&header, sizeof(header));
+                file.write(image.name.data(), image.name.size());
+                file.write((const char*)stored.data(), stored.size());
+                if(!file) {
+                    ENG_LOG_DEBUG("TextureGenerator - failed to write '{}'.", tmp_filepath);
+                    file.close();
+                    std::filesystem::remove(tmp_filepath, ec);
+                    return false;
+                }
+            }
+            std::filesystem::rename(tmp_filepath, filepath, ec);
+            if(ec) {
+                std::filesystem::remove(tmp_filepath, ec);
+                return false;
+            }
+            return true;
+        }
+
+        std::vector<Params> DiskCache_LoadManifest() {
+            std::vector<Params> manifest = {};
+            std::ifstream file = std::ifstream(GENERATED_CACHE_DIR "/manifest", std::ios::binary);
+            if(!file.is_open())
+                return manifest;
+
+            char magic[4];
+            uint32_t version = 0, count = 0;
+            if(!file.read(magic, 4) || memcmp(magic, GENERATED_CACHE_MAGIC, 4) != 0 || !file.read((char*)&version, sizeof(version)) || version != GENERATED_CACHE_VERSION || !file.read((char*)&count, sizeof(count)))
+                return manifest;
+
+            SerializedParams data;
+            for(uint32_t i = 0; i < count && file.read((char*)data.data(), sizeof(data)); i++) {
+                manifest.push_back(DeserializeParams(data));
+            }
+            return manifest;
+        }
+
+        void DiskCache_StoreManifest() {
+            //only the textures that were actually used (the pre-generated ones, that nobody asked for, are dropped)
+            std::vector<SerializedParams> entries = {};
+            for(auto& [hash, entry] : cache.cache) {
+                if(entry.requested)
+                    entries.push_back(SerializeParams(entry.base_params));
+            }
+            if(entries.empty())
+                return;
+
+            std::error_code ec;
+            std::filesystem::create_directories(GENERATED_CACHE_DIR, ec);
+
+            std::ofstream file = std::ofstream(GENERATED_CACHE_DIR "/manifest", std::ios::binary);
+            if(!file.is_open())
+                return;
+            uint32_t version = GENERATED_CACHE_VERSION;
+            uint32_t count = uint32_t(entries.size());
+            file.write(GENERATED_CACHE_MAGIC, 4);
+            file.write((const char*)&version, sizeof(version));
+            file.write((const char*)&count, sizeof(count));
+            for(const SerializedParams& data : entries)
+                file.write((const char*)data.data(), sizeof(data));
+        }
+
+        //==============================
+
+        GeneratedImage ButtonTexture_Clear1(const Params& params) {
             return ButtonTexture_Clear(params.size.x, params.size.y, params.borderSize.x, params.shadingSize.x, params.channel, params.flags & GeneratedTextureFlags::FLIP_SHADING);
         }
 
-        TextureRef ButtonTexture_Clear2(const Params& params) {
+        GeneratedImage ButtonTexture_Clear2(const Params& params) {
             return ButtonTexture_Clear(params.size.x, params.size.y, params.borderSize.x, params.shadingSize.x, (rgb)params.colors[0], (rgb)params.colors[1], (rgb)params.colors[2], (rgb)params.colors[3]);
         }
 
-        TextureRef ButtonTexture_Clear3(const Params& params) {
+        GeneratedImage ButtonTexture_Clear3(const Params& params) {
             return ButtonTexture_Clear(params.size.x, params.size.y, params.borderSize.x, params.shadingSize.x, params.colors[0], params.colors[1], params.colors[2], params.colors[3]);
         }
 
-        TextureRef ButtonTexture_Clear_2borders(const Params& params) {
+        GeneratedImage ButtonTexture_Clear_2borders(const Params& params) {
             return ButtonTexture_Clear_2borders(params.size.x, params.size.y, params.borderSize.x, params.shadingSize.x, params.colors[0], params.colors[1], params.colors[2], params.colors[3], params.colors[4], params.w[0]);
         }
 
-        TextureRef ButtonTexture_Clear_3borders(const Params& params) {
+        GeneratedImage ButtonTexture_Clear_3borders(const Params& params) {
             return ButtonTexture_Clear_3borders(params.size.x, params.size.y, params.borderSize.x, params.shadingSize.x, params.colors[0], params.colors[1], params.colors[2], params.colors[3], params.colors[4], params.w[0], params.colors[5], params.w[1]);
         }
 
-        TextureRef ButtonTexture_Triangle(const Params& params) {
+        GeneratedImage ButtonTexture_Triangle(const Params& params) {
             return ButtonTexture_Triangle(params.size.x, params.size.y, params.borderSize.x, params.flags & GeneratedTextureFlags::FLIP_SHADING, params.flags & GeneratedTextureFlags::UP);
         }
 
-        TextureRef ButtonTexture_Gem(const Params& params) {
+        GeneratedImage ButtonTexture_Gem(const Params& params) {
             return ButtonTexture_Gem(params.size.x, params.size.y, params.borderSize.x, params.ratio, params.colors[0]);
         }
 
-        TextureRef ButtonTexture_Gem2(const Params& params) {
+        GeneratedImage ButtonTexture_Gem2(const Params& params) {
             return ButtonTexture_Gem2(params.size.x, params.size.y, params.borderSize.x, params.ratio, params.colors[0], params.colors[1]);
         }
         
-        TextureRef ButtonHighlightTexture(const Params& params) {
+        GeneratedImage ButtonHighlightTexture(const Params& params) {
             return ButtonHighlightTexture(params.size.x, params.size.y, params.borderSize.x, params.colors[0]);
         }
 
-        TextureRef ShadowsTexture(const Params& params) {
+        GeneratedImage ShadowsTexture(const Params& params) {
             return ShadowsTexture(params.size.x, params.size.y, params.channel);
         }
 
-        TextureRef OcclusionTileset(const Params& params) {
+        GeneratedImage OcclusionTileset(const Params& params) {
             return OcclusionTileset(params.size.x, params.size.y);
         }
 
@@ -341,10 +799,10 @@ namespace eng {
 
         //========================================
 
-        TextureRef ButtonTexture_Clear(int width, int height, int bw, int sw, int channel, bool flipShading) {
+        GeneratedImage ButtonTexture_Clear(int width, int height, int bw, int sw, int channel, bool flipShading) {
             if(((unsigned int)channel) > 3) {
                 ENG_LOG_ERROR("TextureGenerator - valid channel values are only 0,1,2 (rgb channels)");
-                return nullptr;
+                return GeneratedImage();
             }
             
             rgb* data = new rgb[width * height];
@@ -357,16 +815,12 @@ namespace eng {
             const char* c = "rgb";
             snprintf(buf, sizeof(buf), "btnTex_clear_%c%s", c[channel], flipShading ? "_flip" : "");
 
-            TextureRef texture = std::make_shared<Texture>(
-                TextureParams::CustomData(width, height, GL_RGBA, GL_RGB, GL_UNSIGNED_BYTE),
-                (void*)data,
-                std::string(buf)
-            );
+            GeneratedImage image = GeneratedImage(width, height, 3, data, std::string(buf));
             delete[] data;
-            return texture;
+            return image;
         }
 
-        TextureRef ButtonTexture_Clear(int width, int height, int bw, int sw, const rgb& fill, const rgb& border, const rgb& light, const rgb& shadow) {
+        GeneratedImage ButtonTexture_Clear(int width, int height, int bw, int sw, const rgb& fill, const rgb& border, const rgb& light, const rgb& shadow) {
             rgb* data = new rgb[width * height];
 
             basicButton2(data, width, height, bw, sw, fill, border, light, shadow);
@@ -376,16 +830,12 @@ namespace eng {
             char buf[256];
             snprintf(buf, sizeof(buf), "btnTex_clear2_0x%02X%02X%02X", fill.r, fill.g, fill.b);
 
-            TextureRef texture = std::make_shared<Texture>(
-                TextureParams::CustomData(width, height, GL_RGBA, GL_RGB, GL_UNSIGNED_BYTE),
-                (void*)data,
-                std::string(buf)
-            );
+            GeneratedImage image = GeneratedImage(width, height, 3, data, std::string(buf));
             delete[] data;
-            return texture;
+            return image;
         }
 
-        TextureRef ButtonTexture_Clear(int width, int height, int bw, int sw, const rgba& fill, const rgba& border, const rgba& light, const rgba& shadow) {
+        GeneratedImage ButtonTexture_Clear(int width, int height, int bw, int sw, const rgba& fill, const rgba& border, const rgba& light, const rgba& shadow) {
             rgba* data = new rgba[width * height];
 
             basicButton2(data, width, height, bw, sw, fill, border, light, shadow);
@@ -395,16 +845,12 @@ namespace eng {
             char buf[256];
             snprintf(buf, sizeof(buf), "btnTex_clear2_0x%02X%02X%02X", fill.r, fill.g, fill.b);
 
-            TextureRef texture = std::make_shared<Texture>(
-                TextureParams::CustomData(width, height, GL_RGBA, GL_RGBA, GL_UNSIGNED_BYTE),
-                (void*)data,
-                std::string(buf)
-            );
+            GeneratedImage image = GeneratedImage(width, height, 4, data, std::string(buf));
             delete[] data;
-            return texture;
+            return image;
         }
 
-        TextureRef ButtonTexture_Clear_2borders(int width, int height, int bw, int sw, const rgb& fill, const rgb& border, const rgb& light, const rgb& shadow, const rgb& b2, int b2w) {
+        GeneratedImage ButtonTexture_Clear_2borders(int width, int height, int bw, int sw, const rgb& fill, const rgb& border, const rgb& light, const rgb& shadow, const rgb& b2, int b2w) {
             rgb* data = new rgb[width * height];
 
             basicButton3(data, width, height, bw, sw, fill, border, light, shadow, b2, b2w);
@@ -414,16 +860,12 @@ namespace eng {
             char buf[256];
             snprintf(buf, sizeof(buf), "btnTex_clear2_0x%02X%02X%02X", fill.r, fill.g, fill.b);
 
-            TextureRef texture = std::make_shared<Texture>(
-                TextureParams::CustomData(width, height, GL_RGBA, GL_RGB, GL_UNSIGNED_BYTE),
-                (void*)data,
-                std::string(buf)
-            );
+            GeneratedImage image = GeneratedImage(width, height, 3, data, std::string(buf));
             delete[] data;
-            return texture;
+            return image;
         }
 
-        TextureRef ButtonTexture_Clear_3borders(int width, int height, int bw, int sw, const rgb& fill, const rgb& border, const rgb& light, const rgb& shadow, const rgb& b2, int b2w, const rgb& b3, int b3w) {
+        GeneratedImage ButtonTexture_Clear_3borders(int width, int height, int bw, int sw, const rgb& fill, const rgb& border, const rgb& light, const rgb& shadow, const rgb& b2, int b2w, const rgb& b3, int b3w) {
             rgb* data = new rgb[width * height];
 
             basicButton3(data, width, height, bw, sw, fill, border, light, shadow, b2, b2w, b3, b3w);
@@ -433,16 +875,12 @@ namespace eng {
             char buf[256];
             snprintf(buf, sizeof(buf), "btnTex_clear2_0x%02X%02X%02X", fill.r, fill.g, fill.b);
 
-            TextureRef texture = std::make_shared<Texture>(
-                TextureParams::CustomData(width, height, GL_RGBA, GL_RGB, GL_UNSIGNED_BYTE),
-                (void*)data,
-                std::string(buf)
-            );
+            GeneratedImage image = GeneratedImage(width, height, 3, data, std::string(buf));
             delete[] data;
-            return texture;
+            return image;
         }
 
-        TextureRef ButtonTexture_Triangle(int width, int height, int borderWidth, bool flipShading, bool up) {
+        GeneratedImage ButtonTexture_Triangle(int width, int height, int borderWidth, bool flipShading, bool up) {
             rgb* data = new rgb[width * height];
 
             basicButton(data, width, height, 0, borderWidth, borderWidth*2, flipShading);
@@ -453,17 +891,12 @@ namespace eng {
             char buf[256];
             snprintf(buf, sizeof(buf), "btnTex_triangle_%s%s", up ? "up" : "down", flipShading ? "_flip" : "");
 
-            TextureRef texture = std::make_shared<Texture>(
-                TextureParams::CustomData(width, height, GL_RGBA, GL_RGB, GL_UNSIGNED_BYTE),
-                (void*)data,
-                std::string(buf)
-            );
-
+            GeneratedImage image = GeneratedImage(width, height, 3, data, std::string(buf));
             delete[] data;
-            return texture;
+            return image;
         }
 
-        TextureRef ButtonTexture_Gem(int width, int height, int borderWidth, float ratio, const rgba& clr) {
+        GeneratedImage ButtonTexture_Gem(int width, int height, int borderWidth, float ratio, const rgba& clr) {
             rgba* data = new rgba[width * height];
 
             fillColor<rgba>(data, width, height, rgba(0));
@@ -472,17 +905,12 @@ namespace eng {
 
             //--------------------------
 
-            TextureRef texture = std::make_shared<Texture>(
-                TextureParams::CustomData(width, height, GL_RGBA, GL_RGBA, GL_UNSIGNED_BYTE),
-                (void*)data,
-                std::string("btnTex_gem")
-            );
-
+            GeneratedImage image = GeneratedImage(width, height, 4, data, std::string("btnTex_gem"));
             delete[] data;
-            return texture;
+            return image;
         }
 
-        TextureRef ButtonTexture_Gem2(int width, int height, int borderWidth, float ratio, const rgba& clr1, const rgba& clr2) {
+        GeneratedImage ButtonTexture_Gem2(int width, int height, int borderWidth, float ratio, const rgba& clr1, const rgba& clr2) {
             rgba* data = new rgba[width * height];
 
             fillColor<rgba>(data, width, height, rgba(0));
@@ -491,21 +919,16 @@ namespace eng {
 
             //--------------------------
 
-            TextureRef texture = std::make_shared<Texture>(
-                TextureParams::CustomData(width, height, GL_RGBA, GL_RGBA, GL_UNSIGNED_BYTE),
-                (void*)data,
-                std::string("btnTex_gem")
-            );
-
+            GeneratedImage image = GeneratedImage(width, height, 4, data, std::string("btnTex_gem"));
             delete[] data;
-            return texture;
+            return image;
         }
 
-        TextureRef ButtonHighlightTexture(int width, int height, int bw) {
+        GeneratedImage ButtonHighlightTexture(int width, int height, int bw) {
             return ButtonHighlightTexture(width, height, bw, rgba(255, 255, 0, 255));
         }
 
-        TextureRef ButtonHighlightTexture(int width, int height, int bw, const rgba& highlight) {
+        GeneratedImage ButtonHighlightTexture(int width, int height, int bw, const rgba& highlight) {
             rgba* data = new rgba[width * height];
 
             rgba fill = rgba(255, 255, 255, 0);
@@ -537,17 +960,12 @@ namespace eng {
             char buf[256];
             snprintf(buf, sizeof(buf), "btnHighlightTex_%dx%d", width, height);
 
-            TextureRef texture = std::make_shared<Texture>(
-                TextureParams::CustomData(width, height, GL_RGBA, GL_RGBA, GL_UNSIGNED_BYTE),
-                (void*)data,
-                std::string(buf)
-            );
-
+            GeneratedImage image = GeneratedImage(width, height, 4, data, std::string(buf));
             delete[] data;
-            return texture;
+            return image;
         }
 
-        TextureRef ShadowsTexture(int width, int height, int size) {
+        GeneratedImage ShadowsTexture(int width, int height, int size) {
             rgba* data = new rgba[width * height];
             
             rgba clrs[2] = {
@@ -570,14 +988,9 @@ namespace eng {
             char buf[256];
             snprintf(buf, sizeof(buf), "shadowsTex_%dx%d", width, height);
 
-            TextureRef texture = std::make_shared<Texture>(
-                TextureParams::CustomData(width, height, GL_RGBA, GL_RGBA, GL_UNSIGNED_BYTE),
-                (void*)data,
-                std::string(buf)
-            );
-
+            GeneratedImage image = GeneratedImage(width, height, 4, data, std::string(buf));
             delete[] data;
-            return texture;
+            return image;
         }
 
         struct OcclusionVisuals {
@@ -594,7 +1007,7 @@ namespace eng {
             std::array<Circle, 2> circles;
         };
 
-        TextureRef OcclusionTileset(int tile_size, int block_size) {
+        GeneratedImage OcclusionTileset(int tile_size, int block_size) {
             //16 = possible tile corner combinations; 2 = occlusion & fog of war textures
             int rows = 2;
             int cols = 16;
@@ -658,14 +1071,9 @@ namespace eng {
 
             char buf[256];
             snprintf(buf, sizeof(buf), "occlusionsTex_%dx%d", tile_size * 16, tile_size * 2);
-            TextureRef texture = std::make_shared<Texture>(
-                TextureParams::CustomData(total_width, total_height, GL_RGBA, GL_RGBA, GL_UNSIGNED_BYTE),
-                (void*)data,
-                std::string(buf)
-            );
-
+            GeneratedImage image = GeneratedImage(total_width, total_height, 4, data, std::string(buf));
             delete[] data;
-            return texture;
+            return image;
         }
 
         //===============================
@@ -220,10 +220,9 @@ namespace eng::GUI {
     void TextLabel::InnerRender() {
         Element::InnerRender();
         ASSERT_MSG(style->font != nullptr, "GUI element with text has to have a font assigned.");
-        if(centered)
-            style->font->RenderTextCentered(text.c_str(), glm::vec2(position.x, -position.y), style->textScale, style->textColor, style->hoverColor, highlightIdx, Z_INDEX_BASE - zIdx * Z_INDEX_MULT - Z_TEXT_OFFSET);
-        else
-            style->font->RenderTextAlignLeft(text.c_str(), glm::vec2(position.x - size.x, -position.y), style->textScale, style->textColor, style->hoverColor, highlightIdx, Z_INDEX_BASE - zIdx * Z_INDEX_MULT - Z_TEXT_OFFSET);
+        layout.Update(style->font, text, style->textScale, centered ? TextAlign::Centered : TextAlign::Left);
+        glm::vec2 anchor = centered ? glm::vec2(position.x, -position.y) : glm::vec2(position.x - size.x, -position.y);
+        layout.Render(anchor, style->textColor, style->hoverColor, glm::ivec2(highlightIdx, highlightIdx+1), Z_INDEX_BASE - zIdx * Z_INDEX_MULT - Z_TEXT_OFFSET);
     }
 
     void TextLabel::Setup(const std::string& text_, int highlightIdx_, bool enable) {
@@ -928,7 +927,8 @@ namespace eng::GUI {
         Renderer::RenderQuad(Quad::FromCorner(glm::vec3(position.x - size.x + bs.x, -position.y - size.y + bs.y, Z_INDEX_BASE - zIdx * Z_INDEX_MULT - Z_TEXT_OFFSET), (size - bs) * 2.f * glm::vec2(value, 1.f), filler_clr, nullptr));
 
         //render the text
-        text_style->font->RenderTextCentered(text.c_str(), glm::vec2(position.x, -position.y), text_style->textScale, text_style->textColor, Z_INDEX_BASE - zIdx * Z_INDEX_MULT - 2.f*Z_TEXT_OFFSET);
+        layout.Update(text_style->font, text, text_style->textScale, TextAlign::Centered);
+        layout.Render(glm::vec2(position.x, -position.y), text_style->textColor, Z_INDEX_BASE - zIdx * Z_INDEX_MULT - 2.f*Z_TEXT_OFFSET);
     }
 
     //===== KeyValue =====
@@ -957,10 +957,8 @@ namespace eng::GUI {
     void KeyValue::InnerRender() {
         Element::InnerRender();
         ASSERT_MSG(style->font != nullptr, "GUI element with text has to have a font assigned.");
-        style->font->RenderTextKeyValue(text.c_str(), sep_pos, glm::vec2(position.x, -position.y), 
-            style->textScale, style->textColor, style->highlightColor, highlight_idx, 
-            Z_INDEX_BASE - zIdx * Z_INDEX_MULT - Z_TEXT_OFFSET
-        );
+        layout.Update(style->font, text, style->textScale, TextAlign::KeyValue, sep_pos);
+        layout.Render(glm::vec2(position.x, -position.y), style->textColor, style->highlightColor, highlight_idx, Z_INDEX_BASE - zIdx * Z_INDEX_MULT - Z_TEXT_OFFSET);
     }
 
     //===== ImageAndLabel =====
@@ -986,7 +984,8 @@ namespace eng::GUI {
         //position is at the center of icon's right border, icon is set to be square size
         sprite.Render(glm::vec3(position.x - 2*s, -position.y - s,  Z_INDEX_BASE - zIdx * Z_INDEX_MULT - Z_TEXT_OFFSET), glm::vec2(2.f * s), icon.y, icon.x);
 
-        style->font->RenderTextAlignLeft(text.c_str(), highlight_range, glm::vec2(position.x + s*0.5f, -position.y), style->textScale, style->textColor, style->highlightColor, Z_INDEX_BASE - zIdx * Z_INDEX_MULT - Z_TEXT_OFFSET);
+        layout.Update(style->font, text, style->textScale, TextAlign::Left);
+        layout.Render(glm::vec2(position.x + s*0.5f, -position.y), style->textColor, style->highlightColor, highlight_range, Z_INDEX_BASE - zIdx * Z_INDEX_MULT - Z_TEXT_OFFSET);
     }
 
     //===== ImageButtonGrid =====
@@ -8,6 +8,7 @@
 
 #include "engine/utils/setup.h"
 #include "engine/game/config.h"
+#include "engine/utils/timer.h"
 
 // #define INPUT_CALLBACK_CHAINING
 
@@ -91,13 +92,12 @@ namespace eng {
     }
 
     double Input::CurrentTime() {
+#ifdef ENGINE_HEADLESS
+        static Timer timer = {};
+        return timer.TimeElapsed<Timer::us>() * 1e-6;
+#else
         return glfwGetTime();
-    }
-
-    float Input::GameTimeDelay(float delay) {
-        //TODO: might want to track action starting time, rather then end time
-        //because when game speed changes, end time stays unchanged
-        return float(glfwGetTime()) + delay / Config::GameSpeed();
+#endif
     }
 
     void Input::ClampCursorPos(const glm::vec2& min, const glm::vec2& max) {
@@ -193,7 +193,7 @@ namespace eng {
     }
 
     float Input::UpdateDeltaTime() {
-        double currTime = glfwGetTime();
+        double currTime = CurrentTime();
         float deltaTime = float(currTime - data.prevTime);
         data.prevTime = currTime;
         return deltaTime;
@@ -0,0 +1,375 @@
+#include "engine/utils/jobs.h"
+
+#include "engine/utils/setup.h"
+#include "engine/utils/dbg_gui.h"
+#include "engine/utils/timer.h"
+
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <thread>
+
+namespace eng::Jobs {
+
+    struct Job {
+        JobFn fn;
+        Counter* counter = nullptr;
+    };
+
+    //Per-thread job queue. Owner pushes & pops from the back (most recent work first), other threads steal from the front.
+    struct WorkQueue {
+        std::mutex mutex;
+        std::deque<Job> jobs;
+    public:
+        void Push(Job&& job);
+        bool Pop(Job& out_job);
+        bool Steal(Job& out_job);
+        size_t Size();
+    };
+
+    struct WorkerStats {
+        std::atomic<long long> busy_us = 0;
+        std::atomic<int> jobs = 0;
+        std::atomic<int> steals = 0;
+
+        //debug GUI values
+        long long last_busy_us = 0;
+        float utilization = 0.f;
+    };
+
+    struct JobsData {
+        std::vector<std::thread> workers;
+        std::vector<std::unique_ptr<WorkQueue>> queues;         //[0] = main thread (and other non-worker threads), [1..N] = worker threads
+        std::vector<std::unique_ptr<WorkerStats>> stats;        //same indexing as queues
+        WorkQueue mainQueue;                                    //MAIN_THREAD affinity jobs
+
+        std::mutex sleep_mutex;
+        std::condition_variable wake;
+        std::atomic<int> queued = 0;                            //jobs waiting in the per-thread queues
+
+        std::thread::id mainThreadID = std::this_thread::get_id();
+        bool initialized = false;
+        std::atomic<bool> running = false;                      //worker threads are active
+
+        Timer guiTimer;
+    public:
+        static void Schedule(Counter* dependency, JobFn&& fn, Counter* counter, int affinity);
+        static void Submit(Job&& job, int affinity);
+        static void Execute(Job& job);
+        static bool TryRunOne(bool include_main);
+        static void WorkerLoop(int idx);
+        static void Finish(Counter* counter);
+        static void Wait(Counter& counter);
+    };
+
+    static JobsData data = {};
+    static thread_local int thread_idx = 0;
+
+    //==================
+
+    void Initialize(int worker_count) {
+        if(data.initialized) {
+            ENG_LOG_WARN("Jobs::Initialize - already initialized.");
+            return;
+        }
+
+        if(worker_count < 0)
+            worker_count = std::max(int(std::thread::hardware_concurrency()) - 1, 0);
+
+        data.mainThreadID = std::this_thread::get_id();
+        thread_idx = 0;
+
+        data.queues.clear();
+        data.stats.clear();
+        for(int i = 0; i <= worker_count; i++) {
+            data.queues.push_back(std::make_unique<WorkQueue>());
+            data.stats.push_back(std::make_unique<WorkerStats>());
+        }
+
+        data.running = (worker_count > 0);
+        for(int i = 1; i <= worker_count; i++) {
+            data.workers.emplace_back(JobsData::WorkerLoop, i);
+        }
+
+        data.initialized = true;
+        data.guiTimer.Reset();
+        ENG_LOG_TRACE("[C] Jobs ({} workers)", worker_count);
+    }
+
+    void Release() {
+        if(!data.initialized)
+            return;
+
+        //finish the scheduled work first
+        while(data.queued > 0 || data.mainQueue.Size() > 0) {
+            if(!JobsData::TryRunOne(IsMainThread()))
+                std::this_thread::yield();
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(data.sleep_mutex);
+            data.running = false;
+        }
+        data.wake.notify_all();
+        for(std::thread& worker : data.workers)
+            worker.join();
+
+        data.workers.clear();
+        data.queues.clear();
+        data.stats.clear();
+        data.initialized = false;
+        ENG_LOG_TRACE("[D] Jobs");
+    }
+
+    bool IsInitialized() {
+        return data.initialized;
+    }
+
+    int WorkerCount() {
+        return int(data.workers.size());
+    }
+
+    bool IsMainThread() {
+        return std::this_thread::get_id() == data.mainThreadID;
+    }
+
+    void Run(JobFn&& fn, Counter* counter, int affinity) {
+        JobsData::Schedule(nullptr, std::move(fn), counter, affinity);
+    }
+
+    void RunAfter(Counter& dependency, JobFn&& fn, Counter* counter, int affinity) {
+        JobsData::Schedule(&dependency, std::move(fn), counter, affinity);
+    }
+
+    void Wait(Counter& counter) {
+        JobsData::Wait(counter);
+    }
+
+    void ParallelFor(size_t count, const RangeFn& body, size_t batch_size) {
+        if(count == 0)
+            return;
+
+        if(!data.running) {
+            body(0, count);
+            return;
+        }
+
+        //aim for a few batches per thread, so that stealing can even out uneven batches
+        if(batch_size == 0)
+            batch_size = std::max(count / (size_t(WorkerCount() + 1) * 4), size_t(1));
+
+        Counter counter;
+        for(size_t begin = batch_size; begin < count; begin += batch_size) {
+            size_t end = std::min(begin + batch_size, count);
+            Run([&body, begin, end]() { body(begin, end); }, &counter);
+        }
+
+        //calling thread takes the first batch & then helps with the rest
+        body(0, std::min(batch_size, count));
+        Wait(counter);
+    }
+
+    void ProcessMainThreadJobs() {
+        ASSERT_MSG(IsMainThread(), "Jobs::ProcessMainThreadJobs - has to be called from the main thread.");
+
+        //only process jobs queued so far (jobs might queue more main thread work)
+        size_t count = data.mainQueue.Size();
+        Job job;
+        for(size_t i = 0; i < count && data.mainQueue.Steal(job); i++) {
+            JobsData::Execute(job);
+        }
+    }
+
+    void DBG_GUI() {
+#ifdef ENGINE_ENABLE_GUI
+        ImGui::Begin("Jobs");
+
+        float elapsed_us = float(std::max(data.guiTimer.TimeElapsed<Timer::us>(), 1LL));
+        data.guiTimer.Reset();
+
+        ImGui::Text("Workers: %d (hardware threads: %d)", WorkerCount(), int(std::thread::hardware_concurrency()));
+        ImGui::Text("Queued: %d | Main thread queue: %d", data.queued.load(), int(data.mainQueue.Size()));
+        ImGui::Separator();
+
+        char buf[128];
+        for(size_t i = 0; i < data.stats.size(); i++) {
+            WorkerStats& s = *data.stats[i];
+            long long busy = s.busy_us.load();
+            float utilization = std::min(float(busy - s.last_busy_us) / elapsed_us, 1.f);
+            s.last_busy_us = busy;
+            s.utilization = s.utilization * 0.9f + utilization * 0.1f;
+
+            snprintf(buf, sizeof(buf), "%.0f%% (%d jobs, %d stolen)", s.utilization * 100.f, s.jobs.load(), s.steals.load());
+            ImGui::Text("%s", (i == 0) ? "main  " : "worker");
+            ImGui::SameLine();
+            ImGui::ProgressBar(s.utilization, ImVec2(-1.f, 0.f), buf);
+        }
+
+        ImGui::End();
+#endif
+    }
+
+    //===== Counter =====
+
+    void Counter::Decrement() {
+        //decrement under the lock - waiting thread locks the mutex once the counter hits zero,
+        //which guarantees that this thread no longer touches the counter (it might be destroyed right after)
+        std::vector<Continuation> ready;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if(value.fetch_sub(1, std::memory_order_acq_rel) != 1)
+                return;
+            ready.swap(continuations);
+        }
+
+        //counter reached zero - schedule the jobs, that were waiting for it
+        for(Continuation& c : ready) {
+            JobsData::Submit(Job{ std::move(c.fn), c.counter }, c.affinity);
+        }
+    }
+
+    //===== JobsData =====
+
+    void JobsData::Schedule(Counter* dependency, JobFn&& fn, Counter* counter, int affinity) {
+        if(counter != nullptr)
+            counter->Increment();
+
+        if(dependency != nullptr) {
+            std::lock_guard<std::mutex> lock(dependency->mutex);
+            if(!dependency->Done()) {
+                dependency->continuations.push_back(Counter::Continuation{ std::move(fn), counter, affinity });
+                return;
+            }
+        }
+
+        Submit(Job{ std::move(fn), counter }, affinity);
+    }
+
+    void JobsData::Submit(Job&& job, int affinity) {
+        if(affinity == Affinity::MAIN_THREAD) {
+            if(!data.running && IsMainThread()) {
+                Execute(job);
+            }
+            else {
+                data.mainQueue.Push(std::move(job));
+            }
+            return;
+        }
+
+        if(!data.running) {
+            Execute(job);
+            return;
+        }
+
+        data.queues[thread_idx]->Push(std::move(job));
+        data.queued++;
+
+        //lock prevents lost wakeups (worker checking the queues right before this push & going to sleep afterwards)
+        { std::lock_guard<std::mutex> lock(data.sleep_mutex); }
+        data.wake.notify_one();
+    }
+
+    void JobsData::Execute(Job& job) {
+        Timer t = {};
+        job.fn();
+
+        if(thread_idx < (int)data.stats.size()) {
+            WorkerStats& s = *data.stats[thread_idx];
+            s.busy_us += t.TimeElapsed<Timer::us>();
+            s.jobs++;
+        }
+
+        Finish(job.counter);
+    }
+
+    bool JobsData::TryRunOne(bool include_main) {
+        Job job;
+
+        if(include_main && data.mainQueue.Steal(job)) {
+            Execute(job);
+            return true;
+        }
+
+        size_t count = data.queues.size();
+        if(count == 0)
+            return false;
+
+        //own queue first, then try stealing from others
+        if(data.queues[thread_idx]->Pop(job)) {
+            data.queued--;
+            Execute(job);
+            return true;
+        }
+
+        for(size_t i = 1; i < count; i++) {
+            size_t idx = (thread_idx + i) % count;
+            if(data.queues[idx]->Steal(job)) {
+                data.queued--;
+                data.stats[thread_idx]->steals++;
+                Execute(job);
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    void JobsData::WorkerLoop(int idx) {
+        thread_idx = idx;
+
+        while(data.running) {
+            if(TryRunOne(false))
+                continue;
+
+            std::unique_lock<std::mutex> lock(data.sleep_mutex);
+            data.wake.wait(lock, []() { return data.queued > 0 || !data.running; });
+        }
+    }
+
+    void JobsData::Wait(Counter& counter) {
+        bool main_thread = IsMainThread();
+        while(!counter.Done()) {
+            if(!JobsData::TryRunOne(main_thread))
+                std::this_thread::yield();
+        }
+        //wait for the last Decrement() to release the counter
+        std::lock_guard<std::mutex> lock(counter.mutex);
+    }
+
+    void JobsData::Finish(Counter* counter) {
+        if(counter != nullptr)
+            counter->Decrement();
+    }
+
+    //===== WorkQueue =====
+
+    void WorkQueue::Push(Job&& job) {
+        std::lock_guard<std::mutex> lock(mutex);
+        jobs.push_back(std::move(job));
+    }
+
+    bool WorkQueue::Pop(Job& out_job) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if(jobs.empty())
+            return false;
+        out_job = std::move(jobs.back());
+        jobs.pop_back();
+        return true;
+    }
+
+    bool WorkQueue::Steal(Job& out_job) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if(jobs.empty())
+            return false;
+        out_job = std::move(jobs.front());
+        jobs.pop_front();
+        return true;
+    }
+
+    size_t WorkQueue::Size() {
+        std::lock_guard<std::mutex> lock(mutex);
+        return jobs.size();
+    }
+
+}//namespace eng::Jobs
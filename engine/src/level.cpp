@@ -12,6 +12,7 @@
 #include "engine/utils/utils.h"
 #include "engine/utils/randomness.h"
 #include "engine/utils/dbg_gui.h"
+#include "engine/utils/timer.h"
 
 #define CONDITIONS_UPDATE_FREQUENCY 5.f
 
@@ -22,11 +23,17 @@ namespace eng {
     EndCondition Parse_EndCondition(const nlohmann::json& config);
     bool Parse_FactionsFile(const LevelInfo& info, FactionsFile& factions, const nlohmann::json& config);
     bool Parse_Objects(ObjectsFile& objects, const nlohmann::json& config);
+    Unit::Entry Parse_UnitEntry(const nlohmann::json& entry);
+    Building::Entry Parse_BuildingEntry(const nlohmann::json& entry);
+    UtilityObject::Entry Parse_UtilityEntry(const nlohmann::json& entry);
+    void Parse_Entrance(EntranceController::ExportData& entrance, const nlohmann::json& config);
     bool Parse_Camera(const nlohmann::json& config);
     Techtree Parse_Techtree(const nlohmann::json& config);
     EndgameStats Parse_EndgameStats(const nlohmann::json& config);
     bool Parse_Scenario(std::vector<int>& data, const nlohmann::json& config);
 
+    std::vector<glm::ivec3> PrefabWarmupList(const Savefile& savefile);
+
     nlohmann::json Export_Mapfile(const Mapfile& map);
     nlohmann::json Export_Info(const LevelInfo& info);
     nlohmann::json Export_EndCondition(const EndCondition& condition);
@@ -49,10 +56,38 @@ namespace eng {
     //===== Savefile =====
 
     Savefile::Savefile(const std::string& filepath) {
+        //single read of the whole file, the format is detected from its header
+        std::vector<uint8_t> data;
+        if(!TryReadBinaryFile(filepath.c_str(), data)) {
+            ENG_LOG_WARN("Savefile - failed to read '{}'.", filepath.c_str());
+            throw std::runtime_error("Savefile - failed to read the file.");
+        }
+
+        if(IsBinary(data.data(), data.size()))
+            LoadBinary(data.data(), data.size());
+        else
+            LoadJSON(std::string((const char*)data.data(), data.size()));
+
+        ENG_LOG_TRACE("[R] Savefile '{}' successfully loaded.", filepath.c_str());
+    }
+
+    void Savefile::Save(const std::string& filepath) {
+        if(GetExtension(filepath) == "json")
+            SaveJSON(filepath);
+        else
+            SaveBinary(filepath);
+    }
+
+    void Savefile::LoadJSON(const std::string& text) {
         using json = nlohmann::json;
 
-        //load the config and parse it as json file
-        json config = json::parse(ReadFile(filepath.c_str()));
+        if(StreamingParserEnabled()) {
+            LoadJSON_Streaming(text);
+            return;
+        }
+
+        //parse the file as json
+        json config = json::parse(text);
 
         //parse level info
         if(!config.count("info") || !Parse_Info(info, config.at("info"))) {
@@ -89,7 +124,17 @@ namespace eng {
             throw std::runtime_error("Savefile - invalid scenario data.");
         }
 
-        ENG_LOG_TRACE("[R] Savefile '{}' successfully loaded.", filepath.c_str());
+        if(!config.at("info").count("tick"))
+            ConvertLegacyTimers();
+    }
+
+    void Savefile::ConvertLegacyTimers() {
+        //application clock restarts with every run -> stored times can't be related to the simulation ticks
+        //action cooldowns are in fields, that these files don't have (they're already over), worker entrance timers are restarted
+        for(EntranceController::WorkEntry& entry : objects.entrance.workEntries) {
+            entry.start_tick = info.tick;
+        }
+        ENG_LOG_INFO("Savefile - timers converted from the older format (no simulation tick stored).");
     }
 
     void LevelInfo::DBG_GUI() {
@@ -116,7 +161,7 @@ namespace eng {
 #endif
     }
 
-    void Savefile::Save(const std::string& filepath) {
+    void Savefile::SaveJSON(const std::string& filepath) {
         using json = nlohmann::json;
 
         json data = {};
@@ -129,7 +174,7 @@ namespace eng {
 
         WriteFile(filepath.c_str(), data.dump());
         
-        ENG_LOG_TRACE("[R] Savefile::Save - successfully stored as '{}'.", filepath.c_str());
+        ENG_LOG_TRACE("[R] Savefile::SaveJSON - successfully stored as '{}'.", filepath.c_str());
     }
 
     //===== EndCondition =====
@@ -230,26 +275,65 @@ namespace eng {
             scenario = ScenarioController::Initialize(info.campaignIdx, info.race, savefile.scenario);
             EndConditionsEnabled(false);
         }
-        Config::Hack_MapReveal_Clear();
+        lastConditionsUpdate = info.tick;
+
+        //global state belongs to the main thread - loading threads leave it to Finalize()
+        if(Jobs::IsMainThread())
+            RestoreGlobalState();
         
         ENG_LOG_INFO("Level initialization complete.");
     }
 
     void Level::Update() {
+        SimClock& clock = SimClock::Get();
+
+        //simulation runs in fixed timesteps, number of ticks depends on the frame time (deltaTime is zero when paused)
+        int ticks = clock.Advance(Input::Get().deltaTime);
+        for(int i = 0; i < ticks; i++) {
+            Tick();
+        }
+
+        //input processing & GUI updates - once per rendered frame
+        factions.FrameUpdate(*this);
+    }
+
+    void Level::Tick() {
+        if(replay.IsPlaying())
+            replay.Apply(*this);
+
+        Timer t = {};
+
         if(scenario != nullptr)
             scenario->Update(*this);
+        tickStats.scenario += t.TimeElapsed();
 
+        t.Reset();
         map.UntouchabilityUpdate(factions.Diplomacy().Bitmap());
+        tickStats.map += t.TimeElapsed();
+
+        t.Reset();
         factions.Update(*this);
+        tickStats.factions += t.TimeElapsed();
+
+        t.Reset();
         objects.Update();
+        tickStats.objects += t.TimeElapsed();
+
+        t.Reset();
         objects.RunesDispatch(*this, map.RunesDispatch());
+        tickStats.map += t.TimeElapsed();
 
+        t.Reset();
         ConditionsUpdate();
+        tickStats.conditions += t.TimeElapsed();
+
+        tickStats.ticks++;
+        SimClock::Get().Step();
     }
 
     void Level::Render() {
         map.Render();
-        objects.Render();
+        objects.Render(map);
     }
 
     bool Level::Save(const std::string& filepath) {
@@ -270,6 +354,7 @@ namespace eng {
         
         try {
             Savefile sf = Savefile(filepath);
+            Resources::WarmupObjects(PrefabWarmupList(sf));
             out_level = Level(sf);
             out_level.LevelPtrUpdate();
         } catch(std::exception&) {
@@ -280,6 +365,10 @@ namespace eng {
     }
 
     void Level::Release() {
+        if(replay.IsRecording())
+            replay.StopRecording(*this);
+        replay = {};
+
         objects.Release();
         objects = {};
         factions = {};
@@ -362,17 +451,50 @@ namespace eng {
         savefile.factions = factions.Export();
         savefile.objects = objects.Export();
         savefile.info = info;
+        savefile.info.tick = SimClock::Now();
+        savefile.info.rng = Random::State();
         savefile.scenario = (scenario != nullptr) ? scenario->Export() : std::vector<int>{};
         return savefile;
     }
 
+    LevelSnapshot Level::Snapshot() {
+        LevelSnapshot snapshot;
+        if(factions.IsInitialized())
+            factions.Player()->UpdateOcclusions(*this);
+        snapshot.map = map.Snapshot();
+        snapshot.factions = factions.Export();
+        snapshot.objects = objects.Export();
+        snapshot.info = info;
+        snapshot.info.tick = SimClock::Now();
+        snapshot.info.rng = Random::State();
+        snapshot.scenario = (scenario != nullptr) ? scenario->Export() : std::vector<int>{};
+        snapshot.camera_zoom = Camera::Get().Zoom();
+        snapshot.camera_position = Camera::Get().Position();
+        return snapshot;
+    }
+
+    void Level::Finalize() {
+        map.InitializeGraphics();
+        if(factions.IsInitialized())
+            factions.Player()->InitializeGraphics(map.Size());
+        RestoreGlobalState();
+    }
+
     void Level::LevelPtrUpdate() {
         objects.LevelPtrUpdate(*this);
     }
 
+    void Level::RestoreGlobalState() {
+        Config::Hack_MapReveal_Clear();
+
+        //restore simulation time, so that the timers stored within objects remain valid
+        SimClock::Get().Reset(info.tick);
+        Random::Restore(info.rng);
+    }
+
     void Level::ConditionsUpdate() {
-        if(lastConditionsUpdate + CONDITIONS_UPDATE_FREQUENCY < Input::CurrentTime()) {
-            lastConditionsUpdate = Input::CurrentTime();
+        if(lastConditionsUpdate + SimClock::Ticks(CONDITIONS_UPDATE_FREQUENCY) < SimClock::Now()) {
+            lastConditionsUpdate = SimClock::Now();
 
             for(int i = 0; i < 2; i++) {
                 info.end_conditions[i].Update(*this);
@@ -385,8 +507,149 @@ namespace eng {
         }
     }
 
+    //===== LevelLoader =====
+
+    LevelLoader::~LevelLoader() {
+        Wait();
+    }
+
+    bool LevelLoader::Start(const std::string& filepath_) {
+        if(!counter.Done()) {
+            ENG_LOG_WARN("LevelLoader - previous load still in progress.");
+            return false;
+        }
+
+        filepath = filepath_;
+        savefile = {};
+        level = nullptr;
+        result = 0;
+        parse_us = construct_us = 0;
+        stage = LevelLoadStage::PARSING;
+
+        //parsing (worker) -> tileset load (main thread, creates textures) -> level construction (worker)
+        //each job schedules the next one, so the counter doesn't reach zero until the whole chain is done
+        Jobs::Run([this]() { Parse(); }, &counter);
+        return true;
+    }
+
+    float LevelLoader::Progress() const {
+        switch(stage) {
+            case LevelLoadStage::PARSING:       return 0.1f;
+            case LevelLoadStage::RESOURCES:     return 0.5f;
+            case LevelLoadStage::CONSTRUCTING:  return 0.6f;
+            case LevelLoadStage::DONE:          return 1.f;
+            default:                            return 0.f;
+        }
+    }
+
+    int LevelLoader::Finalize(Level& out_level) {
+        Wait();
+        int res = result;
+        if(res == 0) {
+            out_level = std::move(*level);
+            out_level.LevelPtrUpdate();
+            out_level.Finalize();
+            ENG_LOG_INFO("LevelLoader - '{}' loaded (parsing: {:.2f}ms, construction: {:.2f}ms).", filepath, parse_us * 1e-3f, construct_us * 1e-3f);
+        }
+
+        savefile = {};
+        level = nullptr;
+        stage = LevelLoadStage::IDLE;
+        return res;
+    }
+
+    void LevelLoader::Wait() {
+        Jobs::Wait(counter);
+    }
+
+    void LevelLoader::Parse() {
+        if(!std::filesystem::exists(filepath)) {
+            ENG_LOG_WARN("LevelLoader - Invalid filepath '{}'", filepath);
+            result = 1;
+            stage = LevelLoadStage::FAILED;
+            return;
+        }
+
+        Timer t = {};
+        try {
+            savefile = Savefile(filepath);
+        } catch(std::exception&) {
+            ENG_LOG_WARN("LevelLoader - Failed to load level from '{}'", filepath);
+            result = 2;
+            stage = LevelLoadStage::FAILED;
+            return;
+        }
+        parse_us = t.TimeElapsed();
+        stage = LevelLoadStage::RESOURCES;
+        Jobs::Run([this]() { LoadResources(); }, &counter, Jobs::Affinity::MAIN_THREAD);
+    }
+
+    void LevelLoader::LoadResources() {
+        //tileset cache is only modified here - loading thread then gets the already loaded tileset
+        try {
+            Resources::LoadTileset(savefile.map.tileset);
+        } catch(std::exception&) {
+            ENG_LOG_WARN("LevelLoader - Failed to load tileset '{}'", savefile.map.tileset);
+            result = 2;
+            stage = LevelLoadStage::FAILED;
+            return;
+        }
+
+        stage = LevelLoadStage::CONSTRUCTING;
+        Jobs::Run([this]() { Construct(); }, &counter);
+    }
+
+    void LevelLoader::Construct() {
+        Timer t = {};
+        try {
+            Resources::WarmupObjects(PrefabWarmupList(savefile));
+            level = std::make_unique<Level>(savefile);
+        } catch(std::exception&) {
+            ENG_LOG_WARN("LevelLoader - Failed to construct level from '{}'", filepath);
+            result = 2;
+            stage = LevelLoadStage::FAILED;
+            return;
+        }
+        construct_us = t.TimeElapsed();
+        stage = LevelLoadStage::DONE;
+    }
+
     //==============================
 
+    std::vector<glm::ivec3> PrefabWarmupList(const Savefile& savefile) {
+        std::vector<glm::ivec3> num_ids;
+
+        //objects, that are already in the level
+        for(const Unit::Entry& entry : savefile.objects.units)
+            num_ids.push_back(entry.num_id);
+        for(const Building::Entry& entry : savefile.objects.buildings)
+            num_ids.push_back(entry.num_id);
+        for(const UtilityObject::Entry& entry : savefile.objects.utilities) {
+            num_ids.push_back(entry.num_id);
+
+            //corpses display death animation of the unit, that left them
+            if(Resources::LoadUtilityObj(entry.num_id[1])->utility_id == UtilityObjectType::CORPSE && entry.anim_owner.x >= 0)
+                num_ids.push_back(entry.anim_owner);
+        }
+
+        //everything the factions can train & build (within the techtree limits)
+        for(const FactionsFile::FactionEntry& faction : savefile.factions.factions) {
+            if(faction.controllerID == FactionControllerID::NATURE)
+                continue;
+            int race = int(bool(faction.race));
+            for(int i = 0; i < UnitType::COUNT; i++) {
+                if(!faction.techtree.TrainingConstrained(i))
+                    num_ids.push_back(glm::ivec3(ObjectType::UNIT, i, race));
+            }
+            for(int i = 0; i < BuildingType::COUNT; i++) {
+                if(!faction.techtree.BuildingConstrained(i))
+                    num_ids.push_back(glm::ivec3(ObjectType::BUILDING, i, race));
+            }
+        }
+
+        return num_ids;
+    }
+
     bool Parse_Mapfile(Mapfile& map, const nlohmann::json& config) {
         using json = nlohmann::json;
 
@@ -431,6 +694,12 @@ namespace eng {
         info.campaignIdx         = config.count("campaign_idx")         ? int(config.at("campaign_idx")) : -1;
         info.custom_game         = config.count("custom_game")          ? bool(config.at("custom_game")) : true;
         info.race                = config.count("race")                 ? int(config.at("race")) : 0;
+        info.tick                = config.count("tick")                 ? int(config.at("tick")) : 0;
+
+        if(config.count("rng")) {
+            for(int i = 0; i < 4; i++)
+                info.rng.s[i] = uint32_t(config.at("rng")[i]);
+        }
 
         if(config.count("conditions"))
             info.end_conditions = EndConditions{ Parse_EndCondition(config.at("conditions")[0]), Parse_EndCondition(config.at("conditions")[1]) };
@@ -530,43 +799,18 @@ namespace eng {
     bool Parse_Objects(ObjectsFile& objects, const nlohmann::json& config) {
         try {
             for(auto& entry : config.at("units")) {
-                Unit::Entry e = {};
-                parse_GameObject(entry.at(0), e);
-                parse_FactionObject(entry.at(1), e);
-                parse_Unit(entry.at(2), e);
-                parse_UnitCommand(entry.at(3), e);
-                parse_UnitAction(entry.at(4), e);
-                objects.units.push_back(e);
+                objects.units.push_back(Parse_UnitEntry(entry));
             }
 
             for(auto& entry : config.at("buildings")) {
-                Building::Entry e = {};
-                parse_GameObject(entry.at(0), e);
-                parse_FactionObject(entry.at(1), e);
-                parse_Building(entry.at(2), e);
-                parse_BuildingAction(entry.at(3), e);
-                objects.buildings.push_back(e);
+                objects.buildings.push_back(Parse_BuildingEntry(entry));
             }
 
             for(auto& entry : config.at("utilities")) {
-                UtilityObject::Entry e = {};
-                parse_GameObject(entry.at(0), e);
-                parse_Utilities(entry.at(1), e);
-                parse_Utilities_LiveData(entry.at(2), e);
-                objects.utilities.push_back(e);
-            }
-
-            for(auto& e : config.at("entrance").at(0)) {
-                objects.entrance.entries.push_back(EntranceController::Entry{ ObjectID(e.at(0), e.at(1), e.at(2)), ObjectID(e.at(3), e.at(4), e.at(5)), e.at(6), e.at(7) });
-            }
-
-            for(auto& e : config.at("entrance").at(1)) {
-                objects.entrance.workEntries.push_back(EntranceController::WorkEntry{ ObjectID(e.at(0), e.at(1), e.at(2)), ObjectID(e.at(3), e.at(4), e.at(5)), glm::ivec2(e.at(6), e.at(7)), e.at(8), e.at(9) });
+                objects.utilities.push_back(Parse_UtilityEntry(entry));
             }
 
-            for(auto& e : config.at("entrance").at(2)) {
-                objects.entrance.gms.push_back({ ObjectID(e.at(0), e.at(1), e.at(2)), e.at(3) });
-            }
+            Parse_Entrance(objects.entrance, config.at("entrance"));
         } catch(nlohmann::json::exception&) {
             ENG_LOG_WARN("Failed to parse savefile objects.");
             return false;
@@ -575,7 +819,52 @@ namespace eng {
         return true;
     }
 
+    Unit::Entry Parse_UnitEntry(const nlohmann::json& entry) {
+        Unit::Entry e = {};
+        parse_GameObject(entry.at(0), e);
+        parse_FactionObject(entry.at(1), e);
+        parse_Unit(entry.at(2), e);
+        parse_UnitCommand(entry.at(3), e);
+        parse_UnitAction(entry.at(4), e);
+        return e;
+    }
+
+    Building::Entry Parse_BuildingEntry(const nlohmann::json& entry) {
+        Building::Entry e = {};
+        parse_GameObject(entry.at(0), e);
+        parse_FactionObject(entry.at(1), e);
+        parse_Building(entry.at(2), e);
+        parse_BuildingAction(entry.at(3), e);
+        return e;
+    }
+
+    UtilityObject::Entry Parse_UtilityEntry(const nlohmann::json& entry) {
+        UtilityObject::Entry e = {};
+        parse_GameObject(entry.at(0), e);
+        parse_Utilities(entry.at(1), e);
+        parse_Utilities_LiveData(entry.at(2), e);
+        return e;
+    }
+
+    void Parse_Entrance(EntranceController::ExportData& entrance, const nlohmann::json& config) {
+        for(auto& e : config.at(0)) {
+            entrance.entries.push_back(EntranceController::Entry{ ObjectID(e.at(0), e.at(1), e.at(2)), ObjectID(e.at(3), e.at(4), e.at(5)), e.at(6), e.at(7) });
+        }
+
+        for(auto& e : config.at(1)) {
+            entrance.workEntries.push_back(EntranceController::WorkEntry{ ObjectID(e.at(0), e.at(1), e.at(2)), ObjectID(e.at(3), e.at(4), e.at(5)), glm::ivec2(e.at(6), e.at(7)), e.at(8), e.at(9) });
+        }
+
+        for(auto& e : config.at(2)) {
+            entrance.gms.push_back({ ObjectID(e.at(0), e.at(1), e.at(2)), e.at(3) });
+        }
+    }
+
     bool Parse_Camera(const nlohmann::json& config) {
+        //camera is owned by the main thread, background loads leave the camera setup to the game stage
+        if(!Jobs::IsMainThread())
+            return config.count("zoom") && config.count("position");
+
         Camera& cam = Camera::Get();
 
         cam.Zoom(config.at("zoom"));
@@ -682,6 +971,9 @@ namespace eng {
         if(info.campaignIdx >= 0)
             out["campaign_idx"] = info.campaignIdx;
         out["race"] = info.race;
+        out["tick"] = info.tick;
+        if(info.rng.Valid())
+            out["rng"] = { info.rng.s[0], info.rng.s[1], info.rng.s[2], info.rng.s[3] };
         
         out["conditions"] = { Export_EndCondition(info.end_conditions[0]), Export_EndCondition(info.end_conditions[1]) };
 
@@ -757,7 +1049,7 @@ namespace eng {
             //Unit::Command
             e.push_back({ entry.command.type, entry.command.target_pos.x, entry.command.target_pos.y, entry.command.target_id.type, entry.command.target_id.idx, entry.command.target_id.id, entry.command.flag, entry.command.v2.x, entry.command.v2.y });
             //Unit::Action
-            e.push_back({ entry.action.type, entry.action.data.i, entry.action.data.j, entry.action.data.k, entry.action.data.b, entry.action.data.c, entry.action.data.t, entry.action.data.count });
+            e.push_back({ entry.action.type, entry.action.data.i, entry.action.data.j, entry.action.data.k, entry.action.data.b, entry.action.data.c, entry.action.data.t, entry.action.data.count, entry.action.data.tick });
             
             units.push_back(e);
         }
@@ -773,7 +1065,7 @@ namespace eng {
             //Building
             e.push_back({ entry.constructed, entry.amount_left, entry.real_actionIdx });
             //Building::Action
-            e.push_back({ entry.action.type, entry.action.data.t1, entry.action.data.t2, entry.action.data.t3, entry.action.data.i, entry.action.data.flag, entry.action.data.target_id.type, entry.action.data.target_id.idx, entry.action.data.target_id.id });
+            e.push_back({ entry.action.type, entry.action.data.t1, entry.action.data.t2, entry.action.data.t3, entry.action.data.i, entry.action.data.flag, entry.action.data.target_id.type, entry.action.data.target_id.idx, entry.action.data.target_id.id, entry.action.data.tick });
 
             buildings.push_back(e);
         }
@@ -785,7 +1077,7 @@ namespace eng {
             //GameObject
             e.push_back({ entry.id.x, entry.id.y, entry.id.z, entry.num_id.x, entry.num_id.y, entry.num_id.z, entry.position.x, entry.position.y, entry.anim_orientation, entry.anim_action, entry.anim_frame, entry.killed });
             //UtilityObject
-            e.push_back({ entry.real_position.x, entry.real_position.y, entry.real_size.x, entry.real_size.y });
+            e.push_back({ entry.real_position.x, entry.real_position.y, entry.real_size.x, entry.real_size.y, entry.anim_owner.x, entry.anim_owner.y, entry.anim_owner.z });
             //UtilityObject::LiveData
             const auto& ld = entry.live_data;
             e.push_back({ 
@@ -813,7 +1105,7 @@ namespace eng {
 
         entries = {};
         for(const auto& entry : objects.entrance.workEntries) {
-            entries.push_back({ entry.entered.type, entry.entered.idx, entry.entered.id, entry.enteree.type, entry.enteree.idx, entry.enteree.id, entry.cmd_target.x, entry.cmd_target.y, entry.cmd_type, entry.start_time });
+            entries.push_back({ entry.entered.type, entry.entered.idx, entry.entered.id, entry.enteree.type, entry.enteree.idx, entry.enteree.id, entry.cmd_target.x, entry.cmd_target.y, entry.cmd_type, entry.start_tick });
         }
         entrance.push_back(entries);
 
@@ -924,7 +1216,7 @@ namespace eng {
     }
 
     void parse_UnitAction(const nlohmann::json& d, Unit::Entry& e) {
-        int i = 0;
+        size_t i = 0;
         e.action.type            = d.at(i++);
         e.action.data.i          = d.at(i++);
         e.action.data.j          = d.at(i++);
@@ -933,6 +1225,10 @@ namespace eng {
         e.action.data.c          = d.at(i++);
         e.action.data.t          = d.at(i++);
         e.action.data.count      = d.at(i++);
+
+        //cooldown tick isn't in the older files (cooldown is then already over)
+        if(d.size() > i)
+            e.action.data.tick   = d.at(i++);
     }
 
     void parse_Building(const nlohmann::json& d, Building::Entry& e) {
@@ -943,21 +1239,33 @@ namespace eng {
     }
 
     void parse_BuildingAction(const nlohmann::json& d, Building::Entry& e) {
-        int i = 0;
+        size_t i = 0;
         e.action.type            = d.at(i++);
         e.action.data.t1         = d.at(i++);
         e.action.data.t2         = d.at(i++);
         e.action.data.t3         = d.at(i++);
         e.action.data.i          = d.at(i++);
         e.action.data.flag       = d.at(i++);
+
+        //attack timer tick isn't in the older files (placed after the target ID)
+        i += 3;
+        if(d.size() > i)
+            e.action.data.tick   = d.at(i++);
     }
 
     void parse_Utilities(const nlohmann::json& d, UtilityObject::Entry& e) {
-        int i = 0;
+        size_t i = 0;
         e.real_position[0]  = d.at(i++);
         e.real_position[1]  = d.at(i++);
         e.real_size[0]      = d.at(i++);
         e.real_size[1]      = d.at(i++);
+
+        //older files don't have the corpse animation owner
+        if(d.size() >= i+3) {
+            e.anim_owner[0] = d.at(i++);
+            e.anim_owner[1] = d.at(i++);
+            e.anim_owner[2] = d.at(i++);
+        }
     }
 
     void parse_Utilities_LiveData(const nlohmann::json& d, UtilityObject::Entry& e) {
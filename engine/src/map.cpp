@@ -5,6 +5,7 @@
 
 #include "engine/utils/utils.h"
 #include "engine/utils/json.h"
+#include "engine/utils/asset_pack.h"
 #include "engine/utils/dbg_gui.h"
 #include "engine/utils/randomness.h"
 #include "engine/game/config.h"
@@ -12,6 +13,7 @@
 #include "engine/game/gameobject.h"
 #include "engine/game/player_controller.h"
 #include "engine/utils/generator.h"
+#include "engine/utils/jobs.h"
 
 #include "engine/game/level.h"
 
@@ -26,6 +28,8 @@ static constexpr int MIN_OIL_PATCH_DISTANCE = 3;
 
 static constexpr int INVIS_DETECTION_RADIUS = 4;
 
+static constexpr int TERRAIN_CHUNK_SIZE = 16;
+
 namespace eng {
 
     Tileset::Data ParseConfig_Tileset(const std::string& config_filepath, int flags);
@@ -39,10 +43,10 @@ namespace eng {
     float heuristic_diagonal(const glm::ivec2& src, const glm::ivec2& dst);
     float range_heuristic(const glm::ivec2& src, const glm::ivec2& m, const glm::ivec2& M, heuristic_fn H);
 
-    bool Pathfinding_AStar(MapTiles& tiles, pathfindingContainer& open, const glm::ivec2& pos_src, const glm::ivec2& pos_dst, int navType, heuristic_fn h);
-    bool Pathfinding_AStar_Range(MapTiles& tiles, pathfindingContainer& open, const glm::ivec2& pos_src_, int range, const glm::ivec2& m, const glm::ivec2& M, glm::ivec2* result_pos, int navType, heuristic_fn h);
-    bool Pathfinding_AStar_Forrest(MapTiles& tiles, pathfindingContainer& open, const glm::ivec2& pos_src, const glm::ivec2& pos_dst, int navType, heuristic_fn h);
-    bool Pathfinding_Dijkstra_NearestBuilding(MapTiles& tiles, pathfindingContainer& open, const glm::ivec2& pos_src_, const std::vector<buildingMapCoords>& targets, int resourceType, int navType, glm::ivec2& out_dst_pos);
+    bool Pathfinding_AStar(MapTiles& tiles, NavGrid& nav, const glm::ivec2& pos_src, const glm::ivec2& pos_dst, int navType, heuristic_fn h);
+    bool Pathfinding_AStar_Range(MapTiles& tiles, NavGrid& nav, const glm::ivec2& pos_src_, int range, const glm::ivec2& m, const glm::ivec2& M, glm::ivec2* result_pos, int navType, heuristic_fn h);
+    bool Pathfinding_AStar_Forrest(MapTiles& tiles, NavGrid& nav, const glm::ivec2& pos_src, const glm::ivec2& pos_dst, int navType, heuristic_fn h);
+    bool Pathfinding_Dijkstra_NearestBuilding(MapTiles& tiles, NavGrid& nav, const glm::ivec2& pos_src_, const std::vector<buildingMapCoords>& targets, int resourceType, int navType, glm::ivec2& out_dst_pos);
 
     //an element of tmp array, used during tileset parsing
     struct TileDescription {
@@ -50,13 +54,6 @@ namespace eng {
         int borderType = 0;
     };
 
-    void NavData::Cleanup() {
-        d = std::numeric_limits<float>::infinity();
-        visited = false;
-        pathtile = false;
-        part_of_forrest = false;
-    }
-
     void NavData::Claim(int navType, bool permanently, bool is_building) {
         taken |= navType;
         permanent |= int(permanently)*navType;
@@ -69,6 +66,31 @@ namespace eng {
         building = (is_building) ? false : building;
     }
 
+    void NavScratch::Cleanup() {
+        d = std::numeric_limits<float>::infinity();
+        visited = false;
+        pathtile = false;
+        part_of_forrest = false;
+    }
+
+    //===== NavGrid =====
+
+    NavGrid& NavGrid::Get(const glm::ivec2& size) {
+        static thread_local NavGrid grid = {};
+        if(grid.size != size) {
+            grid.size = size;
+            grid.data = std::vector<NavScratch>((size.x+1)*(size.y+1));
+        }
+        return grid;
+    }
+
+    void NavGrid::Cleanup() {
+        for(NavScratch& ns : data)
+            ns.Cleanup();
+    }
+
+    //==========
+
     TileData::TileData(int tileType_, int variation_, int cornerType_, int health_)
         : tileType(tileType_), cornerType(cornerType_), variation(variation_), health(health_) {
         UpdateID();
@@ -78,8 +100,8 @@ namespace eng {
         return bool(unitNavType & (TileTraversability() + NavigationBit::AIR) & (~nav.taken)) && (!nav.building || unitNavType == NavigationBit::AIR);
     }
 
-    bool TileData::TraversableOrForrest(int unitNavType) const {
-        return Traversable(unitNavType) || nav.part_of_forrest;
+    bool TileData::TraversableOrForrest(int unitNavType, const NavScratch& scratch) const {
+        return Traversable(unitNavType) || scratch.part_of_forrest;
     }
 
     bool TileData::Traversable_Terrain(int unitNavType) const {
@@ -122,6 +144,10 @@ namespace eng {
         return !occlusion_enabled || (vis.occ_idx != 0 && (!Config::FogOfWar() || vis.fog_idx != 0));
     }
 
+    bool TileData::IsExplored(bool occlusion_enabled) const {
+        return !occlusion_enabled || vis.occ_idx != 0;
+    }
+
     bool TileData::IsCoastTile() const {
         return coastal;
     }
@@ -387,13 +413,7 @@ namespace eng {
         }
     }
 
-    void MapTiles::NavDataCleanup() {
-        int area = (size.x+1)*(size.y+1);
-        for(int i = 0; i < area; i++)
-            data[i].nav.Cleanup();
-    }
-
-    int MapTiles::NavData_Forrest_FloodFill(const glm::ivec2& pos) {
+    int MapTiles::NavData_Forrest_FloodFill(NavGrid& nav, const glm::ivec2& pos) {
         std::vector<glm::ivec2> to_visit;
         to_visit.push_back(pos);
 
@@ -401,11 +421,12 @@ namespace eng {
         for(size_t idx = 0; idx < to_visit.size(); idx++) {
             glm::ivec2 coords = to_visit.at(idx);
             TileData& td = operator()(coords);
+            NavScratch& nd = nav(coords);
 
-            if(td.nav.part_of_forrest || !td.IsTreeTile())
+            if(nd.part_of_forrest || !td.IsTreeTile())
                 continue;
             
-            td.nav.part_of_forrest = true;
+            nd.part_of_forrest = true;
             forrest_size++;
 
             if(coords.y > 0) {
@@ -559,15 +580,17 @@ namespace eng {
 
     //===== Map =====
 
-    Map::Map(const glm::ivec2& size_, const TilesetRef& tileset_) : tiles(MapTiles(size_)), occlusion(GenOcclusionSprite()) {
+    Map::Map(const glm::ivec2& size_, const TilesetRef& tileset_) : tiles(MapTiles(size_)) {
         ChangeTileset(tileset_);
-        Camera::Get().SetBounds(Size());
+        if(Jobs::IsMainThread())
+            InitializeGraphics();
     }
 
-    Map::Map(Mapfile&& mapfile) : tiles(std::move(mapfile.tiles)), occlusion(GenOcclusionSprite()) {
+    Map::Map(Mapfile&& mapfile) : tiles(std::move(mapfile.tiles)) {
         ASSERT_MSG(tiles.Valid(), "Mapfile doesn't contain any tile descriptions!");
         ChangeTileset(Resources::LoadTileset(mapfile.tileset));
-        Camera::Get().SetBounds(Size());
+        if(Jobs::IsMainThread())
+            InitializeGraphics();
     }
 
     Map::Map(Map&& m) noexcept {
@@ -608,6 +631,7 @@ namespace eng {
         if(damage < 0) damage = 0;
         
         td.health -= damage;
+        SnapshotInvalidate(idx);
         ENG_LOG_FINE("[DMG] {} dealt {} damage to map_object at ({},{}) (melee, remaining: {}/100).", src.to_string(), damage, idx.x, idx.y, td.health);
 
         if(td.health <= 0) {
@@ -616,6 +640,7 @@ namespace eng {
             td.tileType = newType;
             td.health = 100;
             tileset->UpdateTileIndices(tiles, idx);
+            TerrainInvalidate(idx);
             td.UpdateID();
         }
 
@@ -629,11 +654,13 @@ namespace eng {
         }
 
         td.health -= HARVEST_WOOD_HEALTH_TICK;
+        SnapshotInvalidate(idx);
         if(td.health <= 0) {
             ENG_LOG_FINE("Tile transformation [({},{})] - {} -> {} (trees)", idx.x, idx.y, td.tileType, TileType::TREES_FELLED);
             td.tileType = TileType::TREES_FELLED;
             td.health = 100;
             tileset->UpdateTileIndices(tiles, idx);
+            TerrainInvalidate(idx);
             return true;
         }
         else
@@ -647,6 +674,38 @@ namespace eng {
         return mapfile;
     }
 
+    MapSnapshot Map::Snapshot() {
+        int count = tiles.Count();
+        size_t chunk_count = size_t((count + MapSnapshot::CHUNK_SIZE - 1) / MapSnapshot::CHUNK_SIZE);
+        if(snapshot_chunks.size() != chunk_count) {
+            snapshot_chunks.assign(chunk_count, nullptr);
+            snapshot_dirty.assign(chunk_count, 1);
+        }
+
+        //copy only the modified chunks, the rest is shared with the previous snapshot
+        for(size_t c = 0; c < chunk_count; c++) {
+            if(!snapshot_dirty[c] && snapshot_chunks[c] != nullptr)
+                continue;
+
+            int start = int(c) * MapSnapshot::CHUNK_SIZE;
+            int end = std::min(start + MapSnapshot::CHUNK_SIZE, count);
+            std::shared_ptr<MapSnapshot::Chunk> chunk = std::make_shared<MapSnapshot::Chunk>(end - start);
+            for(int i = start; i < end; i++) {
+                const TileData& td = tiles[i];
+                (*chunk)[i - start] = TileState{ td.tileType, td.variation, td.cornerType, td.health };
+            }
+            snapshot_chunks[c] = std::move(chunk);
+            snapshot_dirty[c] = 0;
+        }
+
+        MapSnapshot snapshot = {};
+        snapshot.tileset = tileset->Name();
+        snapshot.size = tiles.Size();
+        snapshot.count = count;
+        snapshot.chunks = snapshot_chunks;
+        return snapshot;
+    }
+
     void Map::Render() {
         Camera& cam = Camera::Get();
 
@@ -654,21 +713,46 @@ namespace eng {
             tiles.UpdateOcclusionIndices();
         }
 
-        float zIdx_map = 0.f;
         float zIdx_occ = -0.7f;
 
-        for(int y = 0; y < tiles.Size().y; y++) {
-            for(int x = 0; x < tiles.Size().x; x++) {
-                int i = c2i(y, x);
-                glm::vec2 pos = cam.map2screen(glm::vec2(x, y));
-                tileset->Tilemap().Render(glm::uvec4(0), glm::vec3(pos, zIdx_map), cam.Mult(), tiles[i].idx.y, tiles[i].idx.x);
-                
-                //use textures based on occlusion indices
-                if(enable_occlusion) {
+        auto [m, M] = VisibleRange();
+        terrain_stats = glm::ivec2(0);
+
+        //terrain - static chunk meshes in map coords, map2screen is applied by the shader
+        glm::ivec2 chunk_count = (tiles.Size() + TERRAIN_CHUNK_SIZE - 1) / TERRAIN_CHUNK_SIZE;
+        if(terrain_chunks.size() != size_t(chunk_count.x * chunk_count.y)) {
+            terrain_chunks = std::vector<QuadMesh>(size_t(chunk_count.x * chunk_count.y));
+            terrain_dirty.assign(terrain_chunks.size(), 1);
+        }
+
+        GLuint tileset_texture = tileset->Tilemap().GetTexture()->Handle();
+        glm::vec4 transform = glm::vec4(cam.Mult(), -(cam.Position() + 0.5f) * cam.Mult());
+        glm::ivec2 cm = m / TERRAIN_CHUNK_SIZE;
+        glm::ivec2 cM = (M + TERRAIN_CHUNK_SIZE - 1) / TERRAIN_CHUNK_SIZE;
+        for(int cy = cm.y; cy < cM.y; cy++) {
+            for(int cx = cm.x; cx < cM.x; cx++) {
+                int c = cy * chunk_count.x + cx;
+                if(terrain_dirty[c]) {
+                    RebuildTerrainChunk(glm::ivec2(cx, cy), terrain_chunks[c]);
+                    terrain_dirty[c] = 0;
+                }
+                Renderer::RenderMesh(terrain_chunks[c], tileset_texture, transform);
+                terrain_stats += glm::ivec2(1, terrain_chunks[c].QuadCount());
+            }
+        }
+
+        //use textures based on occlusion indices
+        if(enable_occlusion) {
+            for(int y = m.y; y < M.y; y++) {
+                for(int x = m.x; x < M.x; x++) {
+                    int i = c2i(y, x);
+                    glm::vec2 pos = cam.map2screen(glm::vec2(x, y));
                     occlusion.Render(glm::vec3(pos, zIdx_occ), cam.Mult(), 0, tiles[i].vis.occ_idx, glm::vec4(0.f, 0.f, 0.f, 1.f));
+                    terrain_stats.y++;
 
                     if(Config::FogOfWar()) {
                         occlusion.Render(glm::vec3(pos, zIdx_occ+1e-3f), cam.Mult(), 1, tiles[i].vis.fog_idx, glm::vec4(0.f, 0.f, 0.f, 1.f));
+                        terrain_stats.y++;
                     }
                 }
             }
@@ -687,15 +771,51 @@ namespace eng {
         }
     }
 
+    std::pair<glm::ivec2, glm::ivec2> Map::VisibleRange(int margin) const {
+        Camera& cam = Camera::Get();
+
+        //tile at x covers <x-0.5, x+0.5> around the camera position
+        glm::vec2 half_view = 1.f / cam.Mult();
+        glm::ivec2 m = glm::ivec2(glm::floor(cam.Position() - 0.5f - half_view)) - margin;
+        glm::ivec2 M = glm::ivec2(glm::ceil(cam.Position() + 0.5f + half_view)) + 1 + margin;
+        return { glm::clamp(m, glm::ivec2(0), tiles.Size()), glm::clamp(M, glm::ivec2(0), tiles.Size()) };
+    }
+
+    void Map::RebuildTerrainChunk(const glm::ivec2& chunk, QuadMesh& mesh) {
+        glm::ivec2 start = chunk * TERRAIN_CHUNK_SIZE;
+        glm::ivec2 end = glm::min(start + TERRAIN_CHUNK_SIZE, tiles.Size());
+        const Sprite& tilemap = tileset->Tilemap();
+
+        //one quad per tile, 1x1 in map coords (same placement as map2screen)
+        std::vector<QuadVertices> quads;
+        quads.reserve(size_t(TERRAIN_CHUNK_SIZE * TERRAIN_CHUNK_SIZE));
+        for(int y = start.y; y < end.y; y++) {
+            for(int x = start.x; x < end.x; x++) {
+                const TileData& td = tiles[c2i(y, x)];
+                QuadVertices quad = QuadVertices::FromCorner(glm::uvec4(0), glm::vec3(x, y, 0.f), glm::vec2(1.f), glm::vec4(1.f), tilemap.FrameTexCoords(td.idx.y, td.idx.x));
+                quad.UpdateTextureIdx(QuadMesh::TEXTURE_SLOT);
+                quads.push_back(quad);
+            }
+        }
+        mesh.Upload(quads);
+    }
+
     bool Map::IsWithinBounds(const glm::ivec2& pos) const {
         return ((unsigned int)pos.y) < ((unsigned int)tiles.Size().y) && ((unsigned int)pos.x) < ((unsigned int)tiles.Size().x);
     }
 
+    void Map::InitializeGraphics() {
+        if(occlusion.GetTexture() == nullptr)
+            occlusion = GenOcclusionSprite();
+        Camera::Get().SetBounds(Size());
+    }
+
     void Map::ChangeTileset(const TilesetRef& tilesetNew) {
         TilesetRef ts = (tilesetNew != nullptr) ? tilesetNew : Resources::DefaultTileset();
         if(tileset != tilesetNew) {
             tileset = tilesetNew;
             tileset->UpdateTileIndices(tiles);
+            TerrainInvalidate();
         }
     }
 
@@ -781,12 +901,13 @@ namespace eng {
         if(unit_pos == target_pos)
             return target_pos;
 
-        //fills distance values in the tile data
-        Pathfinding_AStar(tiles, nav_list, unit_pos, dst_pos, navType, &heuristic_euclidean);
+        //fills distance values in the workspace
+        NavGrid& nav = NavGrid::Get(tiles.Size());
+        Pathfinding_AStar(tiles, nav, unit_pos, dst_pos, navType, &heuristic_euclidean);
         // DBG_PrintDistances();
         
         //assembles the path, returns the next tile coord, that can be reached via a straight line travel
-        return Pathfinding_RetrieveNextPos(unit_pos, dst_pos, navType);
+        return Pathfinding_RetrieveNextPos(nav, unit_pos, dst_pos, navType);
     }
 
     glm::ivec2 Map::Pathfinding_NextPosition_Range(const Unit& unit, const glm::ivec2& m, const glm::ivec2& M, int distance) {
@@ -805,9 +926,10 @@ namespace eng {
         glm::ivec2 dm = m;
         glm::ivec2 dM = M;
 
-        //fills distance values in the tile data
+        //fills distance values in the workspace
+        NavGrid& nav = NavGrid::Get(tiles.Size());
         glm::ivec2 dst_pos = glm::ivec2(-1);
-        if(!Pathfinding_AStar_Range(tiles, nav_list, unit.Position(), distance, dm, dM, &dst_pos, navType, &heuristic_euclidean)) {
+        if(!Pathfinding_AStar_Range(tiles, nav, unit.Position(), distance, dm, dM, &dst_pos, navType, &heuristic_euclidean)) {
             //destination unreachable
             return unit.Position();
         }
@@ -817,7 +939,7 @@ namespace eng {
             dst_pos = make_even(dst_pos);
         
         //assembles the path, returns the next tile coord, that can be reached via a straight line travel
-        return Pathfinding_RetrieveNextPos(unit.Position(), dst_pos, navType);
+        return Pathfinding_RetrieveNextPos(nav, unit.Position(), dst_pos, navType);
     }
 
     bool Map::Pathfinding_CanGetInRange(const FactionObject& src, const glm::ivec2& m, const glm::ivec2& M, int distance) {
@@ -845,12 +967,13 @@ namespace eng {
         //target fix for airborne units
         glm::ivec2 dst_pos = (navType == NavigationBit::GROUND) ? target_pos : make_even(target_pos);
 
-        //fills distance values in the tile data
-        Pathfinding_AStar_Forrest(tiles, nav_list, unit.Position(), dst_pos, navType, &heuristic_euclidean);
+        //fills distance values in the workspace
+        NavGrid& nav = NavGrid::Get(tiles.Size());
+        Pathfinding_AStar_Forrest(tiles, nav, unit.Position(), dst_pos, navType, &heuristic_euclidean);
         // DBG_PrintDistances();
         
         //assembles the path, returns the next tile coord, that can be reached via a straight line travel
-        return Pathfinding_RetrieveNextPos(unit.Position(), dst_pos, navType);
+        return Pathfinding_RetrieveNextPos(nav, unit.Position(), dst_pos, navType);
     }
 
     bool Map::Pathfinding_NextPosition_NearestBuilding(const Unit& unit, const std::vector<buildingMapCoords>& buildings, ObjectID& out_id, glm::ivec2& out_nextPos) {
@@ -861,7 +984,8 @@ namespace eng {
         int res_type = unit.CarryStatus();
 
         glm::ivec2 dst_pos;
-        if(!Pathfinding_Dijkstra_NearestBuilding(tiles, nav_list, unit.Position(), buildings, res_type, navType, dst_pos)) {
+        NavGrid& nav = NavGrid::Get(tiles.Size());
+        if(!Pathfinding_Dijkstra_NearestBuilding(tiles, nav, unit.Position(), buildings, res_type, navType, dst_pos)) {
             return false;
         }
 
@@ -886,7 +1010,7 @@ namespace eng {
         if(navType != NavigationBit::GROUND)
             dst_pos = make_even(dst_pos + 1);
  
-        out_nextPos = Pathfinding_RetrieveNextPos(unit.Position(), dst_pos, navType);
+        out_nextPos = Pathfinding_RetrieveNextPos(nav, unit.Position(), dst_pos, navType);
         return true;
     }
 
@@ -903,12 +1027,13 @@ namespace eng {
         if(src_pos == dst_pos)
             return src_pos;
 
-        //fills distance values in the tile data
-        Pathfinding_AStar(tiles, nav_list, src_pos, dst_pos, navType, &heuristic_euclidean);
+        //fills distance values in the workspace
+        NavGrid& nav = NavGrid::Get(tiles.Size());
+        Pathfinding_AStar(tiles, nav, src_pos, dst_pos, navType, &heuristic_euclidean);
         // DBG_PrintDistances();
         
         //assembles the path, returns the next tile coord, that can be reached via a straight line travel
-        return Pathfinding_RetrieveFinalPos(src_pos, dst_pos, navType);
+        return Pathfinding_RetrieveFinalPos(nav, src_pos, dst_pos, navType);
     }
 
     int Map::NearbySpawnCoords(glm::ivec2 building_pos, glm::ivec2 building_size, int preferred_dir, int nav_type, glm::ivec2& out_coords, int max_range) {
@@ -1439,6 +1564,8 @@ namespace eng {
         DBG_PrintTiles();
 
         tileset->UpdateTileIndices(tiles);
+        SnapshotInvalidate();
+        TerrainInvalidate();
     }
 
     void Map::ModifyTiles(PaintBitmap& paint, int tileType, bool randomVariation, int variationValue, std::vector<TileRecord>* history) {
@@ -1506,6 +1633,8 @@ namespace eng {
 
         //update tile visuals
         tileset->UpdateTileIndices(tiles);
+        SnapshotInvalidate();
+        TerrainInvalidate();
 
         ENG_LOG_TRACE("Map::ModifyTiles - number of affected tiles = {} ({})", modified.size(), affectedTiles.size());
 
@@ -1535,6 +1664,16 @@ namespace eng {
         return false;
     }
 
+    bool Map::IsTileExplored(const glm::ivec2& position, const glm::ivec2& size) const {
+        for(int y = 0; y < size.y; y++) {
+            for(int x = 0; x < size.x; x++) {
+                if(operator()(glm::ivec2(position.x + x, position.y + y)).IsExplored(enable_occlusion))
+                    return true;
+            }
+        }
+        return false;
+    }
+
     bool Map::IsDockingLocation(const glm::ivec2& bot_left) const {
         return 
             operator()(bot_left.y+0, bot_left.x+0).IsCoastTile() || 
@@ -1588,9 +1727,11 @@ namespace eng {
         
 
         ImGui::Checkbox("render_occlusion", &enable_occlusion);
+        ImGui::Text("Terrain: %d/%d chunks drawn, %d quads/frame (per tile rendering: %d)", terrain_stats.x, (int)terrain_chunks.size(), terrain_stats.y, tiles.Area() * (enable_occlusion ? (Config::FogOfWar() ? 3 : 2) : 1));
         
 
         glm::ivec2 size = (mode != 1) ? tiles.Size() : (tiles.Size()+1);
+        NavGrid& nav = NavGrid::Get(tiles.Size());
 
         float TEXT_BASE_WIDTH = ImGui::CalcTextSize("A").x;
         float cell_width = TEXT_BASE_WIDTH * 3.f;
@@ -1638,8 +1779,8 @@ namespace eng {
             if(mode == 5) {
                 for(int y = 0; y < size.y; y++) {
                     for(int x = 0; x < size.x; x++) {
-                        if(tiles(y,x).nav.d > D && !std::isinf(tiles(y,x).nav.d))
-                            D = tiles(y,x).nav.d;
+                        if(nav(y,x).d > D && !std::isinf(nav(y,x).d))
+                            D = nav(y,x).d;
                     }
                 }
             }
@@ -1679,18 +1820,18 @@ namespace eng {
                                 ImGui::TableSetBgColor(ImGuiTableBgTarget_CellBg, tiles(y,x).nav.building ? clr4 : taken_clr);
                                 ImGui::TableNextColumn();
                                 ImGui::Text(" ");
-                                ImGui::TableSetBgColor(ImGuiTableBgTarget_CellBg, tiles(y,x).nav.pathtile ? clr5 : taken_clr);
+                                ImGui::TableSetBgColor(ImGuiTableBgTarget_CellBg, nav(y,x).pathtile ? clr5 : taken_clr);
                                 ImGui::EndTable();
                             }
                             ImGui::PopStyleVar();
                             break;
                         case 4:
-                            ImGui::Text("%d", tiles(y,x).nav.visited);
-                            ImGui::TableSetBgColor(ImGuiTableBgTarget_CellBg, tiles(y,x).nav.visited ? clr2 : clr1);
+                            ImGui::Text("%d", nav(y,x).visited);
+                            ImGui::TableSetBgColor(ImGuiTableBgTarget_CellBg, nav(y,x).visited ? clr2 : clr1);
                             break;
                         case 5:
-                            ImGui::Text("%5.1f", tiles(y,x).nav.d);
-                            ImGui::TableSetBgColor(ImGuiTableBgTarget_CellBg, ImGui::GetColorU32(ImVec4(std::min(1.f, std::pow(tiles(y,x).nav.d / D, 2.2f)), 0.1f, 0.1f, 1.0f)));
+                            ImGui::Text("%5.1f", nav(y,x).d);
+                            ImGui::TableSetBgColor(ImGuiTableBgTarget_CellBg, ImGui::GetColorU32(ImVec4(std::min(1.f, std::pow(nav(y,x).d / D, 2.2f)), 0.1f, 0.1f, 1.0f)));
                             break;
                         case 6:
                             ImGui::PushStyleVar(ImGuiStyleVar_CellPadding, ImVec2(style.CellPadding.x, 0));
@@ -1708,8 +1849,8 @@ namespace eng {
                             ImGui::TableSetBgColor(ImGuiTableBgTarget_CellBg, ImGui::GetColorU32(ImVec4(tiles(y,x).health / 100.f, 0.1f, 0.1f, 1.0f)));
                             break;
                         case 8:
-                            ImGui::Text("%d", int(tiles(y,x).nav.part_of_forrest));
-                            ImGui::TableSetBgColor(ImGuiTableBgTarget_CellBg, tiles(y,x).nav.part_of_forrest ? clr2 : clr1);
+                            ImGui::Text("%d", int(nav(y,x).part_of_forrest));
+                            ImGui::TableSetBgColor(ImGuiTableBgTarget_CellBg, nav(y,x).part_of_forrest ? clr2 : clr1);
                             break;
                         case 9:
                             ImGui::Text("%d", tiles(y,x).info[airborne].factionId);
@@ -1960,7 +2101,7 @@ namespace eng {
             return tileType;
     }
 
-    glm::ivec2 Map::MinDistanceNeighbor(const glm::ivec2& center, int step) {
+    glm::ivec2 Map::MinDistanceNeighbor(NavGrid& nav, const glm::ivec2& center, int step) {
         glm::ivec2 idx = center - step;
         float min_d = std::numeric_limits<float>::infinity();
         
@@ -1974,7 +2115,7 @@ namespace eng {
                     continue;
 
                 glm::ivec2 pos = glm::ivec2(x, y);
-                float d = tiles(pos).nav.d;
+                float d = nav(pos).d;
                 if(d <= min_d) {
                     idx = glm::ivec2(pos);
                     min_d = d;
@@ -1986,7 +2127,7 @@ namespace eng {
         return idx;
     }
 
-    glm::ivec2 Map::MinDistanceNeighbor(const glm::ivec2& center, int nav_type, int step) {
+    glm::ivec2 Map::MinDistanceNeighbor(NavGrid& nav, const glm::ivec2& center, int nav_type, int step) {
         glm::ivec2 idx = center - step;
         float min_d = std::numeric_limits<float>::infinity();
         
@@ -2002,7 +2143,7 @@ namespace eng {
                     continue;
 
                 glm::ivec2 pos = glm::ivec2(x, y);
-                float d = tiles(pos).nav.d;
+                float d = nav(pos).d;
                 if(d <= min_d) {
                     bool path_valid = true;
                     if(step > 1) {
@@ -2026,7 +2167,7 @@ namespace eng {
         return idx;
     }
 
-    glm::ivec2 Map::Pathfinding_RetrieveNextPos(const glm::ivec2& pos_src, const glm::ivec2& pos_dst_, int navType) {
+    glm::ivec2 Map::Pathfinding_RetrieveNextPos(NavGrid& nav, const glm::ivec2& pos_src, const glm::ivec2& pos_dst_, int navType) {
         glm::ivec2 pos_dst = pos_dst_;
         glm::ivec2 dir = glm::sign(pos_dst - pos_src);
         int step = 1 + int(navType != NavigationBit::GROUND);
@@ -2039,7 +2180,7 @@ namespace eng {
         
         int j = 0;
         //when the target destination is unreachable - find new (reachable) location along the way from dst to src position
-        while(tiles.IsWithinBounds(pos_dst) && (tiles(pos_dst).nav.d == std::numeric_limits<float>::infinity() || !tiles(pos_dst).TraversableOrForrest(navType)) && pos_dst != pos_src) {
+        while(tiles.IsWithinBounds(pos_dst) && (nav(pos_dst).d == std::numeric_limits<float>::infinity() || !tiles(pos_dst).TraversableOrForrest(navType, nav(pos_dst))) && pos_dst != pos_src) {
             pos_dst -= dir * step;
             j++;
         }
@@ -2055,12 +2196,12 @@ namespace eng {
         int i = 0;
         while(pos != pos_src) {
             glm::ivec2 pos_prev = pos;
-            tiles(pos_prev).nav.pathtile = true;
+            nav(pos_prev).pathtile = true;
             
             //find neighboring tile in the direct neighborhood, that has the lowest distance from the starting location
-            pos = MinDistanceNeighbor(pos, step);
+            pos = MinDistanceNeighbor(nav, pos, step);
             ASSERT_MSG(pos_prev != pos, "Map::Pathfinding - path retrieval is stuck.");
-            ASSERT_MSG(tiles(pos).TraversableOrForrest(navType) || pos == pos_src, "Map::Pathfinding - path leads through untraversable tiles ({}).", pos);
+            ASSERT_MSG(tiles(pos).TraversableOrForrest(navType, nav(pos)) || pos == pos_src, "Map::Pathfinding - path leads through untraversable tiles ({}).", pos);
 
             //direction change means corner in the path -> mark as new target position
             glm::ivec2 dir_new = pos_prev - pos;
@@ -2075,17 +2216,17 @@ namespace eng {
             i++;
 
             //previous tile was part of forrest (untraversable) -> mark as new target position
-            if(tiles(pos_prev).nav.part_of_forrest) {
+            if(nav(pos_prev).part_of_forrest) {
                 res = pos;
             }
         }
 
         ENG_LOG_FINEST("        full path: {}\b\b  ({} tiles + {} unreachable)", ss.str().c_str(), i, j);
-        ENG_LOG_FINER("    Map::Pathfinding::Result | from ({},{}) to ({},{}) | next=({},{}) | (D - next:{:.1f}, total:{:.1f})", pos_src.x, pos_src.y, pos_dst.x, pos_dst.y, res.x, res.y, tiles(res).nav.d, tiles(pos_dst).nav.d);
+        ENG_LOG_FINER("    Map::Pathfinding::Result | from ({},{}) to ({},{}) | next=({},{}) | (D - next:{:.1f}, total:{:.1f})", pos_src.x, pos_src.y, pos_dst.x, pos_dst.y, res.x, res.y, nav(res).d, nav(pos_dst).d);
         return res;
     }
 
-    glm::ivec2 Map::Pathfinding_RetrieveFinalPos(const glm::ivec2& pos_src, const glm::ivec2& pos_dst_, int navType) {
+    glm::ivec2 Map::Pathfinding_RetrieveFinalPos(NavGrid& nav, const glm::ivec2& pos_src, const glm::ivec2& pos_dst_, int navType) {
         glm::ivec2 pos_dst = pos_dst_;
         glm::ivec2 dir = glm::sign(pos_dst - pos_src);
         int step = 1 + int(navType != NavigationBit::GROUND);
@@ -2098,7 +2239,7 @@ namespace eng {
         
         int j = 0;
         //when the target destination is unreachable - find new (reachable) location along the way from dst to src position
-        while(tiles.IsWithinBounds(pos_dst) && (tiles(pos_dst).nav.d == std::numeric_limits<float>::infinity() || !tiles(pos_dst).TraversableOrForrest(navType)) && pos_dst != pos_src) {
+        while(tiles.IsWithinBounds(pos_dst) && (nav(pos_dst).d == std::numeric_limits<float>::infinity() || !tiles(pos_dst).TraversableOrForrest(navType, nav(pos_dst))) && pos_dst != pos_src) {
             pos_dst -= dir * step;
             j++;
         }
@@ -2130,10 +2271,11 @@ namespace eng {
     }
 
     void Map::DBG_PrintDistances() const {
+        NavGrid& nav = NavGrid::Get(tiles.Size());
         printf("DISTANCES:\n");
         for(int y = 0; y <= Size().y; y++) {
             for(int x = 0; x <= Size().x; x++) {
-                printf("%5.1f ", at(Size().y-y, x).nav.d);
+                printf("%5.1f ", nav(Size().y-y, x).d);
             }
             printf("\n");
         }
@@ -2162,9 +2304,40 @@ namespace eng {
         occlusion = m.occlusion;
         rune_dispatch = m.rune_dispatch;
         
+        snapshot_chunks = std::move(m.snapshot_chunks);
+        snapshot_dirty = std::move(m.snapshot_dirty);
+        terrain_chunks = std::move(m.terrain_chunks);
+        terrain_dirty = std::move(m.terrain_dirty);
+
         m.rune_dispatch = {};
         m.traversableObjects = {};
         m.tileset = nullptr;
+        m.snapshot_chunks = {};
+        m.snapshot_dirty = {};
+        m.terrain_chunks.clear();
+        m.terrain_dirty = {};
+    }
+
+    void Map::SnapshotInvalidate(const glm::ivec2& idx) {
+        size_t c = size_t(c2i(idx.y, idx.x) / MapSnapshot::CHUNK_SIZE);
+        if(c < snapshot_dirty.size())
+            snapshot_dirty[c] = 1;
+    }
+
+    void Map::SnapshotInvalidate() {
+        snapshot_chunks.clear();
+        snapshot_dirty.clear();
+    }
+
+    void Map::TerrainInvalidate(const glm::ivec2& idx) {
+        int chunks_x = (tiles.Size().x + TERRAIN_CHUNK_SIZE - 1) / TERRAIN_CHUNK_SIZE;
+        size_t c = size_t((idx.y / TERRAIN_CHUNK_SIZE) * chunks_x + (idx.x / TERRAIN_CHUNK_SIZE));
+        if(c < terrain_dirty.size())
+            terrain_dirty[c] = 1;
+    }
+
+    void Map::TerrainInvalidate() {
+        std::fill(terrain_dirty.begin(), terrain_dirty.end(), 1);
     }
 
     //===================================================================================
@@ -2176,7 +2349,7 @@ namespace eng {
         data.name = GetFilename(config_filepath, true);
 
         //load the config and parse it as json file
-        json config = json::parse(ReadFile(config_filepath.c_str()));
+        json config = AssetPack::LoadJSON(config_filepath);
 
         try {
             data.type = config.at("type");
@@ -2322,16 +2495,17 @@ namespace eng {
         });
     }
 
-    bool Pathfinding_AStar(MapTiles& tiles, pathfindingContainer& open, const glm::ivec2& pos_src_, const glm::ivec2& pos_dst, int navType, heuristic_fn H) {
+    bool Pathfinding_AStar(MapTiles& tiles, NavGrid& nav, const glm::ivec2& pos_src_, const glm::ivec2& pos_dst, int navType, heuristic_fn H) {
         //airborne units only move on even tiles
         int step = 1 + int(navType != NavigationBit::GROUND);
         glm::ivec2 pos_src = (navType != NavigationBit::GROUND) ? make_even(pos_src_) : pos_src_;
 
         //prep distance values
-        tiles.NavDataCleanup();
-        tiles(pos_src).nav.d = 0.f;
+        nav.Cleanup();
+        nav(pos_src).d = 0.f;
 
         //reset the open set tracking
+        pathfindingContainer& open = nav.open;
         open = {};
         open.emplace(H(pos_src, pos_dst), 0.f, pos_src);
         glm::ivec2 size = tiles.Size();
@@ -2342,18 +2516,19 @@ namespace eng {
             NavEntry entry = open.top();
             open.pop();
             TileData& td = tiles(entry.pos);
+            NavScratch& nd = nav(entry.pos);
 
             //skip if (already visited) or (untraversable & not starting pos (that one's untraversable bcs unit's standing there))
-            if(td.nav.visited || !(td.Traversable(navType) || entry.pos == pos_src))
+            if(nd.visited || !(td.Traversable(navType) || entry.pos == pos_src))
                 continue;
             
             it++;
             
             //mark as visited, set distance value
-            ASSERT_MSG(fabsf(entry.d - td.nav.d) < 1e-5f, "Value here should already be a minimal distance ({} < {})", entry.d, td.nav.d);
-            // if(entry.d > td.nav.d) ENG_LOG_WARN("HOPE IT'S JUST A ROUNDING ERROR (distance mismatch): {}, {}", entry.d, td.nav.d);
-            td.nav.visited = true;
-            td.nav.d = std::min(entry.d, td.nav.d);
+            ASSERT_MSG(fabsf(entry.d - nd.d) < 1e-5f, "Value here should already be a minimal distance ({} < {})", entry.d, nd.d);
+            // if(entry.d > nd.d) ENG_LOG_WARN("HOPE IT'S JUST A ROUNDING ERROR (distance mismatch): {}, {}", entry.d, nd.d);
+            nd.visited = true;
+            nd.d = std::min(entry.d, nd.d);
 
             //path to the target destination found - terminate
             if(entry.pos == pos_dst) {
@@ -2370,14 +2545,15 @@ namespace eng {
                         continue;
                     
                     TileData& td = tiles(pos);
+                    NavScratch& nd = nav(pos);
                     float d = entry.d + (((std::abs(x+y)/step) % 2 == 0) ? 1.414213f : 1.f) * step;
 
                     //skip when (untraversable) or (already visited) or (marked as open & current distance is worse than existing distance)
-                    if(!td.Traversable(navType) || (td.nav.visited && d > td.nav.d) || (!std::isinf(td.nav.d) && d > td.nav.d))
+                    if(!td.Traversable(navType) || (nd.visited && d > nd.d) || (!std::isinf(nd.d) && d > nd.d))
                         continue;
 
                     //tmp distance value (tile is still open)
-                    td.nav.d = d;
+                    nd.d = d;
                     
                     float h = H(pos, pos_dst);
                     open.emplace(h+d, d, pos);
@@ -2389,16 +2565,17 @@ namespace eng {
         return found;
     }
 
-    bool Pathfinding_AStar_Range(MapTiles& tiles, pathfindingContainer& open, const glm::ivec2& pos_src_, int range, const glm::ivec2& m, const glm::ivec2& M, glm::ivec2* result_pos, int navType, heuristic_fn H) {
+    bool Pathfinding_AStar_Range(MapTiles& tiles, NavGrid& nav, const glm::ivec2& pos_src_, int range, const glm::ivec2& m, const glm::ivec2& M, glm::ivec2* result_pos, int navType, heuristic_fn H) {
         //airborne units only move on even tiles
         int step = 1 + int(navType != NavigationBit::GROUND);
         glm::ivec2 pos_src = (navType != NavigationBit::GROUND) ? make_even(pos_src_) : pos_src_;
 
         //prep distance values
-        tiles.NavDataCleanup();
-        tiles(pos_src).nav.d = 0.f;
+        nav.Cleanup();
+        nav(pos_src).d = 0.f;
 
         //reset the open set tracking
+        pathfindingContainer& open = nav.open;
         open = {};
         open.emplace(range_heuristic(pos_src, m, M, H), 0.f, pos_src);
         glm::ivec2 size = tiles.Size();
@@ -2409,18 +2586,19 @@ namespace eng {
             NavEntry entry = open.top();
             open.pop();
             TileData& td = tiles(entry.pos);
+            NavScratch& nd = nav(entry.pos);
 
             //skip if (already visited) or (untraversable & not starting pos (that one's untraversable bcs unit's standing there))
-            if(td.nav.visited || !(td.Traversable(navType) || entry.pos == pos_src))
+            if(nd.visited || !(td.Traversable(navType) || entry.pos == pos_src))
                 continue;
             
             it++;
             
             //mark as visited, set distance value
-            ASSERT_MSG(fabsf(entry.d - td.nav.d) < 1e-5f, "Value here should already be a minimal distance ({} < {})", entry.d, td.nav.d);
-            // if(entry.d > td.nav.d) ENG_LOG_WARN("HOPE IT'S JUST A ROUNDING ERROR (distance mismatch): {}, {}", entry.d, td.nav.d);
-            td.nav.visited = true;
-            td.nav.d = std::min(entry.d, td.nav.d);
+            ASSERT_MSG(fabsf(entry.d - nd.d) < 1e-5f, "Value here should already be a minimal distance ({} < {})", entry.d, nd.d);
+            // if(entry.d > nd.d) ENG_LOG_WARN("HOPE IT'S JUST A ROUNDING ERROR (distance mismatch): {}, {}", entry.d, nd.d);
+            nd.visited = true;
+            nd.d = std::min(entry.d, nd.d);
 
             //path to the target destination found - terminate
             if(get_range(entry.pos, m, M) <= range) {
@@ -2440,14 +2618,15 @@ namespace eng {
                         continue;
                     
                     TileData& td = tiles(pos);
+                    NavScratch& nd = nav(pos);
                     float d = entry.d + (((std::abs(x+y)/step) % 2 == 0) ? 1.414213f : 1.f) * step;
 
                     //skip when (untraversable) or (already visited) or (marked as open & current distance is worse than existing distance)
-                    if(!td.Traversable(navType) || (td.nav.visited && d > td.nav.d) || (!std::isinf(td.nav.d) && d > td.nav.d))
+                    if(!td.Traversable(navType) || (nd.visited && d > nd.d) || (!std::isinf(nd.d) && d > nd.d))
                         continue;
 
                     //tmp distance value (tile is still open)
-                    td.nav.d = d;
+                    nd.d = d;
                     
                     float h = range_heuristic(pos, m, M, H);
                     open.emplace(h+d, d, pos);
@@ -2459,22 +2638,23 @@ namespace eng {
         return found;
     }
 
-    bool Pathfinding_AStar_Forrest(MapTiles& tiles, pathfindingContainer& open, const glm::ivec2& pos_src_, const glm::ivec2& pos_dst, int navType, heuristic_fn H) {
+    bool Pathfinding_AStar_Forrest(MapTiles& tiles, NavGrid& nav, const glm::ivec2& pos_src_, const glm::ivec2& pos_dst, int navType, heuristic_fn H) {
         //airborne units only move on even tiles
         int step = 1 + int(navType != NavigationBit::GROUND);
         glm::ivec2 pos_src = (navType != NavigationBit::GROUND) ? make_even(pos_src_) : pos_src_;
 
         //prep distance values
-        tiles.NavDataCleanup();
-        tiles(pos_src).nav.d = 0.f;
+        nav.Cleanup();
+        nav(pos_src).d = 0.f;
 
         //reset the open set tracking
+        pathfindingContainer& open = nav.open;
         open = {};
         open.emplace(H(pos_src, pos_dst), 0.f, pos_src);
         glm::ivec2 size = tiles.Size();
 
         //fillout the entire forrest
-        int forrest_size = tiles.NavData_Forrest_FloodFill(pos_dst);
+        int forrest_size = tiles.NavData_Forrest_FloodFill(nav, pos_dst);
         ENG_LOG_FINEST("    Map::Pathfinding::Alg    | forrest size = {}", forrest_size);
         if(forrest_size < 1) {
             return false;
@@ -2486,18 +2666,19 @@ namespace eng {
             NavEntry entry = open.top();
             open.pop();
             TileData& td = tiles(entry.pos);
+            NavScratch& nd = nav(entry.pos);
 
             //skip if (already visited) or (untraversable & not starting pos (that one's untraversable bcs unit's standing there))
-            if(td.nav.visited || !(td.TraversableOrForrest(navType) || entry.pos == pos_src))
+            if(nd.visited || !(td.TraversableOrForrest(navType, nd) || entry.pos == pos_src))
                 continue;
             
             it++;
             
             //mark as visited, set distance value
-            ASSERT_MSG(fabsf(entry.d - td.nav.d) < 1e-5f, "Value here should already be a minimal distance ({} < {})", entry.d, td.nav.d);
-            // if(entry.d > td.nav.d) ENG_LOG_WARN("HOPE IT'S JUST A ROUNDING ERROR (distance mismatch): {}, {}", entry.d, td.nav.d);
-            td.nav.visited = true;
-            td.nav.d = std::min(entry.d, td.nav.d);
+            ASSERT_MSG(fabsf(entry.d - nd.d) < 1e-5f, "Value here should already be a minimal distance ({} < {})", entry.d, nd.d);
+            // if(entry.d > nd.d) ENG_LOG_WARN("HOPE IT'S JUST A ROUNDING ERROR (distance mismatch): {}, {}", entry.d, nd.d);
+            nd.visited = true;
+            nd.d = std::min(entry.d, nd.d);
 
             //path to the target destination found - terminate
             if(entry.pos == pos_dst) {
@@ -2514,18 +2695,19 @@ namespace eng {
                         continue;
                     
                     TileData& td = tiles(pos);
+                    NavScratch& nd = nav(pos);
                     float d = entry.d + (((std::abs(x+y)/step) % 2 == 0) ? 1.414213f : 1.f) * step;
 
                     //penalize pathfinding through forrest in order to properly navigate to border forrest tiles
                     //higher the penalization value, the more likely will worker lookup closest accessible location to the selected tile
-                    d += td.nav.part_of_forrest * 10.f;
+                    d += nd.part_of_forrest * 10.f;
 
                     //skip when (untraversable) or (already visited) or (marked as open & current distance is worse than existing distance)
-                    if(!td.TraversableOrForrest(navType) || (td.nav.visited && d > td.nav.d) || (!std::isinf(td.nav.d) && d > td.nav.d))
+                    if(!td.TraversableOrForrest(navType, nd) || (nd.visited && d > nd.d) || (!std::isinf(nd.d) && d > nd.d))
                         continue;
 
                     //tmp distance value (tile is still open)
-                    td.nav.d = d;
+                    nd.d = d;
                     
                     float h = H(pos, pos_dst);
                     open.emplace(h+d, d, pos);
@@ -2537,16 +2719,17 @@ namespace eng {
         return found;
     }
 
-    bool Pathfinding_Dijkstra_NearestBuilding(MapTiles& tiles, pathfindingContainer& open, const glm::ivec2& pos_src_, const std::vector<buildingMapCoords>& targets, int unit_resourceType, int navType, glm::ivec2& out_dst_pos) {
+    bool Pathfinding_Dijkstra_NearestBuilding(MapTiles& tiles, NavGrid& nav, const glm::ivec2& pos_src_, const std::vector<buildingMapCoords>& targets, int unit_resourceType, int navType, glm::ivec2& out_dst_pos) {
         //airborne units only move on even tiles
         int step = 1 + int(navType != NavigationBit::GROUND);
         glm::ivec2 pos_src = (navType != NavigationBit::GROUND) ? make_even(pos_src_) : pos_src_;
 
         //prep distance values
-        tiles.NavDataCleanup();
-        tiles(pos_src).nav.d = 0.f;
+        nav.Cleanup();
+        nav(pos_src).d = 0.f;
 
         //reset the open set tracking
+        pathfindingContainer& open = nav.open;
         open = {};
         open.emplace(0.f, 0.f, pos_src);
         glm::ivec2 size = tiles.Size();
@@ -2558,7 +2741,7 @@ namespace eng {
 
             for(int y = m.y; y <= M.y; y++) {
                 for(int x = m.x; x <= M.x; x++) {
-                    tiles(y,x).nav.part_of_forrest = true;
+                    nav(y,x).part_of_forrest = true;
                 }
             }
         }
@@ -2569,21 +2752,22 @@ namespace eng {
             NavEntry entry = open.top();
             open.pop();
             TileData& td = tiles(entry.pos);
+            NavScratch& nd = nav(entry.pos);
 
             //skip if (already visited) or (untraversable & not starting pos (that one's untraversable bcs unit's standing there))
-            if(td.nav.visited || !(td.TraversableOrForrest(navType) || entry.pos == pos_src))
+            if(nd.visited || !(td.TraversableOrForrest(navType, nd) || entry.pos == pos_src))
                 continue;
             
             it++;
             
             //mark as visited, set distance value
-            ASSERT_MSG(fabsf(entry.d - td.nav.d) < 1e-5f, "Value here should already be a minimal distance ({} < {})", entry.d, td.nav.d);
-            // if(entry.d > td.nav.d) ENG_LOG_WARN("HOPE IT'S JUST A ROUNDING ERROR (distance mismatch): {}, {}", entry.d, td.nav.d);
-            td.nav.visited = true;
-            td.nav.d = std::min(entry.d, td.nav.d);
+            ASSERT_MSG(fabsf(entry.d - nd.d) < 1e-5f, "Value here should already be a minimal distance ({} < {})", entry.d, nd.d);
+            // if(entry.d > nd.d) ENG_LOG_WARN("HOPE IT'S JUST A ROUNDING ERROR (distance mismatch): {}, {}", entry.d, nd.d);
+            nd.visited = true;
+            nd.d = std::min(entry.d, nd.d);
 
             //path to the target destination found - terminate
-            if(td.nav.part_of_forrest) {
+            if(nd.part_of_forrest) {
                 out_dst_pos = entry.pos;
                 found = true;
                 break;
@@ -2598,14 +2782,15 @@ namespace eng {
                         continue;
                     
                     TileData& td = tiles(pos);
+                    NavScratch& nd = nav(pos);
                     float d = entry.d + (((std::abs(x+y)/step) % 2 == 0) ? 1.414213f : 1.f) * step;
 
                     //skip when (untraversable) or (already visited) or (marked as open & current distance is worse than existing distance)
-                    if(!td.TraversableOrForrest(navType) || (td.nav.visited && d > td.nav.d) || (!std::isinf(td.nav.d) && d > td.nav.d))
+                    if(!td.TraversableOrForrest(navType, nd) || (nd.visited && d > nd.d) || (!std::isinf(nd.d) && d > nd.d))
                         continue;
 
                     //tmp distance value (tile is still open)
-                    td.nav.d = d;
+                    nd.d = d;
                     
                     open.emplace(d, d, pos);
                 }
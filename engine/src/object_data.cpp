@@ -43,9 +43,12 @@ namespace eng {
     //===== SoundEffect =====
 
     std::string SoundEffect::Random() const {
+        //audio stream - sounds are also triggered by player input, which would desync the simulation's random sequence on replays
+        Random::Generator& gen = Random::Get(Random::Stream::AUDIO);
+
         char buf[512];
         if(variations > 0)
-            snprintf(buf, sizeof(buf), "%s/%s%d.wav", SOUNDS_PATH_PREFIX, path.c_str(), Random::UniformInt(1, variations));
+            snprintf(buf, sizeof(buf), "%s/%s%d.wav", SOUNDS_PATH_PREFIX, path.c_str(), gen.UniformInt(1, variations));
         else
             snprintf(buf, sizeof(buf), "%s/%s.wav", SOUNDS_PATH_PREFIX, path.c_str());
         return std::string(buf);
@@ -14,12 +14,13 @@ namespace eng {
     namespace Resources {
         //defined in resources.cpp
         GameObjectDataRef LinkObject(const std::string& name);
-        GameObjectDataRef LinkObject(const glm::ivec3& num_id, bool initialized_only);
-        UtilityObjectDataRef LinkSpell(int spellID, bool initialized_only);
+        GameObjectDataRef LinkObject(const glm::ivec3& num_id, bool indexed_only);
+        UtilityObjectDataRef LinkSpell(int spellID, bool indexed_only);
     }
 
     //=======
     
+    GameObjectDataRef GameObjectData_Create(int objectType);
     void Parse_GameObjectData(const nlohmann::json& config, GameObjectDataRef data);
     void Parse_FactionObjectData(const nlohmann::json& config, FactionObjectData& data);
     void Parse_BuildingData(const nlohmann::json& config, GameObjectDataRef data);
@@ -45,27 +46,9 @@ namespace eng {
     //========================= INTERFACE FUNCTIONS =================================
 
     GameObjectDataRef GameObjectData_ParseNew(const nlohmann::json& config) {
-        int objectType = config.at("type");
-        GameObjectDataRef data = nullptr;
-
-        switch(objectType) {
-            case ObjectType::BUILDING:
-                data = std::static_pointer_cast<GameObjectData>(std::make_shared<BuildingData>());
-                break;
-            case ObjectType::UNIT:
-                data = std::static_pointer_cast<GameObjectData>(std::make_shared<UnitData>());
-                break;
-            case ObjectType::UTILITY:
-                data = std::static_pointer_cast<GameObjectData>(std::make_shared<UtilityObjectData>());
-                break;
-            default:
-                ENG_LOG_ERROR("Encountered an unrecognized object type when parsing GameObjectData (type = {})", objectType);
-                throw std::runtime_error("");
-        }
-
+        GameObjectDataRef data = GameObjectData_Create(config.at("type"));
         data->str_id = config.at("str_id");
         GameObjectData_ParseExisting(config, data);
-
         return data;
     }
 
@@ -90,6 +73,26 @@ namespace eng {
         }
     }
 
+    GameObjectDataRef GameObjectData_ParseHeaderNew(const nlohmann::json& config) {
+        GameObjectDataRef data = GameObjectData_Create(config.at("type"));
+        GameObjectData_ParseHeader(config, data);
+        return data;
+    }
+
+    void GameObjectData_ParseHeader(const nlohmann::json& config, GameObjectDataRef data) {
+        data->objectType        = config.at("type");
+        data->str_id            = config.at("str_id");
+        data->size              = config.count("size") ? eng::json::parse_vec2(config.at("size")) : glm::vec2(1.f);
+        data->navigationType    = config.at("nav_type");
+
+        data->anim_speed        = config.count("anim_speed") ? float(config.at("anim_speed")) : 1.f;
+
+        data->icon              = config.count("icon") ? json::parse_ivec2(config.at("icon")) : glm::ivec2(0);
+        data->cost              = config.count("cost") ? ParseCost(config.at("cost")) : glm::ivec4(0);
+        data->name              = config.at("name");
+        data->indexed           = true;
+    }
+
     void GameObjectData_FinalizeButtonDescriptions(GameObjectDataRef& dt) {
         FactionObjectDataRef data = std::dynamic_pointer_cast<FactionObjectData>(dt);
         if(data == nullptr)
@@ -225,17 +228,22 @@ namespace eng {
 
     //=======================================================================
 
-    void Parse_GameObjectData(const nlohmann::json& config, GameObjectDataRef data) {
-        data->objectType        = config.at("type");
-        data->str_id            = config.at("str_id");
-        data->size              = config.count("size") ? eng::json::parse_vec2(config.at("size")) : glm::vec2(1.f);
-        data->navigationType    = config.at("nav_type");
-
-        data->anim_speed        = config.count("anim_speed") ? float(config.at("anim_speed")) : 1.f;
+    GameObjectDataRef GameObjectData_Create(int objectType) {
+        switch(objectType) {
+            case ObjectType::BUILDING:
+                return std::static_pointer_cast<GameObjectData>(std::make_shared<BuildingData>());
+            case ObjectType::UNIT:
+                return std::static_pointer_cast<GameObjectData>(std::make_shared<UnitData>());
+            case ObjectType::UTILITY:
+                return std::static_pointer_cast<GameObjectData>(std::make_shared<UtilityObjectData>());
+            default:
+                ENG_LOG_ERROR("Encountered an unrecognized object type when parsing GameObjectData (type = {})", objectType);
+                throw std::runtime_error("");
+        }
+    }
 
-        data->icon              = config.count("icon") ? json::parse_ivec2(config.at("icon")) : glm::ivec2(0);
-        data->cost              = config.count("cost") ? ParseCost(config.at("cost")) : glm::ivec4(0);
-        data->name              = config.at("name");
+    void Parse_GameObjectData(const nlohmann::json& config, GameObjectDataRef data) {
+        GameObjectData_ParseHeader(config, data);
         data->initialized       = true;
     }
 
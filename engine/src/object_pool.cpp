@@ -1,9 +1,9 @@
 #include "engine/game/object_pool.h"
 
 #include "engine/utils/dbg_gui.h"
+#include "engine/utils/jobs.h"
 
-#include "engine/core/input.h"
-#include "engine/game/config.h"
+#include "engine/game/sim_clock.h"
 #include "engine/game/map.h"
 
 #include "engine/game/resources.h"
@@ -15,10 +15,16 @@
 
 #define MAX_UNLOAD_RANGE 3
 
+//extra tiles around the view - units are rendered with interpolated movement & their sprites are larger than a tile
+#define RENDER_CULL_MARGIN 2
+
 namespace eng {
 
     int GetPreferredDirection(const glm::ivec2& target, const glm::ivec2& building);
 
+    //Marks object's pool slot as visited in given frame, returns false if it already was.
+    bool MarkVisited(std::vector<uint32_t>& stamps, ObjectID::dtype idx, uint32_t frame);
+
     //===== EntranceController =====
 
     EntranceController::EntranceController(EntranceController::ExportData&& data, const idMappingType& id_mapping)
@@ -43,10 +49,10 @@ namespace eng {
         //TODO: could maybe use some more fitting data structure, other than vector
 
         //timing updates & respawning for worker entrances
-        float currentTime = (float)Input::CurrentTime();
-        float duration = WORKER_ENTRY_DURATION / Config::GameSpeed();
+        tick_t currentTick = SimClock::Now();
+        tick_t duration = SimClock::Ticks(WORKER_ENTRY_DURATION);
         for(int i = (int)workEntries.size()-1; i >= 0; i--) {   
-            if(workEntries[i].start_time + duration <= currentTime) {
+            if(workEntries[i].start_tick + duration <= currentTick) {
                 IssueExit_Work(objects, workEntries[i]);
                 workEntries.erase(workEntries.begin() + i);
             }
@@ -64,8 +70,7 @@ namespace eng {
                 - need to use it to re-issue the command on object exiting (exiting will be issued from this update method)
                 - how to manage the timing:
                     - there will probably be some shared constant that defines how long does a worker stay inside
-                    - there's also the issue of game speed changing
-                        - exit time will get invalidated whenever speed changes
+                    - timing is measured in simulation ticks (game speed only changes how often the ticks happen)
 
             - how to handle container death:
                 - can maybe do requests from within Kill() method
@@ -110,7 +115,7 @@ namespace eng {
         }
 
         worker->WithdrawObject();
-        workEntries.push_back({ buildingID, workerID, cmd_target, cmd_type, (float)Input::CurrentTime() });
+        workEntries.push_back({ buildingID, workerID, cmd_target, cmd_type, SimClock::Now() });
         ENG_LOG_TRACE("EntranceController::WorkEntrance - Worker '{}' entered '{}'.", *worker, *building);
         return true;
     }
@@ -523,6 +528,8 @@ namespace eng {
     void ObjectPool::Update() {
         entranceController.Update(*this);
 
+        PlanUpdates();
+
         for(int i = 0; i < factionObjectCount.size(); i++)
             factionObjectCount[i] = 0;
         for(int i = 0; i < factionKillCount.size(); i++)
@@ -601,12 +608,57 @@ namespace eng {
         factionKillCount[fIdx][int(isBuilding)]++;
     }
 
-    void ObjectPool::Render() {
+    void ObjectPool::PlanUpdates() {
+        planned.clear();
         for(Unit& u : units)
-            u.Render();
-        
-        for(Building& b : buildings)
-            b.Render();
+            planned.push_back(&u);
+
+        //map isn't modified during planning, units only write into their own command
+        Jobs::ParallelFor(planned.size(), [this](size_t begin, size_t end) {
+            for(size_t i = begin; i < end; i++)
+                planned[i]->PlanUpdate();
+        });
+    }
+
+    void ObjectPool::Render(const Map& map) {
+        auto [m, M] = map.VisibleRange(RENDER_CULL_MARGIN);
+        render_frame++;
+
+        //only the objects on the tiles in view are visited (the same grid the gameplay queries use)
+        int drawn = 0, hidden = 0;
+        for(int y = m.y; y < M.y; y++) {
+            for(int x = m.x; x < M.x; x++) {
+                const TileData& td = map(y, x);
+                for(int i = 0; i < 2; i++) {
+                    const ObjectID& id = td.info[i].id;
+                    if(id.type == ObjectType::UNIT) {
+                        UnitsPool::key key = UnitsPool::key(id.idx, id.id);
+                        if(!MarkVisited(rendered_units, id.idx, render_frame) || !units.exists(key))
+                            continue;
+                        Unit& u = units[key];
+                        if(!u.IsActive() || !map.IsTileVisible(u.Position())) {
+                            hidden++;
+                            continue;
+                        }
+                        u.Render();
+                        drawn++;
+                    }
+                    else if(id.type == ObjectType::BUILDING) {
+                        BuildingsPool::key key = BuildingsPool::key(id.idx, id.id);
+                        if(!MarkVisited(rendered_buildings, id.idx, render_frame) || !buildings.exists(key))
+                            continue;
+                        Building& b = buildings[key];
+                        if(!b.IsActive() || !map.IsTileExplored(b.Position(), b.Data()->size)) {
+                            hidden++;
+                            continue;
+                        }
+                        b.Render();
+                        drawn++;
+                    }
+                }
+            }
+        }
+        render_stats = glm::ivec3(drawn, int(units.size() + buildings.size()) - drawn - hidden, hidden);
         
         for(UtilityObject& u : utilityObjs)
             u.Render();
@@ -778,6 +830,26 @@ namespace eng {
         return ObjectID();
     }
 
+    ObjectID ObjectPool::FindObject(ObjectID::dtype type, ObjectID::dtype id) {
+        ObjectID::dtype idx = ObjectID::dtype(-1);
+        bool found = false;
+        switch(type) {
+            case ObjectType::UNIT:
+                idx = units.find(id);
+                found = (idx != ObjectID::dtype(-1)) && units.taken(idx);
+                break;
+            case ObjectType::BUILDING:
+                idx = buildings.find(id);
+                found = (idx != ObjectID::dtype(-1)) && buildings.taken(idx);
+                break;
+            case ObjectType::UTILITY:
+                idx = utilityObjs.find(id);
+                found = (idx != ObjectID::dtype(-1)) && utilityObjs.taken(idx);
+                break;
+        }
+        return found ? ObjectID(type, idx, id) : ObjectID();
+    }
+
     Unit& ObjectPool::GetUnit(const ObjectID& id) {
         ASSERT_MSG(id.type != ObjectType::INVALID, "ObjectPool::GetUnit - Using an invalid ID to access a unit.");
         if(id.type != ObjectType::UNIT) {
@@ -950,6 +1022,7 @@ namespace eng {
 
         ImGui::Text("Units: %d, Buildings: %d, Utilities: %d", (int)units.size(), (int)buildings.size(), (int)utilityObjs.size());
         ImGui::Text("Faction Object Counter: %s", factionObjectCount_str.str().c_str());
+        ImGui::Text("Rendered: %d drawn, %d culled (out of view), %d hidden (occlusion/fog)", render_stats.x, render_stats.y, render_stats.z);
         ImGui::Separator();
 
         // float indent_val = ImGui::GetWindowSize().x * 0.05f;
@@ -1000,4 +1073,13 @@ namespace eng {
         return res;
     }
 
+    bool MarkVisited(std::vector<uint32_t>& stamps, ObjectID::dtype idx, uint32_t frame) {
+        if(size_t(idx) >= stamps.size())
+            stamps.resize(size_t(idx) + 1, 0);
+        if(stamps[idx] == frame)
+            return false;
+        stamps[idx] = frame;
+        return true;
+    }
+
 }//namespace eng
@@ -3,6 +3,8 @@
 #include "engine/core/input.h"
 #include "engine/core/renderer.h"
 #include "engine/utils/generator.h"
+#include "engine/utils/jobs.h"
+#include "engine/utils/timer.h"
 #include "engine/game/resources.h"
 #include "engine/game/camera.h"
 #include "engine/game/config.h"
@@ -32,6 +34,10 @@ namespace eng {
 
     void format_wBonus(char* buf, size_t buf_size, const char* prefix, int val_bonus, glm::ivec2& out_highlight_idx);
 
+    //Issues player's order & records it into the level's replay log.
+    void IssuePlayerCommand(Level& level, Unit& unit, const Command& cmd);
+    void IssuePlayerAction(Level& level, Building& building, const BuildingAction& action, const glm::ivec3& price);
+
     void RenderGUIBorders(bool isOrc, float z);
     std::vector<GUI::StyleRef> SetupScrollMenuStyles(const FontRef& font, const glm::vec2& scrollMenuSize, int scrollMenuItems, float scrollButtonSize, const glm::vec2& smallBtnSize);
     std::vector<GUI::StyleRef> SetupSliderStyles(const FontRef& font, const glm::vec2& scrollMenuSize, int scrollMenuItems, float scrollButtonSize, const glm::vec2& smallBtnSize);
@@ -1442,7 +1448,7 @@ namespace eng {
             }
             
             ENG_LOG_FINE("Targeted command - '{}' - pos: ({}, {}), ID: {}, payload: {}", cmd_name, target_pos.x, target_pos.y, target_id, payload_id);
-            unit.IssueCommand(cmd);
+            IssuePlayerCommand(level, unit, cmd);
 
             if(unit.Sound_Yes().valid) {
                 Audio::Play(unit.Sound_Yes().Random());
@@ -1531,11 +1537,11 @@ namespace eng {
                 
                 if(conditions_met) {
                     ENG_LOG_FINE("Targeted command - Unit[{}] - issued {}", i, cmd_name);
-                    unit.IssueCommand(cmd);
+                    IssuePlayerCommand(level, unit, cmd);
                 }
                 else {
                     ENG_LOG_FINE("Targeted command - Unit[{}] - conditions failed", i);
-                    unit.IssueCommand(Command::Move(target_pos));
+                    IssuePlayerCommand(level, unit, Command::Move(target_pos));
                 }
 
                 if(i == 0 && unit.Sound_Yes().valid) {
@@ -1576,27 +1582,27 @@ namespace eng {
             //command resolution based on unit type & target type
             if(unit.IsWorker() && gatherable) {
                 ENG_LOG_FINE("Adaptive command - Unit[{}] - Gather", i);
-                unit.IssueCommand(Command::Gather(target_id));
+                IssuePlayerCommand(level, unit, Command::Gather(target_id));
             }
             else if(unit.IsWorker() && harvestable) {
                 ENG_LOG_FINE("Adaptive command - Unit[{}] - Harvest", i);
-                unit.IssueCommand(Command::Harvest(target_pos));
+                IssuePlayerCommand(level, unit, Command::Harvest(target_pos));
             }
             else if(unit.IsWorker() && repairable) {
                 ENG_LOG_FINE("Adaptive command - Unit[{}] - Repair", i);
-                unit.IssueCommand(Command::Repair(target_id));
+                IssuePlayerCommand(level, unit, Command::Repair(target_id));
             }
             else if(attackable && enemy) {
                 ENG_LOG_FINE("Adaptive command - Unit[{}] - Attack", i);
-                unit.IssueCommand(Command::Attack(target_id, target_pos_sharpened));
+                IssuePlayerCommand(level, unit, Command::Attack(target_id, target_pos_sharpened));
             }
             else if(transport && !enemy) {
                 ENG_LOG_FINE("Adaptive command - Unit[{}] - Enter transport", i);
-                unit.IssueCommand(Command::EnterTransport(target_id));
+                IssuePlayerCommand(level, unit, Command::EnterTransport(target_id));
             }
             else if(level.map.IsWithinBounds(target_pos)) {
                 ENG_LOG_FINE("Adaptive command - Unit[{}] - Move", i);
-                unit.IssueCommand(Command::Move(target_pos));
+                IssuePlayerCommand(level, unit, Command::Move(target_pos));
             }
 
             //play unit sound
@@ -1644,23 +1650,24 @@ namespace eng {
 
                 player->PayResources(price);
             }
+            glm::ivec3 paid = Config::Hack_NoPrices() ? glm::ivec3(0) : price;
             
             switch(command_id) {
                 case GUI::ActionButton_CommandType::UPGRADE:
                     ENG_LOG_FINE("Targetless command - Upgrade (payload={})", payload_id);
-                    building.IssueAction(BuildingAction::Upgrade(payload_id));
+                    IssuePlayerAction(level, building, BuildingAction::Upgrade(payload_id), paid);
                     building.LastBtnIcon() = last_click_icon;
                     update_flag = true;
                     break;
                 case GUI::ActionButton_CommandType::RESEARCH:
                     ENG_LOG_FINE("Targetless command - Research (payload={})", payload_id);
-                    building.IssueAction(BuildingAction::TrainOrResearch(false, payload_id, building.TrainOrResearchTime(false, payload_id)));
+                    IssuePlayerAction(level, building, BuildingAction::TrainOrResearch(false, payload_id, building.TrainOrResearchTime(false, payload_id)), paid);
                     building.LastBtnIcon() = last_click_icon;
                     update_flag = true;
                     break;
                 case GUI::ActionButton_CommandType::TRAIN:
                     ENG_LOG_FINE("Targetless command - Train (payload={})", payload_id);
-                    building.IssueAction(BuildingAction::TrainOrResearch(true, payload_id, building.TrainOrResearchTime(true, payload_id)));
+                    IssuePlayerAction(level, building, BuildingAction::TrainOrResearch(true, payload_id, building.TrainOrResearchTime(true, payload_id)), paid);
                     building.LastBtnIcon() = last_click_icon;
                     update_flag = true;
                     break;
@@ -1718,7 +1725,7 @@ namespace eng {
                 Unit& unit = level.objects.GetUnit(selection[i]);
                 bool return_goods_condition = unit.IsWorker() && (unit.CarryStatus() != WorkerCarryState::NONE);
                 if(command_id != GUI::ActionButton_CommandType::RETURN_GOODS || return_goods_condition) {
-                    unit.IssueCommand(cmd);
+                    IssuePlayerCommand(level, unit, cmd);
                     ENG_LOG_FINE("Targetless command - Unit[{}] - {}", i, cmd_name);
 
                     if(i == 0 && unit.Sound_Yes().valid) {
@@ -1742,6 +1749,7 @@ namespace eng {
         }
 
         ENG_LOG_FINE("Canceling building action (action type={})", building.BuildActionType());
+        level.replay.RecordCancel(building.OID());
         building.CancelAction();
     }
 
@@ -2025,7 +2033,15 @@ namespace eng {
     }
 
     PlayerFactionController::PlayerFactionController(FactionsFile::FactionEntry&& entry, const glm::ivec2& mapSize)
-        : FactionController(std::move(entry), mapSize, FactionControllerID::LOCAL_PLAYER), mapview(MapView(mapSize)), occlusion(OcclusionMask(entry.occlusionData, mapSize)) {
+        : FactionController(std::move(entry), mapSize, FactionControllerID::LOCAL_PLAYER), occlusion(OcclusionMask(entry.occlusionData, mapSize)) {
+        if(Jobs::IsMainThread())
+            InitializeGraphics(mapSize);
+    }
+
+    void PlayerFactionController::InitializeGraphics(const glm::ivec2& mapSize) {
+        if(mapview.GetTexture() != nullptr)
+            return;
+        mapview = MapView(mapSize);
         InitializeGUI();
     }
 
@@ -2039,11 +2055,13 @@ namespace eng {
         }
 
         //render individual GUI elements
+        Timer t = {};
         game_panel.Render();
         text_prompt.Render();
         msg_bar.Render();
         resources.Render();
         price.Render();
+        dbg_guiTime = 0.95f * dbg_guiTime + 0.05f * float(t.TimeElapsed());
         RenderMapView();
 
         RenderBuildingViz();
@@ -2058,7 +2076,7 @@ namespace eng {
         selection.Render();
     }
 
-    void PlayerFactionController::Update(Level& level) {
+    void PlayerFactionController::FrameUpdate(Level& level) {
 
         selection.GroupsUpdate(level);
         resources.Update(level.factions.Player()->Resources(), level.factions.Player()->Population());
@@ -2734,6 +2752,11 @@ namespace eng {
 #ifdef ENGINE_ENABLE_GUI
         selection.DBG_GUI();
         // ImGui::ColorEdit4("shadows", (float*)&clr);
+
+        ImGui::Text("GUI render (CPU): %.1f us | Text layouts rebuilt: %d", dbg_guiTime, TextLayout::RebuildCount());
+        bool caching = TextLayout::Caching();
+        if(ImGui::Checkbox("Cached text layouts", &caching))
+            TextLayout::SetCaching(caching);
 #endif
     }
 
@@ -2753,6 +2776,16 @@ namespace eng {
 
     //==============================================================
 
+    void IssuePlayerCommand(Level& level, Unit& unit, const Command& cmd) {
+        level.replay.RecordCommand(unit.OID(), cmd);
+        unit.IssueCommand(cmd);
+    }
+
+    void IssuePlayerAction(Level& level, Building& building, const BuildingAction& action, const glm::ivec3& price) {
+        level.replay.RecordAction(building.OID(), action, price);
+        building.IssueAction(action);
+    }
+
     void RenderGUIBorders(bool isOrc, float z) {
         Window& window = Window::Get();
 
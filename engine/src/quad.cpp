@@ -1,5 +1,7 @@
 #include "engine/core/quad.h"
 
+#include <glm/gtc/packing.hpp>
+
 namespace eng {
 
     int Quad::paletteSize = 1;
@@ -12,6 +14,15 @@ namespace eng {
 
     //======= QuadVertices =======
 
+    QuadVertices QuadVertices::FromCorner(const glm::uvec4& info, const glm::vec3& botLeft, const glm::vec2& size, const glm::vec4& color, const TexCoords& tc) {
+        QuadVertices q = {};
+        q.vertices[0] = Vertex(botLeft + glm::vec3(0.f, 0.f, 0.f),       color, tc[0], info);
+        q.vertices[1] = Vertex(botLeft + glm::vec3(0.f, size.y, 0.f),    color, tc[1], info);
+        q.vertices[2] = Vertex(botLeft + glm::vec3(size.x, 0.f, 0.f),    color, tc[2], info);
+        q.vertices[3] = Vertex(botLeft + glm::vec3(size.x, size.y, 0.f), color, tc[3], info);
+        return q;
+    }
+
     Vertex& QuadVertices::operator[](int i) {
         return vertices[i];
     }
@@ -42,6 +53,10 @@ namespace eng {
         vertices[0].alphaFromTexture = vertices[1].alphaFromTexture = vertices[2].alphaFromTexture = vertices[3].alphaFromTexture = enabled ? 1.f : 0.f;
     }
 
+    void QuadVertices::SetDistanceField(bool enabled) {
+        vertices[0].alphaFromTexture = vertices[1].alphaFromTexture = vertices[2].alphaFromTexture = vertices[3].alphaFromTexture = enabled ? 2.f : 0.f;
+    }
+
     void QuadVertices::SetPaletteIdx(float idx) {
         vertices[0].paletteIdx = vertices[1].paletteIdx = vertices[2].paletteIdx = vertices[3].paletteIdx = idx;
     }
@@ -54,6 +69,46 @@ namespace eng {
         indices[4] = (uint32_t)(-1);
     }
 
+    //======= SpriteInstance =======
+
+    SpriteInstance SpriteInstance::FromCorner(const glm::vec3& botLeft, const glm::vec2& size, const glm::vec4& color, const TexCoords& tc) {
+        SpriteInstance s = {};
+        s.position = botLeft;
+        s.size = glm::u16vec2(glm::packHalf1x16(size.x), glm::packHalf1x16(size.y));
+        s.texRect = glm::u16vec4(
+            glm::packUnorm1x16(tc[0].x), glm::packUnorm1x16(tc[0].y),
+            glm::packUnorm1x16(tc[3].x), glm::packUnorm1x16(tc[3].y)
+        );
+        s.color = glm::u8vec4(glm::round(glm::clamp(color, 0.f, 1.f) * 255.f));
+        s.paletteIdx = glm::packHalf1x16(-1.f);
+        return s;
+    }
+
+    QuadVertices SpriteInstance::Vertices() const {
+        glm::vec2 sz = glm::vec2(glm::unpackHalf1x16(size.x), glm::unpackHalf1x16(size.y));
+        glm::vec2 tc0 = glm::vec2(glm::unpackUnorm1x16(texRect.x), glm::unpackUnorm1x16(texRect.y));
+        glm::vec2 tc1 = glm::vec2(glm::unpackUnorm1x16(texRect.z), glm::unpackUnorm1x16(texRect.w));
+        TexCoords tc = TexCoords(tc0, glm::vec2(tc0.x, tc1.y), glm::vec2(tc1.x, tc0.y), tc1);
+
+        QuadVertices q = QuadVertices::FromCorner(Quad::DefaultInfo(), position, sz, glm::vec4(color) * (1.f / 255.f), tc);
+        q.UpdateTextureIdx(textureID);
+        q.SetAlphaFromTexture((flags & 1) != 0);
+        q.SetPaletteIdx(glm::unpackHalf1x16(paletteIdx));
+        return q;
+    }
+
+    void SpriteInstance::UpdateTextureIdx(uint32_t texIdx) {
+        textureID = uint8_t(texIdx);
+    }
+
+    void SpriteInstance::SetAlphaFromTexture(bool enabled) {
+        flags = enabled ? (flags | 1) : (flags & ~1);
+    }
+
+    void SpriteInstance::SetPaletteIdx(float idx) {
+        paletteIdx = glm::packHalf1x16(idx);
+    }
+
 
     //======= Quad =======
 
@@ -130,11 +185,7 @@ namespace eng {
         Quad q = {};
 
         q.tex = texture;
-
-        q.vertices[0] = Vertex(botLeft + glm::vec3(0.f, 0.f, 0.f),       color, tc[0], info);
-        q.vertices[1] = Vertex(botLeft + glm::vec3(0.f, size.y, 0.f),    color, tc[1], info);
-        q.vertices[2] = Vertex(botLeft + glm::vec3(size.x, 0.f, 0.f),    color, tc[2], info);
-        q.vertices[3] = Vertex(botLeft + glm::vec3(size.x, size.y, 0.f), color, tc[3], info);
+        q.vertices = QuadVertices::FromCorner(info, botLeft, size, color, tc);
         
         return q;
     }
@@ -199,14 +250,14 @@ namespace eng {
         float h = c.size.y * size_mult.y;
 
         float tx = c.textureOffset;
-        float ow = c.size.x;
-        float oh = c.size.y;
+        float ow = c.textureSize.x;
+        float oh = c.textureSize.y;
 
         q.vertices[0] = Vertex(glm::vec3(x  , y  , z), color, glm::vec2(tx   , oh ) * texSize_inv, info);
         q.vertices[1] = Vertex(glm::vec3(x  , y+h, z), color, glm::vec2(tx   , 0.f) * texSize_inv, info);
         q.vertices[2] = Vertex(glm::vec3(x+w, y  , z), color, glm::vec2(tx+ow, oh ) * texSize_inv, info);
         q.vertices[3] = Vertex(glm::vec3(x+w, y+h, z), color, glm::vec2(tx+ow, 0.f) * texSize_inv, info);
-        q.vertices.SetAlphaFromTexture(true);
+        q.vertices.SetDistanceField(true);
 
         return q;
     }
@@ -218,22 +269,23 @@ namespace eng {
         float x = pos.x + c.bearing.x * size_mult.x;
         float y = pos.y - (c.size.y - c.bearing.y) * size_mult.y;
 
-        int cut = std::max(c.size.y - c.bearing.y + cp, 0);
+        float cut = std::max(c.size.y - c.bearing.y + cp, 0.f);
 
         float w = c.size.x * size_mult.x;
         float h = std::min(c.size.y, cut) * size_mult.y;
 
         float tx = c.textureOffset;
-        float ow = c.size.x;
-        float oh = c.size.y;
+        float ow = c.textureSize.x;
+        float oh = c.textureSize.y;
 
-        float ch = std::max(c.size.y - cut, 0);
+        //clipped part in atlas pixels
+        float ch = (c.size.y > 0.f) ? (std::max(c.size.y - cut, 0.f) * oh / c.size.y) : 0.f;
 
         q.vertices[0] = Vertex(glm::vec3(x  , y  , z), color, glm::vec2(tx   , oh) * texSize_inv, info);
         q.vertices[1] = Vertex(glm::vec3(x  , y+h, z), color, glm::vec2(tx   , ch) * texSize_inv, info);
         q.vertices[2] = Vertex(glm::vec3(x+w, y  , z), color, glm::vec2(tx+ow, oh) * texSize_inv, info);
         q.vertices[3] = Vertex(glm::vec3(x+w, y+h, z), color, glm::vec2(tx+ow, ch) * texSize_inv, info);
-        q.vertices.SetAlphaFromTexture(true);
+        q.vertices.SetDistanceField(true);
 
         return q;
     }
@@ -254,14 +306,15 @@ namespace eng {
         float yh = std::max(y+h, floor);
 
         float tx = c.textureOffset;
-        float ow = c.size.x;
-        float oh = std::max(c.size.y - c.size.y + c.bearing.y, cp) - std::max(-c.size.y + c.bearing.y, cp);
+        float ow = c.textureSize.x;
+        float vis = std::max(c.bearing.y, float(cp)) - std::max(-c.size.y + c.bearing.y, float(cp));
+        float oh = (c.size.y > 0.f) ? (vis * c.textureSize.y / c.size.y) : 0.f;
 
         q.vertices[0] = Vertex(glm::vec3(x  , yl, z), color, glm::vec2(tx   , oh ) * texSize_inv, info);
         q.vertices[1] = Vertex(glm::vec3(x  , yh, z), color, glm::vec2(tx   , 0.f) * texSize_inv, info);
         q.vertices[2] = Vertex(glm::vec3(x+w, yl, z), color, glm::vec2(tx+ow, oh ) * texSize_inv, info);
         q.vertices[3] = Vertex(glm::vec3(x+w, yh, z), color, glm::vec2(tx+ow, 0.f) * texSize_inv, info);
-        q.vertices.SetAlphaFromTexture(true);
+        q.vertices.SetDistanceField(true);
 
         return q;
     }
@@ -3,29 +3,61 @@
 
 namespace eng::Random {
 
-    struct Data {
-        std::mt19937 gen;
-        std::uniform_real_distribution<float> dist;
+    struct Streams {
+        Generator gen[Stream::COUNT];
     public:
-        Data() : gen(std::mt19937(std::random_device{}())), dist(std::uniform_real_distribution<float>(0.f, 1.f)) {}
+        Streams() {
+            std::random_device rd;
+            for(int i = 0; i < Stream::COUNT; i++)
+                gen[i].Seed((uint64_t(rd()) << 32) | rd());
+        }
     };
 
-    static Data data = {};
+    static thread_local Streams streams = {};
 
     //==================
 
+    void Generator::Seed(uint64_t seed) {
+        //splitmix64 - spreads the seed bits over the whole state (never yields all-zero state)
+        for(int i = 0; i < 2; i++) {
+            uint64_t z = (seed += 0x9e3779b97f4a7c15ULL);
+            z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+            z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+            z = z ^ (z >> 31);
+            s[2*i+0] = uint32_t(z);
+            s[2*i+1] = uint32_t(z >> 32);
+        }
+    }
+
+    //==================
+
+    Generator& Get(int stream) {
+        return streams.gen[stream];
+    }
+
+    void Seed(uint64_t seed) {
+        streams.gen[Stream::SIMULATION].Seed(seed);
+    }
+
+    Generator State() {
+        return streams.gen[Stream::SIMULATION];
+    }
+
+    void Restore(const Generator& state) {
+        if(state.Valid())
+            streams.gen[Stream::SIMULATION] = state;
+    }
+
     float Uniform() {
-        return data.dist(data.gen);
+        return streams.gen[Stream::SIMULATION].Uniform();
     }
 
     int UniformInt(int max) {
-        std::uniform_int_distribution<int> dist = std::uniform_int_distribution<int>(0, max);
-        return dist(data.gen);
+        return streams.gen[Stream::SIMULATION].UniformInt(max);
     }
-    
+
     int UniformInt(int min, int max) {
-        std::uniform_int_distribution<int> dist = std::uniform_int_distribution<int>(min, max);
-        return dist(data.gen);
+        return streams.gen[Stream::SIMULATION].UniformInt(min, max);
     }
 
 }//namespace eng::Random
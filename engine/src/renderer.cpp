@@ -6,19 +6,57 @@
 #include "engine/utils/setup.h"
 #include "engine/core/texture.h"
 
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
 namespace eng {
 
     namespace Renderer {
 
         //TODO: move somewhere and make it modifiable
-        static constexpr int BATCH_SIZE = 1000;
+        static constexpr int BATCH_SIZE = 4096;
+
+        //Streaming buffers are split into regions (one batch each), GPU reads from one while the next ones are being filled.
+        static constexpr int RING_REGIONS = 3;
 
-        //TODO: maybe query from the driver... glGetIntegerv(GL_MAX_TEXTURE_IMAGE_UNITS, &maxUnits);
-        static constexpr int MAX_TEXTURE_COUNT = 8;
+        //Upper limit for the texture slots (has to match MAX_TEXTURES in the fragment shaders). Actual slot count also depends on the driver.
+        static constexpr int MAX_TEXTURE_COUNT = 16;
 
-        //Looks up texture's slot (or assigns new one if the texture doesn't have one).
+        //Depth quantization for the deferred mode sorting (finer than any depth step used by the game - GUI text offset is 1e-4).
+        static constexpr float DEFERRED_DEPTH_STEP = 1e-5f;
+
+        //Looks up texture's slot (or assigns new one if the texture doesn't have one). Handle 0 = no texture (blank texture's slot).
         //Can also triggers Flush(), if there isn't any space left for additional texture.
-        uint32_t ResolveTextureIdx(const TextureRef& tex);
+        uint32_t ResolveTextureIdx(GLuint handle);
+
+        //Vertex attributes layout of the Vertex struct (for the currently bound VAO & VBO).
+        void SetupVertexAttributes();
+
+        //Sorts the quads collected in deferred mode & pushes them through the regular batch.
+        void SubmitDeferred();
+
+        //Issues the draw call for the current batch.
+        void FlushBatch();
+
+        //Fences the region, that was just drawn from & moves the batch to the next one (waits if the GPU is still reading from it).
+        void NextRingRegion();
+
+        //Appends the current batch to the recording (sprites expanded into quads).
+        void RecordBatch();
+
+        //False when nothing goes to the GPU (headless build or null/recording backend).
+        bool UsesGL();
+
+        //Quad or sprite collected in deferred mode, sorted back to front, then by texture (submission order within the same key).
+        struct DeferredEntry {
+            int64_t depth;
+            GLuint texture;
+            bool sprite;
+            uint32_t index;
+        public:
+            bool operator<(const DeferredEntry& e) const;
+        };
 
         //Carries the internal renderer state.
         struct RendererInstance {
@@ -26,32 +64,60 @@ namespace eng {
             GLuint vbo = 0;
             GLuint ebo = 0;
 
+            //instanced sprites
+            GLuint instanceVao = 0;
+            GLuint instanceVbo = 0;
+
             ShaderRef shader = nullptr;
+            ShaderRef spriteShader = nullptr;
             FramebufferRef fbo = nullptr;
 
+            int backend = Backend::GL;
+            Recording recording = {};
+
+            //persistently mapped ring buffers (plain arrays with a single region without GL)
+            QuadVertices* quadRing = nullptr;
+            SpriteInstance* instanceRing = nullptr;
+            GLsync fences[RING_REGIONS] = {};
+            int region = 0;
+
+            //current batch - points into the ring region, that's being filled
             QuadVertices* quadBuffer = nullptr;
-            QuadIndices* indexBuffer = nullptr;
+            SpriteInstance* instanceBuffer = nullptr;
 
             RenderStats stats = {};
             bool inProgress = false;
 
             int idx = 0;
+            int instanceIdx = 0;
+            bool instancing = false;
 
             int texIdx = 1;
             int texIdxEnd = MAX_TEXTURE_COUNT-1;
 
+            //deferred submission
+            bool deferred = false;
+            std::vector<DeferredEntry> deferredEntries;
+            std::vector<QuadVertices> deferredQuads;
+            std::vector<SpriteInstance> deferredSprites;
+
             GLuint textures[MAX_TEXTURE_COUNT];
             TextureRef blankTexture = nullptr;
 
+            //last resolved texture (consecutive quads mostly come from the same atlas)
+            GLuint lastHandle = 0;
+            uint32_t lastTexIdx = 0;
+
             int lastFlush_wastedQuads = 0;
 
-            int maxTextureCount = 8;
+            int maxTextureCount = MAX_TEXTURE_COUNT;
             int maxTextureSize = 0;
         public:
             RendererInstance() = default;
             ~RendererInstance();
 
-            void Initialize();
+            void Initialize(int backend);
+            void Release();
             bool IsInitialized() const;
         };
 
@@ -75,14 +141,23 @@ namespace eng {
             return instance.maxTextureSize;
         }
 
+        int ActiveBackend() {
+            return instance.backend;
+        }
+
+        const Recording& Recorded() {
+            return instance.recording;
+        }
+
         //======================
 
-        void Initialize() {
+        void Initialize(int backend) {
             if(!instance.IsInitialized())
-                instance.Initialize();
+                instance.Initialize(backend);
         }
 
         void Release() {
+            instance.Release();
             instance = {};
         }
 
@@ -101,34 +176,67 @@ namespace eng {
 
             //first call -> initialize the renderer
             if(!instance.IsInitialized())
-                instance.Initialize();
+                instance.Initialize(Backend::GL);
 
-            if(shader == nullptr) {
+            if(shader == nullptr && UsesGL()) {
                 ENG_LOG_ERROR("Renderer requires a valid shader in order to render.");
                 throw std::exception();
             }
             instance.shader = shader;
 
+            if(instance.backend == Backend::Recording)
+                instance.recording.Clear();
+
             //reset all texture slots to blank texture
-            GLuint blank_handle = instance.blankTexture->Handle();
-            for (int i = 0; i < MAX_TEXTURE_COUNT; i++) {
+            GLuint blank_handle = (instance.blankTexture != nullptr) ? instance.blankTexture->Handle() : 0;
+            for (int i = 0; i < instance.maxTextureCount; i++) {
                 instance.textures[i] = blank_handle;
             }
             instance.idx = 0;
+            instance.instanceIdx = 0;
+            instance.instancing = false;
+            instance.spriteShader = nullptr;
+            instance.deferred = false;
+            instance.deferredEntries.clear();
+            instance.deferredQuads.clear();
+            instance.deferredSprites.clear();
             instance.texIdx = 1;
-            instance.texIdxEnd = MAX_TEXTURE_COUNT - 1;
+            instance.texIdxEnd = instance.maxTextureCount - 1;
             instance.lastFlush_wastedQuads = 0;
+            instance.lastHandle = 0;
+            instance.lastTexIdx = 0;
 
             //bind fbo & clear; move to Flush() maybe? (in case some fbo switching happens during the render)
             instance.fbo = fbo;
-            if(instance.fbo != nullptr)
-                instance.fbo->Bind();
-            else
-                Framebuffer::Unbind();
+#ifndef ENGINE_HEADLESS
+            if(UsesGL()) {
+                if(instance.fbo != nullptr)
+                    instance.fbo->Bind();
+                else
+                    Framebuffer::Unbind();
+
+                if(clearFBO) {
+                    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+                }
+            }
+#endif
+        }
 
-            if(clearFBO) {
-                glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+        void UseSpriteShader(const ShaderRef& shader) {
+            if(shader == nullptr && UsesGL()) {
+                ENG_LOG_ERROR("Renderer - instanced sprite path requires a valid shader.");
+                throw std::exception();
             }
+            //pending quads were submitted before the switch
+            Flush();
+            instance.spriteShader = shader;
+            instance.instancing = true;
+        }
+
+        void DeferredMode(bool enabled) {
+            //quads collected so far are submitted before the switch
+            Flush();
+            instance.deferred = enabled;
         }
 
         void End() {
@@ -138,173 +246,472 @@ namespace eng {
             instance.inProgress = false;
 
             Flush();
+            instance.instancing = false;
+            instance.spriteShader = nullptr;
+            instance.deferred = false;
             // ENG_LOG_INFO("Draw calls: {}", instance.stats.drawCalls);
         }
 
         void Flush() {
-            if (instance.idx > 0) {
-                ASSERT_MSG(instance.shader != nullptr, "\tRenderer requires shader to function.\n");
+            if(instance.deferred && !instance.deferredEntries.empty())
+                SubmitDeferred();
+            FlushBatch();
+        }
 
-                glEnable(GL_PRIMITIVE_RESTART);
-                glPrimitiveRestartIndex((unsigned int)-1);
+        //======================
 
-                instance.shader->Bind();
-                glBindVertexArray(instance.vao);
+        void RenderQuad(const Quad& quad) {
+            RenderQuad(quad.vertices, (quad.tex != nullptr) ? quad.tex->Handle() : 0);
+        }
 
-                //upload quad vertex buffer
-                glBindBuffer(GL_ARRAY_BUFFER, instance.vbo);
-                glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(QuadVertices) * instance.idx, instance.quadBuffer);
+        void RenderQuad(const QuadVertices& vertices, GLuint texture) {
+            if(instance.deferred) {
+                float depth = 0.25f * (vertices[0].position.z + vertices[1].position.z + vertices[2].position.z + vertices[3].position.z);
+                instance.deferredEntries.push_back({ int64_t(std::floor(depth / DEFERRED_DEPTH_STEP)), texture, false, uint32_t(instance.deferredQuads.size()) });
+                instance.deferredQuads.push_back(vertices);
+                return;
+            }
 
-                //upload quad index buffer
-                glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, instance.ebo);
-                glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, 0, sizeof(QuadIndices) * instance.idx, instance.indexBuffer);
+            if(instance.instanceIdx > 0)
+                Flush();
 
-                //bind all used textures into proper slots
-                // ENG_LOG_INFO("Draw call textures:");
-                for (int i = 0; i < MAX_TEXTURE_COUNT; i++) {
-                    Texture::Bind(i, instance.textures[i]);
-                    // ENG_LOG_INFO("[{}] - '{}' ({})", i, instance.textures[i]->Name(), instance.textures[i]->Handle());
-                }
-                // ENG_LOG_INFO("----");
+            //resolve needs to be done before adding to buffers, since it can trigger Flush()
+            uint32_t texIdx = ResolveTextureIdx(texture);
 
-                //draw the quads
-                glDrawElements(GL_TRIANGLE_STRIP, instance.idx * 5, GL_UNSIGNED_INT, nullptr);
-                instance.stats.drawCalls++;
-                instance.stats.totalQuads += instance.idx;
-                instance.stats.wastedQuads += instance.lastFlush_wastedQuads;
-                instance.stats.numTextures += instance.texIdx-1;
-                instance.lastFlush_wastedQuads = BATCH_SIZE - instance.idx;
-            }
+            instance.quadBuffer[instance.idx] = vertices;
+            instance.quadBuffer[instance.idx].UpdateTextureIdx(texIdx);
 
-            instance.idx = 0;
-            instance.texIdx = 1;
+            instance.idx++;
+            if(instance.idx >= BATCH_SIZE) {
+                Flush();
+            }
         }
 
-        //======================
+        void RenderSprite(const SpriteInstance& sprite, GLuint texture) {
+            if(instance.deferred) {
+                instance.deferredEntries.push_back({ int64_t(std::floor(sprite.position.z / DEFERRED_DEPTH_STEP)), texture, true, uint32_t(instance.deferredSprites.size()) });
+                instance.deferredSprites.push_back(sprite);
+                return;
+            }
 
-        void RenderQuad(const Quad& quad) {
-            //resolve needs to be done before adding to buffers, since it can trigger Flush()
-            uint32_t texIdx = ResolveTextureIdx(quad.tex);
+            if(!instance.instancing) {
+                RenderQuad(sprite.Vertices(), texture);
+                return;
+            }
 
-            instance.quadBuffer[instance.idx] = quad.vertices;
-            instance.indexBuffer[instance.idx] = QuadIndices(instance.idx);
+            if(instance.idx > 0)
+                Flush();
 
-            instance.quadBuffer[instance.idx].UpdateTextureIdx(texIdx);
+            uint32_t texIdx = ResolveTextureIdx(texture);
 
-            instance.idx++;
-            if(instance.idx >= BATCH_SIZE) {
+            instance.instanceBuffer[instance.instanceIdx] = sprite;
+            instance.instanceBuffer[instance.instanceIdx].UpdateTextureIdx(texIdx);
+
+            instance.instanceIdx++;
+            if(instance.instanceIdx >= BATCH_SIZE) {
                 Flush();
             }
         }
 
-        //============== RendererInstance ==============
+        void RenderMesh(const QuadMesh& mesh, GLuint texture, const glm::vec4& transform) {
+            if(mesh.QuadCount() <= 0)
+                return;
 
-        RendererInstance::~RendererInstance() {
-            if(IsInitialized()) {
-                delete[] quadBuffer;
-                delete[] indexBuffer;
+            //mesh is drawn right away -> flush everything queued before it (also frees up the texture slots)
+            Flush();
+            uint32_t texIdx = ResolveTextureIdx(texture);
+            ASSERT_MSG(texture == 0 || texIdx == QuadMesh::TEXTURE_SLOT, "Renderer::RenderMesh - mesh texture didn't end up in the expected slot ({}).", texIdx);
 
-                glDeleteBuffers(1, &vbo);
-                glDeleteBuffers(1, &ebo);
-                glDeleteBuffers(1, &vao);
+#ifndef ENGINE_HEADLESS
+            if(UsesGL()) {
+                ASSERT_MSG(instance.shader != nullptr, "\tRenderer requires shader to function.\n");
 
-                ENG_LOG_TRACE("[D] RendererInstance");
+                for (int i = 0; i < instance.maxTextureCount; i++) {
+                    Texture::Bind(i, instance.textures[i]);
+                }
+
+                glEnable(GL_PRIMITIVE_RESTART);
+                glPrimitiveRestartIndex((unsigned int)-1);
+
+                instance.shader->Bind();
+                instance.shader->SetVec4("transform", transform);
+                mesh.Draw();
+                instance.shader->SetVec4("transform", glm::vec4(1.f, 1.f, 0.f, 0.f));
+            }
+#endif
+            if(instance.backend == Backend::Recording) {
+                Recording& r = instance.recording;
+                for(const QuadVertices& quad : mesh.CPUQuads()) {
+                    QuadVertices q = quad;
+                    for(int i = 0; i < 4; i++)
+                        q[i].position = glm::vec3(glm::vec2(q[i].position) * glm::vec2(transform.x, transform.y) + glm::vec2(transform.z, transform.w), q[i].position.z);
+                    r.quads.push_back(q);
+                    r.textures.push_back(texture);
+                }
+                r.batches.push_back(int(mesh.CPUQuads().size()));
             }
+
+            instance.stats.drawCalls++;
+            instance.stats.totalQuads += mesh.QuadCount();
         }
 
-        void RendererInstance::Initialize() {
-            ASSERT_MSG(quadBuffer == nullptr, "Calling RendererInstance::Initialize() on already initialized object.");
+        //============== Recording ==============
 
-            //quad vertices & indices buffers
-            quadBuffer = new QuadVertices[BATCH_SIZE];
-            indexBuffer = new QuadIndices[BATCH_SIZE];
+        void Recording::Clear() {
+            quads.clear();
+            textures.clear();
+            batches.clear();
+        }
 
-            //their GPU counterparts
-            glGenVertexArrays(1, &vao);
-            glGenBuffers(1, &vbo);
-            glGenBuffers(1, &ebo);
+        uint64_t Recording::Hash() const {
+            uint64_t value = 14695981039346656037ULL;
+            auto add = [&value](const void* data, size_t size) {
+                const uint8_t* bytes = (const uint8_t*)data;
+                for(size_t i = 0; i < size; i++) {
+                    value = (value ^ bytes[i]) * 1099511628211ULL;
+                }
+            };
+            add(quads.data(), sizeof(QuadVertices) * quads.size());
+            add(textures.data(), sizeof(GLuint) * textures.size());
+            add(batches.data(), sizeof(int) * batches.size());
+            return value;
+        }
 
-            glBindVertexArray(vao);
-            glBindBuffer(GL_ARRAY_BUFFER, vbo);
+        //============== RendererInstance ==============
 
-            //proper vertex attributes setup
-            glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, position));
-            glEnableVertexAttribArray(0);
-            glVertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, color));
-            glEnableVertexAttribArray(1);
-            glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, texCoords));
-            glEnableVertexAttribArray(2);
-            glVertexAttribIPointer(3, 1, GL_UNSIGNED_INT, sizeof(Vertex), (void*)offsetof(Vertex, textureID));
-            glEnableVertexAttribArray(3);
-            glVertexAttribPointer(4, 1, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, alphaFromTexture));
-            glEnableVertexAttribArray(4);
-            glVertexAttribPointer(5, 1, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, paletteIdx));
-            glEnableVertexAttribArray(5);
-            glVertexAttribPointer(6, 4, GL_UNSIGNED_INT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, info));
-            glEnableVertexAttribArray(6);
+        RendererInstance::~RendererInstance() {
+            Release();
+        }
 
-            glBindBuffer(GL_ARRAY_BUFFER, vbo);
-            glBufferData(GL_ARRAY_BUFFER, sizeof(Quad) * BATCH_SIZE, nullptr, GL_DYNAMIC_DRAW);
+        void RendererInstance::Release() {
+            if(IsInitialized()) {
+                if(backend != Backend::GL) {
+                    delete[] quadRing;
+                    delete[] instanceRing;
+                }
+#ifndef ENGINE_HEADLESS
+                else {
+                    //deleting the buffers also unmaps them
+                    for(GLsync& fence : fences) {
+                        if(fence != nullptr)
+                            glDeleteSync(fence);
+                    }
+                    glDeleteBuffers(1, &vbo);
+                    glDeleteBuffers(1, &ebo);
+                    glDeleteVertexArrays(1, &vao);
+                    glDeleteBuffers(1, &instanceVbo);
+                    glDeleteVertexArrays(1, &instanceVao);
+                }
+#endif
+                quadRing = nullptr;
+                instanceRing = nullptr;
 
-            glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ebo);
-            glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(QuadIndices) * BATCH_SIZE, nullptr, GL_DYNAMIC_DRAW);
+                ENG_LOG_TRACE("[D] RendererInstance");
+            }
+        }
 
-            //empty texture
-            uint8_t tmp[] = { 255,255,255,255 };
-            blankTexture = std::make_shared<Texture>(TextureParams::CustomData(1, 1, GL_RGBA, GL_RGBA, GL_UNSIGNED_BYTE), (void*)&tmp, "renderer_blankTexture");
+        void RendererInstance::Initialize(int backend_) {
+            ASSERT_MSG(quadRing == nullptr, "Calling RendererInstance::Initialize() on already initialized object.");
+
+#ifdef ENGINE_HEADLESS
+            //no GL in the headless build, quads are just discarded
+            if(backend_ == Backend::GL)
+                backend_ = Backend::Null;
+#endif
+            backend = backend_;
+
+            if(backend != Backend::GL) {
+                quadRing = new QuadVertices[BATCH_SIZE];
+                instanceRing = new SpriteInstance[BATCH_SIZE];
+            }
+#ifndef ENGINE_HEADLESS
+            else {
+                //vertex & instance data are written straight into the mapped buffers (coherent mapping -> no explicit flushes)
+                GLbitfield map_flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+
+                //quad vertices ring
+                glGenVertexArrays(1, &vao);
+                glGenBuffers(1, &vbo);
+                glGenBuffers(1, &ebo);
+
+                glBindVertexArray(vao);
+                glBindBuffer(GL_ARRAY_BUFFER, vbo);
+
+                SetupVertexAttributes();
+
+                glBufferStorage(GL_ARRAY_BUFFER, sizeof(QuadVertices) * BATCH_SIZE * RING_REGIONS, nullptr, map_flags);
+                quadRing = (QuadVertices*)glMapBufferRange(GL_ARRAY_BUFFER, 0, sizeof(QuadVertices) * BATCH_SIZE * RING_REGIONS, map_flags);
+
+                //indices only depend on the position within the batch -> generated once (regions are selected through base vertex)
+                std::vector<QuadIndices> indices;
+                indices.reserve(BATCH_SIZE);
+                for(int i = 0; i < BATCH_SIZE; i++)
+                    indices.push_back(QuadIndices(i));
+                glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ebo);
+                glBufferStorage(GL_ELEMENT_ARRAY_BUFFER, sizeof(QuadIndices) * BATCH_SIZE, indices.data(), 0);
+
+                //instanced sprites - no per-vertex data, every attribute advances once per instance
+                glGenVertexArrays(1, &instanceVao);
+                glGenBuffers(1, &instanceVbo);
+
+                glBindVertexArray(instanceVao);
+                glBindBuffer(GL_ARRAY_BUFFER, instanceVbo);
+                glBufferStorage(GL_ARRAY_BUFFER, sizeof(SpriteInstance) * BATCH_SIZE * RING_REGIONS, nullptr, map_flags);
+                instanceRing = (SpriteInstance*)glMapBufferRange(GL_ARRAY_BUFFER, 0, sizeof(SpriteInstance) * BATCH_SIZE * RING_REGIONS, map_flags);
+
+                glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(SpriteInstance), (void*)offsetof(SpriteInstance, position));
+                glVertexAttribPointer(1, 2, GL_HALF_FLOAT, GL_FALSE, sizeof(SpriteInstance), (void*)offsetof(SpriteInstance, size));
+                glVertexAttribPointer(2, 4, GL_UNSIGNED_SHORT, GL_TRUE, sizeof(SpriteInstance), (void*)offsetof(SpriteInstance, texRect));
+                glVertexAttribPointer(3, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(SpriteInstance), (void*)offsetof(SpriteInstance, color));
+                glVertexAttribPointer(4, 1, GL_HALF_FLOAT, GL_FALSE, sizeof(SpriteInstance), (void*)offsetof(SpriteInstance, paletteIdx));
+                glVertexAttribIPointer(5, 2, GL_UNSIGNED_BYTE, sizeof(SpriteInstance), (void*)offsetof(SpriteInstance, textureID));
+                for(GLuint i = 0; i < 6; i++) {
+                    glEnableVertexAttribArray(i);
+                    glVertexAttribDivisor(i, 1);
+                }
+                glBindVertexArray(0);
 
-            //texture info retrieval
-            glGetIntegerv(GL_MAX_TEXTURE_IMAGE_UNITS, &maxTextureCount);
-            glGetIntegerv(GL_MAX_TEXTURE_SIZE, &maxTextureSize);
+                if(quadRing == nullptr || instanceRing == nullptr) {
+                    ENG_LOG_ERROR("Renderer - failed to map the streaming buffers.");
+                    throw std::exception();
+                }
+            }
+#endif
+            region = 0;
+            quadBuffer = quadRing;
+            instanceBuffer = instanceRing;
+
+#ifndef ENGINE_HEADLESS
+            if(backend == Backend::GL) {
+                //empty texture (other backends use handle 0 for the blank slots)
+                uint8_t tmp[] = { 255,255,255,255 };
+                blankTexture = std::make_shared<Texture>(TextureParams::CustomData(1, 1, GL_RGBA, GL_RGBA, GL_UNSIGNED_BYTE), (void*)&tmp, "renderer_blankTexture");
+
+                //texture info retrieval
+                glGetIntegerv(GL_MAX_TEXTURE_IMAGE_UNITS, &maxTextureCount);
+                glGetIntegerv(GL_MAX_TEXTURE_SIZE, &maxTextureSize);
+            }
+#endif
 
-            ENG_LOG_TRACE("[C] RendererInstance");
+            ENG_LOG_TRACE("[C] RendererInstance (backend {})", backend);
             ENG_LOG_TRACE("Texture Units: {}, Max Size: {}", maxTextureCount, maxTextureSize);
-            maxTextureCount = MAX_TEXTURE_COUNT;
+            maxTextureCount = std::min(maxTextureCount, MAX_TEXTURE_COUNT);
         }
 
         bool RendererInstance::IsInitialized() const {
-            return (quadBuffer != nullptr);
+            return (quadRing != nullptr);
         }
 
         //===============================
 
-        uint32_t ResolveTextureIdx(const TextureRef& texture) {
+        uint32_t ResolveTextureIdx(GLuint handle) {
+            //using handle, bcs merged textures can be in different objects
+            if(handle == 0)
+                return 0;
+            if(handle == instance.lastHandle)
+                return instance.lastTexIdx;
+
             uint32_t idx = 0;
 
-            if(texture != nullptr) {
-                //using handle, bcs merged textures can be in different objects
-                GLuint handle = texture->Handle();
+            //search for the texture in already queued textures
+            //search only the textures queued in this draw call (higher index textures might get overriden)
+            for (int i = 0; i < instance.texIdx; i++) {
+                if (instance.textures[i] == handle) {
+                    idx = uint32_t(i);
+                    break;
+                }
+            }
 
-                //search for the texture in already queued textures
-                //search only the textures queued in this draw call (higher index textures might get overriden)
-                for (int i = 0; i < instance.texIdx; i++) {
-                    if (instance.textures[i] == handle) {
-                        idx = uint32_t(i);
-                        break;
-                    }
+            //not found, use new slot for this texture
+            if (idx == 0) {
+                //trigger a draw call, if all the slots are already taken
+                if (instance.texIdx > instance.texIdxEnd) {
+                    instance.stats.textureFlushes++;
+                    Flush();
                 }
 
-                //not found, use new slot for this texture
-                if (idx == 0) {
-                    //trigger a draw call, if all the slots are already taken
-                    if (instance.texIdx > instance.texIdxEnd) {
-                        Flush();
+                idx = (uint32_t)instance.texIdx;
+                instance.textures[instance.texIdx] = handle;
+                instance.texIdx++;
+            }
+
+            instance.lastHandle = handle;
+            instance.lastTexIdx = idx;
+            return idx;
+        }
+
+        void FlushBatch() {
+            //only one of the batches is ever filled (switching between quads & sprites triggers a flush)
+            int count = instance.idx + instance.instanceIdx;
+            if (count > 0) {
+#ifndef ENGINE_HEADLESS
+                if(UsesGL()) {
+                    //bind all used textures into proper slots
+                    // ENG_LOG_INFO("Draw call textures:");
+                    for (int i = 0; i < instance.maxTextureCount; i++) {
+                        Texture::Bind(i, instance.textures[i]);
+                        // ENG_LOG_INFO("[{}] - '{}' ({})", i, instance.textures[i]->Name(), instance.textures[i]->Handle());
                     }
+                    // ENG_LOG_INFO("----");
+
+                    if(instance.idx > 0) {
+                        ASSERT_MSG(instance.shader != nullptr, "\tRenderer requires shader to function.\n");
+
+                        glEnable(GL_PRIMITIVE_RESTART);
+                        glPrimitiveRestartIndex((unsigned int)-1);
+
+                        instance.shader->Bind();
+                        glBindVertexArray(instance.vao);
+
+                        //draw the quads - vertices are already in the mapped region, static indices are offset into it (restart index is compared before the offset)
+                        glDrawElementsBaseVertex(GL_TRIANGLE_STRIP, instance.idx * 5, GL_UNSIGNED_INT, nullptr, instance.region * BATCH_SIZE * 4);
+                    }
+                    else {
+                        ASSERT_MSG(instance.spriteShader != nullptr, "\tRenderer requires sprite shader for the instanced path.\n");
+
+                        instance.spriteShader->Bind();
+                        glBindVertexArray(instance.instanceVao);
+
+                        //draw the sprites - 4 corners per instance, expanded in the vertex shader
+                        glDrawArraysInstancedBaseInstance(GL_TRIANGLE_STRIP, 0, 4, instance.instanceIdx, instance.region * BATCH_SIZE);
+                    }
+                }
+#endif
+                if(instance.backend == Backend::Recording)
+                    RecordBatch();
+
+                //null backend only goes through the motions (submission benchmark)
+                instance.stats.drawCalls++;
+                instance.stats.totalQuads += count;
+                instance.stats.wastedQuads += instance.lastFlush_wastedQuads;
+                instance.stats.numTextures += instance.texIdx-1;
+                instance.stats.bytesUploaded += (instance.idx > 0) ? int(sizeof(QuadVertices) * instance.idx) : int(sizeof(SpriteInstance) * instance.instanceIdx);
+                instance.lastFlush_wastedQuads = BATCH_SIZE - count;
+
+                NextRingRegion();
+            }
+
+            instance.idx = 0;
+            instance.instanceIdx = 0;
+            instance.texIdx = 1;
+            instance.lastHandle = 0;
+            instance.lastTexIdx = 0;
+        }
 
-                    idx = (uint32_t)instance.texIdx;
-                    instance.textures[instance.texIdx] = handle;
-                    instance.texIdx++;
+        void NextRingRegion() {
+#ifndef ENGINE_HEADLESS
+            if(!UsesGL())
+                return;
+
+            instance.fences[instance.region] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+            instance.region = (instance.region + 1) % RING_REGIONS;
+
+            GLsync& fence = instance.fences[instance.region];
+            if(fence != nullptr) {
+                //only block (and count the stall) when the GPU didn't finish the draws from this region yet
+                if(glClientWaitSync(fence, 0, 0) == GL_TIMEOUT_EXPIRED) {
+                    instance.stats.ringStalls++;
+                    while(glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000) == GL_TIMEOUT_EXPIRED) {}
                 }
+                glDeleteSync(fence);
+                fence = nullptr;
             }
 
-            return idx;
+            instance.quadBuffer = instance.quadRing + instance.region * BATCH_SIZE;
+            instance.instanceBuffer = instance.instanceRing + instance.region * BATCH_SIZE;
+#endif
+        }
+
+        void RecordBatch() {
+            Recording& r = instance.recording;
+            if(instance.idx > 0) {
+                r.quads.insert(r.quads.end(), instance.quadBuffer, instance.quadBuffer + instance.idx);
+                for(int i = 0; i < instance.idx; i++)
+                    r.textures.push_back(instance.textures[instance.quadBuffer[i][0].textureID]);
+                r.batches.push_back(instance.idx);
+            }
+            else {
+                for(int i = 0; i < instance.instanceIdx; i++) {
+                    const SpriteInstance& sprite = instance.instanceBuffer[i];
+                    r.quads.push_back(sprite.Vertices());
+                    r.textures.push_back(instance.textures[sprite.textureID]);
+                }
+                r.batches.push_back(instance.instanceIdx);
+            }
+        }
+
+        bool UsesGL() {
+#ifdef ENGINE_HEADLESS
+            return false;
+#else
+            return instance.backend == Backend::GL;
+#endif
+        }
+
+        void SubmitDeferred() {
+            //stable order for the entries with the same key (index is part of the comparison)
+            std::sort(instance.deferredEntries.begin(), instance.deferredEntries.end());
+
+            //regular submission from here on (nested flushes only issue the batches)
+            instance.deferred = false;
+            for(const DeferredEntry& e : instance.deferredEntries) {
+                if(e.sprite)
+                    RenderSprite(instance.deferredSprites[e.index], e.texture);
+                else
+                    RenderQuad(instance.deferredQuads[e.index], e.texture);
+            }
+            instance.deferred = true;
+
+            instance.stats.deferredQuads += int(instance.deferredEntries.size());
+            instance.deferredEntries.clear();
+            instance.deferredQuads.clear();
+            instance.deferredSprites.clear();
+        }
+
+        bool DeferredEntry::operator<(const DeferredEntry& e) const {
+            //farther quads first (larger depth), so that the blended edges have their background already drawn
+            if(depth != e.depth)
+                return depth > e.depth;
+            if(texture != e.texture)
+                return texture < e.texture;
+            if(sprite != e.sprite)
+                return sprite < e.sprite;
+            return index < e.index;
+        }
+
+        void SetupVertexAttributes() {
+#ifndef ENGINE_HEADLESS
+            glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, position));
+            glEnableVertexAttribArray(0);
+            glVertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, color));
+            glEnableVertexAttribArray(1);
+            glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, texCoords));
+            glEnableVertexAttribArray(2);
+            glVertexAttribIPointer(3, 1, GL_UNSIGNED_INT, sizeof(Vertex), (void*)offsetof(Vertex, textureID));
+            glEnableVertexAttribArray(3);
+            glVertexAttribPointer(4, 1, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, alphaFromTexture));
+            glEnableVertexAttribArray(4);
+            glVertexAttribPointer(5, 1, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, paletteIdx));
+            glEnableVertexAttribArray(5);
+            glVertexAttribPointer(6, 4, GL_UNSIGNED_INT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, info));
+            glEnableVertexAttribArray(6);
+#endif
         }
 
         void WireframeMode(bool enabled) {
-            glPolygonMode(GL_FRONT_AND_BACK, enabled ? GL_LINE : GL_FILL);
+#ifndef ENGINE_HEADLESS
+            if(UsesGL())
+                glPolygonMode(GL_FRONT_AND_BACK, enabled ? GL_LINE : GL_FILL);
+#endif
         }
 
         int ForceBindTexture(const TextureRef& texture) {
+            //already bound (texture shared by multiple shaders, e.g. color palette)
+            for(int i = instance.texIdxEnd+1; i < instance.maxTextureCount; i++) {
+                if(instance.textures[i] == texture->Handle())
+                    return i;
+            }
+
             int idx = instance.texIdxEnd;
             instance.texIdxEnd--;
 
@@ -320,4 +727,96 @@ namespace eng {
         
     }//namespace Renderer
 
+    //===== QuadMesh =====
+
+    QuadMesh::~QuadMesh() {
+        Release();
+    }
+
+    QuadMesh::QuadMesh(QuadMesh&& m) noexcept {
+        Move(std::move(m));
+    }
+
+    QuadMesh& QuadMesh::operator=(QuadMesh&& m) noexcept {
+        Release();
+        Move(std::move(m));
+        return *this;
+    }
+
+    void QuadMesh::Upload(const std::vector<QuadVertices>& quads) {
+        count = int(quads.size());
+        if(!Renderer::UsesGL()) {
+            cpu_quads = quads;
+            return;
+        }
+        cpu_quads.clear();
+
+#ifndef ENGINE_HEADLESS
+        if(vao == 0) {
+            glGenVertexArrays(1, &vao);
+            glGenBuffers(1, &vbo);
+            glGenBuffers(1, &ebo);
+
+            glBindVertexArray(vao);
+            glBindBuffer(GL_ARRAY_BUFFER, vbo);
+            Renderer::SetupVertexAttributes();
+            glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ebo);
+        }
+        else {
+            glBindVertexArray(vao);
+            glBindBuffer(GL_ARRAY_BUFFER, vbo);
+        }
+
+        //indices only depend on the quad count -> only uploaded when the buffers grow
+        if(count > capacity) {
+            std::vector<QuadIndices> indices;
+            indices.reserve(count);
+            for(int i = 0; i < count; i++)
+                indices.push_back(QuadIndices(i));
+
+            glBufferData(GL_ARRAY_BUFFER, sizeof(QuadVertices) * count, quads.data(), GL_STATIC_DRAW);
+            glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(QuadIndices) * count, indices.data(), GL_STATIC_DRAW);
+            capacity = count;
+        }
+        else if(count > 0) {
+            glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(QuadVertices) * count, quads.data());
+        }
+        glBindVertexArray(0);
+#endif
+    }
+
+    void QuadMesh::Draw() const {
+#ifndef ENGINE_HEADLESS
+        if(count <= 0 || vao == 0)
+            return;
+        glBindVertexArray(vao);
+        glDrawElements(GL_TRIANGLE_STRIP, count * 5, GL_UNSIGNED_INT, nullptr);
+#endif
+    }
+
+    void QuadMesh::Release() noexcept {
+#ifndef ENGINE_HEADLESS
+        if(vao != 0) {
+            glDeleteBuffers(1, &vbo);
+            glDeleteBuffers(1, &ebo);
+            glDeleteVertexArrays(1, &vao);
+        }
+#endif
+        vao = vbo = ebo = 0;
+        count = capacity = 0;
+        cpu_quads.clear();
+    }
+
+    void QuadMesh::Move(QuadMesh&& m) noexcept {
+        vao = m.vao;
+        vbo = m.vbo;
+        ebo = m.ebo;
+        count = m.count;
+        capacity = m.capacity;
+        cpu_quads = std::move(m.cpu_quads);
+
+        m.vao = m.vbo = m.ebo = 0;
+        m.count = m.capacity = 0;
+    }
+
 }//namespace eng
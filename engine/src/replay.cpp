@@ -0,0 +1,362 @@
+#include "engine/game/replay.h"
+
+#include "engine/game/level.h"
+#include "engine/utils/randomness.h"
+#include "engine/utils/setup.h"
+
+#include <cstring>
+#include <fstream>
+#include <random>
+
+#define REPLAY_MAGIC "S2RP"
+#define REPLAY_VERSION 4
+
+//Replay log layout (little-endian):
+//  header:  char[4] magic, u32 version, u32 seed, i32 next_object_id, i32 start_tick, i32 end_tick, u64 end_hash, u32 entry_count
+//  entry:   i32 tick, u8 type, ObjectID object, payload
+//  payload: UNIT_COMMAND    - i32 type, ivec2 target_pos, ObjectID target_id, i32 flag, ivec2 v2
+//           BUILDING_ACTION - i32 type, f32 t1, f32 t2, f32 t3, i32 i, u8 flag, ObjectID target_id, ivec3 price
+//           BUILDING_CANCEL - no payload
+//  ObjectID is stored as 3x u32 (type, idx, id); objects are looked up by the id on playback (slot indices don't persist through save/load)
+
+namespace eng {
+
+    template <typename T> void Write(std::ostream& out, const T& value);
+    template <typename T> T Read(std::istream& in);
+
+    void Write_ObjectID(std::ostream& out, const ObjectID& id);
+    ObjectID Read_ObjectID(std::istream& in);
+
+    void Write_Entry(std::ostream& out, const ReplayEntry& entry);
+    ReplayEntry Read_Entry(std::istream& in);
+
+    //Translates object identifier from the recorded session into identifier within the current level.
+    ObjectID ResolveID(Level& level, const ObjectID& id);
+
+    //FNV-1a hash, for the state hash computations.
+    struct StateHasher {
+        uint64_t value = 14695981039346656037ULL;
+    public:
+        template <typename T>
+        StateHasher& Add(const T& v) {
+            const uint8_t* bytes = (const uint8_t*)&v;
+            for(size_t i = 0; i < sizeof(T); i++) {
+                value = (value ^ bytes[i]) * 1099511628211ULL;
+            }
+            return *this;
+        }
+    };
+
+    //===== Replay =====
+
+    bool Replay::StartRecording(Level& level, const std::string& filepath_) {
+        filepath = filepath_;
+        if(!level.Save(SavefilePath())) {
+            ENG_LOG_WARN("Replay::StartRecording - failed to store the initial savefile ('{}').", SavefilePath());
+            return false;
+        }
+
+        entries.clear();
+        next_entry = 0;
+
+        seed = uint32_t(std::random_device{}());
+        Random::Seed(seed);
+        next_object_id = GameObject::PeekNextID();
+        start_tick = end_tick = SimClock::Now();
+        end_hash = 0;
+
+        recording = true;
+        playing = false;
+        ENG_LOG_INFO("Replay - recording started ('{}', tick {}, seed {})", filepath, start_tick, seed);
+        return true;
+    }
+
+    bool Replay::StopRecording(Level& level) {
+        if(!recording)
+            return false;
+        recording = false;
+
+        end_tick = SimClock::Now();
+        end_hash = StateHash(level);
+
+        std::ofstream out = std::ofstream(filepath, std::ios::binary | std::ios::trunc);
+        if(!out.is_open()) {
+            ENG_LOG_WARN("Replay::StopRecording - failed to open '{}' for writing.", filepath);
+            return false;
+        }
+
+        out.write(REPLAY_MAGIC, 4);
+        Write<uint32_t>(out, REPLAY_VERSION);
+        Write<uint32_t>(out, seed);
+        Write<int32_t>(out, next_object_id);
+        Write<int32_t>(out, start_tick);
+        Write<int32_t>(out, end_tick);
+        Write<uint64_t>(out, end_hash);
+        Write<uint32_t>(out, uint32_t(entries.size()));
+        for(const ReplayEntry& entry : entries) {
+            Write_Entry(out, entry);
+        }
+
+        if(!out.good()) {
+            ENG_LOG_WARN("Replay::StopRecording - failed to write the log ('{}').", filepath);
+            return false;
+        }
+
+        ENG_LOG_INFO("Replay - recording stored ('{}', {} orders, ticks {}-{}, hash {:016x})", filepath, entries.size(), start_tick, end_tick, end_hash);
+        return true;
+    }
+
+    bool Replay::Load(const std::string& filepath_) {
+        std::ifstream in = std::ifstream(filepath_, std::ios::binary);
+        if(!in.is_open()) {
+            ENG_LOG_WARN("Replay::Load - failed to open '{}'.", filepath_);
+            return false;
+        }
+
+        char magic[4];
+        in.read(magic, 4);
+        if(!in.good() || strncmp(magic, REPLAY_MAGIC, 4) != 0 || Read<uint32_t>(in) != REPLAY_VERSION) {
+            ENG_LOG_WARN("Replay::Load - '{}' isn't a valid replay log (or has incompatible version).", filepath_);
+            return false;
+        }
+
+        filepath = filepath_;
+        seed = Read<uint32_t>(in);
+        next_object_id = Read<int32_t>(in);
+        start_tick = Read<int32_t>(in);
+        end_tick = Read<int32_t>(in);
+        end_hash = Read<uint64_t>(in);
+
+        uint32_t count = Read<uint32_t>(in);
+        entries.clear();
+        entries.reserve(count);
+        for(uint32_t i = 0; i < count && in.good(); i++) {
+            entries.push_back(Read_Entry(in));
+        }
+
+        if(!in.good()) {
+            ENG_LOG_WARN("Replay::Load - log '{}' is truncated.", filepath_);
+            entries.clear();
+            return false;
+        }
+
+        next_entry = 0;
+        recording = playing = false;
+        ENG_LOG_TRACE("[R] Replay::Load - '{}' ({} orders, ticks {}-{})", filepath, entries.size(), start_tick, end_tick);
+        return true;
+    }
+
+    void Replay::StartPlayback(Level& level) {
+        if(SimClock::Now() != start_tick) {
+            ENG_LOG_WARN("Replay::StartPlayback - level tick doesn't match the recording ({} vs {}).", SimClock::Now(), start_tick);
+        }
+
+        Random::Seed(seed);
+        GameObject::SetID(next_object_id);
+        next_entry = 0;
+        playing = true;
+    }
+
+    void Replay::Apply(Level& level) {
+        tick_t now = SimClock::Now();
+        while(next_entry < entries.size() && entries[next_entry].tick <= now) {
+            const ReplayEntry& entry = entries[next_entry++];
+
+            ObjectID id = ResolveID(level, entry.object);
+            if(!ObjectID::IsValid(id)) {
+                ENG_LOG_WARN("Replay::Apply - order target no longer exists (object {}, tick {}).", entry.object, entry.tick);
+                continue;
+            }
+
+            switch(entry.type) {
+                case ReplayEntryType::UNIT_COMMAND:
+                {
+                    Command::Entry cmd = entry.command;
+                    cmd.target_id = ResolveID(level, cmd.target_id);
+                    level.objects.GetUnit(id).IssueCommand(Command(cmd));
+                    break;
+                }
+                case ReplayEntryType::BUILDING_ACTION:
+                {
+                    Building& building = level.objects.GetBuilding(id);
+                    BuildingAction::Entry action = entry.action;
+                    action.data.target_id = ResolveID(level, action.data.target_id);
+                    building.Faction()->PayResources(entry.price);
+                    building.IssueAction(BuildingAction(action));
+                    break;
+                }
+                case ReplayEntryType::BUILDING_CANCEL:
+                    level.objects.GetBuilding(id).CancelAction();
+                    break;
+            }
+        }
+    }
+
+    void Replay::RecordCommand(const ObjectID& unitID, const Command& command) {
+        if(!recording)
+            return;
+
+        ReplayEntry entry = {};
+        entry.type = ReplayEntryType::UNIT_COMMAND;
+        entry.object = unitID;
+        entry.command = command.Export();
+        Record(std::move(entry));
+    }
+
+    void Replay::RecordAction(const ObjectID& buildingID, const BuildingAction& action, const glm::ivec3& price) {
+        if(!recording)
+            return;
+
+        ReplayEntry entry = {};
+        entry.type = ReplayEntryType::BUILDING_ACTION;
+        entry.object = buildingID;
+        entry.action = action.Export();
+        entry.price = price;
+        Record(std::move(entry));
+    }
+
+    void Replay::RecordCancel(const ObjectID& buildingID) {
+        if(!recording)
+            return;
+
+        ReplayEntry entry = {};
+        entry.type = ReplayEntryType::BUILDING_CANCEL;
+        entry.object = buildingID;
+        Record(std::move(entry));
+    }
+
+    uint64_t Replay::StateHash(Level& level) {
+        //per-object hashes are summed up, so that the result doesn't depend on the iteration order
+        uint64_t objects_hash = 0;
+
+        ObjectsFile objects = level.objects.Export();
+        for(const Unit::Entry& u : objects.units) {
+            objects_hash += StateHasher{}
+                .Add(u.id.z).Add(u.num_id).Add(u.position).Add(u.health).Add(u.factionIdx)
+                .Add(u.carry_state).Add(u.mana).Add(u.command.type).Add(u.command.target_pos).Add(u.action.type).Add(u.action.data.tick)
+                .value;
+        }
+        for(const Building::Entry& b : objects.buildings) {
+            objects_hash += StateHasher{}
+                .Add(b.id.z).Add(b.num_id).Add(b.position).Add(b.health).Add(b.factionIdx)
+                .Add(b.constructed).Add(b.amount_left).Add(b.action.type).Add(b.action.data.t1).Add(b.action.data.tick)
+                .value;
+        }
+        for(const UtilityObject::Entry& o : objects.utilities) {
+            objects_hash += StateHasher{}.Add(o.id.z).Add(o.num_id).Add(o.position).value;
+        }
+
+        StateHasher hasher = {};
+        hasher.Add(SimClock::Now()).Add(objects_hash);
+
+        FactionsFile factions = level.factions.Export();
+        for(const FactionsFile::FactionEntry& f : factions.factions) {
+            hasher.Add(f.id).Add(f.resources).Add(f.eliminated);
+        }
+
+        glm::ivec2 size = level.map.Size();
+        for(int y = 0; y < size.y; y++) {
+            for(int x = 0; x < size.x; x++) {
+                const TileData& td = level.map(y, x);
+                hasher.Add(td.tileType).Add(td.health);
+            }
+        }
+
+        return hasher.value;
+    }
+
+    void Replay::Record(ReplayEntry&& entry) {
+        entry.tick = SimClock::Now();
+        entries.push_back(std::move(entry));
+    }
+
+    //=============================================
+
+    template <typename T>
+    void Write(std::ostream& out, const T& value) {
+        out.write((const char*)&value, sizeof(T));
+    }
+
+    template <typename T>
+    T Read(std::istream& in) {
+        T value = {};
+        in.read((char*)&value, sizeof(T));
+        return value;
+    }
+
+    void Write_ObjectID(std::ostream& out, const ObjectID& id) {
+        Write<uint32_t>(out, uint32_t(id.type));
+        Write<uint32_t>(out, uint32_t(id.idx));
+        Write<uint32_t>(out, uint32_t(id.id));
+    }
+
+    ObjectID Read_ObjectID(std::istream& in) {
+        ObjectID id = {};
+        id.type = Read<uint32_t>(in);
+        id.idx = Read<uint32_t>(in);
+        id.id = Read<uint32_t>(in);
+        return id;
+    }
+
+    void Write_Entry(std::ostream& out, const ReplayEntry& entry) {
+        Write<int32_t>(out, entry.tick);
+        Write<uint8_t>(out, uint8_t(entry.type));
+        Write_ObjectID(out, entry.object);
+
+        switch(entry.type) {
+            case ReplayEntryType::UNIT_COMMAND:
+                Write<int32_t>(out, entry.command.type);
+                Write<glm::ivec2>(out, entry.command.target_pos);
+                Write_ObjectID(out, entry.command.target_id);
+                Write<int32_t>(out, entry.command.flag);
+                Write<glm::ivec2>(out, entry.command.v2);
+                break;
+            case ReplayEntryType::BUILDING_ACTION:
+                Write<int32_t>(out, entry.action.type);
+                Write<float>(out, entry.action.data.t1);
+                Write<float>(out, entry.action.data.t2);
+                Write<float>(out, entry.action.data.t3);
+                Write<int32_t>(out, entry.action.data.i);
+                Write<uint8_t>(out, uint8_t(entry.action.data.flag));
+                Write_ObjectID(out, entry.action.data.target_id);
+                Write<glm::ivec3>(out, entry.price);
+                break;
+        }
+    }
+
+    ReplayEntry Read_Entry(std::istream& in) {
+        ReplayEntry entry = {};
+        entry.tick = Read<int32_t>(in);
+        entry.type = Read<uint8_t>(in);
+        entry.object = Read_ObjectID(in);
+
+        switch(entry.type) {
+            case ReplayEntryType::UNIT_COMMAND:
+                entry.command.type = Read<int32_t>(in);
+                entry.command.target_pos = Read<glm::ivec2>(in);
+                entry.command.target_id = Read_ObjectID(in);
+                entry.command.flag = Read<int32_t>(in);
+                entry.command.v2 = Read<glm::ivec2>(in);
+                break;
+            case ReplayEntryType::BUILDING_ACTION:
+                entry.action.type = Read<int32_t>(in);
+                entry.action.data.t1 = Read<float>(in);
+                entry.action.data.t2 = Read<float>(in);
+                entry.action.data.t3 = Read<float>(in);
+                entry.action.data.i = Read<int32_t>(in);
+                entry.action.data.flag = bool(Read<uint8_t>(in));
+                entry.action.data.target_id = Read_ObjectID(in);
+                entry.price = Read<glm::ivec3>(in);
+                break;
+        }
+        return entry;
+    }
+
+    ObjectID ResolveID(Level& level, const ObjectID& id) {
+        //only pool objects need translation (map objects are identified by their position)
+        if(!ObjectID::IsObject(id))
+            return id;
+        return level.objects.FindObject(id.type, id.id);
+    }
+
+}//namespace eng
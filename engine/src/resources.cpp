@@ -5,13 +5,17 @@
 #include "engine/core/cursor.h"
 
 #include "engine/utils/json.h"
+#include "engine/utils/asset_pack.h"
 #include "engine/utils/utils.h"
 #include "engine/utils/timer.h"
+#include "engine/utils/jobs.h"
 #include "engine/utils/dbg_gui.h"
 
 #include "engine/game/gameobject.h"
 #include "engine/game/object_parsing.h"
 
+#include <mutex>
+
 constexpr float DEFAULT_FONT_SCALE = 0.055f;
 
 #define RESEARCH_MAX_LEVEL 10
@@ -19,10 +23,17 @@ constexpr float DEFAULT_FONT_SCALE = 0.055f;
 namespace eng {
     //defined in sprite.cpp:280 (+-)
     SpritesheetData ParseConfig_Spritesheet(const std::string& name, const nlohmann::json& config, int texture_flags);
+    SpritesheetData ParseConfig_Spritesheet(const std::string& name, const nlohmann::json& config, const TextureRef& texture);
 }
 
 namespace eng::Resources {
 
+    //Location of a serialized prefab definition in the records buffer.
+    struct PrefabRecord {
+        size_t offset;
+        size_t size;
+    };
+
     struct Data {
         float fontScale = DEFAULT_FONT_SCALE;
 
@@ -42,6 +53,15 @@ namespace eng::Resources {
         std::array<UnitDataRef, UnitType::COUNT2> other_units;
         std::array<BuildingDataRef, BuildingType::COUNT2> other_buildings;
 
+        //prefab definitions (as MessagePack) - indexed during preload, fully parsed on the first use (see MaterializeObject)
+        std::vector<uint8_t> prefab_buffer;
+        std::unordered_map<std::string, PrefabRecord> prefab_records;
+        int corpse_anim_base = -1;
+        int materialized_count = 0;
+        long long materialize_us = 0;
+
+        bool atlas_baked = false;       //spritesheet textures were merged from the atlas in the asset pack
+
         std::array<ResearchVisuals, ResearchType::COUNT> research_viz;
         std::unordered_map<int, ResearchData> research_data;
 
@@ -52,31 +72,59 @@ namespace eng::Resources {
     };
     static Data data = {};
 
+    //guards the on-demand prefab parsing (levels are constructed on the worker threads); recursive, as prefabs parse the prefabs they reference
+    static std::recursive_mutex prefab_mutex;
+
+    //Intermediate results of the parallel part of the preload (parsed JSON files & decoded spritesheet images).
+    struct PreloadCache {
+        std::unordered_map<std::string, nlohmann::json> json;
+        std::vector<Image> images;                  //indexed the same as entries in spritesheets.json
+
+        std::atomic<long long> json_us = 0;         //summed up job durations (= time it would take on a single thread)
+        std::atomic<long long> image_us = 0;
+    };
+    static PreloadCache preload_cache = {};
+
     //============
 
     void ResizeFonts(int windowHeight);
 
+    void PreloadFiles();
+    void PreloadImages(const nlohmann::json& config, Jobs::Counter& counter);
+    const nlohmann::json& PreloadedJSON(const std::string& filepath);
+
     void PreloadSpritesheets();
+    bool PreloadBakedAtlas(const nlohmann::json& config, std::vector<TextureRef>& out_textures);
+    std::vector<std::pair<std::string, std::string>> AtlasSpritesheets(const nlohmann::json& config);
     void PreloadObjects();
 
     void ProcessIndexFile();
-    void LoadObjectDefinitions();
+    void IndexObjectDefinitions();
     void PreloadResearchDefinitions();
     void FinalizeOthers();
     void MergeSpritesheets();
 
     void ValidateIndexEntries();
-    UtilityObjectDataRef SetupCorpseData();
-    void FinalizeButtonDescriptions();
+    void MaterializeObject(const GameObjectDataRef& obj);
+    void RegisterDeathAnimation(const UnitDataRef& unit);
+    UtilityObjectDataRef CorpseData();
 
     GameObjectDataRef LinkObject(const std::string& name);
-    GameObjectDataRef LinkObject(const glm::ivec3& num_id, bool initialized_only);
-    UtilityObjectDataRef LinkSpell(int spellID, bool initialized_only);
+    GameObjectDataRef LinkObject(const glm::ivec3& num_id, bool indexed_only);
+    UtilityObjectDataRef LinkSpell(int spellID, bool indexed_only);
 
     //============
 
     void Preload() {
         ASSERT_MSG(!data.preloaded, "Calling Resources::Preload multiple times!");
+        Timer t = {};
+
+        //cooked assets are used when the pack is present (see AssetPack::Cook), loose files otherwise
+        if(!AssetPack::IsMounted())
+            AssetPack::Mount(AssetPack::DefaultPath());
+
+        //file parsing & image decoding fanned out to the worker threads, the rest runs on the main thread (GL calls & cross references between prefabs)
+        PreloadFiles();
 
         PreloadSpritesheets();
 
@@ -88,12 +136,18 @@ namespace eng::Resources {
 
         data.cursorIcons = CursorIconManager("res/json/cursors.json");
 
-        ENG_LOG_INFO("[R] Resources::Preload");
+        //intermediate data are no longer needed
+        preload_cache.json.clear();
+        preload_cache.images.clear();
+
+        float time_elapsed = t.TimeElapsed<Timer::ms>() * 1e-3f;
+        ENG_LOG_INFO("[R] Resources::Preload ({:.2f}s, {})", time_elapsed, AssetPack::IsMounted() ? "asset pack" : "loose files");
         data.preloaded = true;
     }
 
     void Release() {
         data = {};
+        AssetPack::Unmount();
     }
 
     void OnResize(int width, int height) {
@@ -265,7 +319,9 @@ namespace eng::Resources {
             throw std::runtime_error("");
         }
 
-        return data.objects.at(name);
+        GameObjectDataRef& obj = data.objects.at(name);
+        MaterializeObject(obj);
+        return obj;
     }
 
     UtilityObjectDataRef LoadUtilityObj(const std::string& name) {
@@ -298,7 +354,7 @@ namespace eng::Resources {
         return res;
     }
 
-    GameObjectDataRef LinkObject(const glm::ivec3& num_id, bool initialized_only) {
+    GameObjectDataRef LinkObject(const glm::ivec3& num_id, bool indexed_only) {
         if(!data.linkable) {
             ENG_LOG_ERROR("Resources::LinkObject - index needs to be processed before linking is allowed!");
             throw std::runtime_error("");
@@ -332,15 +388,15 @@ namespace eng::Resources {
                 throw std::runtime_error("");
         }
 
-        if(obj == nullptr || (initialized_only && !obj->initialized)) {
-            ENG_LOG_ERROR("Resources::LinkObject - attempting to link object that is not yet initialized (num_id=({},{},{}))", num_id[0], num_id[1], num_id[2]);
+        if(obj == nullptr || (indexed_only && !obj->indexed)) {
+            ENG_LOG_ERROR("Resources::LinkObject - attempting to link object that has no definition (num_id=({},{},{}))", num_id[0], num_id[1], num_id[2]);
             throw std::runtime_error("");
         }
 
         return obj;
     }
 
-    UtilityObjectDataRef LinkSpell(int spellID, bool initialized_only) {
+    UtilityObjectDataRef LinkSpell(int spellID, bool indexed_only) {
         if(!data.linkable) {
             ENG_LOG_ERROR("Resources::LinkObject - index needs to be processed before linking is allowed!");
             throw std::runtime_error("");
@@ -352,8 +408,8 @@ namespace eng::Resources {
         }
         UtilityObjectDataRef obj = data.spells[spellID];
 
-        if(obj == nullptr || (initialized_only && !obj->initialized)) {
-            ENG_LOG_ERROR("Resources::LinkObject - attempting to link object that is not yet initialized (spell - {}))", spellID);
+        if(obj == nullptr || (indexed_only && !obj->indexed)) {
+            ENG_LOG_ERROR("Resources::LinkObject - attempting to link object that has no definition (spell - {}))", spellID);
             throw std::runtime_error("");
         }
 
@@ -383,6 +439,7 @@ namespace eng::Resources {
             ENG_LOG_ERROR("Resources::LoadUtilityObj - invalid ID (id = {}, max legit value = {})!", num_id, data.utilities.size());
             throw std::runtime_error("");
         }
+        MaterializeObject(data.utilities[num_id]);
         return data.utilities[num_id];
     }
 
@@ -395,6 +452,7 @@ namespace eng::Resources {
             ENG_LOG_ERROR("Resources::LoadSpell - invalid ID (id = {}, max legit value = {})!", num_id, data.spells.size());
             throw std::runtime_error("");
         }
+        MaterializeObject(data.spells[num_id]);
         return data.spells[num_id];
     }
 
@@ -404,11 +462,13 @@ namespace eng::Resources {
             throw std::runtime_error("");
         }
         if((unsigned int)(num_id) < data.buildings.size()) {
+            MaterializeObject(data.buildings[num_id][(int)(isOrc)]);
             return data.buildings[num_id][(int)(isOrc)];
         }
         else {
             num_id -= 101;
             if(num_id >= 0 && num_id < data.other_buildings.size()) {
+                MaterializeObject(data.other_buildings[num_id]);
                 return data.other_buildings[num_id];
             }
         }
@@ -423,11 +483,13 @@ namespace eng::Resources {
             throw std::runtime_error("");
         }
         if((unsigned int)(num_id) < data.units.size()) {
+            MaterializeObject(data.units[num_id][(int)(isOrc)]);
             return data.units[num_id][(int)(isOrc)];
         }
         else {
             num_id -= 101;
             if(num_id >= 0 && num_id < data.other_units.size()) {
+                MaterializeObject(data.other_units[num_id]);
                 return data.other_units[num_id];
             }
         }
@@ -436,6 +498,31 @@ namespace eng::Resources {
         throw std::runtime_error("");
     }
 
+    void WarmupObjects(const std::vector<glm::ivec3>& num_ids) {
+        std::lock_guard<std::recursive_mutex> lock(prefab_mutex);
+        Timer t = {};
+        int count = data.materialized_count;
+
+        for(const glm::ivec3& num_id : num_ids) {
+            LoadObject(num_id);
+        }
+
+        float time_elapsed = t.TimeElapsed<Timer::us>() * 1e-3f;
+        ENG_LOG_TRACE("Resources::WarmupObjects - parsed {} object prefabs ({} requested, {}/{} parsed in total, {:.2f}ms)", data.materialized_count - count, num_ids.size(), data.materialized_count, data.prefab_records.size(), time_elapsed);
+    }
+
+    bool DeathAnimationOwner(int anim_idx, glm::ivec3& out_num_id) {
+        std::lock_guard<std::recursive_mutex> lock(prefab_mutex);
+        CorpseData();
+
+        //inverse of the index assignment in RegisterDeathAnimation()
+        int i = anim_idx - data.corpse_anim_base;
+        if(i < 0 || i >= UnitType::COUNT * 2 + UnitType::COUNT2)
+            return false;
+        out_num_id = (i < UnitType::COUNT * 2) ? glm::ivec3(ObjectType::UNIT, i / 2, i % 2) : glm::ivec3(ObjectType::UNIT, 101 + (i - UnitType::COUNT * 2), 0);
+        return true;
+    }
+
     bool LoadResearchInfo(int type, int level, ResearchInfo& out_info) {
         if(!data.preloaded) {
             ENG_LOG_ERROR("Resources::LoadResearchInfo - data need to be preloaded!");
@@ -474,7 +561,8 @@ namespace eng::Resources {
         ImGui::Text("Fonts: %d, Shaders: %d", (int)data.fonts.size(), (int)data.shaders.size());
         ImGui::Text("Textures: %d, Tilesets: %d", (int)data.textures.size(), (int)data.tilesets.size());
         ImGui::Text("Spritesheets: %d", (int)data.spritesheets.size());
-        ImGui::Text("Object data: %d", (int)data.objects.size());
+        ImGui::Text("Object data: %d (%d parsed, %.2fms)", (int)data.objects.size(), data.materialized_count, data.materialize_us * 1e-3f);
+        ImGui::Text("Prefab records: %.1fkB", data.prefab_buffer.size() / 1024.f);
 
         ImGui::Separator();
         ImGui::Text("Buildings: %d, Units: %d", (int)data.buildings.size(), (int)data.units.size());
@@ -507,6 +595,95 @@ namespace eng::Resources {
         }
     }
     
+    void PreloadFiles() {
+        using json = nlohmann::json;
+
+        static const std::vector<std::string> json_files = {
+            "res/json/spritesheets.json",
+            "res/json/index.json",
+            "res/json/utility.json",
+            "res/json/spells.json",
+            "res/json/objects.json",
+            "res/json/research.json",
+        };
+
+        Timer t = {};
+        t.Reset();
+        preload_cache.json_us = 0;
+        preload_cache.image_us = 0;
+
+        //entries are inserted upfront - jobs only write into their own value, the map itself isn't modified concurrently
+        for(const std::string& filepath : json_files)
+            preload_cache.json.insert({ filepath, json() });
+
+        Jobs::Counter counter = {};
+        for(const std::string& filepath : json_files) {
+            json* target = &preload_cache.json.at(filepath);
+            Jobs::Run([filepath, target, &counter]() {
+                Timer t = {};
+                try {
+                    *target = AssetPack::LoadJSON(filepath);
+                }
+                catch(std::exception&) {
+                    //entry stays empty, file is loaded again (& the error reported) from the main thread
+                }
+                preload_cache.json_us += t.TimeElapsed<Timer::us>();
+
+                //spritesheet images can be scheduled once their list is known
+                if(filepath == "res/json/spritesheets.json")
+                    PreloadImages(*target, counter);
+            }, &counter);
+        }
+        Jobs::Wait(counter);
+
+        int image_count = 0;
+        for(const Image& img : preload_cache.images)
+            image_count += int(!img.Empty());
+
+        float time_elapsed = t.TimeElapsed<Timer::us>() * 1e-3f;
+        float json_ms = preload_cache.json_us * 1e-3f;
+        float image_ms = preload_cache.image_us * 1e-3f;
+        ENG_LOG_TRACE("Resources::PreloadFiles - parsed {} JSON files ({:.2f}ms), decoded {} images ({:.2f}ms); {:.2f}ms on {} threads ({:.1f}x speedup)", 
+            json_files.size(), json_ms, image_count, image_ms, time_elapsed, Jobs::WorkerCount() + 1, (json_ms + image_ms) / std::max(time_elapsed, 1e-3f));
+    }
+
+    void PreloadImages(const nlohmann::json& config, Jobs::Counter& counter) {
+#ifndef ENGINE_HEADLESS
+        if(!config.is_array())
+            return;
+
+        //spritesheets are uploaded as a single image (see PreloadBakedAtlas), individual textures are only decoded if the atlas turns out to be stale
+        if(AssetPack::Contains(BAKED_ATLAS_LAYOUT))
+            return;
+
+        //runs from within a preload job, but nothing else touches the images until the main thread's done waiting
+        preload_cache.images.resize(config.size());
+        for(size_t i = 0; i < config.size(); i++) {
+            Jobs::Run([i, &config]() {
+                Timer t = {};
+                try {
+                    std::string texture_filepath = config.at(i).at("texture_filepath");
+                    preload_cache.images[i] = Image(texture_filepath);
+                }
+                catch(std::exception&) {
+                    //image stays empty, texture is loaded directly from the main thread (& reports the error)
+                }
+                preload_cache.image_us += t.TimeElapsed<Timer::us>();
+            }, &counter);
+        }
+#endif
+        //headless build doesn't upload the textures (only reads the image headers), there's nothing to decode
+    }
+
+    const nlohmann::json& PreloadedJSON(const std::string& filepath) {
+        auto it = preload_cache.json.find(filepath);
+        if(it == preload_cache.json.end())
+            it = preload_cache.json.insert({ filepath, AssetPack::LoadJSON(filepath) }).first;
+        else if(it->second.is_null())
+            it->second = AssetPack::LoadJSON(filepath);
+        return it->second;
+    }
+
     void PreloadSpritesheets() {
         using json = nlohmann::json;
 
@@ -514,20 +691,119 @@ namespace eng::Resources {
         Timer t = {};
 
         t.Reset();
-        json config = json::parse(ReadFile("res/json/spritesheets.json"));
-        for(auto& entry : config) {
+        const json& config = PreloadedJSON("res/json/spritesheets.json");
+
+        //GPU upload of the images decoded in PreloadFiles(), done in one go (or the whole baked atlas, when there's one)
+        Timer t_upload = {};
+        std::vector<TextureRef> textures(config.size(), nullptr);
+        if(!PreloadBakedAtlas(config, textures)) {
+            for(size_t i = 0; i < std::min(config.size(), preload_cache.images.size()); i++) {
+                if(!preload_cache.images[i].Empty()) {
+                    std::string texture_filepath = config.at(i).at("texture_filepath");
+                    textures[i] = std::make_shared<Texture>(texture_filepath, preload_cache.images[i]);
+                    preload_cache.images[i] = Image();
+                }
+            }
+        }
+        float upload_time = t_upload.TimeElapsed<Timer::us>() * 1e-3f;
+
+        for(size_t i = 0; i < config.size(); i++) {
+            const json& entry = config.at(i);
             std::string name = entry.at("name");
 
-            SpritesheetData sData = ParseConfig_Spritesheet(name, entry, 0);
+            SpritesheetData sData = (textures[i] != nullptr) ? ParseConfig_Spritesheet(name, entry, textures[i]) : ParseConfig_Spritesheet(name, entry, 0);
             SpritesheetRef spritesheet = std::make_shared<Spritesheet>(sData);
 
             data.spritesheets.insert({ name, spritesheet });
             sprite_count += spritesheet->Size();
         }
         float time_elapsed = t.TimeElapsed<Timer::ms>() * 1e-3f;
-        ENG_LOG_TRACE("Resources::PreloadSpritesheets - parsed {} spritesheets ({} sprites in total, {:.2f}s)", data.spritesheets.size(), sprite_count, time_elapsed);
+        ENG_LOG_TRACE("Resources::PreloadSpritesheets - parsed {} spritesheets ({} sprites in total, texture upload {:.2f}ms, {:.2f}s)", data.spritesheets.size(), sprite_count, upload_time, time_elapsed);
+    }
+
+    bool PreloadBakedAtlas(const nlohmann::json& config, std::vector<TextureRef>& out_textures) {
+#ifdef ENGINE_HEADLESS
+        //no GPU textures to merge
+        return false;
+#else
+        if(!AssetPack::Contains(BAKED_ATLAS_LAYOUT))
+            return false;
+
+        AtlasLayout layout = {};
+        try {
+            if(!AtlasLayout::Deserialize(AssetPack::LoadJSON(BAKED_ATLAS_LAYOUT).dump(), layout))
+                throw std::exception();
+        }
+        catch(std::exception&) {
+            ENG_LOG_WARN("Resources::PreloadBakedAtlas - failed to parse the atlas layout, falling back to the individual textures.");
+            return false;
+        }
 
-        //TODO: texture merging
+        //layout is only valid for the exact same textures (in the same order) - compare against the images in the pack
+        std::vector<std::pair<std::string, std::string>> entries = AtlasSpritesheets(config);
+        std::vector<std::string> names = {};
+        std::vector<glm::ivec2> sizes = {};
+        for(auto& [name, texture_filepath] : entries) {
+            int width, height, channels;
+            if(!AssetPack::ImageInfo(texture_filepath, width, height, channels)) {
+                ENG_LOG_WARN("Resources::PreloadBakedAtlas - texture '{}' isn't in the asset pack, atlas is stale.", texture_filepath);
+                return false;
+            }
+            names.push_back(GetFilename(texture_filepath));
+            sizes.push_back(glm::ivec2(width, height));
+        }
+        if(layout.inputs_hash != AtlasLayout::InputsHash(names, sizes) || layout.offsets.size() != entries.size()) {
+            ENG_LOG_WARN("Resources::PreloadBakedAtlas - atlas doesn't match the spritesheets, re-cook the asset pack.");
+            return false;
+        }
+        if(std::max(layout.size.x, layout.size.y) > Renderer::MaxTextureSize()) {
+            ENG_LOG_WARN("Resources::PreloadBakedAtlas - atlas is too large for this GPU ({}x{}, max {}).", layout.size.x, layout.size.y, Renderer::MaxTextureSize());
+            return false;
+        }
+
+        AssetPack::ImageData img = {};
+        if(!AssetPack::ReadImage(BAKED_ATLAS_IMAGE, img) || img.channels != 4 || img.width != layout.size.x || img.height != layout.size.y) {
+            ENG_LOG_WARN("Resources::PreloadBakedAtlas - atlas image is missing or doesn't match the layout.");
+            return false;
+        }
+
+        //textures only carry the name & size, all of them share the atlas' handle
+        std::vector<TextureRef> textures = {};
+        std::unordered_map<std::string, size_t> lookup = {};
+        for(size_t i = 0; i < entries.size(); i++) {
+            textures.push_back(std::make_shared<Texture>(entries[i].second, sizes[i]));
+            lookup.insert({ entries[i].first, i });
+        }
+        Texture::MergeTextures(textures, layout, img.pixels, GL_NEAREST);
+
+        for(size_t i = 0; i < config.size(); i++) {
+            auto it = lookup.find(config.at(i).at("name"));
+            if(it != lookup.end())
+                out_textures[i] = textures[it->second];
+        }
+
+        ENG_LOG_TRACE("Resources::PreloadBakedAtlas - {} spritesheet textures from the baked atlas ({}x{}).", textures.size(), layout.size.x, layout.size.y);
+        data.atlas_baked = true;
+        return true;
+#endif
+    }
+
+    std::vector<std::pair<std::string, std::string>> AtlasSpritesheets() {
+        return AtlasSpritesheets(AssetPack::LoadJSON("res/json/spritesheets.json"));
+    }
+
+    std::vector<std::pair<std::string, std::string>> AtlasSpritesheets(const nlohmann::json& config) {
+        //same order as in the config file (so that the atlas layout doesn't change between launches), first entry wins on duplicate names
+        std::vector<std::pair<std::string, std::string>> entries = {};
+        std::unordered_map<std::string, bool> seen = {};
+        for(const nlohmann::json& entry : config) {
+            std::string name = entry.at("name");
+            if(seen.count(name))
+                continue;
+            seen.insert({ name, true });
+            entries.push_back({ name, entry.at("texture_filepath") });
+        }
+        return entries;
     }
     
     void PreloadObjects() {
@@ -537,23 +813,21 @@ namespace eng::Resources {
         //load & process index file
         ProcessIndexFile();
         
-        //fully load & prepare object prefab definitions
-        LoadObjectDefinitions();
+        //index object prefab definitions (the rest of each prefab is parsed on its first use)
+        IndexObjectDefinitions();
 
         FinalizeOthers();
 
         // ValidateIndexEntries();
-        SetupCorpseData();
-        FinalizeButtonDescriptions();
 
         float time_elapsed = t.TimeElapsed<Timer::ms>() * 1e-3f;
-        ENG_LOG_TRACE("Resources::PreloadObjects - parsed {} object prefab descriptions ({:.2f}s)", data.objects.size(), time_elapsed);
+        ENG_LOG_TRACE("Resources::PreloadObjects - indexed {} object prefab descriptions ({:.1f}kB of records, {:.2f}s)", data.objects.size(), data.prefab_buffer.size() / 1024.f, time_elapsed);
     }
 
     void ProcessIndexFile() {
         using json = nlohmann::json;
 
-        json config = json::parse(ReadFile("res/json/index.json"));
+        const json& config = PreloadedJSON("res/json/index.json");
         int i = 0;
         
         i = 0;
@@ -624,35 +898,24 @@ namespace eng::Resources {
         data.linkable = true;
     }
 
-    void LoadObjectDefinitions() {
-        using json = nlohmann::json;
-
-        json config = json::parse(ReadFile("res/json/utility.json"));
-        for(auto& entry : config) {
-            std::string str_id = entry.at("str_id");
-            if(!data.objects.count(str_id))
-                data.objects.insert({ str_id, GameObjectData_ParseNew(entry) });
-            else
-                GameObjectData_ParseExisting(entry, data.objects.at(str_id));
-        }
-
-        config = json::parse(ReadFile("res/json/spells.json"));
-        for(auto& entry : config) {
-            std::string str_id = entry.at("str_id");
-            if(!data.objects.count(str_id))
-                data.objects.insert({ str_id, GameObjectData_ParseNew(entry) });
-            else
-                GameObjectData_ParseExisting(entry, data.objects.at(str_id));
-        }
-
-        //load regular object definitions
-        config = json::parse(ReadFile("res/json/objects.json"));
-        for(auto& entry : config) {
-            std::string str_id = entry.at("str_id");
-            if(!data.objects.count(str_id))
-                data.objects.insert({ str_id, GameObjectData_ParseNew(entry) });
-            else
-                GameObjectData_ParseExisting(entry, data.objects.at(str_id));
+    void IndexObjectDefinitions() {
+        //utility objects & spells first, regular object definitions after
+        for(const char* filepath : { "res/json/utility.json", "res/json/spells.json", "res/json/objects.json" }) {
+            for(auto& entry : PreloadedJSON(filepath)) {
+                std::string str_id = entry.at("str_id");
+                if(!data.objects.count(str_id))
+                    data.objects.insert({ str_id, GameObjectData_ParseHeaderNew(entry) });
+                else
+                    GameObjectData_ParseHeader(entry, data.objects.at(str_id));
+
+                if(data.prefab_records.count(str_id))
+                    ENG_LOG_WARN("Resources::IndexObjectDefinitions - object '{}' is defined multiple times, using the last definition.", str_id);
+
+                //whole definition is kept in binary form, until the prefab is needed
+                std::vector<uint8_t> record = nlohmann::json::to_msgpack(entry);
+                data.prefab_records[str_id] = PrefabRecord{ data.prefab_buffer.size(), record.size() };
+                data.prefab_buffer.insert(data.prefab_buffer.end(), record.begin(), record.end());
+            }
         }
     }
 
@@ -661,7 +924,7 @@ namespace eng::Resources {
         t.Reset();
 
         using json = nlohmann::json;
-        json config = json::parse(ReadFile("res/json/research.json"));
+        const json& config = PreloadedJSON("res/json/research.json");
         if(config.size() != ResearchType::COUNT) {
             ENG_LOG_ERROR("Resources::PreloadResearchDefinitions - invalid number of researches detected.");
             throw std::runtime_error("");
@@ -684,7 +947,7 @@ namespace eng::Resources {
 
     void FinalizeOthers() {
         using json = nlohmann::json;
-        json config = json::parse(ReadFile("res/json/index.json"));
+        const json& config = PreloadedJSON("res/json/index.json");
 
         int i = 0;
         for(auto& entry : config.at("other")) {
@@ -718,10 +981,17 @@ namespace eng::Resources {
     }
 
     void MergeSpritesheets() {
+        if(data.atlas_baked) {
+            ENG_LOG_TRACE("Resources::MergeSpritesheets - using the baked atlas");
+            return;
+        }
+
         ENG_LOG_TRACE("Resources::MergeSpritesheets");
         std::vector<TextureRef> textures = {};
-        for(auto& [hash, ss] : data.spritesheets) {
-            textures.push_back(ss->Texture());
+        for(auto& [name, texture_filepath] : AtlasSpritesheets(PreloadedJSON("res/json/spritesheets.json"))) {
+            auto it = data.spritesheets.find(name);
+            if(it != data.spritesheets.end())
+                textures.push_back(it->second->Texture());
         }
         Texture::MergeTextures(textures, GL_NEAREST);
     }
@@ -729,7 +999,7 @@ namespace eng::Resources {
     void ValidateIndexEntries() {
         for(auto& entry : data.buildings) {
             for(auto& val : entry) {
-                if(!val->initialized) {
+                if(!val->indexed) {
                     ENG_LOG_ERROR("Resources::ValidateIndexEntries - index entry for building '{}' has no definition.", val->str_id);
                     throw std::runtime_error("");
                 }
@@ -738,7 +1008,7 @@ namespace eng::Resources {
 
         for(auto& entry : data.units) {
             for(auto& val : entry) {
-                if(!val->initialized) {
+                if(!val->indexed) {
                     ENG_LOG_ERROR("Resources::ValidateIndexEntries - index entry for unit '{}' has no definition.", val->str_id);
                     throw std::runtime_error("");
                 }
@@ -746,41 +1016,83 @@ namespace eng::Resources {
         }
 
         for(auto& val : data.utilities) {
-            if(!val->initialized) {
+            if(!val->indexed) {
                 ENG_LOG_ERROR("Resources::ValidateIndexEntries - index entry for utility object '{}' has no definition.", val->str_id);
                 throw std::runtime_error("");
             }
         }
     }
 
-    UtilityObjectDataRef SetupCorpseData() {
-        UtilityObjectDataRef corpse = std::dynamic_pointer_cast<UtilityObjectData>(Resources::LinkObject("corpse"));
-        if(corpse == nullptr) {
-            ENG_LOG_ERROR("Resources::SetupCorpseData - 'corpse' prefab not found");
+    void MaterializeObject(const GameObjectDataRef& obj) {
+        if(obj == nullptr)
+            return;
+
+        std::lock_guard<std::recursive_mutex> lock(prefab_mutex);
+        if(obj->initialized)
+            return;
+
+        auto it = data.prefab_records.find(obj->str_id);
+        if(it == data.prefab_records.end()) {
+            ENG_LOG_ERROR("Resources::MaterializeObject - object '{}' has no definition.", obj->str_id);
             throw std::runtime_error("");
         }
-        
-        AnimatorDataRef anim = corpse->animData;
-        int idx = anim->ActionCount();
 
-        //scan through all the units & retrieve their death animations
-        for(auto& [key, value] : data.objects) {
-            UnitDataRef ptr = std::dynamic_pointer_cast<UnitData>(value);
-            if(ptr != nullptr && ptr->initialized && ptr->animData->HasGraphics(3)) {
-                anim->AddAction(idx, ptr->animData->GetGraphics(3));
+        Timer t = {};
+        try {
+            const uint8_t* record = data.prefab_buffer.data() + it->second.offset;
+            nlohmann::json config = nlohmann::json::from_msgpack(record, record + it->second.size);
+            GameObjectData_ParseExisting(config, obj);
 
-                //mark unit's animation index in the corpse object, for easier access
-                ptr->deathAnimIdx = idx++;
-            }
+            GameObjectDataRef dt = obj;
+            GameObjectData_FinalizeButtonDescriptions(dt);
+        }
+        catch(std::exception&) {
+            //flag is set at the start of the parsing
+            obj->initialized = false;
+            ENG_LOG_ERROR("Resources::MaterializeObject - failed to parse the definition of '{}'.", obj->str_id);
+            throw;
         }
+        data.materialized_count++;
 
-        return corpse;
+        //referenced prefabs are used directly (not through Resources), they have to be ready as well
+        FactionObjectDataRef faction_obj = std::dynamic_pointer_cast<FactionObjectData>(obj);
+        if(faction_obj != nullptr)
+            MaterializeObject(faction_obj->projectile);
+
+        UnitDataRef unit = std::dynamic_pointer_cast<UnitData>(obj);
+        if(unit != nullptr)
+            RegisterDeathAnimation(unit);
+
+        data.materialize_us += t.TimeElapsed<Timer::us>();
+    }
+
+    void RegisterDeathAnimation(const UnitDataRef& unit) {
+        if(!unit->animData->HasGraphics(3))
+            return;
+
+        AnimatorDataRef anim = CorpseData()->animData;
+
+        //animation index derived from the unit's ID (not from the parsing order) - corpses store it in savefiles
+        int type = unit->num_id[1];
+        int idx = data.corpse_anim_base + ((type < 101) ? (type * 2 + int(bool(unit->num_id[2]))) : (UnitType::COUNT * 2 + (type - 101)));
+        anim->AddAction(idx, unit->animData->GetGraphics(3));
+
+        //mark unit's animation index in the corpse object, for easier access
+        unit->deathAnimIdx = idx;
     }
 
-    void FinalizeButtonDescriptions() {
-        for(auto& [name, entry] : data.objects) {
-            GameObjectData_FinalizeButtonDescriptions(entry);
+    UtilityObjectDataRef CorpseData() {
+        UtilityObjectDataRef corpse = std::dynamic_pointer_cast<UtilityObjectData>(LinkObject("corpse"));
+        if(corpse == nullptr) {
+            ENG_LOG_ERROR("Resources::CorpseData - 'corpse' prefab not found");
+            throw std::runtime_error("");
         }
+        MaterializeObject(corpse);
+
+        //unit death animations are added after the corpse's own animations
+        if(data.corpse_anim_base < 0)
+            data.corpse_anim_base = corpse->animData->ActionCount();
+        return corpse;
     }
 
 }//namespace eng::Resources
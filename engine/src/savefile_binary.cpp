@@ -0,0 +1,877 @@
+#include "engine/game/level.h"
+
+#include "engine/game/camera.h"
+#include "engine/utils/compression.h"
+#include "engine/utils/setup.h"
+
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <type_traits>
+
+#define SAVEFILE_MAGIC "S2SV"
+#define SAVEFILE_VERSION 3
+
+//Binary savefile layout (little-endian):
+//  header:        char[4] magic, u32 version, u32 section_count
+//  section table: section_count x { u32 id, u32 flags, u64 offset, u64 stored_size, u64 raw_size }
+//  sections:      raw or LZ compressed (flag COMPRESSED) section data, offsets are relative to the file start
+//
+//Section contents - arrays are stored as u32 count followed by raw POD records (fixed size, 4B fields, no padding):
+//  INFO:     i32 campaign_idx, i32 race, u32 custom_game, i32 preferred_opponents, i32 tick, u32[4] rng, ivec2[] starting_locations, 2x end condition
+//  MAP:      string tileset, ivec2 size, TileState[] tiles
+//  FACTIONS: per faction - FactionRecord, string name, u8[] research (human, orc, limits), u8[] building_limits, u8[] unit_limits, u32[] occlusion; ivec3[] diplomacy
+//  OBJECTS:  UnitRecord[], BuildingRecord[], UtilityRecord[], EntranceRecord[], WorkEntryRecord[], GarrisonRecord[]
+//  SCENARIO: i32[] data
+//  CAMERA:   f32 zoom, vec2 position
+//Records store the same fields as the JSON format, so both formats load into identical state.
+
+namespace eng {
+
+    namespace SavefileSection { enum { INFO = 1, MAP, FACTIONS, OBJECTS, SCENARIO, CAMERA }; }
+    namespace SavefileSectionFlags { enum { COMPRESSED = 1 }; }
+
+    struct SectionEntry {
+        uint32_t id;
+        uint32_t flags;
+        uint64_t offset;
+        uint64_t stored_size;
+        uint64_t raw_size;
+    };
+    static_assert(sizeof(SectionEntry) == 32);
+
+    //===== records =====
+
+    struct ObjectIDRecord {
+        uint32_t type, idx, id;
+    };
+
+    struct GameObjectRecord {
+        int32_t id[3];
+        int32_t num_id[3];
+        int32_t position[2];
+        int32_t anim_orientation;
+        int32_t anim_action;
+        float anim_frame;
+        uint32_t killed;
+    };
+
+    struct FactionObjectRecord {
+        float health;
+        int32_t factionIdx;
+        int32_t colorIdx;
+        int32_t variationIdx;
+        uint32_t active;
+        uint32_t finalized;
+        uint32_t faction_informed;
+    };
+
+    struct UnitRecord {
+        GameObjectRecord go;
+        FactionObjectRecord fo;
+        float move_offset[2];
+        int32_t carry_state;
+        float mana;
+        uint32_t anim_ended;
+
+        int32_t cmd_type;
+        int32_t cmd_target_pos[2];
+        ObjectIDRecord cmd_target_id;
+        int32_t cmd_flag;
+        int32_t cmd_v2[2];
+
+        int32_t action_type;
+        int32_t action_i, action_j, action_k;
+        uint32_t action_b, action_c;
+        float action_t;
+        int32_t action_count;
+        int32_t action_tick;
+    };
+
+    struct BuildingRecord {
+        GameObjectRecord go;
+        FactionObjectRecord fo;
+        uint32_t constructed;
+        int32_t amount_left;
+        int32_t real_actionIdx;
+
+        int32_t action_type;
+        float action_t1, action_t2, action_t3;
+        int32_t action_i;
+        uint32_t action_flag;
+        ObjectIDRecord action_target_id;
+        int32_t action_tick;
+    };
+
+    struct UtilityRecord {
+        GameObjectRecord go;
+        float real_position[2];
+        float real_size[2];
+        int32_t anim_owner[3];
+
+        float source_pos[2];
+        float target_pos[2];
+        ObjectIDRecord targetID;
+        ObjectIDRecord sourceID;
+        float f1, f2, f3;
+        int32_t i1, i2, i3, i4, i5, i6, i7;
+        ObjectIDRecord ids[5];
+    };
+
+    struct EntranceRecord {
+        ObjectIDRecord entered;
+        ObjectIDRecord enteree;
+        uint32_t construction;
+        int32_t carry_state;
+    };
+
+    struct WorkEntryRecord {
+        ObjectIDRecord entered;
+        ObjectIDRecord enteree;
+        int32_t cmd_target[2];
+        int32_t cmd_type;
+        int32_t start_tick;
+    };
+
+    struct GarrisonRecord {
+        ObjectIDRecord id;
+        int32_t value;
+    };
+
+    struct FactionRecord {
+        int32_t id;
+        int32_t controllerID;
+        int32_t colorIdx;
+        int32_t race;
+        uint32_t eliminated;
+        int32_t stats[7];
+        int32_t cameraPosition[2];
+        int32_t resources[3];
+    };
+
+    //===== BinaryWriter =====
+
+    struct BinaryWriter {
+        std::vector<uint8_t> data;
+    public:
+        template <typename T>
+        void Write(const T& value) {
+            static_assert(std::is_trivially_copyable_v<T>);
+            const uint8_t* bytes = (const uint8_t*)&value;
+            data.insert(data.end(), bytes, bytes + sizeof(T));
+        }
+
+        template <typename T>
+        void WriteArray(const T* values, size_t count) {
+            static_assert(std::is_trivially_copyable_v<T>);
+            Write<uint32_t>(uint32_t(count));
+            const uint8_t* bytes = (const uint8_t*)values;
+            data.insert(data.end(), bytes, bytes + sizeof(T) * count);
+        }
+
+        template <typename T>
+        void WriteArray(const std::vector<T>& values) { WriteArray(values.data(), values.size()); }
+
+        void WriteString(const std::string& str) { WriteArray(str.data(), str.size()); }
+    };
+
+    //===== BinaryReader =====
+
+    //Reads directly from the loaded file buffer. Throws on out-of-bounds reads (truncated or corrupted file).
+    struct BinaryReader {
+        const uint8_t* ptr;
+        const uint8_t* end;
+    public:
+        BinaryReader(const uint8_t* data, size_t size) : ptr(data), end(data + size) {}
+
+        template <typename T>
+        T Read() {
+            T value;
+            Consume(&value, sizeof(T));
+            return value;
+        }
+
+        template <typename T>
+        void ReadArray(std::vector<T>& out_values) {
+            static_assert(std::is_trivially_copyable_v<T>);
+            uint32_t count = Read<uint32_t>();
+            if(size_t(end - ptr) / sizeof(T) < count)
+                throw std::runtime_error("Savefile - binary data truncated.");
+            out_values.resize(count);
+            Consume(out_values.data(), sizeof(T) * count);
+        }
+
+        std::string ReadString() {
+            uint32_t length = Read<uint32_t>();
+            if(size_t(end - ptr) < length)
+                throw std::runtime_error("Savefile - binary data truncated.");
+            std::string str = std::string((const char*)ptr, length);
+            ptr += length;
+            return str;
+        }
+    private:
+        void Consume(void* dst, size_t size) {
+            if(size_t(end - ptr) < size)
+                throw std::runtime_error("Savefile - binary data truncated.");
+            if(size > 0)
+                memcpy(dst, ptr, size);
+            ptr += size;
+        }
+    };
+
+    bool IsLittleEndian();
+
+    void Write_Info(BinaryWriter& w, const LevelInfo& info);
+    void Write_Map(BinaryWriter& w, const Mapfile& map);
+    void Write_Map(BinaryWriter& w, const MapSnapshot& map);
+    void Write_Factions(BinaryWriter& w, const FactionsFile& factions);
+    void Write_Objects(BinaryWriter& w, const ObjectsFile& objects);
+    void Write_Camera(BinaryWriter& w, float zoom, const glm::vec2& position);
+
+    //Compresses the sections (if enabled) & writes the file (header, section table, section data).
+    void Write_Sections(const std::string& filepath, bool compress, std::vector<std::pair<uint32_t, BinaryWriter>>& sections);
+    void Write_EndCondition(BinaryWriter& w, const EndCondition& condition);
+
+    void Read_Info(BinaryReader& r, LevelInfo& info);
+    void Read_Map(BinaryReader& r, Mapfile& map);
+    void Read_Factions(BinaryReader& r, FactionsFile& factions);
+    void Read_Objects(BinaryReader& r, ObjectsFile& objects);
+    void Read_Camera(BinaryReader& r);
+    EndCondition Read_EndCondition(BinaryReader& r);
+
+    ObjectIDRecord Record(const ObjectID& id);
+    ObjectID FromRecord(const ObjectIDRecord& r);
+
+    GameObjectRecord Record(const GameObject::Entry& e);
+    void FromRecord(const GameObjectRecord& r, GameObject::Entry& e);
+
+    FactionObjectRecord Record(const FactionObject::Entry& e);
+    void FromRecord(const FactionObjectRecord& r, FactionObject::Entry& e);
+
+    UnitRecord Record(const Unit::Entry& e);
+    Unit::Entry FromRecord(const UnitRecord& r);
+
+    BuildingRecord Record(const Building::Entry& e);
+    Building::Entry FromRecord(const BuildingRecord& r);
+
+    UtilityRecord Record(const UtilityObject::Entry& e);
+    UtilityObject::Entry FromRecord(const UtilityRecord& r);
+
+    //===== Savefile =====
+
+    bool Savefile::IsBinary(const uint8_t* data, size_t size) {
+        return size >= 4 && strncmp((const char*)data, SAVEFILE_MAGIC, 4) == 0;
+    }
+
+    void Savefile::SaveBinary(const std::string& filepath, bool compress) const {
+        std::vector<std::pair<uint32_t, BinaryWriter>> sections;
+        sections.push_back({ SavefileSection::INFO, {} });       Write_Info(sections.back().second, info);
+        sections.push_back({ SavefileSection::MAP, {} });        Write_Map(sections.back().second, map);
+        sections.push_back({ SavefileSection::FACTIONS, {} });   Write_Factions(sections.back().second, factions);
+        sections.push_back({ SavefileSection::OBJECTS, {} });    Write_Objects(sections.back().second, objects);
+        sections.push_back({ SavefileSection::SCENARIO, {} });   sections.back().second.WriteArray(scenario);
+        sections.push_back({ SavefileSection::CAMERA, {} });     Write_Camera(sections.back().second, Camera::Get().Zoom(), Camera::Get().Position());
+        Write_Sections(filepath, compress, sections);
+    }
+
+    void Savefile::LoadBinary(const uint8_t* data, size_t size) {
+        if(!IsLittleEndian())
+            throw std::runtime_error("Savefile::LoadBinary - big-endian platforms aren't supported.");
+
+        BinaryReader header = BinaryReader(data, size);
+        header.ptr += 4;
+        uint32_t version = header.Read<uint32_t>();
+        uint32_t section_count = header.Read<uint32_t>();
+        if(version != SAVEFILE_VERSION) {
+            ENG_LOG_WARN("Savefile - unsupported binary format version ({}, expected {}).", version, SAVEFILE_VERSION);
+            throw std::runtime_error("Savefile - unsupported binary format version.");
+        }
+
+        std::vector<uint8_t> buffer;
+        bool has_info = false, has_map = false;
+        for(uint32_t i = 0; i < section_count; i++) {
+            SectionEntry entry = header.Read<SectionEntry>();
+            if(entry.offset > size || entry.stored_size > size - entry.offset)
+                throw std::runtime_error("Savefile - section out of bounds.");
+
+            //uncompressed sections are parsed directly from the file buffer
+            const uint8_t* section_data = data + entry.offset;
+            size_t section_size = size_t(entry.stored_size);
+            if(HAS_FLAG(entry.flags, SavefileSectionFlags::COMPRESSED)) {
+                buffer.resize(size_t(entry.raw_size));
+                if(!LZ::Decompress(section_data, section_size, buffer.data(), buffer.size())) {
+                    ENG_LOG_WARN("Savefile - failed to decompress section {}.", entry.id);
+                    throw std::runtime_error("Savefile - corrupted section data.");
+                }
+                section_data = buffer.data();
+                section_size = buffer.size();
+            }
+
+            BinaryReader r = BinaryReader(section_data, section_size);
+            switch(entry.id) {
+                case SavefileSection::INFO:     Read_Info(r, info); has_info = true; break;
+                case SavefileSection::MAP:      Read_Map(r, map); has_map = true; break;
+                case SavefileSection::FACTIONS: Read_Factions(r, factions); break;
+                case SavefileSection::OBJECTS:  Read_Objects(r, objects); break;
+                case SavefileSection::SCENARIO: r.ReadArray(scenario); break;
+                case SavefileSection::CAMERA:   Read_Camera(r); break;
+                default:
+                    ENG_LOG_WARN("Savefile - unknown section ({}), skipping.", entry.id);
+                    break;
+            }
+        }
+
+        if(!has_info || !has_map) {
+            ENG_LOG_WARN("Savefile - missing info or map data.");
+            throw std::runtime_error("Savefile - missing info or map data.");
+        }
+    }
+
+    //===== LevelSnapshot =====
+
+    void LevelSnapshot::SaveBinary(const std::string& filepath, bool compress) const {
+        std::vector<std::pair<uint32_t, BinaryWriter>> sections;
+        sections.push_back({ SavefileSection::INFO, {} });       Write_Info(sections.back().second, info);
+        sections.push_back({ SavefileSection::MAP, {} });        Write_Map(sections.back().second, map);
+        sections.push_back({ SavefileSection::FACTIONS, {} });   Write_Factions(sections.back().second, factions);
+        sections.push_back({ SavefileSection::OBJECTS, {} });    Write_Objects(sections.back().second, objects);
+        sections.push_back({ SavefileSection::SCENARIO, {} });   sections.back().second.WriteArray(scenario);
+        sections.push_back({ SavefileSection::CAMERA, {} });     Write_Camera(sections.back().second, camera_zoom, camera_position);
+        Write_Sections(filepath, compress, sections);
+    }
+
+    //==============================
+
+    bool IsLittleEndian() {
+        uint32_t v = 1;
+        return *(const uint8_t*)&v == 1;
+    }
+
+    void Write_Sections(const std::string& filepath, bool compress, std::vector<std::pair<uint32_t, BinaryWriter>>& sections) {
+        if(!IsLittleEndian())
+            throw std::runtime_error("Savefile::SaveBinary - big-endian platforms aren't supported.");
+
+        //compress sections & build the section table
+        std::vector<SectionEntry> table;
+        std::vector<std::vector<uint8_t>> payloads;
+        uint64_t offset = 12 + sizeof(SectionEntry) * sections.size();
+        for(auto& [id, writer] : sections) {
+            SectionEntry entry = { id, 0, offset, writer.data.size(), writer.data.size() };
+            if(compress && writer.data.size() > 0) {
+                std::vector<uint8_t> compressed = LZ::Compress(writer.data.data(), writer.data.size());
+                if(compressed.size() < writer.data.size()) {
+                    entry.flags |= SavefileSectionFlags::COMPRESSED;
+                    entry.stored_size = compressed.size();
+                    writer.data = std::move(compressed);
+                }
+            }
+            offset += entry.stored_size;
+            table.push_back(entry);
+            payloads.push_back(std::move(writer.data));
+        }
+
+        std::ofstream out = std::ofstream(filepath, std::ios::binary | std::ios::trunc);
+        if(!out.is_open()) {
+            ENG_LOG_WARN("Savefile::SaveBinary - failed to open '{}' for writing.", filepath.c_str());
+            throw std::runtime_error("Savefile::SaveBinary - failed to open the file.");
+        }
+
+        uint32_t header[2] = { SAVEFILE_VERSION, uint32_t(table.size()) };
+        out.write(SAVEFILE_MAGIC, 4);
+        out.write((const char*)header, sizeof(header));
+        out.write((const char*)table.data(), sizeof(SectionEntry) * table.size());
+        for(const std::vector<uint8_t>& payload : payloads)
+            out.write((const char*)payload.data(), payload.size());
+
+        if(!out.good()) {
+            ENG_LOG_WARN("Savefile::SaveBinary - failed to write '{}'.", filepath.c_str());
+            throw std::runtime_error("Savefile::SaveBinary - write failed.");
+        }
+
+        ENG_LOG_TRACE("[R] Savefile::SaveBinary - successfully stored as '{}' ({} bytes).", filepath.c_str(), offset);
+    }
+
+    void Write_Info(BinaryWriter& w, const LevelInfo& info) {
+        w.Write<int32_t>(info.campaignIdx);
+        w.Write<int32_t>(info.race);
+        w.Write<uint32_t>(info.custom_game);
+        w.Write<int32_t>(info.preferred_opponents);
+        w.Write<int32_t>(info.tick);
+        w.Write(info.rng.s);
+        w.WriteArray(info.startingLocations);
+        Write_EndCondition(w, info.end_conditions[0]);
+        Write_EndCondition(w, info.end_conditions[1]);
+    }
+
+    void Write_EndCondition(BinaryWriter& w, const EndCondition& condition) {
+        w.Write<uint32_t>(condition.disabled);
+        w.Write<uint32_t>(condition.state);
+        w.Write<uint32_t>(condition.factions_any);
+        w.Write<uint32_t>(condition.objects_any);
+
+        w.WriteArray(condition.factions);
+
+        std::vector<ObjectIDRecord> ids;
+        for(const ObjectID& id : condition.objects)
+            ids.push_back(Record(id));
+        w.WriteArray(ids);
+    }
+
+    void Write_Map(BinaryWriter& w, const Mapfile& map) {
+        w.WriteString(map.tileset);
+        w.Write<glm::ivec2>(map.tiles.Size());
+
+        int count = map.tiles.Count();
+        std::vector<TileState> tiles(count);
+        for(int i = 0; i < count; i++) {
+            const TileData& td = map.tiles[i];
+            tiles[i] = TileState{ td.tileType, td.variation, td.cornerType, td.health };
+        }
+        w.WriteArray(tiles);
+    }
+
+    void Write_Map(BinaryWriter& w, const MapSnapshot& map) {
+        w.WriteString(map.tileset);
+        w.Write<glm::ivec2>(map.size);
+
+        //same layout as the array of TileState records
+        w.Write<uint32_t>(uint32_t(map.count));
+        for(const std::shared_ptr<const MapSnapshot::Chunk>& chunk : map.chunks) {
+            const uint8_t* bytes = (const uint8_t*)chunk->data();
+            w.data.insert(w.data.end(), bytes, bytes + sizeof(TileState) * chunk->size());
+        }
+    }
+
+    void Write_Factions(BinaryWriter& w, const FactionsFile& factions) {
+        w.Write<uint32_t>(uint32_t(factions.factions.size()));
+        for(const FactionsFile::FactionEntry& entry : factions.factions) {
+            FactionRecord r = {};
+            r.id = entry.id;
+            r.controllerID = entry.controllerID;
+            r.colorIdx = entry.colorIdx;
+            r.race = entry.race;
+            r.eliminated = entry.eliminated;
+            std::array<int,7> stats = entry.stats.ToArray();
+            for(int i = 0; i < 7; i++)
+                r.stats[i] = stats[i];
+            r.cameraPosition[0] = entry.cameraPosition.x;
+            r.cameraPosition[1] = entry.cameraPosition.y;
+            for(int i = 0; i < 3; i++)
+                r.resources[i] = entry.resources[i];
+            w.Write(r);
+
+            w.WriteString(entry.name);
+
+            const Techtree& t = entry.techtree;
+            w.WriteArray(t.ResearchData(false).data(), t.ResearchData(false).size());
+            w.WriteArray(t.ResearchData(true).data(), t.ResearchData(true).size());
+            if(t.HasResearchLimits())
+                w.WriteArray(t.ResearchLimits().data(), t.ResearchLimits().size());
+            else
+                w.Write<uint32_t>(0);
+
+            std::vector<uint8_t> limits;
+            if(t.HasBuildingLimits())
+                limits.assign(t.BuildingLimits().begin(), t.BuildingLimits().end());
+            w.WriteArray(limits);
+
+            limits.clear();
+            if(t.HasUnitLimits())
+                limits.assign(t.UnitLimits().begin(), t.UnitLimits().end());
+            w.WriteArray(limits);
+
+            w.WriteArray(entry.occlusionData);
+        }
+
+        w.WriteArray(factions.diplomacy);
+    }
+
+    void Write_Objects(BinaryWriter& w, const ObjectsFile& objects) {
+        std::vector<UnitRecord> units;
+        units.reserve(objects.units.size());
+        for(const Unit::Entry& e : objects.units)
+            units.push_back(Record(e));
+        w.WriteArray(units);
+
+        std::vector<BuildingRecord> buildings;
+        buildings.reserve(objects.buildings.size());
+        for(const Building::Entry& e : objects.buildings)
+            buildings.push_back(Record(e));
+        w.WriteArray(buildings);
+
+        std::vector<UtilityRecord> utilities;
+        utilities.reserve(objects.utilities.size());
+        for(const UtilityObject::Entry& e : objects.utilities)
+            utilities.push_back(Record(e));
+        w.WriteArray(utilities);
+
+        std::vector<EntranceRecord> entries;
+        for(const auto& e : objects.entrance.entries)
+            entries.push_back(EntranceRecord{ Record(e.entered), Record(e.enteree), uint32_t(e.construction), e.carry_state });
+        w.WriteArray(entries);
+
+        std::vector<WorkEntryRecord> workEntries;
+        for(const auto& e : objects.entrance.workEntries)
+            workEntries.push_back(WorkEntryRecord{ Record(e.entered), Record(e.enteree), { e.cmd_target.x, e.cmd_target.y }, e.cmd_type, int32_t(e.start_tick) });
+        w.WriteArray(workEntries);
+
+        std::vector<GarrisonRecord> gms;
+        for(const auto& e : objects.entrance.gms)
+            gms.push_back(GarrisonRecord{ Record(e.first), e.second });
+        w.WriteArray(gms);
+    }
+
+    void Write_Camera(BinaryWriter& w, float zoom, const glm::vec2& position) {
+        w.Write<float>(zoom);
+        w.Write<glm::vec2>(position);
+    }
+
+    void Read_Info(BinaryReader& r, LevelInfo& info) {
+        info.campaignIdx = r.Read<int32_t>();
+        info.race = r.Read<int32_t>();
+        info.custom_game = bool(r.Read<uint32_t>());
+        info.preferred_opponents = r.Read<int32_t>();
+        info.tick = r.Read<int32_t>();
+        for(int i = 0; i < 4; i++)
+            info.rng.s[i] = r.Read<uint32_t>();
+        r.ReadArray(info.startingLocations);
+        info.end_conditions = EndConditions{ Read_EndCondition(r), Read_EndCondition(r) };
+    }
+
+    EndCondition Read_EndCondition(BinaryReader& r) {
+        EndCondition c = {};
+        c.disabled      = bool(r.Read<uint32_t>());
+        c.state         = bool(r.Read<uint32_t>());
+        c.factions_any  = bool(r.Read<uint32_t>());
+        c.objects_any   = bool(r.Read<uint32_t>());
+
+        r.ReadArray(c.factions);
+
+        std::vector<ObjectIDRecord> ids;
+        r.ReadArray(ids);
+        for(const ObjectIDRecord& id : ids)
+            c.objects.push_back(FromRecord(id));
+        return c;
+    }
+
+    void Read_Map(BinaryReader& r, Mapfile& map) {
+        map.tileset = r.ReadString();
+        glm::ivec2 size = r.Read<glm::ivec2>();
+        if(size.x <= 0 || size.y <= 0)
+            throw std::runtime_error("Savefile - invalid map size.");
+
+        std::vector<TileState> tiles;
+        r.ReadArray(tiles);
+
+        map.tiles = MapTiles(size);
+        if(int(tiles.size()) != map.tiles.Count()) {
+            ENG_LOG_WARN("Mapfile - size mismatch ({}/{}).", tiles.size(), map.tiles.Count());
+            throw std::runtime_error("Savefile - invalid map data.");
+        }
+
+        for(size_t i = 0; i < tiles.size(); i++) {
+            const TileState& t = tiles[i];
+            map.tiles[int(i)] = TileData(t.tileType, t.variation, t.cornerType, t.health);
+        }
+    }
+
+    void Read_Factions(BinaryReader& r, FactionsFile& factions) {
+        uint32_t count = r.Read<uint32_t>();
+        for(uint32_t f = 0; f < count; f++) {
+            FactionsFile::FactionEntry e = {};
+
+            FactionRecord rec = r.Read<FactionRecord>();
+            e.id = rec.id;
+            e.controllerID = rec.controllerID;
+            e.colorIdx = rec.colorIdx;
+            e.race = rec.race;
+            e.eliminated = bool(rec.eliminated);
+            e.stats.total_units         = rec.stats[0];
+            e.stats.total_buildings     = rec.stats[1];
+            e.stats.total_resources[0]  = rec.stats[2];
+            e.stats.total_resources[1]  = rec.stats[3];
+            e.stats.total_resources[2]  = rec.stats[4];
+            e.stats.units_killed        = rec.stats[5];
+            e.stats.buildings_razed     = rec.stats[6];
+            e.cameraPosition = glm::ivec2(rec.cameraPosition[0], rec.cameraPosition[1]);
+            e.resources = glm::ivec3(rec.resources[0], rec.resources[1], rec.resources[2]);
+
+            e.name = r.ReadString();
+
+            std::vector<uint8_t> values;
+            for(int i = 0; i < 2; i++) {
+                r.ReadArray(values);
+                std::array<uint8_t, ResearchType::COUNT>& research = e.techtree.ResearchData(bool(i));
+                if(values.size() != research.size())
+                    throw std::runtime_error("Savefile - invalid techtree data.");
+                std::copy(values.begin(), values.end(), research.begin());
+            }
+
+            r.ReadArray(values);
+            if(values.size() != 0) {
+                if(values.size() != ResearchType::COUNT)
+                    throw std::runtime_error("Savefile - invalid techtree data.");
+                std::copy(values.begin(), values.end(), e.techtree.ResearchLimits().begin());
+            }
+
+            r.ReadArray(values);
+            if(values.size() != 0) {
+                if(values.size() != BuildingType::COUNT)
+                    throw std::runtime_error("Savefile - invalid techtree data.");
+                for(int i = 0; i < BuildingType::COUNT; i++)
+                    e.techtree.BuildingLimits()[i] = bool(values[i]);
+            }
+
+            r.ReadArray(values);
+            if(values.size() != 0) {
+                if(values.size() != UnitType::COUNT)
+                    throw std::runtime_error("Savefile - invalid techtree data.");
+                for(int i = 0; i < UnitType::COUNT; i++)
+                    e.techtree.UnitLimits()[i] = bool(values[i]);
+            }
+            e.techtree.RecalculateBoth();
+
+            r.ReadArray(e.occlusionData);
+
+            factions.factions.push_back(std::move(e));
+        }
+
+        r.ReadArray(factions.diplomacy);
+    }
+
+    void Read_Objects(BinaryReader& r, ObjectsFile& objects) {
+        std::vector<UnitRecord> units;
+        r.ReadArray(units);
+        objects.units.reserve(units.size());
+        for(const UnitRecord& rec : units)
+            objects.units.push_back(FromRecord(rec));
+
+        std::vector<BuildingRecord> buildings;
+        r.ReadArray(buildings);
+        objects.buildings.reserve(buildings.size());
+        for(const BuildingRecord& rec : buildings)
+            objects.buildings.push_back(FromRecord(rec));
+
+        std::vector<UtilityRecord> utilities;
+        r.ReadArray(utilities);
+        objects.utilities.reserve(utilities.size());
+        for(const UtilityRecord& rec : utilities)
+            objects.utilities.push_back(FromRecord(rec));
+
+        std::vector<EntranceRecord> entries;
+        r.ReadArray(entries);
+        for(const EntranceRecord& e : entries)
+            objects.entrance.entries.push_back(EntranceController::Entry{ FromRecord(e.entered), FromRecord(e.enteree), bool(e.construction), e.carry_state });
+
+        std::vector<WorkEntryRecord> workEntries;
+        r.ReadArray(workEntries);
+        for(const WorkEntryRecord& e : workEntries)
+            objects.entrance.workEntries.push_back(EntranceController::WorkEntry{ FromRecord(e.entered), FromRecord(e.enteree), glm::ivec2(e.cmd_target[0], e.cmd_target[1]), e.cmd_type, tick_t(e.start_tick) });
+
+        std::vector<GarrisonRecord> gms;
+        r.ReadArray(gms);
+        for(const GarrisonRecord& e : gms)
+            objects.entrance.gms.push_back({ FromRecord(e.id), e.value });
+    }
+
+    void Read_Camera(BinaryReader& r) {
+        float zoom = r.Read<float>();
+        glm::vec2 position = r.Read<glm::vec2>();
+
+        //camera is owned by the main thread, background loads leave the camera setup to the game stage
+        if(Jobs::IsMainThread()) {
+            Camera& cam = Camera::Get();
+            cam.Zoom(zoom);
+            cam.Position(position);
+        }
+    }
+
+    //============================================
+
+    ObjectIDRecord Record(const ObjectID& id) {
+        return ObjectIDRecord{ uint32_t(id.type), uint32_t(id.idx), uint32_t(id.id) };
+    }
+
+    ObjectID FromRecord(const ObjectIDRecord& r) {
+        return ObjectID(r.type, r.idx, r.id);
+    }
+
+    GameObjectRecord Record(const GameObject::Entry& e) {
+        GameObjectRecord r = {};
+        for(int i = 0; i < 3; i++) {
+            r.id[i] = e.id[i];
+            r.num_id[i] = e.num_id[i];
+        }
+        r.position[0] = e.position.x;
+        r.position[1] = e.position.y;
+        r.anim_orientation = e.anim_orientation;
+        r.anim_action = e.anim_action;
+        r.anim_frame = e.anim_frame;
+        r.killed = e.killed;
+        return r;
+    }
+
+    void FromRecord(const GameObjectRecord& r, GameObject::Entry& e) {
+        e.id = glm::ivec3(r.id[0], r.id[1], r.id[2]);
+        e.num_id = glm::ivec3(r.num_id[0], r.num_id[1], r.num_id[2]);
+        e.position = glm::ivec2(r.position[0], r.position[1]);
+        e.anim_orientation = r.anim_orientation;
+        e.anim_action = r.anim_action;
+        e.anim_frame = r.anim_frame;
+        e.killed = bool(r.killed);
+    }
+
+    FactionObjectRecord Record(const FactionObject::Entry& e) {
+        return FactionObjectRecord{ e.health, e.factionIdx, e.colorIdx, e.variationIdx, e.active, e.finalized, e.faction_informed };
+    }
+
+    void FromRecord(const FactionObjectRecord& r, FactionObject::Entry& e) {
+        e.health = r.health;
+        e.factionIdx = r.factionIdx;
+        e.colorIdx = r.colorIdx;
+        e.variationIdx = r.variationIdx;
+        e.active = bool(r.active);
+        e.finalized = bool(r.finalized);
+        e.faction_informed = bool(r.faction_informed);
+    }
+
+    UnitRecord Record(const Unit::Entry& e) {
+        UnitRecord r = {};
+        r.go = Record((const GameObject::Entry&)e);
+        r.fo = Record((const FactionObject::Entry&)e);
+        r.move_offset[0] = e.move_offset.x;
+        r.move_offset[1] = e.move_offset.y;
+        r.carry_state = e.carry_state;
+        r.mana = e.mana;
+        r.anim_ended = e.anim_ended;
+
+        r.cmd_type = e.command.type;
+        r.cmd_target_pos[0] = e.command.target_pos.x;
+        r.cmd_target_pos[1] = e.command.target_pos.y;
+        r.cmd_target_id = Record(e.command.target_id);
+        r.cmd_flag = e.command.flag;
+        r.cmd_v2[0] = e.command.v2.x;
+        r.cmd_v2[1] = e.command.v2.y;
+
+        r.action_type = e.action.type;
+        r.action_i = e.action.data.i;
+        r.action_j = e.action.data.j;
+        r.action_k = e.action.data.k;
+        r.action_b = e.action.data.b;
+        r.action_c = e.action.data.c;
+        r.action_t = e.action.data.t;
+        r.action_count = e.action.data.count;
+        r.action_tick = e.action.data.tick;
+        return r;
+    }
+
+    Unit::Entry FromRecord(const UnitRecord& r) {
+        Unit::Entry e = {};
+        FromRecord(r.go, e);
+        FromRecord(r.fo, e);
+        e.move_offset = glm::vec2(r.move_offset[0], r.move_offset[1]);
+        e.carry_state = r.carry_state;
+        e.mana = r.mana;
+        e.anim_ended = bool(r.anim_ended);
+
+        e.command.type = r.cmd_type;
+        e.command.target_pos = glm::ivec2(r.cmd_target_pos[0], r.cmd_target_pos[1]);
+        e.command.target_id = FromRecord(r.cmd_target_id);
+        e.command.flag = r.cmd_flag;
+        e.command.v2 = glm::ivec2(r.cmd_v2[0], r.cmd_v2[1]);
+
+        e.action.type = r.action_type;
+        e.action.data.i = r.action_i;
+        e.action.data.j = r.action_j;
+        e.action.data.k = r.action_k;
+        e.action.data.b = bool(r.action_b);
+        e.action.data.c = bool(r.action_c);
+        e.action.data.t = r.action_t;
+        e.action.data.count = r.action_count;
+        e.action.data.tick = r.action_tick;
+        return e;
+    }
+
+    BuildingRecord Record(const Building::Entry& e) {
+        BuildingRecord r = {};
+        r.go = Record((const GameObject::Entry&)e);
+        r.fo = Record((const FactionObject::Entry&)e);
+        r.constructed = e.constructed;
+        r.amount_left = e.amount_left;
+        r.real_actionIdx = e.real_actionIdx;
+
+        r.action_type = e.action.type;
+        r.action_t1 = e.action.data.t1;
+        r.action_t2 = e.action.data.t2;
+        r.action_t3 = e.action.data.t3;
+        r.action_i = e.action.data.i;
+        r.action_flag = e.action.data.flag;
+        r.action_target_id = Record(e.action.data.target_id);
+        r.action_tick = e.action.data.tick;
+        return r;
+    }
+
+    Building::Entry FromRecord(const BuildingRecord& r) {
+        Building::Entry e = {};
+        FromRecord(r.go, e);
+        FromRecord(r.fo, e);
+        e.constructed = bool(r.constructed);
+        e.amount_left = r.amount_left;
+        e.real_actionIdx = r.real_actionIdx;
+
+        e.action.type = r.action_type;
+        e.action.data.t1 = r.action_t1;
+        e.action.data.t2 = r.action_t2;
+        e.action.data.t3 = r.action_t3;
+        e.action.data.i = r.action_i;
+        e.action.data.flag = bool(r.action_flag);
+        e.action.data.target_id = FromRecord(r.action_target_id);
+        e.action.data.tick = r.action_tick;
+        return e;
+    }
+
+    UtilityRecord Record(const UtilityObject::Entry& e) {
+        UtilityRecord r = {};
+        r.go = Record((const GameObject::Entry&)e);
+        r.real_position[0] = e.real_position.x;
+        r.real_position[1] = e.real_position.y;
+        r.real_size[0] = e.real_size.x;
+        r.real_size[1] = e.real_size.y;
+        r.anim_owner[0] = e.anim_owner.x;
+        r.anim_owner[1] = e.anim_owner.y;
+        r.anim_owner[2] = e.anim_owner.z;
+
+        const UtilityObject::LiveData& ld = e.live_data;
+        r.source_pos[0] = ld.source_pos.x;
+        r.source_pos[1] = ld.source_pos.y;
+        r.target_pos[0] = ld.target_pos.x;
+        r.target_pos[1] = ld.target_pos.y;
+        r.targetID = Record(ld.targetID);
+        r.sourceID = Record(ld.sourceID);
+        r.f1 = ld.f1; r.f2 = ld.f2; r.f3 = ld.f3;
+        r.i1 = ld.i1; r.i2 = ld.i2; r.i3 = ld.i3; r.i4 = ld.i4; r.i5 = ld.i5; r.i6 = ld.i6; r.i7 = ld.i7;
+        for(int i = 0; i < 5; i++)
+            r.ids[i] = Record(ld.ids[i]);
+        return r;
+    }
+
+    UtilityObject::Entry FromRecord(const UtilityRecord& r) {
+        UtilityObject::Entry e = {};
+        FromRecord(r.go, e);
+        e.real_position = glm::vec2(r.real_position[0], r.real_position[1]);
+        e.real_size = glm::vec2(r.real_size[0], r.real_size[1]);
+        e.anim_owner = glm::ivec3(r.anim_owner[0], r.anim_owner[1], r.anim_owner[2]);
+
+        UtilityObject::LiveData& ld = e.live_data;
+        ld.source_pos = glm::vec2(r.source_pos[0], r.source_pos[1]);
+        ld.target_pos = glm::vec2(r.target_pos[0], r.target_pos[1]);
+        ld.targetID = FromRecord(r.targetID);
+        ld.sourceID = FromRecord(r.sourceID);
+        ld.f1 = r.f1; ld.f2 = r.f2; ld.f3 = r.f3;
+        ld.i1 = r.i1; ld.i2 = r.i2; ld.i3 = r.i3; ld.i4 = r.i4; ld.i5 = r.i5; ld.i6 = r.i6; ld.i7 = r.i7;
+        for(int i = 0; i < 5; i++)
+            ld.ids[i] = FromRecord(r.ids[i]);
+        return e;
+    }
+
+}//namespace eng
@@ -0,0 +1,467 @@
+#include "engine/game/level.h"
+
+#include "engine/utils/json.h"
+#include "engine/utils/setup.h"
+
+#include <stdexcept>
+
+//Streaming (SAX) parser for the JSON savefiles. Bulk of the file is converted directly as the tokens arrive:
+//  map.data                            - tile arrays are written straight into MapTiles (or into a compact buffer, if the size isn't known yet)
+//  objects.units/buildings/utilities   - each entry is collected into a small DOM, converted into an Entry & discarded
+//Remaining sections are small - they're collected into DOM subtrees & handed over to the regular Parse_* functions (same validation as the DOM path).
+
+namespace eng {
+
+    //defined in level.cpp
+    bool Parse_Info(LevelInfo& info, const nlohmann::json& config);
+    bool Parse_FactionsFile(const LevelInfo& info, FactionsFile& factions, const nlohmann::json& config);
+    bool Parse_Camera(const nlohmann::json& config);
+    bool Parse_Scenario(std::vector<int>& data, const nlohmann::json& config);
+    Unit::Entry Parse_UnitEntry(const nlohmann::json& entry);
+    Building::Entry Parse_BuildingEntry(const nlohmann::json& entry);
+    UtilityObject::Entry Parse_UtilityEntry(const nlohmann::json& entry);
+    void Parse_Entrance(EntranceController::ExportData& entrance, const nlohmann::json& config);
+
+    static bool streaming_parser = true;
+
+    namespace SaxFrame { enum { ROOT, MAP, MAP_DATA, TILE, OBJECTS, UNITS, BUILDINGS, UTILITIES }; }
+    namespace SaxTarget { enum { SECTION, MAP_FIELD, OBJECTS_FIELD, OBJECT_ENTRY }; }
+    namespace SaxObjectsPart { enum { UNITS = 1, BUILDINGS = 2, UTILITIES = 4, ENTRANCE = 8, ALL = 15 }; }
+
+    //===== SaxCapture =====
+
+    //Builds a DOM of a single JSON value from the SAX events.
+    struct SaxCapture {
+        nlohmann::json value;
+        std::vector<nlohmann::json*> stack;
+        std::string key;
+        bool active = false;
+    public:
+        void Begin();
+
+        //Each returns true once the captured value is complete.
+        bool Value(nlohmann::json&& v);
+        bool StartContainer(nlohmann::json&& container);
+        bool EndContainer();
+    private:
+        nlohmann::json* Insert(nlohmann::json&& v);
+    };
+
+    //===== SavefileSAX =====
+
+    class SavefileSAX : public nlohmann::json_sax<nlohmann::json> {
+    public:
+        SavefileSAX(Mapfile& map, ObjectsFile& objects);
+
+        virtual bool null() override;
+        virtual bool boolean(bool val) override;
+        virtual bool number_integer(number_integer_t val) override;
+        virtual bool number_unsigned(number_unsigned_t val) override;
+        virtual bool number_float(number_float_t val, const string_t& s) override;
+        virtual bool string(string_t& val) override;
+        virtual bool binary(binary_t& val) override;
+        virtual bool start_object(std::size_t elements) override;
+        virtual bool key(string_t& val) override;
+        virtual bool end_object() override;
+        virtual bool start_array(std::size_t elements) override;
+        virtual bool end_array() override;
+        virtual bool parse_error(std::size_t position, const std::string& last_token, const nlohmann::detail::exception& ex) override;
+
+        //Moves buffered tiles into the mapfile (when the size came after the data) & validates the tile count.
+        bool FinalizeMap();
+    public:
+        nlohmann::json sections = nlohmann::json::object();     //top level entries, other than map & objects
+        bool has_objects = false;
+        bool objects_valid = true;
+    private:
+        bool Scalar(nlohmann::json&& val);
+        bool StartContainer(bool is_array);
+        bool EndContainer();
+
+        //Decides how to handle a value, that starts at the current position. Returns true when the value is captured into a DOM.
+        bool Route(bool is_container, bool is_array);
+        void Captured();
+
+        void TileValue(const nlohmann::json& val);
+        void TileEnd();
+    private:
+        Mapfile& map;
+        ObjectsFile& objects;
+
+        std::vector<int> frames;
+        std::string current_key;
+
+        SaxCapture capture;
+        int capture_target = SaxTarget::SECTION;
+        int capture_frame = SaxFrame::ROOT;
+        std::string capture_key;
+
+        bool has_map = false;
+        bool has_size = false;
+        bool has_tiles = false;
+        glm::ivec2 size = glm::ivec2(0);
+        std::vector<TileState> tile_buffer;                     //used only when the tile data precede the map size
+        int tile_count = 0;
+        int tile_values[4] = {};
+        int tile_value_count = 0;
+        bool outdated = false;
+
+        int objects_parts = 0;
+    };
+
+    //===== Savefile =====
+
+    bool Savefile::StreamingParserEnabled() {
+        return streaming_parser;
+    }
+
+    void Savefile::EnableStreamingParser(bool enabled) {
+        streaming_parser = enabled;
+    }
+
+    void Savefile::LoadJSON_Streaming(const std::string& text) {
+        SavefileSAX handler = SavefileSAX(map, objects);
+        if(!nlohmann::json::sax_parse(text, &handler)) {
+            throw std::runtime_error("Savefile - malformed JSON.");
+        }
+        nlohmann::json& config = handler.sections;
+
+        //parse level info
+        if(!config.count("info") || !Parse_Info(info, config.at("info"))) {
+            ENG_LOG_WARN("Savefile - invalid info data.");
+            throw std::runtime_error("Savefile - invalid info data.");
+        }
+
+        //map tiles were already streamed in
+        if(!handler.FinalizeMap()) {
+            ENG_LOG_WARN("Savefile - invalid map data.");
+            throw std::runtime_error("Savefile - invalid map data.");
+        }
+
+        //parse factions data (optional entry, but malformed structure throws)
+        if(config.count("factions") && !Parse_FactionsFile(info, factions, config.at("factions"))) {
+            ENG_LOG_WARN("Savefile - invalid factions data.");
+            throw std::runtime_error("Savefile - invalid factions data.");
+        }
+
+        //object entries were already streamed in (optional entry, but malformed structure throws)
+        if(handler.has_objects && !handler.objects_valid) {
+            ENG_LOG_WARN("Savefile - invalid object data.");
+            throw std::runtime_error("Savefile - invalid object data.");
+        }
+
+        //parse camera params (optional entry, but malformed structure throws)
+        if(config.count("camera") && !Parse_Camera(config.at("camera"))) {
+            ENG_LOG_WARN("Savefile - invalid camera data.");
+            throw std::runtime_error("Savefile - invalid camera data.");
+        }
+
+        if(config.count("scenario") && !Parse_Scenario(scenario, config.at("scenario"))) {
+            ENG_LOG_WARN("Savefile - invalid scenario data.");
+            throw std::runtime_error("Savefile - invalid scenario data.");
+        }
+
+        if(!config.at("info").count("tick"))
+            ConvertLegacyTimers();
+    }
+
+    //===== SavefileSAX =====
+
+    SavefileSAX::SavefileSAX(Mapfile& map_, ObjectsFile& objects_) : map(map_), objects(objects_) {}
+
+    bool SavefileSAX::null() { return Scalar(nullptr); }
+    bool SavefileSAX::boolean(bool val) { return Scalar(val); }
+    bool SavefileSAX::number_integer(number_integer_t val) { return Scalar(val); }
+    bool SavefileSAX::number_unsigned(number_unsigned_t val) { return Scalar(val); }
+    bool SavefileSAX::number_float(number_float_t val, const string_t& s) { return Scalar(val); }
+    bool SavefileSAX::string(string_t& val) { return Scalar(std::move(val)); }
+    bool SavefileSAX::binary(binary_t& val) { return Scalar(nlohmann::json::binary(std::move(val))); }
+
+    bool SavefileSAX::start_object(std::size_t elements) { return StartContainer(false); }
+    bool SavefileSAX::end_object() { return EndContainer(); }
+    bool SavefileSAX::start_array(std::size_t elements) { return StartContainer(true); }
+    bool SavefileSAX::end_array() { return EndContainer(); }
+
+    bool SavefileSAX::key(string_t& val) {
+        if(capture.active)
+            capture.key = val;
+        else
+            current_key = val;
+        return true;
+    }
+
+    bool SavefileSAX::parse_error(std::size_t position, const std::string& last_token, const nlohmann::detail::exception& ex) {
+        ENG_LOG_WARN("Savefile - JSON parse error at {} ({}).", position, ex.what());
+        return false;
+    }
+
+    bool SavefileSAX::FinalizeMap() {
+        if(!has_map || !has_size || !has_tiles || map.tileset.empty()) {
+            ENG_LOG_WARN("Mapfile - missing entries.");
+            return false;
+        }
+
+        if(!tile_buffer.empty()) {
+            map.tiles = MapTiles(size);
+            int count = std::min(int(tile_buffer.size()), map.tiles.Count());
+            for(int i = 0; i < count; i++) {
+                const TileState& t = tile_buffer[i];
+                map.tiles[i] = TileData(t.tileType, t.variation, t.cornerType, t.health);
+            }
+            tile_buffer = {};
+        }
+
+        if(outdated) {
+            ENG_LOG_WARN("Mapfile format is outdated.");
+        }
+
+        if(tile_count != map.tiles.Count()) {
+            ENG_LOG_WARN("Mapfile - size mismatch ({}/{}).", tile_count, map.tiles.Count());
+            return false;
+        }
+
+        return true;
+    }
+
+    bool SavefileSAX::Scalar(nlohmann::json&& val) {
+        if(capture.active) {
+            if(capture.Value(std::move(val)))
+                Captured();
+            return true;
+        }
+
+        if(!frames.empty() && frames.back() == SaxFrame::TILE) {
+            TileValue(val);
+            return true;
+        }
+
+        Route(false, false);
+        capture.Begin();
+        capture.Value(std::move(val));
+        Captured();
+        return true;
+    }
+
+    bool SavefileSAX::StartContainer(bool is_array) {
+        nlohmann::json container = is_array ? nlohmann::json::array() : nlohmann::json::object();
+        if(capture.active) {
+            capture.StartContainer(std::move(container));
+        }
+        else if(Route(true, is_array)) {
+            capture.Begin();
+            capture.StartContainer(std::move(container));
+        }
+        return true;
+    }
+
+    bool SavefileSAX::EndContainer() {
+        if(capture.active) {
+            if(capture.EndContainer())
+                Captured();
+            return true;
+        }
+
+        if(frames.back() == SaxFrame::TILE) {
+            TileEnd();
+        }
+        else if(frames.back() == SaxFrame::OBJECTS && objects_parts != SaxObjectsPart::ALL) {
+            //all the object lists are required (same as in the DOM parser)
+            ENG_LOG_WARN("Failed to parse savefile objects.");
+            objects_valid = false;
+        }
+        frames.pop_back();
+        return true;
+    }
+
+    bool SavefileSAX::Route(bool is_container, bool is_array) {
+        if(frames.empty()) {
+            if(!is_container || is_array)
+                throw std::runtime_error("Savefile - invalid JSON structure.");
+            frames.push_back(SaxFrame::ROOT);
+            return false;
+        }
+
+        int frame = frames.back();
+        capture_frame = frame;
+        capture_key = current_key;
+        switch(frame) {
+            case SaxFrame::ROOT:
+                if(current_key == "map" && is_container && !is_array) {
+                    has_map = true;
+                    frames.push_back(SaxFrame::MAP);
+                    return false;
+                }
+                else if(current_key == "objects" && is_container && !is_array) {
+                    has_objects = true;
+                    frames.push_back(SaxFrame::OBJECTS);
+                    return false;
+                }
+                capture_target = SaxTarget::SECTION;
+                return true;
+            case SaxFrame::MAP:
+                if(current_key == "data" && is_array) {
+                    has_tiles = true;
+                    frames.push_back(SaxFrame::MAP_DATA);
+                    return false;
+                }
+                capture_target = SaxTarget::MAP_FIELD;
+                return true;
+            case SaxFrame::MAP_DATA:
+                if(!is_array)
+                    throw std::runtime_error("Savefile - invalid tile entry.");
+                tile_value_count = 0;
+                frames.push_back(SaxFrame::TILE);
+                return false;
+            case SaxFrame::TILE:
+                throw std::runtime_error("Savefile - invalid tile entry.");
+            case SaxFrame::OBJECTS:
+                if(is_array) {
+                    if(current_key == "units")     { objects_parts |= SaxObjectsPart::UNITS;     frames.push_back(SaxFrame::UNITS);     return false; }
+                    if(current_key == "buildings") { objects_parts |= SaxObjectsPart::BUILDINGS; frames.push_back(SaxFrame::BUILDINGS); return false; }
+                    if(current_key == "utilities") { objects_parts |= SaxObjectsPart::UTILITIES; frames.push_back(SaxFrame::UTILITIES); return false; }
+                }
+                capture_target = SaxTarget::OBJECTS_FIELD;
+                return true;
+            default:
+                capture_target = SaxTarget::OBJECT_ENTRY;
+                return true;
+        }
+    }
+
+    void SavefileSAX::Captured() {
+        nlohmann::json& value = capture.value;
+        switch(capture_target) {
+            case SaxTarget::SECTION:
+                sections[capture_key] = std::move(value);
+                break;
+            case SaxTarget::MAP_FIELD:
+                if(capture_key == "size") {
+                    size = json::parse_ivec2(value);
+                    has_size = true;
+                    //size came before the tile data - tiles can be written directly
+                    if(tile_count == 0)
+                        map.tiles = MapTiles(size);
+                }
+                else if(capture_key == "tileset") {
+                    map.tileset = value;
+                }
+                break;
+            case SaxTarget::OBJECTS_FIELD:
+                //object lists that aren't arrays (empty lists are stored as null) are handled the same way as in the DOM parser
+                try {
+                    if(capture_key == "entrance") {
+                        objects_parts |= SaxObjectsPart::ENTRANCE;
+                        Parse_Entrance(objects.entrance, value);
+                    }
+                    else if(capture_key == "units") {
+                        objects_parts |= SaxObjectsPart::UNITS;
+                        for(auto& entry : value)
+                            objects.units.push_back(Parse_UnitEntry(entry));
+                    }
+                    else if(capture_key == "buildings") {
+                        objects_parts |= SaxObjectsPart::BUILDINGS;
+                        for(auto& entry : value)
+                            objects.buildings.push_back(Parse_BuildingEntry(entry));
+                    }
+                    else if(capture_key == "utilities") {
+                        objects_parts |= SaxObjectsPart::UTILITIES;
+                        for(auto& entry : value)
+                            objects.utilities.push_back(Parse_UtilityEntry(entry));
+                    }
+                } catch(nlohmann::json::exception&) {
+                    ENG_LOG_WARN("Failed to parse savefile objects.");
+                    objects_valid = false;
+                }
+                break;
+            case SaxTarget::OBJECT_ENTRY:
+                try {
+                    switch(capture_frame) {
+                        case SaxFrame::UNITS:       objects.units.push_back(Parse_UnitEntry(value)); break;
+                        case SaxFrame::BUILDINGS:   objects.buildings.push_back(Parse_BuildingEntry(value)); break;
+                        case SaxFrame::UTILITIES:   objects.utilities.push_back(Parse_UtilityEntry(value)); break;
+                    }
+                } catch(nlohmann::json::exception&) {
+                    ENG_LOG_WARN("Failed to parse savefile objects.");
+                    objects_valid = false;
+                }
+                break;
+        }
+        value = nullptr;
+    }
+
+    void SavefileSAX::TileValue(const nlohmann::json& val) {
+        if(tile_value_count < 4)
+            tile_values[tile_value_count] = int(val);
+        tile_value_count++;
+    }
+
+    void SavefileSAX::TileEnd() {
+        if(tile_value_count < 3)
+            throw std::runtime_error("Savefile - invalid tile entry.");
+
+        int health = 100;
+        if(tile_value_count >= 4)
+            health = tile_values[3];
+        else
+            outdated = true;
+
+        if(map.tiles.Valid()) {
+            if(tile_count < map.tiles.Count())
+                map.tiles[tile_count] = TileData(tile_values[0], tile_values[1], tile_values[2], health);
+        }
+        else {
+            tile_buffer.push_back(TileState{ tile_values[0], tile_values[1], tile_values[2], health });
+        }
+        tile_count++;
+    }
+
+    //===== SaxCapture =====
+
+    void SaxCapture::Begin() {
+        value = nullptr;
+        stack.clear();
+        active = true;
+    }
+
+    bool SaxCapture::Value(nlohmann::json&& v) {
+        Insert(std::move(v));
+        if(stack.empty()) {
+            active = false;
+            return true;
+        }
+        return false;
+    }
+
+    bool SaxCapture::StartContainer(nlohmann::json&& container) {
+        stack.push_back(Insert(std::move(container)));
+        return false;
+    }
+
+    bool SaxCapture::EndContainer() {
+        stack.pop_back();
+        if(stack.empty()) {
+            active = false;
+            return true;
+        }
+        return false;
+    }
+
+    nlohmann::json* SaxCapture::Insert(nlohmann::json&& v) {
+        if(stack.empty()) {
+            value = std::move(v);
+            return &value;
+        }
+
+        nlohmann::json& parent = *stack.back();
+        if(parent.is_array()) {
+            parent.push_back(std::move(v));
+            return &parent.back();
+        }
+        else {
+            nlohmann::json& slot = parent[key];
+            slot = std::move(v);
+            return &slot;
+        }
+    }
+
+}//namespace eng
@@ -2,7 +2,7 @@
 #include "engine/utils/log.h"
 
 #include "engine/game/level.h"
-#include "engine/core/input.h"
+#include "engine/game/sim_clock.h"
 
 constexpr float CONDITION_UPDATE_FREQ = 2.f;
 
@@ -39,7 +39,7 @@ namespace eng {
     }
 
     bool Sc00_ScenarioController::EndConditionsUpdate(Level& level) {
-        t += Input::Get().deltaTime;
+        t += SimClock::DeltaTime();
         if(t < CONDITION_UPDATE_FREQ)
             return false;
 
@@ -76,7 +76,7 @@ namespace eng {
     }
 
     bool Sc01_ScenarioController::EndConditionsUpdate(Level& level) {
-        t += Input::Get().deltaTime;
+        t += SimClock::DeltaTime();
         if(t < CONDITION_UPDATE_FREQ)
             return false;
 
@@ -0,0 +1,63 @@
+#include "engine/game/sim_clock.h"
+
+#include "engine/utils/setup.h"
+#include "engine/utils/dbg_gui.h"
+
+#include <cmath>
+
+namespace eng {
+
+    //====== SimClock ======
+
+    SimClock& SimClock::Get() {
+        static SimClock instance = SimClock();
+        return instance;
+    }
+
+    int SimClock::Advance(float frameTime) {
+        acc += frameTime;
+
+        int ticks = int(acc * TICK_RATE);
+        if(ticks > MAX_TICKS_PER_FRAME) {
+            //frame took too long - drop the excess time, only keep the fraction for interpolation
+            ticks = MAX_TICKS_PER_FRAME;
+            acc = std::fmod(acc, TICK_LENGTH);
+        }
+        else {
+            acc -= ticks * TICK_LENGTH;
+        }
+
+        //guard against float imprecision (keeps Alpha() within range)
+        if(acc < 0.f) acc = 0.f;
+
+        frameTicks = ticks;
+        return ticks;
+    }
+
+    void SimClock::Reset(tick_t tick_) {
+        tick = tick_;
+        acc = 0.f;
+        frameTicks = 0;
+        ENG_LOG_TRACE("SimClock::Reset - tick = {}", tick);
+    }
+
+    tick_t SimClock::Now() {
+        return Get().tick;
+    }
+
+    tick_t SimClock::Ticks(float seconds) {
+        return tick_t(std::ceil(seconds * TICK_RATE));
+    }
+
+    void SimClock::DBG_GUI() {
+#ifdef ENGINE_ENABLE_GUI
+        ImGui::Begin("SimClock");
+        ImGui::Text("Tick: %d (%.1fs)", tick, Time());
+        ImGui::Text("Tick rate: %d", TICK_RATE);
+        ImGui::Text("Ticks this frame: %d", frameTicks);
+        ImGui::Text("Alpha: %.2f", Alpha());
+        ImGui::End();
+#endif
+    }
+
+}//namespace eng
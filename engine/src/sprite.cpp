@@ -4,6 +4,7 @@
 #include "engine/utils/utils.h"
 #include "engine/utils/dbg_gui.h"
 #include "engine/utils/json.h"
+#include "engine/utils/asset_pack.h"
 
 #include "engine/core/quad.h"
 #include "engine/core/renderer.h"
@@ -12,8 +13,12 @@ namespace eng {
 
     SpritesheetData ParseConfig_Spritesheet(const std::string& config_filepath, int flags);
     SpritesheetData ParseConfig_Spritesheet(const std::string& name, const nlohmann::json& config, int texture_flags);
+    SpritesheetData ParseConfig_Spritesheet(const std::string& name, const nlohmann::json& config, const TextureRef& texture);
     SpriteData ParseConfig_Sprite(const nlohmann::json& config);
 
+    //Submits axis aligned sprite quad. Sprites without object info go through the compact instanced path.
+    void SubmitSprite(const glm::uvec4& info, const glm::vec3& screen_pos, const glm::vec2& screen_size, const glm::vec4& color, const TexCoords& tc, GLuint texture, float paletteIdx = -1.f, bool alphaFromTexture = false);
+
     //===== Sprite =====
 
     Sprite::Sprite(const TextureRef& texture_, const SpriteData& data_) : texture(texture_), data(data_) {
@@ -21,9 +26,7 @@ namespace eng {
     }
 
     void Sprite::Render(const glm::uvec4& info, const glm::vec3& screen_pos, const glm::vec2& screen_size, int idxY, int idxX) const {
-        glm::vec2 texOffset = glm::vec2((data.size.x + data.frames.offset.x) * (idxX % data.frames.line_length), (data.size.y + data.frames.offset.y) * (idxY % data.frames.line_count));
-        Quad quad = Quad::FromCorner(info, screen_pos, screen_size, glm::vec4(1.f), texture, TexOffset(texOffset));
-        Renderer::RenderQuad(quad);
+        SubmitSprite(info, screen_pos, screen_size, glm::vec4(1.f), FrameTexCoords(idxY, idxX), texture->Handle());
     }
 
     void Sprite::Render(const glm::vec3& screen_pos, const glm::vec2& screen_size, int idxY, int idxX, float paletteIdx) const {
@@ -31,27 +34,16 @@ namespace eng {
     }
 
     void Sprite::Render(const glm::vec3& screen_pos, const glm::vec2& screen_size, int idxY, int idxX, const glm::vec4& color, float paletteIdx) const {
-        glm::vec2 texOffset = glm::vec2((data.size.x + data.frames.offset.x) * (idxX % data.frames.line_length), (data.size.y + data.frames.offset.y) * (idxY % data.frames.line_count));
-        Quad quad = Quad::FromCorner(screen_pos, screen_size, color, texture, TexOffset(texOffset)).SetPaletteIdx(paletteIdx);
-        Renderer::RenderQuad(quad);
+        SubmitSprite(Quad::DefaultInfo(), screen_pos, screen_size, color, FrameTexCoords(idxY, idxX), texture->Handle(), paletteIdx / Quad::paletteSize);
     }
 
     void Sprite::RenderAnim(const glm::vec3& screen_pos, const glm::vec2& screen_size, int frameIdx, int spriteIdx, float paletteIdx) const {
         ASSERT_MSG(((unsigned int)frameIdx < (unsigned int)data.pts.size()), "Sprite::RenderAnim - frame index is out of bounds ({}).", frameIdx);
-        glm::ivec2 frameOffset = data.pts[frameIdx];
 
-        bool flip = false;
-        if(data.frames.enable_flip) {
-            flip = (spriteIdx > 4);
-            spriteIdx = (1-flip)*spriteIdx + int(flip)*(8-std::min(spriteIdx, 8));
-        }
-
-        glm::vec2 texOffset = glm::vec2(
-            (data.size.x + data.frames.offset.x) * (spriteIdx % data.frames.line_length) + frameOffset.x, 
-            (data.size.y + data.frames.offset.y) * (spriteIdx % data.frames.line_count) + frameOffset.y
-        );
-        Quad quad = Quad::FromCorner(screen_pos, screen_size, glm::vec4(1.f), texture, TexOffset(texOffset, flip)).SetPaletteIdx(paletteIdx);;
-        Renderer::RenderQuad(quad);
+        const FrameTable& table = Frames();
+        size_t idx = size_t(frameIdx) * ANIM_ORIENTATIONS + spriteIdx;
+        const TexCoords& tc = ((unsigned int)spriteIdx < ANIM_ORIENTATIONS && idx < table.anim.size()) ? table.anim[idx] : ComputeAnimTexCoords(frameIdx, spriteIdx);
+        SubmitSprite(Quad::DefaultInfo(), screen_pos, screen_size, glm::vec4(1.f), tc, texture->Handle(), paletteIdx / Quad::paletteSize);
     }
 
     void Sprite::RenderAnimAlt(const glm::vec4& color, bool noTexture, const glm::vec3& screen_pos, const glm::vec2& screen_size, int frameIdx, int spriteIdx, float paletteIdx) const {
@@ -68,16 +60,18 @@ namespace eng {
             (data.size.x + data.frames.offset.x + frameOffset.x) * (spriteIdx % data.frames.line_length), 
             (data.size.y + data.frames.offset.y + frameOffset.y) * (spriteIdx % data.frames.line_count)
         );
-        Quad quad = Quad::FromCorner(screen_pos, screen_size, color, texture, TexOffset(texOffset, flip)).SetPaletteIdx(paletteIdx);;
-        quad.vertices.SetAlphaFromTexture(noTexture);
-        Renderer::RenderQuad(quad);
+        SubmitSprite(Quad::DefaultInfo(), screen_pos, screen_size, color, TexOffset(texOffset, flip), texture->Handle(), paletteIdx / Quad::paletteSize, noTexture);
     }
 
     void Sprite::RenderAlt(const glm::uvec4& info, const glm::vec4& color, bool noTexture, const glm::vec3& screen_pos, const glm::vec2& screen_size, int idxY, int idxX) const {
-        glm::vec2 texOffset = glm::vec2((data.size.x + data.frames.offset.x) * (idxX % data.frames.line_length), (data.size.y + data.frames.offset.y) * (idxY % data.frames.line_count));
-        Quad quad = Quad::FromCorner(info, screen_pos, screen_size, color, texture, TexOffset(texOffset));
-        quad.vertices.SetAlphaFromTexture(noTexture);
-        Renderer::RenderQuad(quad);
+        SubmitSprite(info, screen_pos, screen_size, color, FrameTexCoords(idxY, idxX), texture->Handle(), -1.f, noTexture);
+    }
+
+    TexCoords Sprite::FrameTexCoords(int idxY, int idxX) const {
+        if(idxY < 0 || idxX < 0)
+            return ComputeFrameTexCoords(idxY, idxX);
+        const FrameTable& table = Frames();
+        return table.grid[(idxY % data.frames.line_count) * data.frames.line_length + (idxX % data.frames.line_length)];
     }
 
     void Sprite::RecomputeTexCoords() {
@@ -89,6 +83,54 @@ namespace eng {
         texCoords[1] = glm::vec2(of + glm::ivec2(   0,    0)) / tsz;
         texCoords[2] = glm::vec2(of + glm::ivec2(sz.x, sz.y)) / tsz;
         texCoords[3] = glm::vec2(of + glm::ivec2(sz.x,    0)) / tsz;
+
+        //fresh table - other copies of the sprite keep the old one (their data didn't change)
+        frames = std::make_shared<FrameTable>();
+        BakeFrames(*frames);
+    }
+
+    const Sprite::FrameTable& Sprite::Frames() const {
+        if(frames->revision != texture->Revision())
+            BakeFrames(*frames);
+        return *frames;
+    }
+
+    void Sprite::BakeFrames(FrameTable& table) const {
+        int ll = std::max(data.frames.line_length, 1);
+        int lc = std::max(data.frames.line_count, 1);
+
+        table.grid.resize(size_t(ll) * lc);
+        for(int y = 0; y < lc; y++)
+            for(int x = 0; x < ll; x++)
+                table.grid[y * ll + x] = ComputeFrameTexCoords(y, x);
+
+        table.anim.resize(data.pts.size() * ANIM_ORIENTATIONS);
+        for(int f = 0; f < (int)data.pts.size(); f++)
+            for(int o = 0; o < ANIM_ORIENTATIONS; o++)
+                table.anim[f * ANIM_ORIENTATIONS + o] = ComputeAnimTexCoords(f, o);
+
+        table.revision = texture->Revision();
+    }
+
+    TexCoords Sprite::ComputeFrameTexCoords(int idxY, int idxX) const {
+        glm::vec2 texOffset = glm::vec2((data.size.x + data.frames.offset.x) * (idxX % data.frames.line_length), (data.size.y + data.frames.offset.y) * (idxY % data.frames.line_count));
+        return TexOffset(texOffset);
+    }
+
+    TexCoords Sprite::ComputeAnimTexCoords(int frameIdx, int spriteIdx) const {
+        glm::ivec2 frameOffset = data.pts[frameIdx];
+
+        bool flip = false;
+        if(data.frames.enable_flip) {
+            flip = (spriteIdx > 4);
+            spriteIdx = (1-flip)*spriteIdx + int(flip)*(8-std::min(spriteIdx, 8));
+        }
+
+        glm::vec2 texOffset = glm::vec2(
+            (data.size.x + data.frames.offset.x) * (spriteIdx % data.frames.line_length) + frameOffset.x, 
+            (data.size.y + data.frames.offset.y) * (spriteIdx % data.frames.line_count) + frameOffset.y
+        );
+        return TexOffset(texOffset, flip);
     }
 
     void Sprite::DBG_GUI() {
@@ -106,7 +148,8 @@ namespace eng {
                 char buf[256];
                 for(int i = 0; i < (int)data.pts.size(); i++) {
                     snprintf(buf, sizeof(buf), "pt[%d]", i);
-                    ImGui::DragInt2(buf, (int*)&data.pts[i]);
+                    if(ImGui::DragInt2(buf, (int*)&data.pts[i]))
+                        RecomputeTexCoords();
                 }
             }
             ImGui::PopID();
@@ -262,7 +305,7 @@ namespace eng {
         using json = nlohmann::json;
 
         //load the config and parse it as json file
-        json config = json::parse(ReadFile(config_filepath.c_str()));
+        json config = AssetPack::LoadJSON(config_filepath);
 
         //spritesheet
         SpritesheetData data = ParseConfig_Spritesheet(config_filepath, config, flags);
@@ -275,12 +318,27 @@ namespace eng {
 
     SpritesheetData ParseConfig_Spritesheet(const std::string& name, const nlohmann::json& config, int texture_flags) {
         using json = nlohmann::json;
-        SpritesheetData data = {};
+        TextureRef texture = nullptr;
 
         try {
             //get spritesheet texture path & load the texture
             std::string texture_filepath = config.at("texture_filepath");
-            data.texture = std::make_shared<Texture>(texture_filepath, texture_flags);
+            texture = std::make_shared<Texture>(texture_filepath, texture_flags);
+        }
+        catch(json::exception& e) {
+            ENG_LOG_WARN("Failed to parse '{}' config file - {}", name.c_str(), e.what());
+            throw e;
+        }
+
+        return ParseConfig_Spritesheet(name, config, texture);
+    }
+
+    SpritesheetData ParseConfig_Spritesheet(const std::string& name, const nlohmann::json& config, const TextureRef& texture) {
+        using json = nlohmann::json;
+        SpritesheetData data = {};
+
+        try {
+            data.texture = texture;
 
             if(config.count("name"))
                 data.name = config.at("name");
@@ -341,4 +399,19 @@ namespace eng {
         return data;
     }
 
+    void SubmitSprite(const glm::uvec4& info, const glm::vec3& screen_pos, const glm::vec2& screen_size, const glm::vec4& color, const TexCoords& tc, GLuint texture, float paletteIdx, bool alphaFromTexture) {
+        if(info != Quad::DefaultInfo()) {
+            QuadVertices quad = QuadVertices::FromCorner(info, screen_pos, screen_size, color, tc);
+            quad.SetPaletteIdx(paletteIdx);
+            quad.SetAlphaFromTexture(alphaFromTexture);
+            Renderer::RenderQuad(quad, texture);
+            return;
+        }
+
+        SpriteInstance sprite = SpriteInstance::FromCorner(screen_pos, screen_size, color, tc);
+        sprite.SetPaletteIdx(paletteIdx);
+        sprite.SetAlphaFromTexture(alphaFromTexture);
+        Renderer::RenderSprite(sprite, texture);
+    }
+
 }//namespace eng
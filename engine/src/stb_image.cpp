@@ -6,70 +6,71 @@
 
 #include "engine/core/texture.h"
 #include "engine/utils/utils.h"
+#include "engine/utils/asset_pack.h"
 
 bool eng::Texture::LoadFromFile(const std::string& filepath, int flags) {
-    //use texture unit 0 for manipulation
-    glActiveTexture(GL_TEXTURE0);
-
-    bool srgb = ((flags & TextureFlags::LOAD_SRGB) != 0);
-    bool flip = ((flags & TextureFlags::VERTICAL_FLIP) != 0);
-    stbi_set_flip_vertically_on_load(flip);
-
-    //load image data
+#ifdef ENGINE_HEADLESS
+    //headless build - no GPU upload, only parse the header to get the texture dimensions
     int channels;
-    uint8_t* buf = stbi_load(filepath.c_str(), &params.width, &params.height, &channels, 0);
-    if (buf == nullptr) {
+    if(!AssetPack::ImageInfo(filepath, params.width, params.height, channels) && !stbi_info(filepath.c_str(), &params.width, &params.height, &channels)) {
         ENG_LOG_WARN("Failed to load texture from '{}'.", filepath.c_str());
         return false;
     }
+    params.internalFormat = params.format = (channels == 4) ? GL_RGBA : ((channels == 1) ? GL_RED : GL_RGB);
+    params.dtype = GL_UNSIGNED_BYTE;
+    return true;
+#else
+    bool srgb = ((flags & TextureFlags::LOAD_SRGB) != 0);
+    bool flip = ((flags & TextureFlags::VERTICAL_FLIP) != 0);
+    stbi_set_flip_vertically_on_load_thread(flip);
 
-    //generate the texture
-    glGenTextures(1, &handle);
-    glBindTexture(GL_TEXTURE_2D, handle);
-
-    //setup filtering & wrapping (based on options)
-    if (params.filtering != GL_NONE) {
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, params.filtering);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, params.filtering);
+    //load image data - pre-decoded from the asset pack or decode the file
+    int channels;
+    uint8_t* buf = nullptr;
+    AssetPack::ImageData img = {};
+    const uint8_t* pixels = nullptr;
+    if(AssetPack::ReadImage(filepath, img, flip)) {
+        params.width = img.width;
+        params.height = img.height;
+        channels = img.channels;
+        pixels = img.pixels;
     }
-    if (params.wrapping != GL_NONE) {
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, params.wrapping);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, params.wrapping);
+    else {
+        buf = stbi_load(filepath.c_str(), &params.width, &params.height, &channels, 0);
+        if (buf == nullptr) {
+            ENG_LOG_WARN("Failed to load texture from '{}'.", filepath.c_str());
+            return false;
+        }
+        pixels = buf;
     }
 
-    //resolve texture's data format
-    switch (channels) {
-        case 1:
-            params.internalFormat = params.format = GL_RED;
-            if (srgb) params.internalFormat = GL_SRGB8;
-            break;
-        default:
-        case 3:
-            params.internalFormat = params.format = GL_RGB;
-            if (srgb) params.internalFormat = GL_SRGB;
-            break;
-        case 4:
-            params.internalFormat = params.format = GL_RGBA;
-            if (srgb) params.internalFormat = GL_SRGB_ALPHA;
-            break;
-    }
-    params.dtype = GL_UNSIGNED_BYTE;
-
-    //initialize the texture
-    glTexImage2D(GL_TEXTURE_2D, 0, params.internalFormat, params.width, params.height, 0, params.format, params.dtype, buf);
-    stbi_image_free(buf);
-
-    //unbind
-    glBindTexture(GL_TEXTURE_2D, 0);
+    //generate & initialize the texture
+    Upload(pixels, channels, srgb);
+    if(buf != nullptr)
+        stbi_image_free(buf);
 
     ENG_LOG_TRACE("[R] Loaded texture from '{}' ({}x{}).", name.c_str(), params.width, params.height);
     return true;
+#endif
 }
 
 bool eng::Image::LoadFromFile(const std::string& filepath, int flags) {
     bool srgb = ((flags & TextureFlags::LOAD_SRGB) != 0);
     bool flip = ((flags & TextureFlags::VERTICAL_FLIP) != 0);
-    stbi_set_flip_vertically_on_load(flip);
+    //thread local setting - images can be decoded on worker threads
+    stbi_set_flip_vertically_on_load_thread(flip);
+
+    //pre-decoded image from the asset pack
+    AssetPack::ImageData img = {};
+    if(AssetPack::ReadImage(filepath, img, flip)) {
+        width = img.width;
+        height = img.height;
+        channels = img.channels;
+        data = new uint8_t[width * height * channels];
+        memcpy(data, img.pixels, sizeof(uint8_t) * width * height * channels);
+        ENG_LOG_TRACE("[R] Loaded image from '{}' ({}x{}, asset pack).", name.c_str(), width, height);
+        return true;
+    }
 
     //load image data
     uint8_t* buf = stbi_load(filepath.c_str(), &width, &height, &channels, 0);
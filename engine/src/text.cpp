@@ -5,11 +5,81 @@
 #include "engine/core/window.h"
 #include "engine/utils/utils.h"
 
+#include "engine/utils/compression.h"
+#include "engine/utils/timer.h"
+
 #include <ft2build.h>
 #include FT_FREETYPE_H
 
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <unordered_map>
+
+#define SDF_BASE_HEIGHT 64                  //glyphs are rasterized once at this height, other sizes are scaled in the shader
+#define SDF_SPREAD 8                        //distance field range (in base height pixels), also the padding around each glyph
+
+#define FONT_CACHE_DIR "res/generated"
+#define FONT_CACHE_MAGIC "TSDF"
+#define FONT_CACHE_VERSION 1                //bump whenever the atlas generation changes
+
 namespace eng {
 
+    constexpr int CHAR_START = 32;
+    constexpr int CHAR_END = 128;
+
+    //Glyph metrics at the base height (without the padding).
+    struct GlyphMetrics {
+        glm::ivec2 size = glm::ivec2(0);
+        glm::ivec2 bearing = glm::ivec2(0);
+        int advance = 0;
+        int atlasX = 0;
+    };
+
+    //===== FontAtlas =====
+
+    //Signed distance field atlas of a single font file (all the glyphs in 1 row, edge at 0.5).
+    struct FontAtlas {
+        GlyphMetrics glyphs[128] = {};
+        glm::ivec2 size = glm::ivec2(0);
+        std::vector<uint8_t> pixels;        //only kept until the upload
+        TextureRef texture = nullptr;
+    };
+
+    struct FontCacheHeader {
+        char magic[4];
+        uint32_t version;
+        uint64_t font_hash;
+        int32_t base_height;
+        int32_t spread;
+        int32_t width;
+        int32_t height;
+        uint32_t stored_size;
+    };
+
+    static int layout_rebuilds = 0;
+    static bool layout_caching = true;
+
+    //atlases of the currently existing fonts, by filepath
+    static std::unordered_map<std::string, std::weak_ptr<FontAtlas>> atlas_cache;
+
+    //Returns atlas for given font file - already existing one, from the disk cache or freshly generated.
+    FontAtlasRef AcquireAtlas(const std::string& filepath, const std::string& name);
+    bool GenerateAtlas(const std::string& font_data, FontAtlas& atlas);
+
+    //Distance field of a glyph bitmap, padded by spread on each side.
+    std::vector<uint8_t> DistanceField(const uint8_t* bitmap, int width, int height, int pitch, int spread);
+    void DistanceTransform(std::vector<float>& grid, int width, int height);
+    void DistanceTransform_1D(const float* f, float* d, int* v, float* z, int n);
+
+    std::string AtlasCache_Path(const std::string& name);
+    bool AtlasCache_Load(const std::string& name, uint64_t font_hash, FontAtlas& atlas);
+    bool AtlasCache_Store(const std::string& name, uint64_t font_hash, const FontAtlas& atlas);
+
+    //===== Font =====
+
     Font::Font(const std::string& filepath_, int fontHeight_) : fontHeight(fontHeight_), name(GetFilename(filepath_)), filepath(filepath_) {
         Load(filepath);
         ENG_LOG_TRACE("[C] Font '{}' (height = {})", name.c_str(), fontHeight);
@@ -294,108 +364,439 @@ namespace eng {
     void Font::Resize(int newHeight) {
         if(fontHeight != newHeight) {
             fontHeight = newHeight;
-            Load(filepath);
+            Rescale();
         }
     }
 
     void Font::Load(const std::string& filepath) {
+        atlas = AcquireAtlas(filepath, name);
+        texture = atlas->texture;
+        atlasSize_inv = 1.f / glm::vec2(atlas->size);
+        Rescale();
+    }
+
+    void Font::Rescale() {
+        float k = float(fontHeight) / SDF_BASE_HEIGHT;
+        float pad = float(SDF_SPREAD);
+
+        rowHeight = 0;
+        for(int c = CHAR_START; c < CHAR_END; c++) {
+            const GlyphMetrics& g = atlas->glyphs[c];
+            CharInfo& ch = chars[c];
+
+            ch.advance = glm::ivec2(int(std::round(g.advance * k)), 0);
+            ch.textureOffset = float(g.atlasX);
+            if(g.size.x > 0 && g.size.y > 0) {
+                //quad covers the padding as well (distance field fades out there)
+                ch.size = (glm::vec2(g.size) + 2.f*pad) * k;
+                ch.bearing = glm::vec2(g.bearing.x - pad, g.bearing.y + pad) * k;
+                ch.textureSize = glm::vec2(g.size) + 2.f*pad;
+            }
+            else {
+                ch.size = glm::vec2(0.f);
+                ch.bearing = glm::vec2(g.bearing) * k;
+                ch.textureSize = glm::vec2(0.f);
+            }
+
+            rowHeight = std::max(rowHeight, int(std::round(g.bearing.y * k)));
+        }
+
+        revision++;
+    }
+
+    void Font::Release() noexcept {
+        if(texture != nullptr) {
+            texture = nullptr;
+            atlas = nullptr;
+            ENG_LOG_TRACE("[D] Font '{}' (height = {})", name.c_str(), fontHeight);
+        }
+    }
+
+    void Font::Move(Font&& f) noexcept {
+        texture = std::move(f.texture);
+        atlas = std::move(f.atlas);
+        name = std::move(f.name);
+        filepath = std::move(f.filepath);
+        atlasSize_inv = f.atlasSize_inv;
+        fontHeight = f.fontHeight;
+        rowHeight = f.rowHeight;
+        revision = f.revision;
+        memcpy(chars, f.chars, sizeof(chars));
+
+        f.texture = nullptr;
+    }
+
+    //===== TextLayout =====
+
+    void TextLayout::Update(const FontRef& font_, const std::string& text_, float scale_, int align_, size_t sep_pos_) {
+        glm::ivec2 ws = Window::Get().Size();
+        int rev = (font_ != nullptr) ? font_->Revision() : -1;
+
+        if(layout_caching && valid && font == font_ && scale == scale_ && align == align_ && sep_pos == sep_pos_ && windowSize == ws && fontRevision == rev && text == text_)
+            return;
+
+        font = font_;
+        text = text_;
+        scale = scale_;
+        align = align_;
+        sep_pos = std::min(sep_pos_, text.size());
+        windowSize = ws;
+        fontRevision = rev;
+        valid = true;
+
+        Rebuild();
+        layout_rebuilds++;
+    }
+
+    void TextLayout::Render(const glm::vec2& anchor, const glm::vec4& color, float zIndex, const glm::uvec4& info) const {
+        Render(anchor, color, color, glm::ivec2(-1), zIndex, info);
+    }
+
+    void TextLayout::Render(const glm::vec2& anchor, const glm::vec4& color1, const glm::vec4& color2, const glm::ivec2& highlightRange, float zIndex, const glm::uvec4& info) const {
+        if(font == nullptr || glyphs.empty())
+            return;
+
+        GLuint texture = font->GetTexture()->Handle();
+        glm::vec3 origin = glm::vec3(anchor, zIndex);
+
+        for(const Glyph& g : glyphs) {
+            bool highlight = (g.idx >= 0 && g.idx >= highlightRange.x && g.idx < highlightRange.y);
+            QuadVertices quad = QuadVertices::FromCorner(info, origin + glm::vec3(g.botLeft, 0.f), g.size, highlight ? color2 : color1, g.tc);
+            quad.SetDistanceField(true);
+            Renderer::RenderQuad(quad, texture);
+        }
+    }
+
+    int TextLayout::RebuildCount() {
+        return layout_rebuilds;
+    }
+
+    void TextLayout::SetCaching(bool enabled) {
+        layout_caching = enabled;
+    }
+
+    bool TextLayout::Caching() {
+        return layout_caching;
+    }
+
+    void TextLayout::Rebuild() {
+        glyphs.clear();
+        if(font == nullptr)
+            return;
+
+        const Font& f = *font;
+        glm::vec2 wsize = glm::vec2(windowSize);
+        glm::vec2 size_mult = scale / wsize;
+        glm::vec2 atlasSize_inv = f.AtlasSize_Inv();
+
+        //same metrics as in the Font::RenderText* variants (including the integer truncation)
+        int width = 0;
+        int height = 0;
+        int keyWidth = 0;
+        for(size_t i = 0; i < text.size(); i++) {
+            const CharInfo& ch = f[text[i]];
+
+            int charHeight = ch.advance.x * scale;
+            height = std::max(charHeight, height);
+            width += ch.advance.x * scale;
+
+            if(i < sep_pos)
+                keyWidth += ch.advance.x * scale;
+        }
+
+        glm::vec2 pos = glm::vec2(0.f);
+        switch(align) {
+            case TextAlign::Centered:   pos = -glm::vec2(width / 2, height / 2) / wsize; break;
+            case TextAlign::Left:       pos = -glm::vec2(0.f, height / 2) / wsize; break;
+            case TextAlign::KeyValue:   pos = -glm::vec2(keyWidth, height / 2) / wsize; break;
+        }
+
+        glyphs.reserve(text.size());
+        for(size_t i = 0; i < text.size(); i++) {
+            int idx = int(i);
+            if(align == TextAlign::KeyValue) {
+                //value part starts at the anchor
+                if(i == sep_pos)
+                    pos = -glm::vec2(0.f, height / 2) / wsize;
+                idx = (i < sep_pos) ? -1 : int(i - sep_pos);
+            }
+
+            const CharInfo& ch = f[text[i]];
+
+            //whitespace - nothing to render
+            if(ch.size.x != 0 && ch.size.y != 0) {
+                float tx = ch.textureOffset;
+                float ow = ch.textureSize.x;
+                float oh = ch.textureSize.y;
+
+                Glyph g = {};
+                g.botLeft = glm::vec2(pos.x + ch.bearing.x * size_mult.x, pos.y - (ch.size.y - ch.bearing.y) * size_mult.y);
+                g.size = ch.size * size_mult;
+                g.tc = TexCoords(
+                    glm::vec2(tx   , oh ) * atlasSize_inv,
+                    glm::vec2(tx   , 0.f) * atlasSize_inv,
+                    glm::vec2(tx+ow, oh ) * atlasSize_inv,
+                    glm::vec2(tx+ow, 0.f) * atlasSize_inv
+                );
+                g.idx = idx;
+                glyphs.push_back(g);
+            }
+
+            pos += glm::vec2(ch.advance) * size_mult;
+        }
+    }
+
+    //====================================================================
+
+    FontAtlasRef AcquireAtlas(const std::string& filepath, const std::string& name) {
+        auto it = atlas_cache.find(filepath);
+        if(it != atlas_cache.end()) {
+            FontAtlasRef atlas = it->second.lock();
+            if(atlas != nullptr)
+                return atlas;
+        }
+
+        Timer t = {};
+        std::string font_data;
+        if(!TryReadFile(filepath.c_str(), font_data)) {
+            ENG_LOG_ERROR("Font - Failed to read '{}'.", filepath);
+            throw std::exception();
+        }
+
+        //FNV-1a of the font file - atlas cache key
+        uint64_t font_hash = 14695981039346656037ULL;
+        for(char c : font_data) {
+            font_hash ^= uint8_t(c);
+            font_hash *= 1099511628211ULL;
+        }
+
+        FontAtlasRef atlas = std::make_shared<FontAtlas>();
+        bool cached = AtlasCache_Load(name, font_hash, *atlas);
+        if(!cached) {
+            if(!GenerateAtlas(font_data, *atlas))
+                throw std::exception();
+            if(!AtlasCache_Store(name, font_hash, *atlas))
+                ENG_LOG_DEBUG("Font - Failed to store the atlas of '{}' in the disk cache.", name);
+        }
+
+#ifndef ENGINE_HEADLESS
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+#endif
+        atlas->texture = std::make_shared<Texture>(TextureParams::CustomData(atlas->size.x, atlas->size.y, GL_RED, GL_RED, GL_UNSIGNED_BYTE), atlas->pixels.data(), std::string("atlas_") + name);
+        atlas->pixels = {};
+
+        ENG_LOG_TRACE("[C] FontAtlas '{}' ({}x{}, {}, {:.1f}ms)", name, atlas->size.x, atlas->size.y, cached ? "disk cache" : "generated", t.TimeElapsed() * 1e-3f);
+        atlas_cache[filepath] = atlas;
+        return atlas;
+    }
+
+    bool GenerateAtlas(const std::string& font_data, FontAtlas& atlas) {
         FT_Library ft;
-	    FT_Face face;
+        FT_Face face;
 
         //library initialization
         if (FT_Init_FreeType(&ft)) {
             ENG_LOG_ERROR("FreeType - Initialization failed.");
-            throw std::exception();
+            return false;
         }
 
         //load font data
-        if (FT_New_Face(ft, filepath.c_str(), 0, &face)) {
+        if (FT_New_Memory_Face(ft, (const FT_Byte*)font_data.data(), FT_Long(font_data.size()), 0, &face)) {
             ENG_LOG_ERROR("FreeType - Font failed to load.");
-            throw std::exception();
+            FT_Done_FreeType(ft);
+            return false;
         }
 
         //set font size
-	    FT_Set_Pixel_Sizes(face, 0, fontHeight);
-
-        unsigned int atlasWidth = 0;
-        unsigned int atlasHeight = 0;
-
-        unsigned char char_start = 32;
-        unsigned char char_end = 128;
+        FT_Set_Pixel_Sizes(face, 0, SDF_BASE_HEIGHT);
         FT_GlyphSlot g = face->glyph;
 
-        //compute texture atlas dimensions (all glyphs will be in 1 row)
-        for (unsigned char c = char_start; c < char_end; c++) {
+        //rasterize each glyph & convert it into a distance field (padded by the spread)
+        std::vector<std::vector<uint8_t>> fields(CHAR_END);
+        int x = 0;
+        int height = 1;
+        for (int c = CHAR_START; c < CHAR_END; c++) {
             if (FT_Load_Char(face, c, FT_LOAD_RENDER)) {
                 ENG_LOG_DEBUG("FreeType - Glyph '{}' failed to load.", c);
                 continue;
             }
 
-            atlasWidth += g->bitmap.width;
-            atlasHeight = std::max(atlasHeight, face->glyph->bitmap.rows);
-        }
-
-        //initialize atlas
-        texture = std::make_shared<Texture>(TextureParams::EmptyTexture(atlasWidth, atlasHeight, GL_RED), std::string("atlas_") + name);
-        texture->Bind(0);
-        atlasSize_inv = glm::vec2(1.f / atlasWidth, 1.f / atlasHeight);
+            GlyphMetrics& gm = atlas.glyphs[c];
+            gm.size = glm::ivec2(g->bitmap.width, g->bitmap.rows);
+            gm.bearing = glm::ivec2(g->bitmap_left, g->bitmap_top);
+            gm.advance = int(g->advance.x >> 6);
+            gm.atlasX = x;
 
-        //zero the texture out to get rid of the noise - not sure if required or not
-        uint8_t* data = new uint8_t[atlasWidth * atlasHeight];
-        for(int i = 0; i < atlasWidth * atlasHeight; i++) data[i] = 0;
-        glTexImage2D(GL_TEXTURE_2D, 0, GL_RED, atlasWidth, atlasHeight, 0, GL_RED, GL_UNSIGNED_BYTE, data);
-        delete[] data;
+            if(gm.size.x > 0 && gm.size.y > 0) {
+                fields[c] = DistanceField(g->bitmap.buffer, gm.size.x, gm.size.y, g->bitmap.pitch, SDF_SPREAD);
+                x += gm.size.x + 2*SDF_SPREAD;
+                height = std::max(height, gm.size.y + 2*SDF_SPREAD);
+            }
+        }
 
-        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+        //library cleanup
+        FT_Done_Face(face);
+        FT_Done_FreeType(ft);
 
+        atlas.size = glm::ivec2(std::max(x, 1), height);
+        atlas.pixels.assign(size_t(atlas.size.x) * atlas.size.y, 0);
+        for (int c = CHAR_START; c < CHAR_END; c++) {
+            if(fields[c].empty())
+                continue;
+            const GlyphMetrics& gm = atlas.glyphs[c];
+            int w = gm.size.x + 2*SDF_SPREAD;
+            int h = gm.size.y + 2*SDF_SPREAD;
+            for(int y = 0; y < h; y++)
+                memcpy(atlas.pixels.data() + size_t(y) * atlas.size.x + gm.atlasX, fields[c].data() + size_t(y) * w, w);
+        }
 
-        rowHeight = 0;
+        return true;
+    }
 
-        //load each glyph into the texture
-        int x = 0;
-        for (unsigned char c = char_start; c < char_end; c++) {
-            if (FT_Load_Char(face, c, FT_LOAD_RENDER)) {
-                continue;
+    std::vector<uint8_t> DistanceField(const uint8_t* bitmap, int width, int height, int pitch, int spread) {
+        const float INF = 1e20f;
+        int W = width + 2*spread;
+        int H = height + 2*spread;
+
+        //squared distances to the nearest inside (outside grid) and outside (inside grid) pixel
+        std::vector<float> outside(size_t(W) * H);
+        std::vector<float> inside(size_t(W) * H);
+        for(int y = 0; y < H; y++) {
+            for(int x = 0; x < W; x++) {
+                int bx = x - spread;
+                int by = y - spread;
+                bool in = (bx >= 0 && bx < width && by >= 0 && by < height && bitmap[by * pitch + bx] >= 128);
+                outside[y*W + x] = in ? 0.f : INF;
+                inside[y*W + x] = in ? INF : 0.f;
             }
+        }
+        DistanceTransform(outside, W, H);
+        DistanceTransform(inside, W, H);
+
+        //signed distance (positive inside, edge between the pixels) mapped to <0,1>, 0.5 = edge
+        std::vector<uint8_t> field(size_t(W) * H);
+        for(size_t i = 0; i < field.size(); i++) {
+            bool in = (outside[i] == 0.f);
+            float d = in ? (std::sqrt(inside[i]) - 0.5f) : -(std::sqrt(outside[i]) - 0.5f);
+            float v = std::clamp(0.5f + d / (2.f * spread), 0.f, 1.f);
+            field[i] = uint8_t(v * 255.f + 0.5f);
+        }
+        return field;
+    }
 
-            glTexSubImage2D(GL_TEXTURE_2D, 0, x, 0, g->bitmap.width, g->bitmap.rows, GL_RED, GL_UNSIGNED_BYTE, g->bitmap.buffer);
-
-            chars[c] = CharInfo{
-                glm::ivec2(g->bitmap.width, g->bitmap.rows),
-                glm::ivec2(g->bitmap_left, g->bitmap_top),
-                glm::ivec2(g->advance.x >> 6, g->advance.y >> 6),
-                float(x)
-            };
+    void DistanceTransform(std::vector<float>& grid, int width, int height) {
+        int n = std::max(width, height);
+        std::vector<float> f(n), d(n), z(n+1);
+        std::vector<int> v(n);
+
+        //columns
+        for(int x = 0; x < width; x++) {
+            for(int y = 0; y < height; y++)
+                f[y] = grid[y*width + x];
+            DistanceTransform_1D(f.data(), d.data(), v.data(), z.data(), height);
+            for(int y = 0; y < height; y++)
+                grid[y*width + x] = d[y];
+        }
 
-            rowHeight = std::max(rowHeight, chars[c].bearing.y);
+        //rows
+        for(int y = 0; y < height; y++) {
+            DistanceTransform_1D(&grid[y*width], d.data(), v.data(), z.data(), width);
+            memcpy(&grid[y*width], d.data(), sizeof(float) * width);
+        }
+    }
 
-            x += g->bitmap.width;
+    //Squared euclidean distance transform of a sampled function (Felzenszwalb & Huttenlocher, lower envelope of parabolas).
+    void DistanceTransform_1D(const float* f, float* d, int* v, float* z, int n) {
+        const float INF = 1e20f;
+        int k = 0;
+        v[0] = 0;
+        z[0] = -INF;
+        z[1] = INF;
+        for(int q = 1; q < n; q++) {
+            float s = ((f[q] + q*q) - (f[v[k]] + v[k]*v[k])) / (2*q - 2*v[k]);
+            while(s <= z[k]) {
+                k--;
+                s = ((f[q] + q*q) - (f[v[k]] + v[k]*v[k])) / (2*q - 2*v[k]);
+            }
+            k++;
+            v[k] = q;
+            z[k] = s;
+            z[k+1] = INF;
         }
 
-        // glPixelStorei(GL_UNPACK_ALIGNMENT, 0);
-        Texture::Unbind(0);
+        k = 0;
+        for(int q = 0; q < n; q++) {
+            while(z[k+1] < q)
+                k++;
+            d[q] = (q - v[k])*(q - v[k]) + f[v[k]];
+        }
+    }
 
-        //library cleanup
-        FT_Done_Face(face);
-        FT_Done_FreeType(ft);
+    std::string AtlasCache_Path(const std::string& name) {
+        return std::string(FONT_CACHE_DIR "/") + name + ".sdf";
     }
 
-    void Font::Release() noexcept {
-        if(texture != nullptr) {
-            texture = nullptr;
-            ENG_LOG_TRACE("[D] Font '{}' (height = {})", name.c_str(), fontHeight);
+    bool AtlasCache_Load(const std::string& name, uint64_t font_hash, FontAtlas& atlas) {
+        std::ifstream file = std::ifstream(AtlasCache_Path(name), std::ios::binary);
+        if(!file.is_open())
+            return false;
+
+        //stale files (different font file or generation parameters) are simply regenerated
+        FontCacheHeader header = {};
+        if(!file.read((char*)&header, sizeof(header)) || memcmp(header.magic, FONT_CACHE_MAGIC, 4) != 0 || header.version != FONT_CACHE_VERSION || header.font_hash != font_hash)
+            return false;
+        if(header.base_height != SDF_BASE_HEIGHT || header.spread != SDF_SPREAD || header.width <= 0 || header.height <= 0)
+            return false;
+
+        std::vector<uint8_t> stored(header.stored_size);
+        if(!file.read((char*)atlas.glyphs, sizeof(atlas.glyphs)) || !file.read((char*)stored.data(), stored.size()))
+            return false;
+
+        atlas.size = glm::ivec2(header.width, header.height);
+        atlas.pixels.resize(size_t(header.width) * header.height);
+        if(!LZ::Decompress(stored.data(), stored.size(), atlas.pixels.data(), atlas.pixels.size())) {
+            ENG_LOG_DEBUG("Font - corrupted cache file '{}'.", AtlasCache_Path(name));
+            atlas = FontAtlas();
+            return false;
         }
+        return true;
     }
 
-    void Font::Move(Font&& f) noexcept {
-        texture = std::move(f.texture);
-        name = std::move(f.name);
-        filepath = std::move(f.filepath);
-        atlasSize_inv = f.atlasSize_inv;
-        fontHeight = f.fontHeight;
-        memcpy(chars, f.chars, sizeof(chars));
-
-        f.texture = nullptr;
+    bool AtlasCache_Store(const std::string& name, uint64_t font_hash, const FontAtlas& atlas) {
+        std::error_code ec;
+        std::filesystem::create_directories(FONT_CACHE_DIR, ec);
+
+        std::vector<uint8_t> stored = LZ::Compress(atlas.pixels.data(), atlas.pixels.size());
+
+        FontCacheHeader header = {};
+        memcpy(header.magic, FONT_CACHE_MAGIC, 4);
+        header.version = FONT_CACHE_VERSION;
+        header.font_hash = font_hash;
+        header.base_height = SDF_BASE_HEIGHT;
+        header.spread = SDF_SPREAD;
+        header.width = atlas.size.x;
+        header.height = atlas.size.y;
+        header.stored_size = uint32_t(stored.size());
+
+        std::string filepath = AtlasCache_Path(name);
+        std::string tmp_filepath = filepath + ".tmp";
+        {
+            std::ofstream file = std::ofstream(tmp_filepath, std::ios::binary);
+            file.write((const char*)&header, sizeof(header));
+            file.write((const char*)atlas.glyphs, sizeof(atlas.glyphs));
+            file.write((const char*)stored.data(), stored.size());
+            if(!file) {
+                file.close();
+                std::filesystem::remove(tmp_filepath, ec);
+                return false;
+            }
+        }
+        std::filesystem::rename(tmp_filepath, filepath, ec);
+        if(ec) {
+            std::filesystem::remove(tmp_filepath, ec);
+            return false;
+        }
+        return true;
     }
 
 }//namespace eng
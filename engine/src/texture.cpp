@@ -37,7 +37,9 @@ namespace eng {
     Texture::TextureHandle::~TextureHandle() {
         if(handle != 0) {
             ENG_LOG_TRACE("[D] TextureHandle ({})", handle);
+#ifndef ENGINE_HEADLESS
             glDeleteTextures(1, &handle);
+#endif
             handle = 0;
             counter--;
         }
@@ -54,12 +56,37 @@ namespace eng {
         ENG_LOG_TRACE("[C] Texture '{}' ({})", name.c_str(), handle);
     }
 
+    Texture::Texture(const std::string& filepath, const Image& image, int flags, const TextureParams& params_) : name(GetFilename(filepath)), params(params_) {
+        if(image.Empty()) {
+            ENG_LOG_DEBUG("Texture - Failed to create '{}', image has no data.", filepath.c_str());
+            throw std::exception();
+        }
+        params.width = image.Width();
+        params.height = image.Height();
+        Upload(image.ptr(), image.Channels(), (flags & TextureFlags::LOAD_SRGB) != 0);
+
+        Merge_UpdateData(std::make_shared<TextureHandle>(handle), glm::ivec2(0), glm::vec2(params.width, params.height));
+        ENG_LOG_TRACE("[R] Created texture '{}' from decoded image ({}x{}).", name.c_str(), params.width, params.height);
+        ENG_LOG_TRACE("[C] Texture '{}' ({})", name.c_str(), handle);
+    }
+
     Texture::Texture(const TextureParams& params, const std::string& name) : Texture(TextureParams::EmptyTexture(params), nullptr, name) {}
 
+    Texture::Texture(const std::string& filepath, const glm::ivec2& size) : name(GetFilename(filepath)) {
+        params.width = size.x;
+        params.height = size.y;
+        params.internalFormat = params.format = GL_RGBA;
+        params.dtype = GL_UNSIGNED_BYTE;
+        merge_offset = glm::ivec2(0);
+        merge_size = glm::vec2(size);
+        ENG_LOG_TRACE("[C] Texture '{}' (no storage, {}x{})", name.c_str(), params.width, params.height);
+    }
+
     Texture::Texture(const TextureParams& params_, void* data, const std::string& name_)
         : params(params_) {
         name = name_;
 
+#ifndef ENGINE_HEADLESS
         glActiveTexture(GL_TEXTURE0);
         glGenTextures(1, &handle);
         glBindTexture(GL_TEXTURE_2D, handle);
@@ -78,6 +105,7 @@ namespace eng {
         glTexImage2D(GL_TEXTURE_2D, 0, params.internalFormat, params.width, params.height, 0, params.format, params.dtype, data);
 
         glBindTexture(GL_TEXTURE_2D, 0);
+#endif
 
         Merge_UpdateData(std::make_shared<TextureHandle>(handle), glm::ivec2(0), glm::vec2(params.width, params.height));
 
@@ -112,21 +140,72 @@ namespace eng {
     }
 
     void Texture::Bind(int slot, GLuint handle) {
+#ifndef ENGINE_HEADLESS
         ASSERT_MSG(handle != 0, "Attempting to use uninitialized texture.");
         glActiveTexture(GL_TEXTURE0 + slot);
         glBindTexture(GL_TEXTURE_2D, handle);
+#endif
     }
 
     void Texture::Unbind(int slot) {
+#ifndef ENGINE_HEADLESS
         glActiveTexture(GL_TEXTURE0 + slot);
         glBindTexture(GL_TEXTURE_2D, 0);
+#endif
     }
 
     void Texture::UpdateData(void* data) {
+#ifndef ENGINE_HEADLESS
         Bind(0);
         glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, params.width, params.height, params.format, params.dtype, data);
         // ENG_LOG_TRACE("[R] Texture data update '{}' ({}x{}).", name.c_str(), params.width, params.height);
         Unbind(0);
+#endif
+    }
+
+    void Texture::Upload(const uint8_t* pixels, int channels, bool srgb) {
+        //resolve texture's data format
+        switch (channels) {
+            case 1:
+                params.internalFormat = params.format = GL_RED;
+                if (srgb) params.internalFormat = GL_SRGB8;
+                break;
+            default:
+            case 3:
+                params.internalFormat = params.format = GL_RGB;
+                if (srgb) params.internalFormat = GL_SRGB;
+                break;
+            case 4:
+                params.internalFormat = params.format = GL_RGBA;
+                if (srgb) params.internalFormat = GL_SRGB_ALPHA;
+                break;
+        }
+        params.dtype = GL_UNSIGNED_BYTE;
+
+#ifndef ENGINE_HEADLESS
+        //use texture unit 0 for manipulation
+        glActiveTexture(GL_TEXTURE0);
+
+        //generate the texture
+        glGenTextures(1, &handle);
+        glBindTexture(GL_TEXTURE_2D, handle);
+
+        //setup filtering & wrapping (based on options)
+        if (params.filtering != GL_NONE) {
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, params.filtering);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, params.filtering);
+        }
+        if (params.wrapping != GL_NONE) {
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, params.wrapping);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, params.wrapping);
+        }
+
+        //initialize the texture
+        glTexImage2D(GL_TEXTURE_2D, 0, params.internalFormat, params.width, params.height, 0, params.format, params.dtype, pixels);
+
+        //unbind
+        glBindTexture(GL_TEXTURE_2D, 0);
+#endif
     }
 
     void Texture::Merge_UpdateData(TextureHandleRef new_handle, const glm::ivec2& offset, const glm::vec2& size) {
@@ -134,10 +213,13 @@ namespace eng {
         handle = new_handle->handle;
         merge_offset = offset;
         merge_size = size;
+        revision++;
     }
 
     void Texture::Merge_CopyTo(const TextureRef& other, const glm::ivec2& offset) {
+#ifndef ENGINE_HEADLESS
         glCopyImageSubData(handle, GL_TEXTURE_2D, 0, merge_offset.x, merge_offset.y, 0, other->handle, GL_TEXTURE_2D, 0, offset.x, offset.y, 0, params.width, params.height, 1);
+#endif
     }
 
     TexCoords Texture::GetTexCoords() const {
@@ -215,6 +297,7 @@ namespace eng {
         name = std::move(t.name);
         merge_offset = t.merge_offset;
         merge_size = t.merge_size;
+        revision = std::max(revision, t.revision) + 1;
         t.handle = 0;
         t.handle_data = nullptr;
     }
@@ -1,8 +1,15 @@
 #include "engine/core/texture.h"
 #include "engine/core/renderer.h"
 #include "engine/utils/timer.h"
+#include "engine/utils/utils.h"
 
 #include <rectpack2D/rectpack2D.h>
+#include <nlohmann/json.hpp>
+
+#include <fstream>
+
+#define ATLAS_CACHE_PATH "res/atlas_layout.cache"
+#define ATLAS_CACHE_CAPACITY 8
 
 namespace eng {
 
@@ -15,35 +22,113 @@ namespace eng {
     using spaces_type = r2d::empty_spaces<allow_flip, r2d::default_empty_spaces>;
     using rect_type = r2d::output_rect_t<spaces_type>;
 
-    r2d::rect_wh BinPacking(std::vector<rect_type>& rectangles) {
-        int max_side = Renderer::MaxTextureSize();
+    r2d::rect_wh BinPacking(std::vector<rect_type>& rectangles, int max_side, bool& out_success);
 
-        auto report_successful = [](rect_type&) { return r2d::callback_result::CONTINUE_PACKING; };
-        auto report_unsuccessful = [](rect_type&) { return r2d::callback_result::ABORT_PACKING; };
+    nlohmann::json AtlasLayout_ToJSON(const AtlasLayout& layout);
+    bool AtlasLayout_FromJSON(const nlohmann::json& config, AtlasLayout& out_layout);
 
-        auto report_result = [&rectangles](const r2d::rect_wh& result_size) {
-            // ENG_LOG_FINER("Resultant bin: {} {}", result_size.w, result_size.h);
-            for (const auto& r : rectangles) {
-                // ENG_LOG_FINER("{} {} {} {}", r.x, r.y, r.w, r.h);
+    nlohmann::json AtlasCache_Read();
+
+    //===== AtlasLayout =====
+
+    uint64_t AtlasLayout::InputsHash(const std::vector<std::string>& names, const std::vector<glm::ivec2>& sizes) {
+        //FNV-1a, over the names & sizes in the merge order (the order matters for the offsets)
+        uint64_t hash = 14695981039346656037ULL;
+        auto mix = [&hash](const void* data, size_t size) {
+            const uint8_t* bytes = (const uint8_t*)data;
+            for(size_t i = 0; i < size; i++) {
+                hash ^= bytes[i];
+                hash *= 1099511628211ULL;
             }
         };
 
-        const auto result_size = r2d::find_best_packing<spaces_type>(
-			rectangles,
-			r2d::make_finder_input(
-				max_side,
-				discard_step,
-				report_successful,
-				report_unsuccessful,
-				runtime_flipping_mode
-			)
-		);
+        for(size_t i = 0; i < names.size(); i++) {
+            mix(names[i].c_str(), names[i].size() + 1);
+            int32_t wh[2] = { 0, 0 };
+            if(i < sizes.size()) {
+                wh[0] = int32_t(sizes[i].x);
+                wh[1] = int32_t(sizes[i].y);
+            }
+            mix(wh, sizeof(wh));
+        }
+        return hash;
+    }
 
-		report_result(result_size);
-        return result_size;
+    bool AtlasLayout::Compute(const std::vector<glm::ivec2>& sizes, int max_side, AtlasLayout& out_layout) {
+        std::vector<rect_type> rectangles = {};
+        for(const glm::ivec2& size : sizes) {
+            rectangles.push_back(r2d::rect_xywh(0, 0, size.x, size.y));
+        }
+
+        bool success = true;
+        auto size = BinPacking(rectangles, max_side, success);
+        if(!success) {
+            ENG_LOG_WARN("AtlasLayout::Compute - textures don't fit into a single {}x{} atlas.", max_side, max_side);
+            return false;
+        }
+
+        out_layout.max_side = max_side;
+        out_layout.size = glm::ivec2(size.w, size.h);
+        out_layout.offsets.clear();
+        for(const rect_type& r : rectangles) {
+            out_layout.offsets.push_back(glm::ivec2(r.x, r.y));
+        }
+        return true;
     }
 
+    bool AtlasLayout::LoadCached(uint64_t inputs_hash, int max_side, AtlasLayout& out_layout) {
+        nlohmann::json cache = AtlasCache_Read();
+        for(const nlohmann::json& entry : cache) {
+            AtlasLayout layout = {};
+            if(AtlasLayout_FromJSON(entry, layout) && layout.inputs_hash == inputs_hash && layout.max_side == max_side) {
+                out_layout = std::move(layout);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool AtlasLayout::StoreCached() const {
+        //most recent layout goes first, same inputs are replaced & the oldest entries dropped
+        nlohmann::json cache = nlohmann::json::array();
+        cache.push_back(AtlasLayout_ToJSON(*this));
+        for(const nlohmann::json& entry : AtlasCache_Read()) {
+            AtlasLayout layout = {};
+            if(cache.size() >= ATLAS_CACHE_CAPACITY)
+                break;
+            if(AtlasLayout_FromJSON(entry, layout) && !(layout.inputs_hash == inputs_hash && layout.max_side == max_side))
+                cache.push_back(entry);
+        }
+
+        std::ofstream file = std::ofstream(CachePath());
+        if(!file.is_open()) {
+            ENG_LOG_DEBUG("AtlasLayout::StoreCached - failed to open '{}'.", CachePath());
+            return false;
+        }
+        file << cache.dump();
+        return file.good();
+    }
+
+    std::string AtlasLayout::CachePath() {
+        return ATLAS_CACHE_PATH;
+    }
+
+    std::string AtlasLayout::Serialize() const {
+        return AtlasLayout_ToJSON(*this).dump();
+    }
+
+    bool AtlasLayout::Deserialize(const std::string& text, AtlasLayout& out_layout) {
+        nlohmann::json config = nlohmann::json::parse(text, nullptr, false);
+        return AtlasLayout_FromJSON(config, out_layout);
+    }
+
+    //===== Texture merging =====
+
     void Texture::MergeTextures(std::vector<TextureRef>& textures, GLenum filteringMode, bool rgba) {
+#ifdef ENGINE_HEADLESS
+        //nothing to merge without GPU textures (and the max texture size is unknown)
+        return;
+#endif
         Timer t1, t2;
 
         //TODO: case where the algorithm fails is not handled (should split into more than 1 texture)
@@ -51,24 +136,36 @@ namespace eng {
         t1.Reset();
         t2.Reset();
 
-        std::vector<rect_type> rectangles = {};
+        std::vector<std::string> names = {};
+        std::vector<glm::ivec2> sizes = {};
         for(TextureRef& tex : textures) {
-            rectangles.push_back(r2d::rect_xywh(0, 0, tex->Width(), tex->Height()));
+            names.push_back(tex->Name());
+            sizes.push_back(tex->Size());
         }
-        auto time_packing = t2.TimeElapsed() * 1e-3f;
 
-        //find an optimal layout, taking into account all the textures (rectangle packing problem)
-        auto size = BinPacking(rectangles);
+        //find an optimal layout, taking into account all the textures (rectangle packing problem) - reuse the layout from the last launch if the inputs didn't change
+        AtlasLayout layout = {};
+        uint64_t inputs_hash = AtlasLayout::InputsHash(names, sizes);
+        bool cached = AtlasLayout::LoadCached(inputs_hash, Renderer::MaxTextureSize(), layout) && layout.offsets.size() == textures.size();
+        if(!cached) {
+            if(!AtlasLayout::Compute(sizes, Renderer::MaxTextureSize(), layout)) {
+                ENG_LOG_WARN("Texture::MergeTextures - packing failed, textures are left unmerged.");
+                return;
+            }
+            layout.inputs_hash = inputs_hash;
+            layout.StoreCached();
+        }
+        auto time_packing = t2.TimeElapsed() * 1e-3f;
 
         //create new texture (temporary, only the handle will survive)
         GLenum internalFormat = rgba ? GL_RGBA : GL_RGB;
-        TextureRef tex = std::make_shared<Texture>(TextureParams::EmptyTexture(size.w, size.h, internalFormat, filteringMode), "merge_texture");
+        TextureRef tex = std::make_shared<Texture>(TextureParams::EmptyTexture(layout.size.x, layout.size.y, internalFormat, filteringMode), "merge_texture");
         glm::vec2 tex_size = glm::vec2(tex->Size());
 
         t2.Reset();
         //copy over all the textures to their new respective location
-        for(size_t i = 0; i < rectangles.size(); i++) {
-            glm::ivec2 offset = glm::ivec2(rectangles[i].x, rectangles[i].y);
+        for(size_t i = 0; i < textures.size(); i++) {
+            glm::ivec2 offset = layout.offsets[i];
             textures[i]->Merge_CopyTo(tex, offset);
             textures[i]->Merge_UpdateData(tex->handle_data, offset, tex_size);
         }
@@ -76,7 +173,99 @@ namespace eng {
         auto time_total = t1.TimeElapsed() * 1e-3f;
 
         ENG_LOG_TRACE("Texture::MergeTextures - merged {} textures into {} ({}x{}).", textures.size(), 1, tex_size.x, tex_size.y);
-        ENG_LOG_TRACE("Texture::MergeTextures - {}ms (packing: {}ms, merging: {}ms)", time_total, time_packing, time_merging);
+        ENG_LOG_TRACE("Texture::MergeTextures - {}ms (packing: {}ms ({}), merging: {}ms)", time_total, time_packing, cached ? "cached" : "computed", time_merging);
+    }
+
+    void Texture::MergeTextures(std::vector<TextureRef>& textures, const AtlasLayout& layout, const uint8_t* pixels, GLenum filteringMode) {
+#ifdef ENGINE_HEADLESS
+        return;
+#endif
+        if(layout.offsets.size() != textures.size() || pixels == nullptr) {
+            ENG_LOG_WARN("Texture::MergeTextures - baked atlas doesn't match the textures ({} offsets, {} textures).", layout.offsets.size(), textures.size());
+            throw std::exception();
+        }
+        Timer t = {};
+
+        //atlas already contains all the textures at their location, only need to upload it
+        TextureRef tex = std::make_shared<Texture>(TextureParams::CustomData(layout.size.x, layout.size.y, GL_RGBA, GL_RGBA, GL_UNSIGNED_BYTE, filteringMode), (void*)pixels, "merge_texture");
+        glm::vec2 tex_size = glm::vec2(tex->Size());
+        for(size_t i = 0; i < textures.size(); i++) {
+            textures[i]->Merge_UpdateData(tex->handle_data, layout.offsets[i], tex_size);
+        }
+
+        ENG_LOG_TRACE("Texture::MergeTextures - uploaded baked atlas with {} textures ({}x{}, {}ms).", textures.size(), tex_size.x, tex_size.y, t.TimeElapsed<Timer::us>() * 1e-3f);
+    }
+
+    //===================================================================================
+
+    r2d::rect_wh BinPacking(std::vector<rect_type>& rectangles, int max_side, bool& out_success) {
+        out_success = true;
+
+        //callbacks are only invoked for the final (best) packing - any unsuccessful insertion means, that some rectangles weren't placed
+        auto report_successful = [](rect_type&) { return r2d::callback_result::CONTINUE_PACKING; };
+        auto report_unsuccessful = [&out_success](rect_type&) { out_success = false; return r2d::callback_result::ABORT_PACKING; };
+
+        const auto result_size = r2d::find_best_packing<spaces_type>(
+			rectangles,
+			r2d::make_finder_input(
+				max_side,
+				discard_step,
+				report_successful,
+				report_unsuccessful,
+				runtime_flipping_mode
+			)
+		);
+
+        return result_size;
+    }
+
+    nlohmann::json AtlasLayout_ToJSON(const AtlasLayout& layout) {
+        nlohmann::json offsets = nlohmann::json::array();
+        for(const glm::ivec2& offset : layout.offsets) {
+            offsets.push_back(offset.x);
+            offsets.push_back(offset.y);
+        }
+
+        nlohmann::json config = {};
+        config["hash"] = layout.inputs_hash;
+        config["max_side"] = layout.max_side;
+        config["size"] = { layout.size.x, layout.size.y };
+        config["offsets"] = offsets;
+        return config;
+    }
+
+    bool AtlasLayout_FromJSON(const nlohmann::json& config, AtlasLayout& out_layout) {
+        if(!config.is_object() || !config.count("hash") || !config.count("max_side") || !config.count("size") || !config.count("offsets"))
+            return false;
+
+        try {
+            const nlohmann::json& offsets = config.at("offsets");
+            if(!offsets.is_array() || (offsets.size() % 2) != 0)
+                return false;
+
+            out_layout.inputs_hash = config.at("hash").get<uint64_t>();
+            out_layout.max_side = config.at("max_side").get<int>();
+            out_layout.size = glm::ivec2(config.at("size").at(0).get<int>(), config.at("size").at(1).get<int>());
+            out_layout.offsets.clear();
+            for(size_t i = 0; i < offsets.size(); i += 2) {
+                out_layout.offsets.push_back(glm::ivec2(offsets[i].get<int>(), offsets[i+1].get<int>()));
+            }
+        }
+        catch(nlohmann::json::exception&) {
+            return false;
+        }
+        return true;
+    }
+
+    nlohmann::json AtlasCache_Read() {
+        //missing/corrupted cache file is fine - layouts are recomputed
+        std::string text;
+        std::ifstream file = std::ifstream(AtlasLayout::CachePath());
+        if(file.is_open())
+            text = std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+
+        nlohmann::json cache = nlohmann::json::parse(text, nullptr, false);
+        return cache.is_array() ? cache : nlohmann::json::array();
     }
 
 }//namespace eng
@@ -1,6 +1,6 @@
 #include "engine/game/utility_handlers.h"
 
-#include "engine/core/input.h"
+#include "engine/game/sim_clock.h"
 #include "engine/game/gameobject.h"
 #include "engine/game/level.h"
 #include "engine/game/resources.h"
@@ -168,7 +168,7 @@ namespace eng {
         //set projectile orientation, start & end time, starting position and copy unit's damage values
         glm::vec2 target_dir = d.target_pos - d.source_pos;
         d.i1 = VectorOrientation(target_dir / glm::length(target_dir));
-        d.f1 = d.f2 = (float)Input::CurrentTime();
+        d.f1 = d.f2 = 0.f;
         obj.real_size() = obj.SizeScaled();
 
         if(src != nullptr) {
@@ -209,12 +209,11 @@ namespace eng {
     bool UtilityHandler_Projectile_Update(UtilityObject& obj, Level& level) {
         UtilityObject::LiveData& d = obj.LD();
         UtilityObjectData ud = *obj.UData();
-        Input& input = Input::Get();
 
         obj.act() = 0;
         obj.ori() = d.i1;
 
-        d.f2 += input.deltaTime;
+        d.f2 += SimClock::DeltaTime();
         float t = (d.f2 - d.f1) * d.f3;
 
         //adding sizes cuz rendering uses Quad::FromCorner
@@ -248,7 +247,7 @@ namespace eng {
                 glm::vec2 dir = glm::normalize(d.target_pos - d.source_pos);
                 d.source_pos = d.target_pos;        //setup new target position
                 d.target_pos = d.target_pos + dir;
-                d.f1 = d.f2 = (float)Input::CurrentTime();
+                d.f1 = d.f2 = 0.f;
                 d.f3 = 1.f / 0.25f;    //update duration for the bounces
 
                 //manually play the on done sound, since it normally only spawns when object dies
@@ -329,9 +328,8 @@ namespace eng {
 
     bool UtilityHandler_Corpse_Update(UtilityObject& obj, Level& level) {
         UtilityObject::LiveData& d = obj.LD();
-        Input& input = Input::Get();
 
-        d.f1 -= input.deltaTime;
+        d.f1 -= SimClock::DeltaTime();
 
         //switch from 1st to 2nd animation when the time runs out
         if(d.f1 <= 0.f) {
@@ -353,7 +351,7 @@ namespace eng {
 
         //update the explosion animation
         if(d.i3) {
-            d.f2 -= input.deltaTime;
+            d.f2 -= SimClock::DeltaTime();
             if(d.f2 <= 0.f) {
                 d.i3 = 0;       //hides the explosion visuals
             }
@@ -404,12 +402,11 @@ namespace eng {
 
     bool UtilityHandler_Visuals_Update(UtilityObject& obj, Level& level) {
         UtilityObject::LiveData& d = obj.LD();
-        Input& input = Input::Get();
 
         obj.act() = 0;
         obj.ori() = 0;
 
-        d.f1 += input.deltaTime;
+        d.f1 += SimClock::DeltaTime();
         float t = d.f1 / obj.UData()->duration;
         
         return (t >= 1.f);
@@ -417,12 +414,11 @@ namespace eng {
 
     bool UtilityHandler_Visuals_Update2(UtilityObject& obj, Level& level) {
         UtilityObject::LiveData& d = obj.LD();
-        Input& input = Input::Get();
 
         obj.act() = 0;
         obj.ori() = 0;
 
-        d.f1 += input.deltaTime;
+        d.f1 += SimClock::DeltaTime();
         float t = d.f1 / d.f2;
         
         return (t >= 1.f);
@@ -468,12 +464,11 @@ namespace eng {
 
     bool UtilityHandler_Buff_Update(UtilityObject& obj, Level& level) {
         UtilityObject::LiveData& d = obj.LD();
-        Input& input = Input::Get();
 
         obj.act() = 0;
         obj.ori() = 0;
 
-        d.f1 += input.deltaTime;
+        d.f1 += SimClock::DeltaTime();
         float t = d.f1 / obj.UData()->duration;
         int buffIdx = SpellID::Spell2Buff(d.i1);
 
@@ -621,8 +616,8 @@ namespace eng {
             if(raised == 0) {
                 ENG_LOG_FINE("UtilityObject - Spawn a minion (skeleton) failed - no mana ({}) or no corpses", source->Mana());
                 d.i1 = 0;
-                d.f1 = (float)Input::CurrentTime();
-                d.f2 = d.f1 + obj.UData()->duration;
+                d.f1 = 0.f;
+                d.f2 = obj.UData()->duration;
                 return;
             }
 
@@ -659,14 +654,13 @@ namespace eng {
         }
 
         //start the timer
-        d.f1 = d.f2 = (float)Input::CurrentTime();
+        d.f1 = d.f2 = 0.f;
     }
 
     bool UtilityHandler_Minion_Update(UtilityObject& obj, Level& level) {
         UtilityObject::LiveData& d = obj.LD();
-        Input& input = Input::Get();
 
-        d.f2 += input.deltaTime;
+        d.f2 += SimClock::DeltaTime();
         bool timer_expired = (d.f2 - d.f1) >= obj.UData()->duration;
 
         //kill spawned minions if timer expires
@@ -725,7 +719,7 @@ namespace eng {
 
         obj.real_size() = obj.SizeScaled();
 
-        d.f1 = d.f2 = (float)Input::CurrentTime();
+        d.f1 = d.f2 = 0.f;
 
         ENG_LOG_FINE("UtilityObject - Flame Shield effect applied to '{}'.", d.targetID);
     }
@@ -744,7 +738,7 @@ namespace eng {
         obj.real_pos() = target->RenderPosition() + target->RenderSize() * 0.5f;
         obj.pos() = target->Position();
 
-        d.f2 += Input::Get().deltaTime;
+        d.f2 += SimClock::DeltaTime();
 
         if((d.f2 - d.f1) >= obj.UData()->duration) {
             d.f1 += obj.UData()->duration;
@@ -785,7 +779,7 @@ namespace eng {
         obj.pos() = d.target_pos;
 
         d.source_pos = d.target_pos;
-        d.f1 = d.f2 = (float)Input::CurrentTime();
+        d.f1 = d.f2 = 0.f;
         d.f3 = -1.f;
 
         ENG_LOG_FINE("UtilityObject - Tornado spawned at {}.", d.target_pos);
@@ -794,7 +788,7 @@ namespace eng {
     bool UtilityHandler_Tornado_Update(UtilityObject& obj, Level& level) {
         UtilityObject::LiveData& d = obj.LD();
         UtilityObjectData& ud = *obj.UData();
-        float deltaTime = Input::Get().deltaTime;
+        float deltaTime = SimClock::DeltaTime();
 
         //d.target_pos = last movement's direction vector
         //d.source_pos = movement interpolation position
@@ -850,7 +844,7 @@ namespace eng {
         obj.pos() = d.target_pos;
         obj.real_size() = obj.SizeScaled();
 
-        d.f1 = d.f2 = (float)Input::CurrentTime();
+        d.f1 = d.f2 = 0.f;
         d.f3 = ud.f1;
 
         obj.lvl()->map.SpawnRunes(d.target_pos, obj.ID());
@@ -863,7 +857,7 @@ namespace eng {
         UtilityObjectData& ud = *obj.UData();
 
         //spell duration timer
-        d.f2 += Input::Get().deltaTime;
+        d.f2 += SimClock::DeltaTime();
         if(d.f2 - d.f1 >= ud.duration) {
             int leftovers = level.map.DespawnRunes(d.target_pos, obj.ID());
             ENG_LOG_FINE("UtilityObject - Runes despawned at {} ({} remained).", d.target_pos, leftovers);
@@ -871,7 +865,7 @@ namespace eng {
         }
 
         //animation timer
-        d.f3 += Input::Get().deltaTime;
+        d.f3 += SimClock::DeltaTime();
         if(d.f3 >= ud.f1) {
             d.i1 = 1;
             d.f3 = 0.f;
@@ -1063,7 +1057,7 @@ namespace eng {
             }
         }
 
-        d.f1 = d.f2 = (float)Input::CurrentTime();
+        d.f1 = d.f2 = 0.f;
 
         ENG_LOG_FINE("UtilityObject - Blizzard/DnD spawned at {} (pattern: {}).", d.target_pos, stringify_dnd_pattern(d.ids));
         d.target_pos -= 2.f;
@@ -1072,7 +1066,7 @@ namespace eng {
     bool UtilityHandler_BlizzDnD_Update(UtilityObject& obj, Level& level) {
         UtilityObject::LiveData& d = obj.LD();
         UtilityObjectData& ud = *obj.UData();
-        float deltaTime = Input::Get().deltaTime;
+        float deltaTime = SimClock::DeltaTime();
 
         d.f2 += deltaTime;
         if((d.f2 - d.f1) >= obj.UData()->duration) {
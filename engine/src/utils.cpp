@@ -1,6 +1,7 @@
 #include "engine/utils/utils.h"
 #include "engine/utils/setup.h"
 
+#include <algorithm>
 #include <fstream>
 #include <sstream>
 
@@ -38,6 +39,25 @@ namespace eng {
         return true;
     }
 
+    bool TryReadBinaryFile(const char* filepath, std::vector<uint8_t>& out_data) {
+        std::ifstream file = std::ifstream(filepath, std::ios::binary | std::ios::ate);
+        if(!file.is_open()) {
+            ENG_LOG_DEBUG("ReadBinaryFile - Failed to open '{}'.", filepath);
+            return false;
+        }
+
+        std::streamsize size = file.tellg();
+        file.seekg(0, std::ios::beg);
+        out_data.resize(size_t(std::max(size, std::streamsize(0))));
+        if(size < 0 || !file.read((char*)out_data.data(), size)) {
+            ENG_LOG_DEBUG("ReadBinaryFile - Failed to read from '{}'.", filepath);
+            return false;
+        }
+
+        ENG_LOG_TRACE("[R] ReadBinaryFile - Loaded file '{}' ({})", filepath, (int)out_data.size());
+        return true;
+    }
+
     void WriteFile(const char* filepath, const std::string& text) {
         if(!TryWriteFile(filepath, text))
             throw std::runtime_error("WriteFile() failed.");
@@ -19,9 +19,11 @@ private:
     GameStage stageController;
 
     eng::ShaderRef shader;
+    eng::ShaderRef spriteShader;        //instanced variant of the shader (same fragment stage)
     eng::ColorPalette colorPalette;
 
     DBGONLY(int dbg_stageIdx = -1);
     DBGONLY(int dbg_stageStateIdx = -1);
     bool fullscreen = false;
+    std::string replay_filepath = "";
 };
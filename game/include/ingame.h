@@ -14,7 +14,8 @@ struct IngameInitParams {
 
 class IngameController : public GameStageController, public eng::PlayerFactionController::GUIRequestHandler {
 public:
-    IngameController();
+    //replay_filepath - when not empty, player orders from each level are recorded into a replay log (see eng::Replay)
+    IngameController(const std::string& replay_filepath = "");
 
     virtual void Update() override;
     virtual void Render() override;
@@ -22,6 +23,8 @@ public:
     virtual int GetStageID() const override { return GameStageName::INGAME; }
 
     virtual void OnPreLoad(int prevStageID, int info, void* data) override;
+    virtual bool LoadingUpdate() override;
+    virtual float LoadingProgress() const override;
     virtual void OnPreStart(int prevStageID, int info, void* data) override;
     virtual void OnStart(int prevStageID, int info, void* data) override;
     virtual void OnStop(int nextStageID) override;
@@ -36,14 +39,23 @@ public:
 private:
     void KeyPressCallback(int keycode, int modifiers);
 
+    void LevelLoad(int startType, GameInitParams* params);
     void LevelSetup(int startType, GameInitParams* params);
     void StateReset();
 private:
     eng::Level level;
+    eng::LevelLoader loader;
+    eng::Autosave autosave;
+
+    //parameters of the level, that is being loaded
+    int load_startType = GameStartType::INVALID;
+    GameInitParams load_params = {};
 
     bool can_be_paused = true;
     bool paused = false;
 
     bool ready_to_render = false;
     bool ready_to_run = false;
+
+    std::string replay_filepath;
 };
@@ -107,6 +107,13 @@ public:
     //Use for async assets preloading.
     virtual void OnPreLoad(int prevStageID, int info, void* data) {}
 
+    //Polled once the screen fades out, before switching into this state. Returns false while the stage is still loading (loading screen is displayed meanwhile).
+    //Use to finish the async loading started in OnPreLoad().
+    virtual bool LoadingUpdate() { return true; }
+
+    //Loading progress in range [0,1], displayed on the loading screen.
+    virtual float LoadingProgress() const { return 1.f; }
+
     //Triggered when switching into this state - when screen fades out.
     //Use to initialize visuals, so that there's stuff on screen when fading in.
     virtual void OnPreStart(int prevStageID, int info, void* data) {}
@@ -144,6 +151,9 @@ public:
 
     static int name2idx(std::string name);
     std::string idx2name(int idx);
+private:
+    void SwitchStage();
+    void RenderLoadingScreen(float progress);
 private:
     int currentStageID = GameStageName::INVALID;
     GameStageControllerRef currentStage = nullptr;
@@ -151,6 +161,7 @@ private:
     std::map<int, GameStageControllerRef> stages;
 
     TransitionHandler transitionHandler;
+    bool loading = false;
 };
 
 //===== GameInitParams =====
@@ -49,6 +49,9 @@ Game::Game(int argc, char** argv) : App(640, 480, "game") {
             if(strncmp(argv[i], "--fullscreen", 12) == 0) {
                 fullscreen = true;
             }
+            else if(strncmp(argv[i], "--record", 8) == 0 && i < argc-1) {
+                replay_filepath = std::string(argv[++i]);
+            }
 #ifdef ENGINE_DEBUG
             else if(strncmp(argv[i], "--stage", 7) == 0 && i < argc-1) {
                 dbg_stageIdx = GameStage::name2idx(std::string(argv[++i]));
@@ -82,9 +85,11 @@ void Game::OnInit() {
 
         ReloadShaders();
         Resources::Preload();
+        TextureGenerator::Pregenerate();
 
         colorPalette = ColorPalette(true);
         colorPalette.UpdateShaderValues(shader);
+        colorPalette.UpdateShaderValues(spriteShader);
 
     } catch(std::exception& e) {
         LOG_INFO("ERROR: {}", e.what());
@@ -100,7 +105,7 @@ void Game::OnInit() {
         std::make_shared<IntroController>(),
         std::make_shared<MainMenuController>(),
         std::make_shared<RecapController>(),
-        std::make_shared<IngameController>(),
+        std::make_shared<IngameController>(replay_filepath),
     });
 
 #ifdef ENGINE_DEBUG
@@ -115,6 +120,9 @@ static InputButton t = InputButton(GLFW_KEY_T);
 static InputButton o = InputButton(GLFW_KEY_O);
 #endif
 
+//quads sorted by depth & texture before submission (fewer draw calls)
+static bool deferred_rendering = true;
+
 #ifdef ENGINE_ENABLE_GUI
 static bool gui_enabled = false;
 static InputButton gui_btn = InputButton(GLFW_KEY_P);
@@ -161,8 +169,11 @@ void Game::OnUpdate() {
     stageController.Update();
 
     Renderer::Begin(shader, true);
+    Renderer::UseSpriteShader(spriteShader);
+    Renderer::DeferredMode(deferred_rendering);
 
     colorPalette.Bind(shader);
+    colorPalette.Bind(spriteShader);
     stageController.Render();
 
     Renderer::End();
@@ -175,11 +186,14 @@ void Game::OnGUI() {
         Audio::DBG_GUI();
         Camera::Get().DBG_GUI();
         stageController.DBG_GUI();
+        Jobs::DBG_GUI();
 
         ImGui::Begin("General");
         ImGui::Text("FPS: %.1f", Input::Get().fps);
         ImGui::Text("Draw calls: %d | Total quads: %d (%d wasted)", Renderer::Stats().drawCalls, Renderer::Stats().totalQuads, Renderer::Stats().wastedQuads);
-        ImGui::Text("Textures: %d", Renderer::Stats().numTextures);
+        ImGui::Text("Textures: %d | Uploaded: %.1f kB", Renderer::Stats().numTextures, Renderer::Stats().bytesUploaded / 1024.f);
+        ImGui::Text("Texture slots: %d | Slot flushes: %d | Buffer stalls: %d", Renderer::TextureSlotsCount(), Renderer::Stats().textureFlushes, Renderer::Stats().ringStalls);
+        ImGui::Checkbox("Sorted submission", &deferred_rendering);
         if(ImGui::Button("Reload shaders")) {
             try {
                 ReloadShaders();
@@ -203,4 +217,8 @@ void Game::ReloadShaders() {
     shader = Resources::LoadShader("cycling_shader", true);
     shader->InitTextureSlots(Renderer::TextureSlotsCount());
     colorPalette.UpdateShaderValues(shader);
+
+    spriteShader = std::make_shared<Shader>(ReadFile("res/shaders/cycling_shader_instanced.vert"), ReadFile("res/shaders/cycling_shader.frag"), "cycling_shader_instanced");
+    spriteShader->InitTextureSlots(Renderer::TextureSlotsCount());
+    colorPalette.UpdateShaderValues(spriteShader);
 }
@@ -8,7 +8,7 @@ static std::string stage_names[] = { "CAMPAIGN", "CUSTOM", "LOAD" };
 
 static IngameInitParams gameInitParams = {};
 
-IngameController::IngameController() {}
+IngameController::IngameController(const std::string& replay_filepath_) : replay_filepath(replay_filepath_) {}
 
 void IngameController::Update() {
     if(!ready_to_run)
@@ -16,6 +16,7 @@ void IngameController::Update() {
     
     if(!paused || !can_be_paused) {
         level.Update();
+        autosave.Update(level);
     }
     else {
         level.factions.Player()->Update_Paused(level);
@@ -32,12 +33,10 @@ void IngameController::Render() {
 }
 
 void IngameController::OnPreLoad(int prevStageID, int info, void* data) {
-    //start loading game assets - probably just map data, since opengl can't handle async loading
+    //level is loaded in the background, the setup is finished in LoadingUpdate() (once loaded & the screen fades out)
 
     StateReset();
-
-    //TODO: do this in a separate thread
-    LevelSetup(info, static_cast<GameInitParams*>(data));
+    LevelLoad(info, static_cast<GameInitParams*>(data));
 
     /* ways to reach ingame stage:
         - mainMenu - start campaign (goes through recap stage tho)
@@ -49,6 +48,20 @@ void IngameController::OnPreLoad(int prevStageID, int info, void* data) {
     */
 }
 
+bool IngameController::LoadingUpdate() {
+    if(!loader.InProgress())
+        return true;
+    if(!loader.Done())
+        return false;
+
+    LevelSetup(load_startType, &load_params);
+    return true;
+}
+
+float IngameController::LoadingProgress() const {
+    return loader.Progress();
+}
+
 void IngameController::OnPreStart(int prevStageID, int info, void* data) {
     Camera& camera = Camera::Get();
 
@@ -74,6 +87,11 @@ void IngameController::OnStart(int prevStageID, int info, void* data) {
 void IngameController::OnStop(int nextStageID) {
     ready_to_render = false;
     ready_to_run = false;
+    autosave.Wait();
+
+    if(level.replay.IsRecording()) {
+        level.replay.StopRecording(level);
+    }
 }
 
 void IngameController::PauseRequest(bool pause) {
@@ -126,14 +144,25 @@ void IngameController::DBG_GUI(bool active) {
             level.factions.DBG_GUI();
 
         level.info.DBG_GUI();
+        SimClock::Get().DBG_GUI();
+        autosave.DBG_GUI();
     }
 #endif
 }
 
-void IngameController::LevelSetup(int startType, GameInitParams* params) {
-    LOG_INFO("IngameController::LevelSetup: loading from '{}'", params->filepath);
+void IngameController::LevelLoad(int startType, GameInitParams* params) {
+    LOG_INFO("IngameController::LevelLoad: loading from '{}'", params->filepath);
+    autosave.Wait();
     level.Release();
-    if(Level::Load(params->filepath, level) != 0) {
+
+    //params may point to data, that changes before the load finishes
+    load_startType = startType;
+    load_params = *params;
+    loader.Start(load_params.filepath);
+}
+
+void IngameController::LevelSetup(int startType, GameInitParams* params) {
+    if(loader.Finalize(level) != 0) {
         LOG_ERROR("IngameController::LevelSetup: failed to initialize the level.");
         // throw std::runtime_error("");
         GetTransitionHandler()->InitTransition(
@@ -169,9 +198,15 @@ void IngameController::LevelSetup(int startType, GameInitParams* params) {
 
     LinkController(level.factions.Player());
     ready_to_render = true;
+    autosave.Reset();
+
+    //start recording right after the setup - state that isn't part of the savefile is still in its initial values
+    if(!replay_filepath.empty()) {
+        level.replay.StartRecording(level, replay_filepath);
+    }
 
     //manually trigger first GUI update - to have it finalized when fading in
-    level.factions.Player()->Update(level);
+    level.factions.Player()->FrameUpdate(level);
 }
 
 void IngameController::StateReset() {
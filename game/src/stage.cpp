@@ -96,7 +96,8 @@ void GameStage::Initialize(const std::vector<GameStageControllerRef>& stages_, i
 }
 
 void GameStage::Update() {
-    currentStage->Update();
+    if(!loading)
+        currentStage->Update();
 
     if(transitionHandler.TransitionStarted() && (currentStageID != transitionHandler.NextStageID() || (transitionHandler.ForcePreloadStage() && transitionHandler.IsFadingOut()))) {
         stages[transitionHandler.NextStageID()]->OnPreLoad(currentStageID, transitionHandler.Info(), transitionHandler.Data());
@@ -104,18 +105,28 @@ void GameStage::Update() {
 }
 
 void GameStage::Render() {
-    currentStage->Render();
-    if(transitionHandler.Update()) {
-        currentStage->OnStop(transitionHandler.NextStageID());
-        currentStage = stages[transitionHandler.NextStageID()];
-        if(transitionHandler.IsFadedOut())
-            currentStage->OnPreStart(currentStageID, transitionHandler.Info(), transitionHandler.Data());
-        else
-            currentStage->OnStart(currentStageID, transitionHandler.Info(), transitionHandler.Data());
-        currentStageID = transitionHandler.NextStageID();
-        
-        transitionHandler.AutoFadeIn();
+    if(!loading) {
+        currentStage->Render();
+        if(!transitionHandler.Update())
+            return;
+        //next stage might still be loading once the screen fades out
+        loading = transitionHandler.IsFadedOut();
     }
+
+    if(loading) {
+        GameStageController* next = stages[transitionHandler.NextStageID()].get();
+        if(!next->LoadingUpdate()) {
+            RenderLoadingScreen(next->LoadingProgress());
+            return;
+        }
+        loading = false;
+
+        //loading failed & the stage initiated a different transition instead
+        if(transitionHandler.TransitionInProgress())
+            return;
+    }
+
+    SwitchStage();
 }
 
 void GameStage::DBG_GUI() {
@@ -135,12 +146,37 @@ void GameStage::DBG_SetStage(int stageIdx, int stageStateIdx) {
 
     LOG_DEBUG("GameStage::DBG_SetStage - switching to stage '{}'", idx2name(stageIdx));
     transitionHandler.CancelTransition();
+    loading = false;
     currentStage = stages[stageIdx];
     currentStageID = currentStage->GetStageID();
     currentStage->DBG_StageSwitch(stageStateIdx);
 }
 #endif
 
+void GameStage::SwitchStage() {
+    currentStage->OnStop(transitionHandler.NextStageID());
+    currentStage = stages[transitionHandler.NextStageID()];
+    if(transitionHandler.IsFadedOut())
+        currentStage->OnPreStart(currentStageID, transitionHandler.Info(), transitionHandler.Data());
+    else
+        currentStage->OnStart(currentStageID, transitionHandler.Info(), transitionHandler.Data());
+    currentStageID = transitionHandler.NextStageID();
+    
+    transitionHandler.AutoFadeIn();
+}
+
+void GameStage::RenderLoadingScreen(float progress) {
+    glm::vec2 bar_size = glm::vec2(0.4f, 0.015f);
+    glm::vec2 bar_pos = glm::vec2(-bar_size.x, -0.1f - bar_size.y);
+    progress = std::clamp(progress, 0.f, 1.f);
+
+    //black background, text & progress bar on top of it
+    Renderer::RenderQuad(Quad::FromCenter(glm::vec3(0.f, 0.f, -0.8f), glm::vec2(1.f), glm::vec4(0.f, 0.f, 0.f, 1.f)));
+    Resources::DefaultFont()->RenderTextCentered("Loading...", glm::vec2(0.f, 0.05f), 2.f, glm::vec4(1.f));
+    Renderer::RenderQuad(Quad::FromCorner(glm::vec3(bar_pos, -0.85f), bar_size * 2.f, glm::vec4(0.2f, 0.2f, 0.2f, 1.f)));
+    Renderer::RenderQuad(Quad::FromCorner(glm::vec3(bar_pos, -0.86f), glm::vec2(bar_size.x * 2.f * progress, bar_size.y * 2.f), glm::vec4(0.8f, 0.65f, 0.2f, 1.f)));
+}
+
 int GameStage::name2idx(std::string name) {
     static std::unordered_map<std::string, int> mapping = {
         { "INVALID", GameStageName::INVALID },
@@ -0,0 +1,592 @@
+#include <engine/engine.h>
+#include <engine/utils/timer.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <new>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace eng;
+
+//Headless simulation benchmark - loads a savefile and runs the simulation for given number of ticks as fast as possible.
+//Built against the engine_sim library (no window, GPU or audio). Usage:
+//    strategy2d_headless [savefile] [--ticks N] [--workers N] [--autosave S]   (S = autosave interval in seconds of game time)
+//    strategy2d_headless --replay <replay_log>     (re-executes recorded session & verifies the end state hash)
+//    strategy2d_headless --check-workers [savefile] [--ticks N] [--workers N]   (compares the end state hashes of the runs on 1 thread & on N threads)
+//    strategy2d_headless --bench-jobs [--workers N] (job system micro-benchmark)
+//    strategy2d_headless --bench-savefile           (JSON vs binary savefile load/save times on res/saves/*.json)
+//    strategy2d_headless --bench-json               (DOM vs streaming JSON parser - parse time & peak heap on the shipped maps)
+//    strategy2d_headless --bench-quads              (CPU side of the quad submission - Quad/TextureRef path vs texture handles)
+//    strategy2d_headless --bench-frame [savefile] [--frames N]   (CPU cost of building a frame of the level through the null & recording renderer backends)
+
+//Heap usage tracking (for the parser benchmark) - each allocation is prefixed with its size.
+#define HEAP_HEADER alignof(std::max_align_t)
+static std::atomic<long long> heap_current = 0;
+static std::atomic<long long> heap_peak = 0;
+
+void* operator new(size_t size) {
+    char* p = (char*)malloc(size + HEAP_HEADER);
+    if(p == nullptr)
+        throw std::bad_alloc();
+    *(size_t*)p = size;
+
+    long long current = heap_current.fetch_add((long long)size) + (long long)size;
+    long long peak = heap_peak.load();
+    while(current > peak && !heap_peak.compare_exchange_weak(peak, current)) {}
+    return p + HEAP_HEADER;
+}
+
+void operator delete(void* ptr) noexcept {
+    if(ptr == nullptr)
+        return;
+    char* p = (char*)ptr - HEAP_HEADER;
+    heap_current -= (long long)*(size_t*)p;
+    free(p);
+}
+
+void* operator new[](size_t size) { return operator new(size); }
+void operator delete[](void* ptr) noexcept { operator delete(ptr); }
+void operator delete(void* ptr, size_t) noexcept { operator delete(ptr); }
+void operator delete[](void* ptr, size_t) noexcept { operator delete(ptr); }
+
+static void PrintStat(const char* name, long long us, const TickStats& stats) {
+    double per_tick = double(us) / std::max(stats.ticks, 1);
+    double ratio = 100.0 * double(us) / std::max(stats.Total(), 1LL);
+    printf("    %-12s %10.2f us/tick  (%5.1f%%)\n", name, per_tick, ratio);
+}
+
+//Job system micro-benchmark - scheduling overhead of empty jobs & ParallelFor speedup on synthetic workload.
+static int BenchJobs() {
+    constexpr int job_count = 200000;
+    constexpr size_t item_count = 1 << 20;
+    constexpr int item_work = 64;
+
+    Timer t = {};
+    std::atomic<int> executed = 0;
+    Jobs::Counter counter;
+    for(int i = 0; i < job_count; i++) {
+        Jobs::Run([&executed]() { executed++; }, &counter);
+    }
+    Jobs::Wait(counter);
+    double time_empty = double(t.TimeElapsed<Timer::us>());
+
+    std::vector<float> data(item_count);
+    auto body = [&data](size_t begin, size_t end) {
+        for(size_t i = begin; i < end; i++) {
+            float v = float(i);
+            for(int k = 0; k < item_work; k++)
+                v = v * 0.999f + 0.5f;
+            data[i] = v;
+        }
+    };
+
+    t.Reset();
+    body(0, item_count);
+    double time_serial = double(t.TimeElapsed<Timer::us>());
+
+    t.Reset();
+    Jobs::ParallelFor(item_count, body);
+    double time_parallel = double(t.TimeElapsed<Timer::us>());
+
+    printf("strategy2d_headless - job system benchmark (%d workers + main thread)\n", Jobs::WorkerCount());
+    printf("    empty jobs:   %d in %.2fms (%.1f ns/job)\n", executed.load(), time_empty * 1e-3, time_empty * 1e3 / job_count);
+    printf("    parallel for: %zu items, serial %.2fms, parallel %.2fms (%.2fx speedup)\n", item_count, time_serial * 1e-3, time_parallel * 1e-3, time_serial / std::max(time_parallel, 1.0));
+    return 0;
+}
+
+//Quad submission benchmark - renderer's CPU side only (headless renderer skips the GL calls), quads submitted per millisecond.
+static int BenchQuads() {
+    constexpr int quad_count = 2000000;
+    constexpr int handle_count = 4;
+    constexpr int interleaved_count = 24;      //more textures than the slots -> flushes unless sorted
+
+    TextureRef texture = std::make_shared<Texture>(TextureParams::CustomData(64, 64, GL_RGBA, GL_RGBA, GL_UNSIGNED_BYTE), nullptr, "bench");
+    TexCoords tc = TexCoords::Default();
+    glm::vec2 size = glm::vec2(0.01f);
+
+    auto run = [&](const char* name, bool instanced, bool deferred, auto&& submit) {
+        Renderer::StatsReset();
+        Renderer::Begin(nullptr, nullptr, false);
+        if(instanced)
+            Renderer::UseSpriteShader(nullptr);
+        Renderer::DeferredMode(deferred);
+        Timer t = {};
+        for(int i = 0; i < quad_count; i++) {
+            glm::vec3 pos = glm::vec3(float(i % 100) * 0.01f, float((i / 100) % 100) * 0.01f, 0.f);
+            submit(i, pos);
+        }
+        Renderer::End();
+        double us = double(t.TimeElapsed<Timer::us>());
+        const Renderer::RenderStats& stats = Renderer::Stats();
+        printf("    %-36s %8.0f quads/ms  (%.2fms, %d draw calls, %d slot flushes, %.1f B/quad uploaded)\n", name, quad_count * 1e3 / std::max(us, 1.0), us * 1e-3, stats.drawCalls, stats.textureFlushes, double(stats.bytesUploaded) / std::max(stats.totalQuads, 1));
+    };
+
+    printf("strategy2d_headless - quad submission benchmark (%d quads, %d texture slots)\n", quad_count, Renderer::TextureSlotsCount());
+    run("Quad + TextureRef", false, false, [&](int i, const glm::vec3& pos) {
+        Renderer::RenderQuad(Quad::FromCorner(Quad::DefaultInfo(), pos, size, glm::vec4(1.f), texture, tc));
+    });
+    run("QuadVertices + handle", false, false, [&](int i, const glm::vec3& pos) {
+        Renderer::RenderQuad(QuadVertices::FromCorner(Quad::DefaultInfo(), pos, size, glm::vec4(1.f), tc), 1);
+    });
+    run("QuadVertices + handle (4 textures)", false, false, [&](int i, const glm::vec3& pos) {
+        Renderer::RenderQuad(QuadVertices::FromCorner(Quad::DefaultInfo(), pos, size, glm::vec4(1.f), tc), GLuint(1 + i % handle_count));
+    });
+    run("SpriteInstance", true, false, [&](int i, const glm::vec3& pos) {
+        Renderer::RenderSprite(SpriteInstance::FromCorner(pos, size, glm::vec4(1.f), tc), 1);
+    });
+    run("SpriteInstance (4 textures)", true, false, [&](int i, const glm::vec3& pos) {
+        Renderer::RenderSprite(SpriteInstance::FromCorner(pos, size, glm::vec4(1.f), tc), GLuint(1 + i % handle_count));
+    });
+    run("SpriteInstance (24 textures)", true, false, [&](int i, const glm::vec3& pos) {
+        Renderer::RenderSprite(SpriteInstance::FromCorner(pos, size, glm::vec4(1.f), tc), GLuint(1 + i % interleaved_count));
+    });
+    run("SpriteInstance (24 textures, sorted)", true, true, [&](int i, const glm::vec3& pos) {
+        Renderer::RenderSprite(SpriteInstance::FromCorner(pos, size, glm::vec4(1.f), tc), GLuint(1 + i % interleaved_count));
+    });
+
+    Renderer::Release();
+    return 0;
+}
+
+//Frame building benchmark - map & objects submitted to the renderer without GL (null backend discards the quads, recording backend keeps them & hashes the frame).
+static int BenchFrame(const std::string& filepath, int frame_count) {
+    try {
+        Resources::Preload();
+    } catch(std::exception&) {
+        LOG_ERROR("Failed to load resources; Terminating...");
+        return 1;
+    }
+
+    Level level = {};
+    if(Level::Load(filepath, level) != 0) {
+        LOG_ERROR("Failed to load the level from '{}'.", filepath);
+        Resources::Release();
+        return 1;
+    }
+
+    //no window -> 16:9 view, camera position & zoom come from the savefile
+    Camera::Get().UpdateMultiplier(glm::vec2(9.f / 16.f, 1.f));
+
+    printf("strategy2d_headless - frame building benchmark '%s' (%d frames)\n", filepath.c_str(), frame_count);
+    const char* names[] = { "null", "recording" };
+    int backends[] = { Renderer::Backend::Null, Renderer::Backend::Recording };
+    for(int b = 0; b < 2; b++) {
+        Renderer::Release();
+        Renderer::Initialize(backends[b]);
+
+        Timer t = {};
+        for(int i = 0; i < frame_count; i++) {
+            Renderer::StatsReset();
+            Renderer::Begin(nullptr, nullptr, false);
+            Renderer::UseSpriteShader(nullptr);
+            Renderer::DeferredMode(true);
+            level.Render();
+            Renderer::End();
+        }
+        double us = double(t.TimeElapsed<Timer::us>()) / std::max(frame_count, 1);
+
+        const Renderer::RenderStats& stats = Renderer::Stats();
+        printf("    %-10s %8.1f us/frame  (%d quads, %d draw calls)", names[b], us, stats.totalQuads, stats.drawCalls);
+        if(backends[b] == Renderer::Backend::Recording)
+            printf("  frame hash %016llx", (unsigned long long)Renderer::Recorded().Hash());
+        printf("\n");
+    }
+
+    Renderer::Release();
+    level.Release();
+    Resources::Release();
+    return 0;
+}
+
+//Determinism check - simulates the savefile twice (on the main thread only & with N threads) and compares the end state hashes.
+static int CheckWorkers(const std::string& filepath, int tick_count, int worker_count) {
+    if(worker_count <= 1)
+        worker_count = std::max(int(std::thread::hardware_concurrency()), 2);
+
+    try {
+        Resources::Preload();
+    } catch(std::exception&) {
+        LOG_ERROR("Failed to load resources; Terminating...");
+        return 1;
+    }
+
+    printf("strategy2d_headless - worker count check '%s' (%d ticks)\n", filepath.c_str(), tick_count);
+    int thread_counts[] = { 1, worker_count };
+    uint64_t hashes[2] = {};
+    for(int r = 0; r < 2; r++) {
+        Jobs::Initialize(thread_counts[r] - 1);
+        Random::Seed(0);
+
+        Level level = {};
+        if(Level::Load(filepath, level) != 0) {
+            LOG_ERROR("Failed to load the level from '{}'.", filepath);
+            Jobs::Release();
+            Resources::Release();
+            return 1;
+        }
+        if(!level.factions.IsInitialized()) {
+            level.CustomGame_InitFactions(0, 1);
+            level.CustomGame_InitEndConditions();
+        }
+
+        for(int i = 0; i < tick_count; i++)
+            level.Tick();
+        hashes[r] = Replay::StateHash(level);
+        printf("    %2d threads: state hash %016llx\n", Jobs::WorkerCount()+1, (unsigned long long)hashes[r]);
+
+        level.Release();
+        Jobs::Release();
+    }
+    Resources::Release();
+
+    bool match = (hashes[0] == hashes[1]);
+    printf("    result:     %s\n", match ? "OK (hashes match)" : "MISMATCH");
+    return match ? 0 : 1;
+}
+
+static long long FileSize(const std::string& filepath) {
+    std::error_code ec;
+    long long size = (long long)std::filesystem::file_size(filepath, ec);
+    return ec ? 0 : size;
+}
+
+//Savefile format benchmark - compares load & save times of the JSON and binary formats on all the JSON saves.
+static int BenchSavefile() {
+    constexpr int repeats = 5;
+    std::string tmp_dir = std::filesystem::temp_directory_path().string() + "/";
+    std::string json_path = tmp_dir + "s2d_bench.json";
+    std::string json_path2 = tmp_dir + "s2d_bench_roundtrip.json";
+    std::string bin_path = tmp_dir + "s2d_bench_raw.sav";
+    std::string lz_path = tmp_dir + "s2d_bench_lz.sav";
+
+    printf("strategy2d_headless - savefile benchmark (avg of %d runs, times in ms)\n", repeats);
+    printf("    %-20s %-7s %10s %10s %10s\n", "savefile", "format", "size [kB]", "load", "save");
+
+    int result = 0;
+    for(const std::string& name : Config::Saves::Scan(false)) {
+        std::string filepath = Config::Saves::FullPath(name, false);
+        if(GetExtension(filepath) != "json")
+            continue;
+
+        try {
+            //format, filepath, load time, save time
+            double times[3][2] = {};
+            const char* formats[3] = { "json", "binary", "lz" };
+            const std::string* paths[3] = { &json_path, &bin_path, &lz_path };
+
+            Timer t = {};
+            for(int r = 0; r < repeats; r++) {
+                t.Reset();
+                Savefile sf = Savefile(filepath);
+                times[0][0] += t.TimeElapsed<Timer::us>();
+
+                t.Reset();
+                sf.SaveJSON(json_path);
+                times[0][1] += t.TimeElapsed<Timer::us>();
+
+                t.Reset();
+                sf.SaveBinary(bin_path, false);
+                times[1][1] += t.TimeElapsed<Timer::us>();
+
+                t.Reset();
+                sf.SaveBinary(lz_path, true);
+                times[2][1] += t.TimeElapsed<Timer::us>();
+
+                for(int f = 1; f < 3; f++) {
+                    t.Reset();
+                    Savefile loaded = Savefile(*paths[f]);
+                    times[f][0] += t.TimeElapsed<Timer::us>();
+                }
+            }
+
+            for(int f = 0; f < 3; f++) {
+                printf("    %-20s %-7s %10.1f %10.2f %10.2f\n", name.c_str(), formats[f], FileSize(*paths[f]) / 1024.0, times[f][0] * 1e-3 / repeats, times[f][1] * 1e-3 / repeats);
+            }
+
+            //both formats have to describe the same state
+            Savefile(lz_path).SaveJSON(json_path2);
+            std::string a, b;
+            bool match = TryReadFile(json_path.c_str(), a) && TryReadFile(json_path2.c_str(), b) && a == b;
+            printf("    %-20s roundtrip %s\n", name.c_str(), match ? "identical" : "MISMATCH");
+            if(!match)
+                result = 2;
+        } catch(std::exception&) {
+            LOG_ERROR("Savefile benchmark failed on '{}'.", filepath);
+            result = 1;
+        }
+    }
+
+    for(const std::string* path : { &json_path, &json_path2, &bin_path, &lz_path }) {
+        std::error_code ec;
+        std::filesystem::remove(*path, ec);
+    }
+    return result;
+}
+
+//JSON parser benchmark - DOM vs streaming (SAX) parser on maps, campaign maps & a synthetic 256x256 map. Peak heap is measured relative to the heap usage before the load.
+static int BenchJSON() {
+    constexpr int repeats = 5;
+    std::string synthetic_path = std::filesystem::temp_directory_path().string() + "/s2d_bench_256.json";
+
+    std::vector<std::string> files;
+    for(const std::string& name : Config::Saves::ScanCustomGames(false))
+        files.push_back(Config::Saves::CustomGames_FullPath(name, false));
+    std::error_code ec;
+    for(const auto& entry : std::filesystem::directory_iterator("res/campaign/maps", ec)) {
+        if(entry.is_regular_file() && entry.path().extension() == ".json")
+            files.push_back(entry.path().string());
+    }
+
+    //synthetic map (tiles only, same tile layout as the editor output)
+    try {
+        Savefile sf = {};
+        sf.map.tileset = "summer";
+        sf.map.tiles = MapTiles(glm::ivec2(256));
+        for(int i = 0; i < sf.map.tiles.Count(); i++) {
+            int type = ((i / 7) % 5 == 0) ? TileType::TREES : TileType::GROUND1 + (i % 2);
+            sf.map.tiles[i] = TileData(type, i % 4, type, 100);
+        }
+        sf.info.startingLocations = { glm::ivec2(8, 8), glm::ivec2(240, 240) };
+        sf.SaveJSON(synthetic_path);
+        files.push_back(synthetic_path);
+    } catch(std::exception&) {
+        LOG_ERROR("Failed to generate the synthetic map.");
+    }
+
+    printf("strategy2d_headless - JSON parser benchmark (avg of %d runs)\n", repeats);
+    printf("    %-32s %10s %12s %12s %14s %14s\n", "file", "size [kB]", "DOM [ms]", "SAX [ms]", "DOM peak [kB]", "SAX peak [kB]");
+
+    bool streaming = Savefile::StreamingParserEnabled();
+    int result = 0;
+    for(const std::string& filepath : files) {
+        try {
+            double times[2] = {};
+            long long peaks[2] = {};
+            for(int mode = 0; mode < 2; mode++) {
+                Savefile::EnableStreamingParser(mode == 1);
+                for(int r = 0; r < repeats; r++) {
+                    long long base = heap_current.load();
+                    heap_peak = base;
+
+                    Timer t = {};
+                    Savefile sf = Savefile(filepath);
+                    times[mode] += t.TimeElapsed<Timer::us>();
+                    peaks[mode] = std::max(peaks[mode], heap_peak.load() - base);
+                }
+            }
+
+            printf("    %-32s %10.1f %12.2f %12.2f %14.1f %14.1f\n", std::filesystem::path(filepath).filename().string().c_str(), FileSize(filepath) / 1024.0,
+                times[0] * 1e-3 / repeats, times[1] * 1e-3 / repeats, peaks[0] / 1024.0, peaks[1] / 1024.0);
+        } catch(std::exception&) {
+            LOG_ERROR("JSON parser benchmark failed on '{}'.", filepath);
+            result = 1;
+        }
+    }
+    Savefile::EnableStreamingParser(streaming);
+
+    std::filesystem::remove(synthetic_path, ec);
+    return result;
+}
+
+int main(int argc, char** argv) {
+    std::string filepath = "res/saves/all.json";
+    std::string replay_filepath = "";
+    int tick_count = 10000;
+    int worker_count = -1;
+    bool bench_jobs = false;
+    bool bench_savefile = false;
+    bool bench_json = false;
+    bool bench_quads = false;
+    bool bench_frame = false;
+    bool check_workers = false;
+    int frame_count = 200;
+    float autosave_interval = 0.f;
+
+    for(int i = 1; i < argc; i++) {
+        if(strncmp(argv[i], "--ticks", 7) == 0 && i < argc-1) {
+            tick_count = std::max(std::atoi(argv[++i]), 1);
+        }
+        else if(strncmp(argv[i], "--workers", 9) == 0 && i < argc-1) {
+            worker_count = std::max(std::atoi(argv[++i]), 0);
+        }
+        else if(strncmp(argv[i], "--bench-jobs", 12) == 0) {
+            bench_jobs = true;
+        }
+        else if(strncmp(argv[i], "--bench-savefile", 16) == 0) {
+            bench_savefile = true;
+        }
+        else if(strncmp(argv[i], "--bench-json", 12) == 0) {
+            bench_json = true;
+        }
+        else if(strncmp(argv[i], "--bench-quads", 13) == 0) {
+            bench_quads = true;
+        }
+        else if(strncmp(argv[i], "--bench-frame", 13) == 0) {
+            bench_frame = true;
+        }
+        else if(strncmp(argv[i], "--check-workers", 15) == 0) {
+            check_workers = true;
+        }
+        else if(strncmp(argv[i], "--frames", 8) == 0 && i < argc-1) {
+            frame_count = std::max(std::atoi(argv[++i]), 1);
+        }
+        else if(strncmp(argv[i], "--autosave", 10) == 0 && i < argc-1) {
+            autosave_interval = std::max(float(std::atof(argv[++i])), 0.f);
+        }
+        else if(strncmp(argv[i], "--replay", 8) == 0 && i < argc-1) {
+            replay_filepath = argv[++i];
+        }
+        else {
+            filepath = argv[i];
+        }
+    }
+
+    Log::Initialize();
+
+    if(check_workers) {
+        Config::Reload();
+        Audio::Enabled(false);
+        return CheckWorkers(filepath, tick_count, worker_count);
+    }
+
+    //--workers N = object update planning on N threads (main thread + N-1 workers), 0 or 1 = main thread only
+    Jobs::Initialize(worker_count >= 0 ? std::max(worker_count-1, 0) : -1);
+
+    if(bench_jobs) {
+        int result = BenchJobs();
+        Jobs::Release();
+        return result;
+    }
+
+    if(bench_quads) {
+        int result = BenchQuads();
+        Jobs::Release();
+        return result;
+    }
+
+    Config::Reload();
+    Audio::Enabled(false);
+
+    if(bench_savefile) {
+        int result = BenchSavefile();
+        Jobs::Release();
+        return result;
+    }
+
+    if(bench_json) {
+        int result = BenchJSON();
+        Jobs::Release();
+        return result;
+    }
+
+    if(bench_frame) {
+        int result = BenchFrame(filepath, frame_count);
+        TextureGenerator::Clear();
+        Jobs::Release();
+        return result;
+    }
+
+    Level level = {};
+    Replay replay = {};
+    Timer t = {};
+
+    if(!replay_filepath.empty()) {
+        if(!replay.Load(replay_filepath)) {
+            LOG_ERROR("Failed to load the replay log from '{}'.", replay_filepath);
+            Jobs::Release();
+            return 1;
+        }
+        filepath = replay.SavefilePath();
+    }
+
+    try {
+        Resources::Preload();
+    } catch(std::exception&) {
+        LOG_ERROR("Failed to load resources; Terminating...");
+        Jobs::Release();
+        return 1;
+    }
+
+    if(Level::Load(filepath, level) != 0) {
+        LOG_ERROR("Failed to load the level from '{}'.", filepath);
+        Jobs::Release();
+        return 1;
+    }
+    if(!level.factions.IsInitialized()) {
+        //custom game map without faction data
+        level.CustomGame_InitFactions(0, 1);
+        level.CustomGame_InitEndConditions();
+    }
+    float time_load = t.TimeElapsed<Timer::ms>() * 1e-3f;
+
+    if(!replay_filepath.empty()) {
+        level.replay = std::move(replay);
+        level.replay.StartPlayback(level);
+        tick_count = std::max(level.replay.EndTick() - SimClock::Now(), 0);
+    }
+
+    //autosaves go into the temp directory, synchronous save is measured once for comparison
+    Autosave autosave;
+    std::string autosave_path = std::filesystem::temp_directory_path().string() + "/s2d_autosave.sav";
+    double time_sync_save = 0.0;
+    if(autosave_interval > 0.f) {
+        autosave.SetInterval(autosave_interval);
+        autosave.Reset();
+        t.Reset();
+        level.Save(autosave_path);
+        time_sync_save = t.TimeElapsed<Timer::us>() * 1e-3;
+    }
+
+    level.tickStats = {};
+    t.Reset();
+    for(int i = 0; i < tick_count; i++) {
+        level.Tick();
+        if(autosave_interval > 0.f)
+            autosave.Update(level, autosave_path);
+    }
+    autosave.Wait();
+    double time_sim = t.TimeElapsed<Timer::us>() * 1e-6;
+
+    const TickStats& stats = level.tickStats;
+    printf("strategy2d_headless - '%s'\n", filepath.c_str());
+    printf("    load:        %.2fs\n", time_load);
+    printf("    ticks:       %d (%.1fs of game time)\n", stats.ticks, stats.ticks * SimClock::DeltaTime());
+    printf("    elapsed:     %.3fs (%.1f ticks/s, %s)\n", time_sim, stats.ticks / std::max(time_sim, 1e-9), Jobs::WorkerCount() > 0 ? "parallel planning" : "main thread only");
+    printf("    threads:     %d (main thread + %d workers)\n", Jobs::WorkerCount()+1, Jobs::WorkerCount());
+    PrintStat("scenario", stats.scenario, stats);
+    PrintStat("map", stats.map, stats);
+    PrintStat("factions", stats.factions, stats);
+    PrintStat("objects", stats.objects, stats);
+    PrintStat("conditions", stats.conditions, stats);
+
+    if(autosave_interval > 0.f) {
+        AutosaveStats as = autosave.Stats();
+        printf("    autosave:    %d saves (%d failed), %.1fkB, snapshot %.2fms (max %.2fms), background save %.2fms, synchronous save %.2fms\n",
+            as.count, as.failed, as.bytes / 1024.0, as.snapshot_ms, as.snapshot_ms_max, as.save_ms, time_sync_save);
+        std::error_code ec;
+        std::filesystem::remove(autosave_path, ec);
+    }
+
+    printf("    state hash:  %016llx\n", (unsigned long long)Replay::StateHash(level));
+
+    int result = 0;
+    if(level.replay.IsPlaying()) {
+        uint64_t hash = Replay::StateHash(level);
+        bool match = (hash == level.replay.EndHash());
+        printf("    replay:      %zu orders, end state hash %016llx (%s)\n", level.replay.EntryCount(), (unsigned long long)hash, match ? "match" : "MISMATCH");
+        result = match ? 0 : 2;
+    }
+
+    level.Release();
+    Resources::Release();
+    TextureGenerator::Clear();
+    Jobs::Release();
+
+    return result;
+}
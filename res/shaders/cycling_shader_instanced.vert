@@ -0,0 +1,34 @@
+#version 450 core
+
+//Instanced variant of cycling_shader.vert - one SpriteInstance per quad, corners are generated from the vertex index.
+layout(location = 0) in vec3  iPosition;
+layout(location = 1) in vec2  iSize;
+layout(location = 2) in vec4  iTexRect;
+layout(location = 3) in vec4  iColor;
+layout(location = 4) in float iPaletteIdx;
+layout(location = 5) in uvec2 iTextureFlags;
+
+out vec4 color;
+out vec2 texCoords;
+out flat uint textureID;
+out flat float alphaFromTexture;
+out flat float paletteIdx;
+out flat uvec4 objectInfo;
+
+out vec3 fragPos;
+
+void main() {
+    //same corner order as Quad (0 = bottom left, 1 = top left, 2 = bottom right, 3 = top right)
+    vec2 corner = vec2(gl_VertexID >> 1, gl_VertexID & 1);
+    vec3 position = iPosition + vec3(corner * iSize, 0.0);
+
+    gl_Position       = vec4(position, 1.0);
+    color             = iColor;
+    texCoords         = mix(iTexRect.xy, iTexRect.zw, corner);
+    textureID         = iTextureFlags.x;
+    alphaFromTexture  = float(iTextureFlags.y & 1u);
+    paletteIdx        = iPaletteIdx;
+    objectInfo        = uvec4(0);
+
+    fragPos           = position;
+}
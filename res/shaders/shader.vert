@@ -17,8 +17,11 @@ out flat uvec4 objectInfo;
 
 out vec3 fragPos;
 
+//static meshes are in map coords (scale, offset), everything else is already in screen coords
+uniform vec4 transform = vec4(1.0, 1.0, 0.0, 0.0);
+
 void main() {
-    gl_Position       = vec4(aPosition, 1.0);
+    gl_Position       = vec4(aPosition.xy * transform.xy + transform.zw, aPosition.z, 1.0);
     color             = aColor;
     texCoords         = aTexCoords;
     textureID         = aTextureID;
@@ -10,7 +10,7 @@ in flat float alphaFromTexture;
 in flat float paletteIdx;
 in flat uvec4 objectInfo;
 
-#define MAX_TEXTURES 8
+#define MAX_TEXTURES 16
 uniform sampler2D textures[MAX_TEXTURES];
 
 in vec3 fragPos;
@@ -31,14 +31,28 @@ void main() {
         case 5: tColor = texture(textures[5], texCoords); break;
         case 6: tColor = texture(textures[6], texCoords); break;
         case 7: tColor = texture(textures[7], texCoords); break;
+        case 8: tColor = texture(textures[8], texCoords); break;
+        case 9: tColor = texture(textures[9], texCoords); break;
+        case 10: tColor = texture(textures[10], texCoords); break;
+        case 11: tColor = texture(textures[11], texCoords); break;
+        case 12: tColor = texture(textures[12], texCoords); break;
+        case 13: tColor = texture(textures[13], texCoords); break;
+        case 14: tColor = texture(textures[14], texCoords); break;
+        case 15: tColor = texture(textures[15], texCoords); break;
     }
 
+    //alphaFromTexture = 2 -> red channel is a signed distance field (fonts), edge at 0.5
+    float sdfWidth = max(fwidth(tColor.r), 1e-4);
+    if(alphaFromTexture > 1.5)
+        tColor.r = smoothstep(0.5 - sdfWidth, 0.5 + sdfWidth, tColor.r);
+    float alphaMode = min(alphaFromTexture, 1.0);
+
     //added condition cuz blending apparently doesn't work when depth testing is enabled
     if(tColor.a < 0.75 || (alphaFromTexture > 0 && tColor.r < 0.05))
         discard;
 
     ObjectInfo = objectInfo;
-    FragColor = (1 - alphaFromTexture) * (color * tColor) + alphaFromTexture * color * vec4(1.0, 1.0, 1.0, tColor.r);
+    FragColor = (1 - alphaMode) * (color * tColor) + alphaMode * color * vec4(1.0, 1.0, 1.0, tColor.r);
     // FragColor = vec4(vec3(tColor.r > 0.25), tColor.r);
     // FragColor = color;
 }